@@ -71,6 +71,17 @@ INLINE_ALWAYS bool IsDoubleToIntEbmTypeIndexValid(const double val) {
    return true;
 }
 
+INLINE_ALWAYS IntEbmType ConvertDoubleToIntEbmTypeSaturated(const double val) {
+   static_assert(std::numeric_limits<double>::is_iec559, "we need is_iec559 to know that comparisons to infinity and -infinity to normal numbers work");
+   if(std::isnan(val) || static_cast<double>(std::numeric_limits<IntEbmType>::max()) < val) {
+      return std::numeric_limits<IntEbmType>::max();
+   }
+   if(val < static_cast<double>(std::numeric_limits<IntEbmType>::lowest())) {
+      return std::numeric_limits<IntEbmType>::lowest();
+   }
+   return static_cast<IntEbmType>(val);
+}
+
 void BoostingFinalizer(SEXP boosterHandleWrapped) {
    EBM_ASSERT(nullptr != boosterHandleWrapped); // shouldn't be possible
    if(EXTPTRSXP == TYPEOF(boosterHandleWrapped)) {
@@ -1097,6 +1108,103 @@ SEXP BoostingStep_R(
    return ret;
 }
 
+SEXP BoostCyclic_R(
+   SEXP boosterHandleWrapped,
+   SEXP learningRate,
+   SEXP countSamplesRequiredForChildSplitMin,
+   SEXP leavesMax,
+   SEXP countRoundsMax,
+   SEXP countEarlyStoppingRounds,
+   SEXP earlyStoppingTolerance
+) {
+   EBM_ASSERT(nullptr != boosterHandleWrapped);
+   EBM_ASSERT(nullptr != learningRate);
+   EBM_ASSERT(nullptr != countSamplesRequiredForChildSplitMin);
+   EBM_ASSERT(nullptr != leavesMax);
+   EBM_ASSERT(nullptr != countRoundsMax);
+   EBM_ASSERT(nullptr != countEarlyStoppingRounds);
+   EBM_ASSERT(nullptr != earlyStoppingTolerance);
+
+   if(EXTPTRSXP != TYPEOF(boosterHandleWrapped)) {
+      LOG_0(TraceLevelError, "ERROR BoostCyclic_R EXTPTRSXP != TYPEOF(boosterHandleWrapped)");
+      return R_NilValue;
+   }
+   Booster * pBooster = static_cast<Booster *>(R_ExternalPtrAddr(boosterHandleWrapped));
+   if(nullptr == pBooster) {
+      LOG_0(TraceLevelError, "ERROR BoostCyclic_R nullptr == pBooster");
+      return R_NilValue;
+   }
+
+   if(!IsSingleDoubleVector(learningRate)) {
+      LOG_0(TraceLevelError, "ERROR BoostCyclic_R !IsSingleDoubleVector(learningRate)");
+      return R_NilValue;
+   }
+   double learningRateLocal = REAL(learningRate)[0];
+
+   if(!IsSingleDoubleVector(countSamplesRequiredForChildSplitMin)) {
+      LOG_0(TraceLevelError, "ERROR BoostCyclic_R !IsSingleDoubleVector(countSamplesRequiredForChildSplitMin)");
+      return R_NilValue;
+   }
+   const IntEbmType cSamplesRequiredForChildSplitMin = 
+      ConvertDoubleToIntEbmTypeSaturated(REAL(countSamplesRequiredForChildSplitMin)[0]);
+
+   size_t cDimensions;
+   const IntEbmType * aLeavesMax;
+   if(ConvertDoublesToIndexes(leavesMax, &cDimensions, &aLeavesMax)) {
+      LOG_0(TraceLevelError, "ERROR BoostCyclic_R ConvertDoublesToIndexes(leavesMax, &cDimensions, &aLeavesMax)");
+      return R_NilValue;
+   }
+   // BoostCyclic uses leavesMax for every feature group
+   for(size_t iFeatureGroup = 0; iFeatureGroup < pBooster->GetCountFeatureGroups(); ++iFeatureGroup) {
+      if(cDimensions < pBooster->GetFeatureGroups()[iFeatureGroup]->GetCountFeatures()) {
+         LOG_0(TraceLevelError, "ERROR BoostCyclic_R cDimensions < pBooster->GetFeatureGroups()[iFeatureGroup]->GetCountFeatures()");
+         return R_NilValue;
+      }
+   }
+
+   if(!IsSingleDoubleVector(countRoundsMax)) {
+      LOG_0(TraceLevelError, "ERROR BoostCyclic_R !IsSingleDoubleVector(countRoundsMax)");
+      return R_NilValue;
+   }
+   const IntEbmType cRoundsMax = ConvertDoubleToIntEbmTypeSaturated(REAL(countRoundsMax)[0]);
+
+   if(!IsSingleDoubleVector(countEarlyStoppingRounds)) {
+      LOG_0(TraceLevelError, "ERROR BoostCyclic_R !IsSingleDoubleVector(countEarlyStoppingRounds)");
+      return R_NilValue;
+   }
+   const IntEbmType cEarlyStoppingRounds = ConvertDoubleToIntEbmTypeSaturated(REAL(countEarlyStoppingRounds)[0]);
+
+   if(!IsSingleDoubleVector(earlyStoppingTolerance)) {
+      LOG_0(TraceLevelError, "ERROR BoostCyclic_R !IsSingleDoubleVector(earlyStoppingTolerance)");
+      return R_NilValue;
+   }
+   double earlyStoppingToleranceLocal = REAL(earlyStoppingTolerance)[0];
+
+   IntEbmType countRoundsOut;
+   FloatEbmType bestMetricOut;
+   if(0 != BoostCyclic(
+      reinterpret_cast<BoosterHandle>(pBooster),
+      GenerateUpdateOptions_Default,
+      learningRateLocal,
+      cSamplesRequiredForChildSplitMin,
+      aLeavesMax,
+      cRoundsMax,
+      cEarlyStoppingRounds,
+      earlyStoppingToleranceLocal,
+      &countRoundsOut,
+      &bestMetricOut
+   )) {
+      LOG_0(TraceLevelWarning, "WARNING BoostCyclic_R BoostCyclic returned error code");
+      return R_NilValue;
+   }
+
+   SEXP ret = PROTECT(allocVector(REALSXP, R_xlen_t { 2 }));
+   REAL(ret)[0] = static_cast<double>(countRoundsOut);
+   REAL(ret)[1] = bestMetricOut;
+   UNPROTECT(1);
+   return ret;
+}
+
 SEXP GetBestModelFeatureGroup_R(
    SEXP boosterHandleWrapped,
    SEXP indexFeatureGroup
@@ -1565,6 +1673,7 @@ static const R_CallMethodDef g_exposedFunctions[] = {
    { "CreateClassificationBooster_R", (DL_FUNC)&CreateClassificationBooster_R, 15 },
    { "CreateRegressionBooster_R", (DL_FUNC)&CreateRegressionBooster_R, 14 },
    { "BoostingStep_R", (DL_FUNC)& BoostingStep_R, 5 },
+   { "BoostCyclic_R", (DL_FUNC)&BoostCyclic_R, 7 },
    { "GetBestModelFeatureGroup_R", (DL_FUNC)&GetBestModelFeatureGroup_R, 2 },
    { "GetCurrentModelFeatureGroup_R", (DL_FUNC)& GetCurrentModelFeatureGroup_R, 2 },
    { "FreeBooster_R", (DL_FUNC)& FreeBooster_R, 1 },
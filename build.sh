@@ -48,10 +48,14 @@ staging_path="$root_path/staging"
 
 build_32_bit=0
 build_64_bit=1
+build_benchmark=0
 for arg in "$@"; do
    if [ "$arg" = "-32bit" ]; then
       build_32_bit=1
    fi
+   if [ "$arg" = "-benchmark" ]; then
+      build_benchmark=1
+   fi
    if [ "$arg" = "-no64bit" ]; then
       build_64_bit=0
    fi
@@ -67,15 +71,19 @@ compile_all="$compile_all \"$src_path/BinInteraction.cpp\""
 compile_all="$compile_all \"$src_path/BinningQuantile.cpp\""
 compile_all="$compile_all \"$src_path/BinningUniform.cpp\""
 compile_all="$compile_all \"$src_path/BinningWinsorized.cpp\""
+compile_all="$compile_all \"$src_path/BinningFeatures.cpp\""
 compile_all="$compile_all \"$src_path/Booster.cpp\""
 compile_all="$compile_all \"$src_path/CalculateInteractionScore.cpp\""
 compile_all="$compile_all \"$src_path/CachedThreadResourcesBoosting.cpp\""
 compile_all="$compile_all \"$src_path/CachedThreadResourcesInteraction.cpp\""
 compile_all="$compile_all \"$src_path/CutRandom.cpp\""
+compile_all="$compile_all \"$src_path/CpuDispatch.cpp\""
 compile_all="$compile_all \"$src_path/DataSetBoosting.cpp\""
 compile_all="$compile_all \"$src_path/DataSetInteraction.cpp\""
 compile_all="$compile_all \"$src_path/DebugEbm.cpp\""
 compile_all="$compile_all \"$src_path/Discretization.cpp\""
+compile_all="$compile_all \"$src_path/DiscretizeEngine.cpp\""
+compile_all="$compile_all \"$src_path/MappedFile.cpp\""
 compile_all="$compile_all \"$src_path/FeatureGroup.cpp\""
 compile_all="$compile_all \"$src_path/FindBestBoostingSplitsPairs.cpp\""
 compile_all="$compile_all \"$src_path/FindBestInteractionGainPairs.cpp\""
@@ -85,12 +93,16 @@ compile_all="$compile_all \"$src_path/InitializeResiduals.cpp\""
 compile_all="$compile_all \"$src_path/InteractionDetector.cpp\""
 compile_all="$compile_all \"$src_path/InterpretableNumerics.cpp\""
 compile_all="$compile_all \"$src_path/Logging.cpp\""
+compile_all="$compile_all \"$src_path/PredictScores.cpp\""
+compile_all="$compile_all \"$src_path/Predictor.cpp\""
+compile_all="$compile_all \"$src_path/PredictorFile.cpp\""
 compile_all="$compile_all \"$src_path/RandomExternal.cpp\""
 compile_all="$compile_all \"$src_path/RandomStream.cpp\""
 compile_all="$compile_all \"$src_path/SamplingSet.cpp\""
 compile_all="$compile_all \"$src_path/SegmentedTensor.cpp\""
 compile_all="$compile_all \"$src_path/SumHistogramBuckets.cpp\""
 compile_all="$compile_all \"$src_path/TensorTotalsBuild.cpp\""
+compile_all="$compile_all \"$src_path/Threading.cpp\""
 compile_all="$compile_all -I\"$src_path\""
 compile_all="$compile_all -I\"$src_path/inc\""
 compile_all="$compile_all -Wall -Wextra"
@@ -103,10 +115,21 @@ compile_all="$compile_all -Wformat=2"
 compile_all="$compile_all -std=c++11"
 compile_all="$compile_all -fvisibility=hidden -fvisibility-inlines-hidden"
 compile_all="$compile_all -fno-math-errno -fno-trapping-math"
+compile_all="$compile_all -pthread"
 compile_all="$compile_all -march=core2"
 compile_all="$compile_all -fpic"
 compile_all="$compile_all -DEBM_NATIVE_EXPORTS"
 
+# the scoring benchmark only uses the public interface, so it links against the release library like any other caller
+benchmark_path="$src_path/ebm_native_benchmark"
+compile_benchmark=""
+compile_benchmark="$compile_benchmark \"$benchmark_path/EbmNativeBenchmark.cpp\""
+compile_benchmark="$compile_benchmark -I\"$src_path/inc\""
+compile_benchmark="$compile_benchmark -Wall -Wextra"
+compile_benchmark="$compile_benchmark -std=c++11"
+compile_benchmark="$compile_benchmark -march=core2"
+compile_benchmark="$compile_benchmark -L\"$staging_path\""
+
 if [ "$os_type" = "Darwin" ]; then
    # reference on rpath & install_name: https://www.mikeash.com/pyblog/friday-qa-2009-11-06-linking-and-install-names.html
 
@@ -163,6 +186,40 @@ if [ "$os_type" = "Darwin" ]; then
          exit $ret_code
       fi
 
+      if [ $build_benchmark -eq 1 ]; then
+         ########################## macOS release|x64 benchmark
+
+         printf "%s\n" "Compiling ebm_native_benchmark with $clang_pp_bin for macOS release|x64"
+         intermediate_path="$root_path/tmp/clang/intermediate/release/mac/x64/ebm_native_benchmark"
+         bin_path="$root_path/tmp/clang/bin/release/mac/x64/ebm_native_benchmark"
+         log_file="$intermediate_path/ebm_native_benchmark_release_mac_x64_build_log.txt"
+         compile_command="$clang_pp_bin $compile_benchmark -Wl,-rpath,@loader_path -m64 -DNDEBUG -O3 -l_ebm_native_mac_x64 -o \"$bin_path/ebm_native_benchmark\" 2>&1"
+
+         [ -d "$intermediate_path" ] || mkdir -p "$intermediate_path"
+         ret_code=$?
+         if [ $ret_code -ne 0 ]; then 
+            exit $ret_code
+         fi
+         [ -d "$bin_path" ] || mkdir -p "$bin_path"
+         ret_code=$?
+         if [ $ret_code -ne 0 ]; then 
+            exit $ret_code
+         fi
+         compile_out=`eval $compile_command`
+         ret_code=$?
+         printf "%s\n" "$compile_out"
+         printf "%s\n" "$compile_out" > "$log_file"
+         if [ $ret_code -ne 0 ]; then 
+            exit $ret_code
+         fi
+         cp "$staging_path/lib_ebm_native_mac_x64.dylib" "$bin_path/"
+         ret_code=$?
+         if [ $ret_code -ne 0 ]; then 
+            exit $ret_code
+         fi
+         printf "%s\n" "Run \"$bin_path/ebm_native_benchmark\" to write the scoring benchmark results as JSON"
+      fi
+
       ########################## macOS debug|x64
 
       printf "%s\n" "Compiling ebm_native with $clang_pp_bin for macOS debug|x64"
@@ -258,6 +315,40 @@ elif [ "$os_type" = "Linux" ]; then
          exit $ret_code
       fi
 
+      if [ $build_benchmark -eq 1 ]; then
+         ########################## Linux release|x64 benchmark
+
+         printf "%s\n" "Compiling ebm_native_benchmark with $g_pp_bin for Linux release|x64"
+         intermediate_path="$root_path/tmp/gcc/intermediate/release/linux/x64/ebm_native_benchmark"
+         bin_path="$root_path/tmp/gcc/bin/release/linux/x64/ebm_native_benchmark"
+         log_file="$intermediate_path/ebm_native_benchmark_release_linux_x64_build_log.txt"
+         compile_command="$g_pp_bin $compile_benchmark -Wl,-rpath,'\$ORIGIN/' -m64 -DNDEBUG -O3 -l_ebm_native_linux_x64 -o \"$bin_path/ebm_native_benchmark\" 2>&1"
+
+         [ -d "$intermediate_path" ] || mkdir -p "$intermediate_path"
+         ret_code=$?
+         if [ $ret_code -ne 0 ]; then 
+            exit $ret_code
+         fi
+         [ -d "$bin_path" ] || mkdir -p "$bin_path"
+         ret_code=$?
+         if [ $ret_code -ne 0 ]; then 
+            exit $ret_code
+         fi
+         compile_out=`eval $compile_command`
+         ret_code=$?
+         printf "%s\n" "$compile_out"
+         printf "%s\n" "$compile_out" > "$log_file"
+         if [ $ret_code -ne 0 ]; then 
+            exit $ret_code
+         fi
+         cp "$staging_path/lib_ebm_native_linux_x64.so" "$bin_path/"
+         ret_code=$?
+         if [ $ret_code -ne 0 ]; then 
+            exit $ret_code
+         fi
+         printf "%s\n" "Run \"$bin_path/ebm_native_benchmark\" to write the scoring benchmark results as JSON"
+      fi
+
       ########################## Linux debug|x64
 
       printf "%s\n" "Compiling ebm_native with $g_pp_bin for Linux debug|x64"
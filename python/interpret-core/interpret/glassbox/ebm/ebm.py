@@ -178,6 +178,30 @@ class EBMPreprocessor(BaseEstimator, TransformerMixin):
         if self.max_bins < 2:
             raise ValueError("max_bins must be 2 or higher.  One bin is required for missing, and annother for non-missing values.")
 
+        if self.binning == "quantile":
+            binning_method = Native.BinningMethod_Quantile
+        elif self.binning == "quantile_humanized":
+            binning_method = Native.BinningMethod_QuantileHumanized
+        elif self.binning == "uniform":
+            binning_method = Native.BinningMethod_Uniform
+        else:
+            raise ValueError(f"Unrecognized bin type: {self.binning}")
+
+        # bin all the continuous columns in one native call so that they are processed in parallel
+        continuous_cols = [
+            col_idx for col_idx, col_info in enumerate(schema.values()) if col_info["type"] == "continuous"
+        ]
+        continuous_bin_cuts = {}
+        if len(continuous_cols) != 0:
+            n_cols = len(continuous_cols)
+            results = native.generate_features_bin_cuts(
+                X[:, continuous_cols].astype(float).T,
+                np.full(n_cols, binning_method, dtype=np.int64),
+                np.full(n_cols, 1, dtype=np.int64), # TODO: Expose min_samples_bin
+                np.full(n_cols, self.max_bins - 2, dtype=np.int64), # one bin for missing, and # of cuts is one less again
+            )
+            continuous_bin_cuts = dict(zip(continuous_cols, results))
+
         for col_idx in range(X.shape[1]):
             col_name = list(schema.keys())[col_idx]
             self.col_names_.append(col_name)
@@ -190,36 +214,12 @@ class EBMPreprocessor(BaseEstimator, TransformerMixin):
             if col_info["type"] == "continuous":
                 col_data = col_data.astype(float)
 
-                min_samples_bin = 1 # TODO: Expose
-                is_humanized = 0
-
-                if self.binning == 'quantile' or self.binning == 'quantile_humanized':
-                    if self.binning == 'quantile_humanized':
-                        is_humanized = 1
-
-                    (
-                        bin_cuts, 
-                        count_missing, 
-                        min_val, 
-                        max_val, 
-                    ) = native.generate_quantile_bin_cuts(
-                        col_data, 
-                        min_samples_bin, 
-                        is_humanized, 
-                        self.max_bins - 2, # one bin for missing, and # of cuts is one less again
-                    )
-                elif self.binning == "uniform":
-                    (
-                        bin_cuts, 
-                        count_missing, 
-                        min_val, 
-                        max_val,
-                    ) = native.generate_uniform_bin_cuts(
-                        col_data, 
-                        self.max_bins - 2, # one bin for missing, and # of cuts is one less again
-                    )
-                else:
-                    raise ValueError(f"Unrecognized bin type: {self.binning}")
+                (
+                    bin_cuts, 
+                    count_missing, 
+                    min_val, 
+                    max_val, 
+                ) = continuous_bin_cuts[col_idx]
 
                 discretized = native.discretize(col_data, bin_cuts)
 
@@ -22,6 +22,12 @@ class Native:
     GenerateUpdateOptions_GradientSums          = 0x0000000000000004
     GenerateUpdateOptions_RandomSplits          = 0x0000000000000008
 
+    # BinningMethod
+    BinningMethod_Quantile = 0
+    BinningMethod_QuantileHumanized = 1
+    BinningMethod_Uniform = 2
+    BinningMethod_Winsorized = 3
+
     # TraceLevel
     _TraceLevelOff = 0
     _TraceLevelError = 1
@@ -173,6 +179,63 @@ class Native:
 
         return bin_cuts, count_missing, min_val, max_val
 
+    def generate_features_bin_cuts(
+        self, 
+        features_data, 
+        binning_methods, 
+        min_samples_bin, 
+        max_cuts, 
+    ):
+        # features_data is [n_features, n_samples] and the other arguments have one entry per feature.
+        # Returns a list of (bin_cuts, count_missing, min_val, max_val) with one tuple per feature
+        features_data = np.ascontiguousarray(features_data, dtype=np.float64)
+        n_features = features_data.shape[0]
+        binning_methods = np.ascontiguousarray(binning_methods, dtype=np.int64)
+        min_samples_bin = np.ascontiguousarray(min_samples_bin, dtype=np.int64)
+        max_cuts = np.ascontiguousarray(max_cuts, dtype=np.int64)
+
+        count_cuts = np.empty(n_features, dtype=np.int64, order="C")
+        # ndpointer does not accept empty arrays, so always allocate at least one cut
+        bin_cuts = np.empty(max(int(max_cuts.sum()), 1), dtype=np.float64, order="C")
+        count_missing = np.empty(n_features, dtype=np.int64, order="C")
+        min_val = np.empty(n_features, dtype=np.float64, order="C")
+        count_neg_inf = np.empty(n_features, dtype=np.int64, order="C")
+        max_val = np.empty(n_features, dtype=np.float64, order="C")
+        count_inf = np.empty(n_features, dtype=np.int64, order="C")
+
+        return_code = self._unsafe.GenerateFeaturesBinCuts(
+            0, # use every thread
+            n_features,
+            features_data.shape[1],
+            features_data,
+            binning_methods,
+            min_samples_bin,
+            max_cuts,
+            count_cuts,
+            bin_cuts,
+            count_missing,
+            min_val,
+            count_neg_inf,
+            max_val,
+            count_inf
+        )
+
+        if return_code != 0:  # pragma: no cover
+            raise Exception("Out of memory in GenerateFeaturesBinCuts")
+
+        results = []
+        bin_cut_first = 0
+        for i in range(n_features):
+            results.append((
+                bin_cuts[bin_cut_first:bin_cut_first + count_cuts[i]].copy(),
+                int(count_missing[i]),
+                float(min_val[i]),
+                float(max_val[i]),
+            ))
+            bin_cut_first += int(max_cuts[i])
+
+        return results
+
     def discretize(
         self, 
         col_data, 
@@ -337,6 +400,38 @@ class Native:
         ]
         self._unsafe.GenerateWinsorizedBinCuts.restype = ct.c_int64
 
+        self._unsafe.GenerateFeaturesBinCuts.argtypes = [
+            # int64_t countThreads
+            ct.c_int64,
+            # int64_t countFeatures
+            ct.c_int64,
+            # int64_t countSamples
+            ct.c_int64,
+            # double * featureValues
+            ndpointer(dtype=ct.c_double, ndim=2, flags="C_CONTIGUOUS"),
+            # int64_t * binningMethods
+            ndpointer(dtype=ct.c_int64, ndim=1),
+            # int64_t * countSamplesPerBinMin
+            ndpointer(dtype=ct.c_int64, ndim=1),
+            # int64_t * countBinCutsMax
+            ndpointer(dtype=ct.c_int64, ndim=1),
+            # int64_t * countBinCutsOut
+            ndpointer(dtype=ct.c_int64, ndim=1, flags="C_CONTIGUOUS"),
+            # double * binCutsLowerBoundInclusiveOut
+            ndpointer(dtype=ct.c_double, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t * countMissingValuesOut
+            ndpointer(dtype=ct.c_int64, ndim=1, flags="C_CONTIGUOUS"),
+            # double * minNonInfinityValueOut
+            ndpointer(dtype=ct.c_double, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t * countNegativeInfinityOut
+            ndpointer(dtype=ct.c_int64, ndim=1, flags="C_CONTIGUOUS"),
+            # double * maxNonInfinityValueOut
+            ndpointer(dtype=ct.c_double, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t * countPositiveInfinityOut
+            ndpointer(dtype=ct.c_int64, ndim=1, flags="C_CONTIGUOUS"),
+        ]
+        self._unsafe.GenerateFeaturesBinCuts.restype = ct.c_int64
+
 
         self._unsafe.SuggestGraphBounds.argtypes = [
             # int64_t countBinCuts
@@ -507,6 +602,60 @@ class Native:
         ]
         self._unsafe.ApplyModelFeatureGroupUpdate.restype = ct.c_int64
 
+        self._unsafe.BoostCyclic.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # GenerateUpdateOptionsType options 
+            ct.c_int64,
+            # double learningRate
+            ct.c_double,
+            # int64_t countSamplesRequiredForChildSplitMin
+            ct.c_int64,
+            # int64_t * leavesMax
+            ndpointer(dtype=ct.c_int64, ndim=1),
+            # int64_t countRoundsMax
+            ct.c_int64,
+            # int64_t countEarlyStoppingRounds
+            ct.c_int64,
+            # double earlyStoppingTolerance
+            ct.c_double,
+            # int64_t * countRoundsOut
+            ct.POINTER(ct.c_int64),
+            # double * bestMetricOut
+            ct.POINTER(ct.c_double),
+        ]
+        self._unsafe.BoostCyclic.restype = ct.c_int64
+
+        self._unsafe.BoostJacobi.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # int64_t countThreads
+            ct.c_int64,
+            # int64_t countFeatureGroupsPerBlock
+            ct.c_int64,
+            # double damping
+            ct.c_double,
+            # GenerateUpdateOptionsType options 
+            ct.c_int64,
+            # double learningRate
+            ct.c_double,
+            # int64_t countSamplesRequiredForChildSplitMin
+            ct.c_int64,
+            # int64_t * leavesMax
+            ndpointer(dtype=ct.c_int64, ndim=1),
+            # int64_t countRoundsMax
+            ct.c_int64,
+            # int64_t countEarlyStoppingRounds
+            ct.c_int64,
+            # double earlyStoppingTolerance
+            ct.c_double,
+            # int64_t * countRoundsOut
+            ct.POINTER(ct.c_int64),
+            # double * bestMetricOut
+            ct.POINTER(ct.c_double),
+        ]
+        self._unsafe.BoostJacobi.restype = ct.c_int64
+
         self._unsafe.GetBestModelFeatureGroup.argtypes = [
             # void * boosterHandle
             ct.c_void_p,
@@ -593,6 +742,28 @@ class Native:
         ]
         self._unsafe.CalculateInteractionScore.restype = ct.c_int64
 
+        self._unsafe.CalculateInteractionScores.argtypes = [
+            # void * interactionDetectorHandle
+            ct.c_void_p,
+            # int64_t countThreads
+            ct.c_int64,
+            # int64_t countFeatureGroups
+            ct.c_int64,
+            # int64_t * featureGroupsFeatureCount
+            ndpointer(dtype=ct.c_int64, ndim=1),
+            # int64_t * featureGroupsFeatureIndexes
+            ndpointer(dtype=ct.c_int64, ndim=1),
+            # int64_t countSamplesRequiredForChildSplitMin
+            ct.c_int64,
+            # int64_t countTopScores
+            ct.c_int64,
+            # int64_t * topFeatureGroupIndexesOut
+            ndpointer(dtype=ct.c_int64, ndim=1, flags="C_CONTIGUOUS"),
+            # double * interactionScoresOut
+            ndpointer(dtype=ct.c_double, ndim=1, flags="C_CONTIGUOUS"),
+        ]
+        self._unsafe.CalculateInteractionScores.restype = ct.c_int64
+
         self._unsafe.FreeInteractionDetector.argtypes = [
             # void * interactionDetectorHandle
             ct.c_void_p
@@ -910,6 +1081,113 @@ class NativeEBMBooster:
         # log.debug("Boosting step end")
         return metric_output.value
 
+    def boost_cyclic(
+        self, 
+        generate_update_options, 
+        learning_rate, 
+        min_samples_leaf, 
+        max_leaves, 
+        max_rounds, 
+        early_stopping_rounds, 
+        early_stopping_tolerance, 
+    ):
+
+        """ Boosts each feature group in turn for up to max_rounds rounds,
+            with the early stopping done in native code.
+
+        Args:
+            learning_rate: Learning rate as a float.
+            max_leaves: Max leaf nodes on feature step.
+            min_samples_leaf: Min observations required to split.
+            max_rounds: Max number of rounds over all the feature groups.
+            early_stopping_rounds: Rounds without improvement before stopping,
+                or negative to never stop early.
+            early_stopping_tolerance: Improvement required to continue.
+
+        Returns:
+            The number of rounds run and the best validation metric.
+        """
+
+        count_rounds = ct.c_int64(0)
+        metric_output = ct.c_double(0.0)
+        # see the max_leaves TODO in boosting_step. Every feature group uses the same max_leaves array
+        n_dimensions_max = max((len(feature_group) for feature_group in self._feature_groups), default=0)
+        max_leaves_arr = np.full(max(n_dimensions_max, 1), max_leaves, dtype=ct.c_int64, order="C")
+
+        return_code = self._native._unsafe.BoostCyclic(
+            self._booster_handle,
+            generate_update_options,
+            learning_rate,
+            min_samples_leaf,
+            max_leaves_arr,
+            max_rounds,
+            early_stopping_rounds,
+            early_stopping_tolerance,
+            ct.byref(count_rounds),
+            ct.byref(metric_output),
+        )
+        if return_code != 0:  # pragma: no cover
+            raise Exception("Out of memory in BoostCyclic")
+
+        return count_rounds.value, metric_output.value
+
+    def boost_jacobi(
+        self, 
+        feature_groups_per_block, 
+        damping, 
+        generate_update_options, 
+        learning_rate, 
+        min_samples_leaf, 
+        max_leaves, 
+        max_rounds, 
+        early_stopping_rounds, 
+        early_stopping_tolerance, 
+    ):
+
+        """ Like boost_cyclic, but the updates for each block of feature groups
+            are generated in parallel from the same residuals and then applied together.
+
+        Args:
+            feature_groups_per_block: Feature groups boosted together, or 0 for all of them.
+            damping: Multiplies the learning rate, since updates applied together can overshoot.
+            learning_rate: Learning rate as a float.
+            max_leaves: Max leaf nodes on feature step.
+            min_samples_leaf: Min observations required to split.
+            max_rounds: Max number of rounds over all the feature groups.
+            early_stopping_rounds: Rounds without improvement before stopping,
+                or negative to never stop early.
+            early_stopping_tolerance: Improvement required to continue.
+
+        Returns:
+            The number of rounds run and the best validation metric.
+        """
+
+        count_rounds = ct.c_int64(0)
+        metric_output = ct.c_double(0.0)
+        # see the max_leaves TODO in boosting_step. Every feature group uses the same max_leaves array
+        n_dimensions_max = max((len(feature_group) for feature_group in self._feature_groups), default=0)
+        max_leaves_arr = np.full(max(n_dimensions_max, 1), max_leaves, dtype=ct.c_int64, order="C")
+
+        return_code = self._native._unsafe.BoostJacobi(
+            self._booster_handle,
+            0, # use every thread
+            feature_groups_per_block,
+            damping,
+            generate_update_options,
+            learning_rate,
+            min_samples_leaf,
+            max_leaves_arr,
+            max_rounds,
+            early_stopping_rounds,
+            early_stopping_tolerance,
+            ct.byref(count_rounds),
+            ct.byref(metric_output),
+        )
+        if return_code != 0:  # pragma: no cover
+            raise Exception("Out of memory in BoostJacobi")
+
+        return count_rounds.value, metric_output.value
+
     def get_best_model(self):
         model = []
         for index in range(len(self._feature_groups)):
@@ -1221,6 +1499,48 @@ class NativeEBMInteraction:
         log.info("Fast interaction score end")
         return score.value
 
+    def get_top_interaction_scores(self, feature_groups, min_samples_leaf, n_top):
+        """ Scores all the feature interactions at once on the native thread pool.
+
+        Args:
+            feature_groups: List of feature index tuples.
+            min_samples_leaf: Min observations required to split.
+            n_top: Number of best interactions to return.
+
+        Returns:
+            Indexes into feature_groups and the scores of the n_top
+            best interactions, from the best to the worst.
+        """
+        log.info("Fast interaction scores start")
+        n_feature_groups = len(feature_groups)
+        n_top = min(n_top, n_feature_groups)
+        feature_counts = np.array(
+            [len(feature_group) for feature_group in feature_groups], dtype=ct.c_int64
+        )
+        feature_indexes = np.array(
+            [index for feature_group in feature_groups for index in feature_group],
+            dtype=ct.c_int64,
+        )
+        top_indexes = np.zeros(max(n_top, 1), dtype=ct.c_int64)
+        scores = np.zeros(max(n_top, 1), dtype=ct.c_double)
+        if n_top != 0:
+            return_code = self._native._unsafe.CalculateInteractionScores(
+                self._interaction_handle,
+                0,
+                n_feature_groups,
+                feature_counts,
+                feature_indexes,
+                min_samples_leaf,
+                n_top,
+                top_indexes,
+                scores,
+            )
+            if return_code != 0:  # pragma: no cover
+                raise Exception("Out of memory in CalculateInteractionScores")
+
+        log.info("Fast interaction scores end")
+        return top_indexes[:n_top], scores[:n_top]
+
 
 class NativeHelper:
     @staticmethod
@@ -1248,8 +1568,6 @@ class NativeHelper:
         name,
         optional_temp_params=None,
     ):
-        min_metric = np.inf
-        episode_index = 0
         with closing(
             NativeEBMBooster(
                 model_type,
@@ -1268,44 +1586,18 @@ class NativeHelper:
                 optional_temp_params,
             )
         ) as native_ebm_booster:
-            no_change_run_length = 0
-            bp_metric = np.inf
             log.info("Start boosting {0}".format(name))
-            for episode_index in range(max_rounds):
-                if episode_index % 10 == 0:
-                    log.debug("Sweep Index for {0}: {1}".format(name, episode_index))
-                    log.debug("Metric: {0}".format(min_metric))
-
-                for feature_group_index in range(len(feature_groups)):
-                    curr_metric = native_ebm_booster.boosting_step(
-                        feature_group_index=feature_group_index,
-                        generate_update_options=generate_update_options,
-                        learning_rate=learning_rate,
-                        min_samples_leaf=min_samples_leaf,
-                        max_leaves=max_leaves,
-                    )
-
-                    min_metric = min(curr_metric, min_metric)
-
-                # TODO PK this early_stopping_tolerance is a little inconsistent
-                #      since it triggers intermittently and only re-triggers if the
-                #      threshold is re-passed, but not based on a smooth windowed set
-                #      of checks.  We can do better by keeping a list of the last
-                #      number of measurements to have a consistent window of values.
-                #      If we only cared about the metric at the start and end of the epoch
-                #      window a circular buffer would be best choice with O(1).
-                if no_change_run_length == 0:
-                    bp_metric = min_metric
-                if min_metric + early_stopping_tolerance < bp_metric:
-                    no_change_run_length = 0
-                else:
-                    no_change_run_length += 1
-
-                if (
-                    early_stopping_rounds >= 0
-                    and no_change_run_length >= early_stopping_rounds
-                ):
-                    break
+            count_rounds, min_metric = native_ebm_booster.boost_cyclic(
+                generate_update_options=generate_update_options,
+                learning_rate=learning_rate,
+                min_samples_leaf=min_samples_leaf,
+                max_leaves=max_leaves,
+                max_rounds=max_rounds,
+                early_stopping_rounds=early_stopping_rounds,
+                early_stopping_tolerance=early_stopping_tolerance,
+            )
+            # the index of the last round run, as when we looped over the rounds here
+            episode_index = max(count_rounds - 1, 0)
 
             log.info(
                 "End boosting {0}, Best Metric: {1}, Num Rounds: {2}".format(
@@ -1332,24 +1624,18 @@ class NativeHelper:
         min_samples_leaf,
         optional_temp_params=None,
     ):
-        interaction_scores = []
+        feature_groups = list(iter_feature_groups)
         with closing(
             NativeEBMInteraction(
                 model_type, n_classes, features_categorical, features_bin_count, X, y, scores, optional_temp_params
             )
         ) as native_ebm_interactions:
-            for feature_group in iter_feature_groups:
-                score = native_ebm_interactions.get_interaction_score(
-                    feature_group, min_samples_leaf,
-                )
-                interaction_scores.append((feature_group, score))
-
-        ranked_scores = list(
-            sorted(interaction_scores, key=lambda x: x[1], reverse=True)
-        )
-        final_ranked_scores = ranked_scores
+            # ranking all of them keeps ties in their original order, like a stable sort
+            top_indexes, top_scores = native_ebm_interactions.get_top_interaction_scores(
+                feature_groups, min_samples_leaf, len(feature_groups),
+            )
 
-        final_indices = [x[0] for x in final_ranked_scores]
-        final_scores = [x[1] for x in final_ranked_scores]
+        final_indices = [feature_groups[index] for index in top_indexes]
+        final_scores = top_scores.tolist()
 
         return final_indices, final_scores
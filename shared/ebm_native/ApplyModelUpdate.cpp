@@ -48,6 +48,27 @@ static IntEbmType ApplyModelFeatureGroupUpdateInternal(
    EBM_ASSERT(nullptr != pBooster->GetBestModel());
    EBM_ASSERT(nullptr != aModelFeatureGroupUpdateTensor); // aModelFeatureGroupUpdateTensor is checked for nullptr before calling this function   
 
+   const FeatureGroup * const pFeatureGroup = pBooster->GetFeatureGroups()[iFeatureGroup];
+
+   // boosters that share their data unpack their own samples before we change the model, so running out of memory 
+   // leaves the booster as it was.  Only classification reads the targets, since regression keeps them in the residuals
+   const bool bClassification = IsClassification(pBooster->GetRuntimeLearningTypeOrCountTargetClasses());
+   if(pBooster->GetTrainingSet()->GatherView(pFeatureGroup, bClassification)) {
+      if(nullptr != pValidationMetricReturn) {
+         *pValidationMetricReturn = FloatEbmType { 0 };
+      }
+      LOG_0(TraceLevelWarning, "WARNING ApplyModelFeatureGroupUpdateInternal pBooster->GetTrainingSet()->GatherView");
+      return 1;
+   }
+   if(pBooster->GetValidationSet()->GatherView(pFeatureGroup, bClassification)) {
+      pBooster->GetTrainingSet()->ReleaseView(pFeatureGroup, bClassification);
+      if(nullptr != pValidationMetricReturn) {
+         *pValidationMetricReturn = FloatEbmType { 0 };
+      }
+      LOG_0(TraceLevelWarning, "WARNING ApplyModelFeatureGroupUpdateInternal pBooster->GetValidationSet()->GatherView");
+      return 1;
+   }
+
    // our caller can give us one of these bad types of inputs:
    //  1) NaN values
    //  2) +-infinity
@@ -63,8 +84,6 @@ static IntEbmType ApplyModelFeatureGroupUpdateInternal(
    // so we don't want to overflow the values to NaN or +-infinity there, and it's very cheap for us to check for overflows when applying the model
    pBooster->GetCurrentModel()[iFeatureGroup]->AddExpandedWithBadValueProtection(aModelFeatureGroupUpdateTensor);
 
-   const FeatureGroup * const pFeatureGroup = pBooster->GetFeatureGroups()[iFeatureGroup];
-
    if(0 != pBooster->GetTrainingSet()->GetCountSamples()) {
       ApplyModelUpdateTraining(
          pBooster,
@@ -109,6 +128,8 @@ static IntEbmType ApplyModelFeatureGroupUpdateInternal(
          size_t iModelEnd = pBooster->GetCountFeatureGroups();
          do {
             if(pBooster->GetBestModel()[iModel]->Copy(*pBooster->GetCurrentModel()[iModel])) {
+               pBooster->GetTrainingSet()->ReleaseView(pFeatureGroup, bClassification);
+               pBooster->GetValidationSet()->ReleaseView(pFeatureGroup, bClassification);
                if(nullptr != pValidationMetricReturn) {
                   *pValidationMetricReturn = FloatEbmType { 0 }; // on error set it to something instead of random bits
                }
@@ -119,6 +140,8 @@ static IntEbmType ApplyModelFeatureGroupUpdateInternal(
          } while(iModel != iModelEnd);
       }
    }
+   pBooster->GetTrainingSet()->ReleaseView(pFeatureGroup, bClassification);
+   pBooster->GetValidationSet()->ReleaseView(pFeatureGroup, bClassification);
    if(nullptr != pValidationMetricReturn) {
       *pValidationMetricReturn = modelMetric;
    }
@@ -0,0 +1,904 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <ebm@koch.ninja>
+
+// ApplyModelUpdateTraining.cpp only includes this through CpuVariantKernels.h, once for each CPU variant, so there is no include 
+// guard and nothing gets included here
+
+// C++ does not allow partial function specialization, so we need to use these cumbersome static class functions to do partial function specialization
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+class ApplyModelUpdateTrainingZeroFeatures final {
+public:
+
+   ApplyModelUpdateTrainingZeroFeatures() = delete; // this is a static class.  Do not construct
+
+   static void Func(
+      Booster * const pBooster,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples,
+      FloatEbmType * const aTempFloatVector
+   ) {
+      static_assert(IsClassification(compilerLearningTypeOrCountTargetClasses), "must be classification");
+      static_assert(!IsBinaryClassification(compilerLearningTypeOrCountTargetClasses), "must be multiclass");
+
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
+      DataSetByFeatureGroup * const pTrainingSet = pBooster->GetTrainingSet();
+
+      FloatEbmType aLocalExpVector[
+         k_dynamicClassification == compilerLearningTypeOrCountTargetClasses ? 1 : GetVectorLength(compilerLearningTypeOrCountTargetClasses)
+      ];
+      FloatEbmType * const aExpVector = k_dynamicClassification == compilerLearningTypeOrCountTargetClasses ? aTempFloatVector : aLocalExpVector;
+
+      const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
+         compilerLearningTypeOrCountTargetClasses,
+         runtimeLearningTypeOrCountTargetClasses
+      );
+      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(iSampleFirst + cSamples <= pTrainingSet->GetCountSamples());
+
+      FloatStorageType * pResidualError = pTrainingSet->GetResidualPointer<FloatStorageType>() + cVectorLength * iSampleFirst;
+      const StorageDataType * pTargetData = pTrainingSet->GetTargetDataPointer() + iSampleFirst;
+      FloatStorageType * pPredictorScores = pTrainingSet->GetPredictorScores<FloatStorageType>() + cVectorLength * iSampleFirst;
+      const FloatStorageType * const pPredictorScoresEnd = pPredictorScores + cSamples * cVectorLength;
+      do {
+         size_t targetData = static_cast<size_t>(*pTargetData);
+         ++pTargetData;
+
+         const FloatEbmType * pValues = aModelFeatureGroupUpdateTensor;
+         FloatEbmType * pExpVector = aExpVector;
+         FloatEbmType sumExp = FloatEbmType { 0 };
+         size_t iVector = 0;
+         do {
+            // TODO : because there is only one bin for a zero feature feature group, we could move these values to the stack where the
+            // compiler could reason about their visibility and optimize small arrays into registers
+            const FloatEbmType smallChangeToPredictorScores = *pValues;
+            ++pValues;
+            // this will apply a small fix to our existing TrainingPredictorScores, either positive or negative, whichever is needed
+            const FloatEbmType predictorScore = static_cast<FloatEbmType>(*pPredictorScores) + smallChangeToPredictorScores;
+            *pPredictorScores = static_cast<FloatStorageType>(predictorScore);
+            ++pPredictorScores;
+            const FloatEbmType oneExp = ExpForResidualsMulticlass(predictorScore);
+            *pExpVector = oneExp;
+            ++pExpVector;
+            sumExp += oneExp;
+            ++iVector;
+         } while(iVector < cVectorLength);
+         pExpVector -= cVectorLength;
+         iVector = 0;
+         do {
+            const FloatEbmType residualError = EbmStatistics::ComputeResidualErrorMulticlass(
+               sumExp,
+               *pExpVector,
+               targetData,
+               iVector
+            );
+            ++pExpVector;
+            *pResidualError = static_cast<FloatStorageType>(residualError);
+            ++pResidualError;
+            ++iVector;
+         } while(iVector < cVectorLength);
+         // TODO: this works as a way to remove one parameter, but it obviously insn't as efficient as omitting the parameter
+         // 
+         // this works out in the math as making the first model vector parameter equal to zero, which in turn removes one degree of freedom
+         // from the model vector parameters.  Since the model vector weights need to be normalized to sum to a probabilty of 100%, we can set the first
+         // one to the constant 1 (0 in log space) and force the other parameters to adjust to that scale which fixes them to a single valid set of 
+         // values insted of allowing them to be scaled.  
+         // Probability = exp(T1 + I1) / [exp(T1 + I1) + exp(T2 + I2) + exp(T3 + I3)] => we can add a constant inside each exp(..) term, which 
+         // will be multiplication outside the exp(..), which means the numerator and denominator are multiplied by the same constant, which cancels 
+         // eachother out.  We can thus set exp(T2 + I2) to exp(0) and adjust the other terms
+         constexpr bool bZeroingResiduals = 0 <= k_iZeroResidual;
+         if(bZeroingResiduals) {
+            *(pResidualError - (static_cast<ptrdiff_t>(cVectorLength) - k_iZeroResidual)) = 0;
+         }
+      } while(pPredictorScoresEnd != pPredictorScores);
+   }
+};
+
+#ifndef EXPAND_BINARY_LOGITS
+template<>
+class ApplyModelUpdateTrainingZeroFeatures<2> final {
+public:
+
+   ApplyModelUpdateTrainingZeroFeatures() = delete; // this is a static class.  Do not construct
+
+   static void Func(
+      Booster * const pBooster,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples,
+      FloatEbmType * const aTempFloatVector
+   ) {
+      UNUSED(aTempFloatVector);
+      DataSetByFeatureGroup * const pTrainingSet = pBooster->GetTrainingSet();
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(iSampleFirst + cSamples <= pTrainingSet->GetCountSamples());
+
+      FloatStorageType * pResidualError = pTrainingSet->GetResidualPointer<FloatStorageType>() + iSampleFirst;
+      const StorageDataType * pTargetData = pTrainingSet->GetTargetDataPointer() + iSampleFirst;
+      FloatStorageType * pPredictorScores = pTrainingSet->GetPredictorScores<FloatStorageType>() + iSampleFirst;
+      const FloatStorageType * const pPredictorScoresEnd = pPredictorScores + cSamples;
+      const FloatEbmType smallChangeToPredictorScores = aModelFeatureGroupUpdateTensor[0];
+      do {
+         size_t targetData = static_cast<size_t>(*pTargetData);
+         ++pTargetData;
+         // this will apply a small fix to our existing TrainingPredictorScores, either positive or negative, whichever is needed
+         const FloatEbmType predictorScore = static_cast<FloatEbmType>(*pPredictorScores) + smallChangeToPredictorScores;
+         *pPredictorScores = static_cast<FloatStorageType>(predictorScore);
+         ++pPredictorScores;
+         const FloatEbmType residualError = EbmStatistics::ComputeResidualErrorBinaryClassification(predictorScore, targetData);
+         *pResidualError = static_cast<FloatStorageType>(residualError);
+         ++pResidualError;
+      } while(pPredictorScoresEnd != pPredictorScores);
+   }
+};
+#endif // EXPAND_BINARY_LOGITS
+
+template<>
+class ApplyModelUpdateTrainingZeroFeatures<k_regression> final {
+public:
+
+   ApplyModelUpdateTrainingZeroFeatures() = delete; // this is a static class.  Do not construct
+
+   static void Func(
+      Booster * const pBooster,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples,
+      FloatEbmType * const aTempFloatVector
+   ) {
+      UNUSED(aTempFloatVector);
+      DataSetByFeatureGroup * const pTrainingSet = pBooster->GetTrainingSet();
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(iSampleFirst + cSamples <= pTrainingSet->GetCountSamples());
+
+      FloatStorageType * pResidualError = pTrainingSet->GetResidualPointer<FloatStorageType>() + iSampleFirst;
+      const FloatStorageType * const pResidualErrorEnd = pResidualError + cSamples;
+      const FloatEbmType smallChangeToPrediction = aModelFeatureGroupUpdateTensor[0];
+      do {
+         // this will apply a small fix to our existing TrainingPredictorScores, either positive or negative, whichever is needed
+         const FloatEbmType residualError = 
+            EbmStatistics::ComputeResidualErrorRegression(static_cast<FloatEbmType>(*pResidualError) - smallChangeToPrediction);
+         *pResidualError = static_cast<FloatStorageType>(residualError);
+         ++pResidualError;
+      } while(pResidualErrorEnd != pResidualError);
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
+class ApplyModelUpdateTrainingZeroFeaturesTarget final {
+public:
+
+   ApplyModelUpdateTrainingZeroFeaturesTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      Booster * const pBooster,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples,
+      FloatEbmType * const aTempFloatVector
+   ) {
+      static_assert(IsClassification(compilerLearningTypeOrCountTargetClassesPossible), "compilerLearningTypeOrCountTargetClassesPossible needs to be a classification");
+      static_assert(compilerLearningTypeOrCountTargetClassesPossible <= k_cCompilerOptimizedTargetClassesMax, "We can't have this many items in a data pack.");
+
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
+      EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
+      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+
+      if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
+         ApplyModelUpdateTrainingZeroFeatures<compilerLearningTypeOrCountTargetClassesPossible>::Func(
+            pBooster,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples,
+            aTempFloatVector
+         );
+      } else {
+         ApplyModelUpdateTrainingZeroFeaturesTarget<
+            compilerLearningTypeOrCountTargetClassesPossible + 1
+         >::Func(
+            pBooster,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples,
+            aTempFloatVector
+         );
+      }
+   }
+};
+
+template<>
+class ApplyModelUpdateTrainingZeroFeaturesTarget<k_cCompilerOptimizedTargetClassesMax + 1> final {
+public:
+
+   ApplyModelUpdateTrainingZeroFeaturesTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      Booster * const pBooster,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples,
+      FloatEbmType * const aTempFloatVector
+   ) {
+      static_assert(IsClassification(k_cCompilerOptimizedTargetClassesMax), "k_cCompilerOptimizedTargetClassesMax needs to be a classification");
+
+      EBM_ASSERT(IsClassification(pBooster->GetRuntimeLearningTypeOrCountTargetClasses()));
+      EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pBooster->GetRuntimeLearningTypeOrCountTargetClasses());
+
+      ApplyModelUpdateTrainingZeroFeatures<k_dynamicClassification>::Func(
+         pBooster,
+         aModelFeatureGroupUpdateTensor,
+         iSampleFirst,
+         cSamples,
+         aTempFloatVector
+      );
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, size_t compilerCountItemsPerBitPackedDataUnit>
+class ApplyModelUpdateTrainingInternal final {
+public:
+
+   ApplyModelUpdateTrainingInternal() = delete; // this is a static class.  Do not construct
+
+   static void Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples,
+      FloatEbmType * const aTempFloatVector
+   ) {
+      static_assert(IsClassification(compilerLearningTypeOrCountTargetClasses), "must be classification");
+      static_assert(!IsBinaryClassification(compilerLearningTypeOrCountTargetClasses), "must be multiclass");
+
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
+      DataSetByFeatureGroup * const pTrainingSet = pBooster->GetTrainingSet();
+
+      FloatEbmType aLocalExpVector[
+         k_dynamicClassification == compilerLearningTypeOrCountTargetClasses ? 1 : GetVectorLength(compilerLearningTypeOrCountTargetClasses)
+      ];
+      FloatEbmType * const aExpVector = k_dynamicClassification == compilerLearningTypeOrCountTargetClasses ? aTempFloatVector : aLocalExpVector;
+
+      const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
+         compilerLearningTypeOrCountTargetClasses,
+         runtimeLearningTypeOrCountTargetClasses
+      );
+      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(iSampleFirst + cSamples <= pTrainingSet->GetCountSamples());
+      EBM_ASSERT(0 < pFeatureGroup->GetCountFeatures());
+
+      const size_t cItemsPerBitPackedDataUnit = GET_COUNT_ITEMS_PER_BIT_PACKED_DATA_UNIT(
+         compilerCountItemsPerBitPackedDataUnit,
+         pFeatureGroup->GetCountItemsPerBitPackedDataUnit()
+      );
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+      // chunks start on a bit packed data unit boundary
+      EBM_ASSERT(0 == iSampleFirst % cItemsPerBitPackedDataUnit);
+
+      FloatStorageType * pResidualError = pTrainingSet->GetResidualPointer<FloatStorageType>() + cVectorLength * iSampleFirst;
+      const StorageDataType * pInputData =
+         pTrainingSet->GetInputDataPointer(pFeatureGroup) + iSampleFirst / cItemsPerBitPackedDataUnit;
+      const StorageDataType * pTargetData = pTrainingSet->GetTargetDataPointer() + iSampleFirst;
+      FloatStorageType * pPredictorScores = pTrainingSet->GetPredictorScores<FloatStorageType>() + cVectorLength * iSampleFirst;
+
+      // this shouldn't overflow since we're accessing existing memory
+      const FloatStorageType * const pPredictorScoresTrueEnd = pPredictorScores + cSamples * cVectorLength;
+      const FloatStorageType * pPredictorScoresExit = pPredictorScoresTrueEnd;
+      const FloatStorageType * pPredictorScoresInnerEnd = pPredictorScoresTrueEnd;
+      if(cSamples <= cItemsPerBitPackedDataUnit) {
+         goto one_last_loop;
+      }
+      pPredictorScoresExit = pPredictorScoresTrueEnd - ((cSamples - 1) % cItemsPerBitPackedDataUnit + 1) * cVectorLength;
+      EBM_ASSERT(pPredictorScores < pPredictorScoresExit);
+      EBM_ASSERT(pPredictorScoresExit < pPredictorScoresTrueEnd);
+
+      do {
+         pPredictorScoresInnerEnd = pPredictorScores + cItemsPerBitPackedDataUnit * cVectorLength;
+         // jumping back into this loop and changing pPredictorScoresInnerEnd to a dynamic value that isn't compile time determinable causes this 
+         // function to NOT be optimized for templated cItemsPerBitPackedDataUnit, but that's ok since avoiding one unpredictable branch here is negligible
+      one_last_loop:;
+         // we store the already multiplied dimensional value in *pInputData
+         size_t iTensorBinCombined = static_cast<size_t>(*pInputData);
+         ++pInputData;
+         do {
+            size_t targetData = static_cast<size_t>(*pTargetData);
+            ++pTargetData;
+
+            const size_t iTensorBin = maskBits & iTensorBinCombined;
+            const FloatEbmType * pValues = &aModelFeatureGroupUpdateTensor[iTensorBin * cVectorLength];
+            FloatEbmType * pExpVector = aExpVector;
+            FloatEbmType sumExp = FloatEbmType { 0 };
+            size_t iVector = 0;
+            do {
+               const FloatEbmType smallChangeToPredictorScores = *pValues;
+               ++pValues;
+               // this will apply a small fix to our existing TrainingPredictorScores, either positive or negative, whichever is needed
+               const FloatEbmType predictorScore = static_cast<FloatEbmType>(*pPredictorScores) + smallChangeToPredictorScores;
+               *pPredictorScores = static_cast<FloatStorageType>(predictorScore);
+               ++pPredictorScores;
+               const FloatEbmType oneExp = ExpForResidualsMulticlass(predictorScore);
+               *pExpVector = oneExp;
+               ++pExpVector;
+               sumExp += oneExp;
+               ++iVector;
+            } while(iVector < cVectorLength);
+            pExpVector -= cVectorLength;
+            iVector = 0;
+            do {
+               const FloatEbmType residualError = EbmStatistics::ComputeResidualErrorMulticlass(
+                  sumExp,
+                  *pExpVector,
+                  targetData,
+                  iVector
+               );
+               ++pExpVector;
+               *pResidualError = static_cast<FloatStorageType>(residualError);
+               ++pResidualError;
+               ++iVector;
+            } while(iVector < cVectorLength);
+            // TODO: this works as a way to remove one parameter, but it obviously insn't as efficient as omitting the parameter
+            // 
+            // this works out in the math as making the first model vector parameter equal to zero, which in turn removes one degree of freedom
+            // from the model vector parameters.  Since the model vector weights need to be normalized to sum to a probabilty of 100%, we can set the 
+            // first one to the constant 1 (0 in log space) and force the other parameters to adjust to that scale which fixes them to a single valid 
+            // set of values insted of allowing them to be scaled.  
+            // Probability = exp(T1 + I1) / [exp(T1 + I1) + exp(T2 + I2) + exp(T3 + I3)] => we can add a constant inside each exp(..) term, which 
+            // will be multiplication outside the exp(..), which means the numerator and denominator are multiplied by the same constant, which 
+            // cancels eachother out.  We can thus set exp(T2 + I2) to exp(0) and adjust the other terms
+            constexpr bool bZeroingResiduals = 0 <= k_iZeroResidual;
+            if(bZeroingResiduals) {
+               *(pResidualError - (static_cast<ptrdiff_t>(cVectorLength) - k_iZeroResidual)) = 0;
+            }
+
+            iTensorBinCombined >>= cBitsPerItemMax;
+         } while(pPredictorScoresInnerEnd != pPredictorScores);
+      } while(pPredictorScoresExit != pPredictorScores);
+
+      // first time through?
+      if(pPredictorScoresTrueEnd != pPredictorScores) {
+         pPredictorScoresInnerEnd = pPredictorScoresTrueEnd;
+         pPredictorScoresExit = pPredictorScoresTrueEnd;
+         goto one_last_loop;
+      }
+   }
+};
+
+#ifndef EXPAND_BINARY_LOGITS
+template<size_t compilerCountItemsPerBitPackedDataUnit>
+class ApplyModelUpdateTrainingInternal<2, compilerCountItemsPerBitPackedDataUnit> final {
+public:
+
+   ApplyModelUpdateTrainingInternal() = delete; // this is a static class.  Do not construct
+
+   static void Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples,
+      FloatEbmType * const aTempFloatVector
+   ) {
+      UNUSED(aTempFloatVector);
+      const size_t runtimeCountItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+      DataSetByFeatureGroup * const pTrainingSet = pBooster->GetTrainingSet();
+
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(iSampleFirst + cSamples <= pTrainingSet->GetCountSamples());
+      EBM_ASSERT(0 < pFeatureGroup->GetCountFeatures());
+
+      const size_t cItemsPerBitPackedDataUnit = GET_COUNT_ITEMS_PER_BIT_PACKED_DATA_UNIT(
+         compilerCountItemsPerBitPackedDataUnit,
+         runtimeCountItemsPerBitPackedDataUnit
+      );
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+      // chunks start on a bit packed data unit boundary
+      EBM_ASSERT(0 == iSampleFirst % cItemsPerBitPackedDataUnit);
+
+      FloatStorageType * pResidualError = pTrainingSet->GetResidualPointer<FloatStorageType>() + iSampleFirst;
+      const StorageDataType * pInputData =
+         pTrainingSet->GetInputDataPointer(pFeatureGroup) + iSampleFirst / cItemsPerBitPackedDataUnit;
+      const StorageDataType * pTargetData = pTrainingSet->GetTargetDataPointer() + iSampleFirst;
+      FloatStorageType * pPredictorScores = pTrainingSet->GetPredictorScores<FloatStorageType>() + iSampleFirst;
+
+      // this shouldn't overflow since we're accessing existing memory
+      const FloatStorageType * const pPredictorScoresTrueEnd = pPredictorScores + cSamples;
+      const FloatStorageType * pPredictorScoresExit = pPredictorScoresTrueEnd;
+      const FloatStorageType * pPredictorScoresInnerEnd = pPredictorScoresTrueEnd;
+      if(cSamples <= cItemsPerBitPackedDataUnit) {
+         goto one_last_loop;
+      }
+      pPredictorScoresExit = pPredictorScoresTrueEnd - ((cSamples - 1) % cItemsPerBitPackedDataUnit + 1);
+      EBM_ASSERT(pPredictorScores < pPredictorScoresExit);
+      EBM_ASSERT(pPredictorScoresExit < pPredictorScoresTrueEnd);
+
+      do {
+         pPredictorScoresInnerEnd = pPredictorScores + cItemsPerBitPackedDataUnit;
+         // jumping back into this loop and changing pPredictorScoresInnerEnd to a dynamic value that isn't compile time determinable causes this 
+         // function to NOT be optimized for templated cItemsPerBitPackedDataUnit, but that's ok since avoiding one unpredictable branch here is negligible
+      one_last_loop:;
+         // we store the already multiplied dimensional value in *pInputData
+         size_t iTensorBinCombined = static_cast<size_t>(*pInputData);
+         ++pInputData;
+         do {
+            size_t targetData = static_cast<size_t>(*pTargetData);
+            ++pTargetData;
+
+            const size_t iTensorBin = maskBits & iTensorBinCombined;
+
+            const FloatEbmType smallChangeToPredictorScores = aModelFeatureGroupUpdateTensor[iTensorBin];
+            // this will apply a small fix to our existing TrainingPredictorScores, either positive or negative, whichever is needed
+            const FloatEbmType predictorScore = static_cast<FloatEbmType>(*pPredictorScores) + smallChangeToPredictorScores;
+            *pPredictorScores = static_cast<FloatStorageType>(predictorScore);
+            ++pPredictorScores;
+            const FloatEbmType residualError = EbmStatistics::ComputeResidualErrorBinaryClassification(predictorScore, targetData);
+
+            *pResidualError = static_cast<FloatStorageType>(residualError);
+            ++pResidualError;
+
+            iTensorBinCombined >>= cBitsPerItemMax;
+         } while(pPredictorScoresInnerEnd != pPredictorScores);
+      } while(pPredictorScoresExit != pPredictorScores);
+
+      // first time through?
+      if(pPredictorScoresTrueEnd != pPredictorScores) {
+         pPredictorScoresInnerEnd = pPredictorScoresTrueEnd;
+         pPredictorScoresExit = pPredictorScoresTrueEnd;
+         goto one_last_loop;
+      }
+   }
+};
+#endif // EXPAND_BINARY_LOGITS
+
+template<size_t compilerCountItemsPerBitPackedDataUnit>
+class ApplyModelUpdateTrainingInternal<k_regression, compilerCountItemsPerBitPackedDataUnit> final {
+public:
+
+   ApplyModelUpdateTrainingInternal() = delete; // this is a static class.  Do not construct
+
+   static void Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples,
+      FloatEbmType * const aTempFloatVector
+   ) {
+      UNUSED(aTempFloatVector);
+      const size_t runtimeCountItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+      DataSetByFeatureGroup * const pTrainingSet = pBooster->GetTrainingSet();
+
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(iSampleFirst + cSamples <= pTrainingSet->GetCountSamples());
+      EBM_ASSERT(0 < pFeatureGroup->GetCountFeatures());
+
+      const size_t cItemsPerBitPackedDataUnit = GET_COUNT_ITEMS_PER_BIT_PACKED_DATA_UNIT(
+         compilerCountItemsPerBitPackedDataUnit,
+         runtimeCountItemsPerBitPackedDataUnit
+      );
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+      // chunks start on a bit packed data unit boundary
+      EBM_ASSERT(0 == iSampleFirst % cItemsPerBitPackedDataUnit);
+
+
+      FloatStorageType * pResidualError = pTrainingSet->GetResidualPointer<FloatStorageType>() + iSampleFirst;
+      const StorageDataType * pInputData =
+         pTrainingSet->GetInputDataPointer(pFeatureGroup) + iSampleFirst / cItemsPerBitPackedDataUnit;
+
+      // this shouldn't overflow since we're accessing existing memory
+      const FloatStorageType * const pResidualErrorTrueEnd = pResidualError + cSamples;
+      const FloatStorageType * pResidualErrorExit = pResidualErrorTrueEnd;
+      const FloatStorageType * pResidualErrorInnerEnd = pResidualErrorTrueEnd;
+      if(cSamples <= cItemsPerBitPackedDataUnit) {
+         goto one_last_loop;
+      }
+      pResidualErrorExit = pResidualErrorTrueEnd - ((cSamples - 1) % cItemsPerBitPackedDataUnit + 1);
+      EBM_ASSERT(pResidualError < pResidualErrorExit);
+      EBM_ASSERT(pResidualErrorExit < pResidualErrorTrueEnd);
+
+      do {
+         pResidualErrorInnerEnd = pResidualError + cItemsPerBitPackedDataUnit;
+         // jumping back into this loop and changing pPredictorScoresInnerEnd to a dynamic value that isn't compile time determinable causes this 
+         // function to NOT be optimized for templated cItemsPerBitPackedDataUnit, but that's ok since avoiding one unpredictable branch here is negligible
+      one_last_loop:;
+         // we store the already multiplied dimensional value in *pInputData
+         size_t iTensorBinCombined = static_cast<size_t>(*pInputData);
+         ++pInputData;
+         do {
+            const size_t iTensorBin = maskBits & iTensorBinCombined;
+
+            const FloatEbmType smallChangeToPrediction = aModelFeatureGroupUpdateTensor[iTensorBin];
+            // this will apply a small fix to our existing TrainingPredictorScores, either positive or negative, whichever is needed
+            const FloatEbmType residualError = 
+               EbmStatistics::ComputeResidualErrorRegression(static_cast<FloatEbmType>(*pResidualError) - smallChangeToPrediction);
+
+            *pResidualError = static_cast<FloatStorageType>(residualError);
+            ++pResidualError;
+
+            iTensorBinCombined >>= cBitsPerItemMax;
+         } while(pResidualErrorInnerEnd != pResidualError);
+      } while(pResidualErrorExit != pResidualError);
+
+      // first time through?
+      if(pResidualErrorTrueEnd != pResidualError) {
+         pResidualErrorInnerEnd = pResidualErrorTrueEnd;
+         pResidualErrorExit = pResidualErrorTrueEnd;
+         goto one_last_loop;
+      }
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
+class ApplyModelUpdateTrainingNormalTarget final {
+public:
+
+   ApplyModelUpdateTrainingNormalTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples,
+      FloatEbmType * const aTempFloatVector
+   ) {
+      static_assert(IsClassification(compilerLearningTypeOrCountTargetClassesPossible), "compilerLearningTypeOrCountTargetClassesPossible needs to be a classification");
+      static_assert(compilerLearningTypeOrCountTargetClassesPossible <= k_cCompilerOptimizedTargetClassesMax, "We can't have this many items in a data pack.");
+
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
+      EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
+      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+
+      if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
+         ApplyModelUpdateTrainingInternal<compilerLearningTypeOrCountTargetClassesPossible, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+            pBooster,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples,
+            aTempFloatVector
+         );
+      } else {
+         ApplyModelUpdateTrainingNormalTarget<
+            compilerLearningTypeOrCountTargetClassesPossible + 1
+         >::Func(
+            pBooster,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples,
+            aTempFloatVector
+         );
+      }
+   }
+};
+
+template<>
+class ApplyModelUpdateTrainingNormalTarget<k_cCompilerOptimizedTargetClassesMax + 1> final {
+public:
+
+   ApplyModelUpdateTrainingNormalTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples,
+      FloatEbmType * const aTempFloatVector
+   ) {
+      static_assert(IsClassification(k_cCompilerOptimizedTargetClassesMax), "k_cCompilerOptimizedTargetClassesMax needs to be a classification");
+
+      EBM_ASSERT(IsClassification(pBooster->GetRuntimeLearningTypeOrCountTargetClasses()));
+      EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pBooster->GetRuntimeLearningTypeOrCountTargetClasses());
+
+      ApplyModelUpdateTrainingInternal<k_dynamicClassification, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+         pBooster,
+         pFeatureGroup,
+         aModelFeatureGroupUpdateTensor,
+         iSampleFirst,
+         cSamples,
+         aTempFloatVector
+      );
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, size_t compilerCountItemsPerBitPackedDataUnit>
+class ApplyModelUpdateTrainingSIMD final {
+public:
+
+   ApplyModelUpdateTrainingSIMD() = delete; // this is a static class.  Do not construct
+
+   static void Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples
+   ) {
+      static_assert(IsRegression(compilerLearningTypeOrCountTargetClasses) || 
+         IsBinaryClassification(compilerLearningTypeOrCountTargetClasses), "multiclass uses ApplyModelUpdateTrainingInternal");
+      constexpr bool bRegression = IsRegression(compilerLearningTypeOrCountTargetClasses);
+      constexpr size_t cLanes = SimdVector::k_cLanes;
+
+      const size_t runtimeCountItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+      DataSetByFeatureGroup * const pTrainingSet = pBooster->GetTrainingSet();
+
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(iSampleFirst + cSamples <= pTrainingSet->GetCountSamples());
+      EBM_ASSERT(0 < pFeatureGroup->GetCountFeatures());
+
+      const size_t cItemsPerBitPackedDataUnit = GET_COUNT_ITEMS_PER_BIT_PACKED_DATA_UNIT(
+         compilerCountItemsPerBitPackedDataUnit,
+         runtimeCountItemsPerBitPackedDataUnit
+      );
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+      // we only shift between items, so a full width item never gets shifted.  The modulo keeps the compiler from
+      // warning about a 64 bit shift in the code that it can't see is never reached
+      const size_t cBitsShift = cBitsPerItemMax % k_cBitsForStorageType;
+      // chunks start on a bit packed data unit boundary
+      EBM_ASSERT(0 == iSampleFirst % cItemsPerBitPackedDataUnit);
+
+      FloatStorageType * pResidualError = pTrainingSet->GetResidualPointer<FloatStorageType>() + iSampleFirst;
+      const StorageDataType * pInputData =
+         pTrainingSet->GetInputDataPointer(pFeatureGroup) + iSampleFirst / cItemsPerBitPackedDataUnit;
+      // regression keeps no targets or predictor scores in the training set
+      const StorageDataType * pTargetData = nullptr;
+      FloatStorageType * pPredictorScores = nullptr;
+      if(!bRegression) {
+         pTargetData = pTrainingSet->GetTargetDataPointer() + iSampleFirst;
+         pPredictorScores = pTrainingSet->GetPredictorScores<FloatStorageType>() + iSampleFirst;
+      }
+
+      // We unpack cLanes data units into aiTensorBins at a time, which is always a whole number of vectors, and then
+      // gather the updates for those bins one vector at a time.  Only the last block of the chunk can have samples
+      // left over that don't fill a vector, and those get the scalar code.  With a compile time 
+      // cItemsPerBitPackedDataUnit the compiler unrolls the unpacking completely
+      size_t aiTensorBins[k_cBitsForStorageType * cLanes];
+      size_t cSamplesRemaining = cSamples;
+      do {
+         const size_t cDataUnits = EbmMin(cLanes, (cSamplesRemaining - 1) / cItemsPerBitPackedDataUnit + 1);
+         const StorageDataType * const pInputDataEnd = pInputData + cDataUnits;
+         size_t * piTensorBin = aiTensorBins;
+         do {
+            // we store the already multiplied dimensional value in *pInputData
+            size_t iTensorBinCombined = static_cast<size_t>(*pInputData);
+            ++pInputData;
+            *piTensorBin = maskBits & iTensorBinCombined;
+            ++piTensorBin;
+            for(size_t iItem = 1; iItem < cItemsPerBitPackedDataUnit; ++iItem) {
+               iTensorBinCombined >>= cBitsShift;
+               *piTensorBin = maskBits & iTensorBinCombined;
+               ++piTensorBin;
+            }
+         } while(pInputDataEnd != pInputData);
+
+         const size_t cSamplesBlock = EbmMin(cSamplesRemaining, cDataUnits * cItemsPerBitPackedDataUnit);
+         cSamplesRemaining -= cSamplesBlock;
+
+         const size_t * piTensorBinCur = aiTensorBins;
+         const size_t * const piTensorBinVectorsEnd = aiTensorBins + (cSamplesBlock - cSamplesBlock % cLanes);
+         while(piTensorBinVectorsEnd != piTensorBinCur) {
+            const SimdVector smallChange = SimdVector::Gather(aModelFeatureGroupUpdateTensor, piTensorBinCur);
+            piTensorBinCur += cLanes;
+            if(bRegression) {
+               // ComputeResidualErrorRegression is the identity, so we leave it out like we do for the predictor scores
+               const SimdVector residualError = SimdVector::Load(pResidualError) - smallChange;
+               residualError.Store(pResidualError);
+            } else {
+               const SimdVector predictorScore = SimdVector::Load(pPredictorScores) + smallChange;
+               predictorScore.Store(pPredictorScores);
+               pPredictorScores += cLanes;
+               const SimdVector signs = SimdVector::LoadSignsFromBinaryTargets(pTargetData);
+               pTargetData += cLanes;
+               const SimdVector residualError = ComputeResidualErrorBinaryClassification(predictorScore, signs);
+               residualError.Store(pResidualError);
+            }
+            pResidualError += cLanes;
+         }
+
+         const size_t * const piTensorBinEnd = aiTensorBins + cSamplesBlock;
+         while(piTensorBinEnd != piTensorBinCur) {
+            const FloatEbmType smallChange = aModelFeatureGroupUpdateTensor[*piTensorBinCur];
+            ++piTensorBinCur;
+            if(bRegression) {
+               *pResidualError = static_cast<FloatStorageType>(
+                  EbmStatistics::ComputeResidualErrorRegression(static_cast<FloatEbmType>(*pResidualError) - smallChange));
+            } else {
+               size_t targetData = static_cast<size_t>(*pTargetData);
+               ++pTargetData;
+               const FloatEbmType predictorScore = static_cast<FloatEbmType>(*pPredictorScores) + smallChange;
+               *pPredictorScores = static_cast<FloatStorageType>(predictorScore);
+               ++pPredictorScores;
+               *pResidualError = static_cast<FloatStorageType>(
+                  EbmStatistics::ComputeResidualErrorBinaryClassification(predictorScore, targetData));
+            }
+            ++pResidualError;
+         }
+      } while(0 != cSamplesRemaining);
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, size_t compilerCountItemsPerBitPackedDataUnitPossible>
+class ApplyModelUpdateTrainingSIMDPacking final {
+public:
+
+   ApplyModelUpdateTrainingSIMDPacking() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples
+   ) {
+      const size_t runtimeCountItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+
+      EBM_ASSERT(1 <= runtimeCountItemsPerBitPackedDataUnit);
+      EBM_ASSERT(runtimeCountItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      static_assert(compilerCountItemsPerBitPackedDataUnitPossible <= k_cBitsForStorageType, "We can't have this many items in a data pack.");
+      if(compilerCountItemsPerBitPackedDataUnitPossible == runtimeCountItemsPerBitPackedDataUnit) {
+         ApplyModelUpdateTrainingSIMD<compilerLearningTypeOrCountTargetClasses, compilerCountItemsPerBitPackedDataUnitPossible>::Func(
+            pBooster,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples
+         );
+      } else {
+         ApplyModelUpdateTrainingSIMDPacking<
+            compilerLearningTypeOrCountTargetClasses,
+            GetNextCountItemsBitPacked(compilerCountItemsPerBitPackedDataUnitPossible)
+         >::Func(
+            pBooster,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples
+         );
+      }
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+class ApplyModelUpdateTrainingSIMDPacking<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitDynamic> final {
+public:
+
+   ApplyModelUpdateTrainingSIMDPacking() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples
+   ) {
+      EBM_ASSERT(1 <= pFeatureGroup->GetCountItemsPerBitPackedDataUnit());
+      EBM_ASSERT(pFeatureGroup->GetCountItemsPerBitPackedDataUnit() <= k_cBitsForStorageType);
+      ApplyModelUpdateTrainingSIMD<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+         pBooster,
+         pFeatureGroup,
+         aModelFeatureGroupUpdateTensor,
+         iSampleFirst,
+         cSamples
+      );
+   }
+};
+
+static void ApplyModelUpdateTrainingChunk(
+   Booster * const pBooster,
+   const FeatureGroup * const pFeatureGroup,
+   const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+   const size_t iSampleFirst,
+   const size_t cSamples,
+   FloatEbmType * const aTempFloatVector
+) {
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
+
+   if(0 == pFeatureGroup->GetCountFeatures()) {
+      if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
+         ApplyModelUpdateTrainingZeroFeaturesTarget<2>::Func(
+            pBooster,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples,
+            aTempFloatVector
+         );
+      } else {
+         EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
+         ApplyModelUpdateTrainingZeroFeatures<k_regression>::Func(
+            pBooster,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples,
+            aTempFloatVector
+         );
+      }
+   } else {
+      // k_bUseSIMD is false if we have no SIMD instructions for this variant and build, and then everything goes 
+      // through the normal path.  Multiclass always does, since its exp and softmax loops run across the classes
+      constexpr bool bSIMD = k_bUseSIMD;
+#ifdef EXPAND_BINARY_LOGITS
+      // binary classification has 2 logits per sample then, so it's multiclass as far as our SIMD path is concerned
+      constexpr bool bSIMDBinary = false;
+#else // EXPAND_BINARY_LOGITS
+      constexpr bool bSIMDBinary = bSIMD;
+#endif // EXPAND_BINARY_LOGITS
+
+      if(bSIMD && IsRegression(runtimeLearningTypeOrCountTargetClasses)) {
+         // we start at the maximum number of items per data unit so that every packing width that 
+         // GetNextCountItemsBitPacked produces gets its own compile time specialization
+         ApplyModelUpdateTrainingSIMDPacking<
+            k_regression,
+            k_cBitsForStorageType
+         >::Func(
+            pBooster,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples
+         );
+      } else if(bSIMDBinary && IsBinaryClassification(runtimeLearningTypeOrCountTargetClasses)) {
+         ApplyModelUpdateTrainingSIMDPacking<
+            2,
+            k_cBitsForStorageType
+         >::Func(
+            pBooster,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples
+         );
+      } else {
+         // there isn't much benefit in eliminating the loop that unpacks a data unit unless we're also unpacking that to SIMD code
+         // Our default packing structure is to bin continuous values to 256 values, and we have 64 bit packing structures, so we usually
+         // have more than 8 values per memory fetch.  Eliminating the inner loop for multiclass is valuable since we can have low numbers like 3 class,
+         // 4 class, etc, but by the time we get to 8 loops with exp inside and a lot of other instructures we should worry that our code expansion
+         // will exceed the L1 instruction cache size.  With SIMD we do 8 times the work in the same number of instructions so these are lesser issues
+
+         if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
+            ApplyModelUpdateTrainingNormalTarget<2>::Func(
+               pBooster,
+               pFeatureGroup,
+               aModelFeatureGroupUpdateTensor,
+               iSampleFirst,
+               cSamples,
+               aTempFloatVector
+            );
+         } else {
+            EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
+            ApplyModelUpdateTrainingInternal<k_regression, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+               pBooster,
+               pFeatureGroup,
+               aModelFeatureGroupUpdateTensor,
+               iSampleFirst,
+               cSamples,
+               aTempFloatVector
+            );
+         }
+      }
+   }
+}
@@ -0,0 +1,813 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <ebm@koch.ninja>
+
+// ApplyModelUpdateValidation.cpp only includes this through CpuVariantKernels.h, once for each CPU variant, so there is no include 
+// guard and nothing gets included here
+
+// C++ does not allow partial function specialization, so we need to use these cumbersome static class functions to do partial function specialization
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+class ApplyModelUpdateValidationZeroFeatures final {
+public:
+
+   ApplyModelUpdateValidationZeroFeatures() = delete; // this is a static class.  Do not construct
+
+   static FloatEbmType Func(
+      Booster * const pBooster,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples
+   ) {
+      static_assert(IsClassification(compilerLearningTypeOrCountTargetClasses), "must be classification");
+      static_assert(!IsBinaryClassification(compilerLearningTypeOrCountTargetClasses), "must be multiclass");
+
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
+      DataSetByFeatureGroup * const pValidationSet = pBooster->GetValidationSet();
+
+      const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
+         compilerLearningTypeOrCountTargetClasses,
+         runtimeLearningTypeOrCountTargetClasses
+      );
+      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(iSampleFirst + cSamples <= pValidationSet->GetCountSamples());
+
+      FloatEbmType sumLogLoss = FloatEbmType { 0 };
+      const StorageDataType * pTargetData = pValidationSet->GetTargetDataPointer() + iSampleFirst;
+      FloatStorageType * pPredictorScores = pValidationSet->GetPredictorScores<FloatStorageType>() + cVectorLength * iSampleFirst;
+      const FloatStorageType * const pPredictorScoresEnd = pPredictorScores + cSamples * cVectorLength;
+      do {
+         size_t targetData = static_cast<size_t>(*pTargetData);
+         ++pTargetData;
+
+         const FloatEbmType * pValues = aModelFeatureGroupUpdateTensor;
+         FloatEbmType itemExp = FloatEbmType { 0 };
+         FloatEbmType sumExp = FloatEbmType { 0 };
+         size_t iVector = 0;
+         do {
+            // TODO : because there is only one bin for a zero feature feature group, we could move these values to the stack where the
+            // compiler could reason about their visibility and optimize small arrays into registers
+            const FloatEbmType smallChangeToPredictorScores = *pValues;
+            ++pValues;
+            // this will apply a small fix to our existing ValidationPredictorScores, either positive or negative, whichever is needed
+            const FloatEbmType predictorScore = static_cast<FloatEbmType>(*pPredictorScores) + smallChangeToPredictorScores;
+            *pPredictorScores = static_cast<FloatStorageType>(predictorScore);
+            ++pPredictorScores;
+            const FloatEbmType oneExp = ExpForLogLossMulticlass(predictorScore);
+            itemExp = iVector == targetData ? oneExp : itemExp;
+            sumExp += oneExp;
+            ++iVector;
+         } while(iVector < cVectorLength);
+         const FloatEbmType sampleLogLoss = EbmStatistics::ComputeSingleSampleLogLossMulticlass(
+            sumExp,
+            itemExp
+         );
+
+         EBM_ASSERT(std::isnan(sampleLogLoss) || -k_epsilonLogLoss <= sampleLogLoss);
+         sumLogLoss += sampleLogLoss;
+
+      } while(pPredictorScoresEnd != pPredictorScores);
+      return sumLogLoss;
+   }
+};
+
+#ifndef EXPAND_BINARY_LOGITS
+template<>
+class ApplyModelUpdateValidationZeroFeatures<2> final {
+public:
+
+   ApplyModelUpdateValidationZeroFeatures() = delete; // this is a static class.  Do not construct
+
+   static FloatEbmType Func(
+      Booster * const pBooster,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples
+   ) {
+      DataSetByFeatureGroup * const pValidationSet = pBooster->GetValidationSet();
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(iSampleFirst + cSamples <= pValidationSet->GetCountSamples());
+
+      FloatEbmType sumLogLoss = 0;
+      const StorageDataType * pTargetData = pValidationSet->GetTargetDataPointer() + iSampleFirst;
+      FloatStorageType * pPredictorScores = pValidationSet->GetPredictorScores<FloatStorageType>() + iSampleFirst;
+      const FloatStorageType * const pPredictorScoresEnd = pPredictorScores + cSamples;
+      const FloatEbmType smallChangeToPredictorScores = aModelFeatureGroupUpdateTensor[0];
+      do {
+         size_t targetData = static_cast<size_t>(*pTargetData);
+         ++pTargetData;
+         // this will apply a small fix to our existing ValidationPredictorScores, either positive or negative, whichever is needed
+         const FloatEbmType predictorScore = static_cast<FloatEbmType>(*pPredictorScores) + smallChangeToPredictorScores;
+         *pPredictorScores = static_cast<FloatStorageType>(predictorScore);
+         ++pPredictorScores;
+         const FloatEbmType sampleLogLoss = EbmStatistics::ComputeSingleSampleLogLossBinaryClassification(predictorScore, targetData);
+         EBM_ASSERT(std::isnan(sampleLogLoss) || FloatEbmType { 0 } <= sampleLogLoss);
+         sumLogLoss += sampleLogLoss;
+      } while(pPredictorScoresEnd != pPredictorScores);
+      return sumLogLoss;
+   }
+};
+#endif // EXPAND_BINARY_LOGITS
+
+template<>
+class ApplyModelUpdateValidationZeroFeatures<k_regression> final {
+public:
+
+   ApplyModelUpdateValidationZeroFeatures() = delete; // this is a static class.  Do not construct
+
+   static FloatEbmType Func(
+      Booster * const pBooster,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples
+   ) {
+      DataSetByFeatureGroup * const pValidationSet = pBooster->GetValidationSet();
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(iSampleFirst + cSamples <= pValidationSet->GetCountSamples());
+
+      FloatEbmType sumSquareError = FloatEbmType { 0 };
+      FloatStorageType * pResidualError = pValidationSet->GetResidualPointer<FloatStorageType>() + iSampleFirst;
+      const FloatStorageType * const pResidualErrorEnd = pResidualError + cSamples;
+      const FloatEbmType smallChangeToPrediction = aModelFeatureGroupUpdateTensor[0];
+      do {
+         // this will apply a small fix to our existing ValidationPredictorScores, either positive or negative, whichever is needed
+         const FloatEbmType residualError = 
+            EbmStatistics::ComputeResidualErrorRegression(static_cast<FloatEbmType>(*pResidualError) - smallChangeToPrediction);
+         const FloatEbmType sampleSquaredError = EbmStatistics::ComputeSingleSampleSquaredErrorRegression(residualError);
+         EBM_ASSERT(std::isnan(sampleSquaredError) || FloatEbmType { 0 } <= sampleSquaredError);
+         sumSquareError += sampleSquaredError;
+         *pResidualError = static_cast<FloatStorageType>(residualError);
+         ++pResidualError;
+      } while(pResidualErrorEnd != pResidualError);
+      return sumSquareError;
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
+class ApplyModelUpdateValidationZeroFeaturesTarget final {
+public:
+
+   ApplyModelUpdateValidationZeroFeaturesTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static FloatEbmType Func(
+      Booster * const pBooster,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples
+   ) {
+      static_assert(IsClassification(compilerLearningTypeOrCountTargetClassesPossible), "compilerLearningTypeOrCountTargetClassesPossible needs to be a classification");
+      static_assert(compilerLearningTypeOrCountTargetClassesPossible <= k_cCompilerOptimizedTargetClassesMax, "We can't have this many items in a data pack.");
+
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
+      EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
+      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+
+      if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
+         return ApplyModelUpdateValidationZeroFeatures<compilerLearningTypeOrCountTargetClassesPossible>::Func(
+            pBooster,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples
+         );
+      } else {
+         return ApplyModelUpdateValidationZeroFeaturesTarget<
+            compilerLearningTypeOrCountTargetClassesPossible + 1
+         >::Func(
+            pBooster,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples
+         );
+      }
+   }
+};
+
+template<>
+class ApplyModelUpdateValidationZeroFeaturesTarget<k_cCompilerOptimizedTargetClassesMax + 1> final {
+public:
+
+   ApplyModelUpdateValidationZeroFeaturesTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static FloatEbmType Func(
+      Booster * const pBooster,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples
+   ) {
+      static_assert(IsClassification(k_cCompilerOptimizedTargetClassesMax), "k_cCompilerOptimizedTargetClassesMax needs to be a classification");
+
+      EBM_ASSERT(IsClassification(pBooster->GetRuntimeLearningTypeOrCountTargetClasses()));
+      EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pBooster->GetRuntimeLearningTypeOrCountTargetClasses());
+
+      return ApplyModelUpdateValidationZeroFeatures<k_dynamicClassification>::Func(
+         pBooster,
+         aModelFeatureGroupUpdateTensor,
+         iSampleFirst,
+         cSamples
+      );
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, size_t compilerCountItemsPerBitPackedDataUnit>
+class ApplyModelUpdateValidationInternal final {
+public:
+
+   ApplyModelUpdateValidationInternal() = delete; // this is a static class.  Do not construct
+
+   static FloatEbmType Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples
+   ) {
+      static_assert(IsClassification(compilerLearningTypeOrCountTargetClasses), "must be classification");
+      static_assert(!IsBinaryClassification(compilerLearningTypeOrCountTargetClasses), "must be multiclass");
+
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
+      const size_t runtimeCountItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+      DataSetByFeatureGroup * const pValidationSet = pBooster->GetValidationSet();
+
+      const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
+         compilerLearningTypeOrCountTargetClasses,
+         runtimeLearningTypeOrCountTargetClasses
+      );
+      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(iSampleFirst + cSamples <= pValidationSet->GetCountSamples());
+      EBM_ASSERT(0 < pFeatureGroup->GetCountFeatures());
+
+      const size_t cItemsPerBitPackedDataUnit = GET_COUNT_ITEMS_PER_BIT_PACKED_DATA_UNIT(
+         compilerCountItemsPerBitPackedDataUnit,
+         runtimeCountItemsPerBitPackedDataUnit
+      );
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+      // chunks start on a bit packed data unit boundary
+      EBM_ASSERT(0 == iSampleFirst % cItemsPerBitPackedDataUnit);
+
+      FloatEbmType sumLogLoss = FloatEbmType { 0 };
+      const StorageDataType * pInputData =
+         pValidationSet->GetInputDataPointer(pFeatureGroup) + iSampleFirst / cItemsPerBitPackedDataUnit;
+      const StorageDataType * pTargetData = pValidationSet->GetTargetDataPointer() + iSampleFirst;
+      FloatStorageType * pPredictorScores = pValidationSet->GetPredictorScores<FloatStorageType>() + cVectorLength * iSampleFirst;
+
+      // this shouldn't overflow since we're accessing existing memory
+      const FloatStorageType * const pPredictorScoresTrueEnd = pPredictorScores + cSamples * cVectorLength;
+      const FloatStorageType * pPredictorScoresExit = pPredictorScoresTrueEnd;
+      const FloatStorageType * pPredictorScoresInnerEnd = pPredictorScoresTrueEnd;
+      if(cSamples <= cItemsPerBitPackedDataUnit) {
+         goto one_last_loop;
+      }
+      pPredictorScoresExit = pPredictorScoresTrueEnd - ((cSamples - 1) % cItemsPerBitPackedDataUnit + 1) * cVectorLength;
+      EBM_ASSERT(pPredictorScores < pPredictorScoresExit);
+      EBM_ASSERT(pPredictorScoresExit < pPredictorScoresTrueEnd);
+
+      do {
+         pPredictorScoresInnerEnd = pPredictorScores + cItemsPerBitPackedDataUnit * cVectorLength;
+         // jumping back into this loop and changing pPredictorScoresInnerEnd to a dynamic value that isn't compile time determinable causes this 
+         // function to NOT be optimized for templated cItemsPerBitPackedDataUnit, but that's ok since avoiding one unpredictable branch here is negligible
+      one_last_loop:;
+         // we store the already multiplied dimensional value in *pInputData
+         size_t iTensorBinCombined = static_cast<size_t>(*pInputData);
+         ++pInputData;
+         do {
+            size_t targetData = static_cast<size_t>(*pTargetData);
+            ++pTargetData;
+
+            const size_t iTensorBin = maskBits & iTensorBinCombined;
+            const FloatEbmType * pValues = &aModelFeatureGroupUpdateTensor[iTensorBin * cVectorLength];
+            FloatEbmType itemExp = FloatEbmType { 0 };
+            FloatEbmType sumExp = FloatEbmType { 0 };
+            size_t iVector = 0;
+            do {
+               const FloatEbmType smallChangeToPredictorScores = *pValues;
+               ++pValues;
+               // this will apply a small fix to our existing ValidationPredictorScores, either positive or negative, whichever is needed
+               const FloatEbmType predictorScore = static_cast<FloatEbmType>(*pPredictorScores) + smallChangeToPredictorScores;
+               *pPredictorScores = static_cast<FloatStorageType>(predictorScore);
+               ++pPredictorScores;
+               const FloatEbmType oneExp = ExpForLogLossMulticlass(predictorScore);
+               itemExp = iVector == targetData ? oneExp : itemExp;
+               sumExp += oneExp;
+               ++iVector;
+            } while(iVector < cVectorLength);
+            const FloatEbmType sampleLogLoss = EbmStatistics::ComputeSingleSampleLogLossMulticlass(
+               sumExp,
+               itemExp
+            );
+
+            EBM_ASSERT(std::isnan(sampleLogLoss) || -k_epsilonLogLoss <= sampleLogLoss);
+            sumLogLoss += sampleLogLoss;
+            iTensorBinCombined >>= cBitsPerItemMax;
+         } while(pPredictorScoresInnerEnd != pPredictorScores);
+      } while(pPredictorScoresExit != pPredictorScores);
+
+      // first time through?
+      if(pPredictorScoresTrueEnd != pPredictorScores) {
+         pPredictorScoresInnerEnd = pPredictorScoresTrueEnd;
+         pPredictorScoresExit = pPredictorScoresTrueEnd;
+         goto one_last_loop;
+      }
+      return sumLogLoss;
+   }
+};
+
+#ifndef EXPAND_BINARY_LOGITS
+template<size_t compilerCountItemsPerBitPackedDataUnit>
+class ApplyModelUpdateValidationInternal<2, compilerCountItemsPerBitPackedDataUnit> final {
+public:
+
+   ApplyModelUpdateValidationInternal() = delete; // this is a static class.  Do not construct
+
+   static FloatEbmType Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples
+   ) {
+      const size_t runtimeCountItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+      DataSetByFeatureGroup * const pValidationSet = pBooster->GetValidationSet();
+
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(iSampleFirst + cSamples <= pValidationSet->GetCountSamples());
+      EBM_ASSERT(0 < pFeatureGroup->GetCountFeatures());
+
+      const size_t cItemsPerBitPackedDataUnit = GET_COUNT_ITEMS_PER_BIT_PACKED_DATA_UNIT(
+         compilerCountItemsPerBitPackedDataUnit,
+         runtimeCountItemsPerBitPackedDataUnit
+      );
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+      // chunks start on a bit packed data unit boundary
+      EBM_ASSERT(0 == iSampleFirst % cItemsPerBitPackedDataUnit);
+
+      FloatEbmType sumLogLoss = FloatEbmType { 0 };
+      const StorageDataType * pInputData =
+         pValidationSet->GetInputDataPointer(pFeatureGroup) + iSampleFirst / cItemsPerBitPackedDataUnit;
+      const StorageDataType * pTargetData = pValidationSet->GetTargetDataPointer() + iSampleFirst;
+      FloatStorageType * pPredictorScores = pValidationSet->GetPredictorScores<FloatStorageType>() + iSampleFirst;
+
+      // this shouldn't overflow since we're accessing existing memory
+      const FloatStorageType * const pPredictorScoresTrueEnd = pPredictorScores + cSamples;
+      const FloatStorageType * pPredictorScoresExit = pPredictorScoresTrueEnd;
+      const FloatStorageType * pPredictorScoresInnerEnd = pPredictorScoresTrueEnd;
+      if(cSamples <= cItemsPerBitPackedDataUnit) {
+         goto one_last_loop;
+      }
+      pPredictorScoresExit = pPredictorScoresTrueEnd - ((cSamples - 1) % cItemsPerBitPackedDataUnit + 1);
+      EBM_ASSERT(pPredictorScores < pPredictorScoresExit);
+      EBM_ASSERT(pPredictorScoresExit < pPredictorScoresTrueEnd);
+
+      do {
+         pPredictorScoresInnerEnd = pPredictorScores + cItemsPerBitPackedDataUnit;
+         // jumping back into this loop and changing pPredictorScoresInnerEnd to a dynamic value that isn't compile time determinable causes this 
+         // function to NOT be optimized for templated cItemsPerBitPackedDataUnit, but that's ok since avoiding one unpredictable branch here is negligible
+      one_last_loop:;
+         // we store the already multiplied dimensional value in *pInputData
+         size_t iTensorBinCombined = static_cast<size_t>(*pInputData);
+         ++pInputData;
+         do {
+            size_t targetData = static_cast<size_t>(*pTargetData);
+            ++pTargetData;
+
+            const size_t iTensorBin = maskBits & iTensorBinCombined;
+
+            const FloatEbmType smallChangeToPredictorScores = aModelFeatureGroupUpdateTensor[iTensorBin];
+            // this will apply a small fix to our existing ValidationPredictorScores, either positive or negative, whichever is needed
+            const FloatEbmType predictorScore = static_cast<FloatEbmType>(*pPredictorScores) + smallChangeToPredictorScores;
+            *pPredictorScores = static_cast<FloatStorageType>(predictorScore);
+            ++pPredictorScores;
+            const FloatEbmType sampleLogLoss = EbmStatistics::ComputeSingleSampleLogLossBinaryClassification(predictorScore, targetData);
+
+            EBM_ASSERT(std::isnan(sampleLogLoss) || FloatEbmType { 0 } <= sampleLogLoss);
+            sumLogLoss += sampleLogLoss;
+
+            iTensorBinCombined >>= cBitsPerItemMax;
+         } while(pPredictorScoresInnerEnd != pPredictorScores);
+      } while(pPredictorScoresExit != pPredictorScores);
+
+      // first time through?
+      if(pPredictorScoresTrueEnd != pPredictorScores) {
+         pPredictorScoresInnerEnd = pPredictorScoresTrueEnd;
+         pPredictorScoresExit = pPredictorScoresTrueEnd;
+         goto one_last_loop;
+      }
+      return sumLogLoss;
+   }
+};
+#endif // EXPAND_BINARY_LOGITS
+
+template<size_t compilerCountItemsPerBitPackedDataUnit>
+class ApplyModelUpdateValidationInternal<k_regression, compilerCountItemsPerBitPackedDataUnit> final {
+public:
+
+   ApplyModelUpdateValidationInternal() = delete; // this is a static class.  Do not construct
+
+   static FloatEbmType Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples
+   ) {
+      const size_t runtimeCountItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+      DataSetByFeatureGroup * const pValidationSet = pBooster->GetValidationSet();
+
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(iSampleFirst + cSamples <= pValidationSet->GetCountSamples());
+      EBM_ASSERT(0 < pFeatureGroup->GetCountFeatures());
+
+      const size_t cItemsPerBitPackedDataUnit = GET_COUNT_ITEMS_PER_BIT_PACKED_DATA_UNIT(
+         compilerCountItemsPerBitPackedDataUnit,
+         runtimeCountItemsPerBitPackedDataUnit
+      );
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+      // chunks start on a bit packed data unit boundary
+      EBM_ASSERT(0 == iSampleFirst % cItemsPerBitPackedDataUnit);
+
+      FloatEbmType sumSquareError = FloatEbmType { 0 };
+      FloatStorageType * pResidualError = pValidationSet->GetResidualPointer<FloatStorageType>() + iSampleFirst;
+      const StorageDataType * pInputData =
+         pValidationSet->GetInputDataPointer(pFeatureGroup) + iSampleFirst / cItemsPerBitPackedDataUnit;
+
+      // this shouldn't overflow since we're accessing existing memory
+      const FloatStorageType * const pResidualErrorTrueEnd = pResidualError + cSamples;
+      const FloatStorageType * pResidualErrorExit = pResidualErrorTrueEnd;
+      const FloatStorageType * pResidualErrorInnerEnd = pResidualErrorTrueEnd;
+      if(cSamples <= cItemsPerBitPackedDataUnit) {
+         goto one_last_loop;
+      }
+      pResidualErrorExit = pResidualErrorTrueEnd - ((cSamples - 1) % cItemsPerBitPackedDataUnit + 1);
+      EBM_ASSERT(pResidualError < pResidualErrorExit);
+      EBM_ASSERT(pResidualErrorExit < pResidualErrorTrueEnd);
+
+      do {
+         pResidualErrorInnerEnd = pResidualError + cItemsPerBitPackedDataUnit;
+         // jumping back into this loop and changing pPredictorScoresInnerEnd to a dynamic value that isn't compile time determinable causes this 
+         // function to NOT be optimized for templated cItemsPerBitPackedDataUnit, but that's ok since avoiding one unpredictable branch here is negligible
+      one_last_loop:;
+         // we store the already multiplied dimensional value in *pInputData
+         size_t iTensorBinCombined = static_cast<size_t>(*pInputData);
+         ++pInputData;
+         do {
+            const size_t iTensorBin = maskBits & iTensorBinCombined;
+
+            const FloatEbmType smallChangeToPrediction = aModelFeatureGroupUpdateTensor[iTensorBin];
+            // this will apply a small fix to our existing ValidationPredictorScores, either positive or negative, whichever is needed
+            const FloatEbmType residualError = 
+               EbmStatistics::ComputeResidualErrorRegression(static_cast<FloatEbmType>(*pResidualError) - smallChangeToPrediction);
+            const FloatEbmType sampleSquaredError = EbmStatistics::ComputeSingleSampleSquaredErrorRegression(residualError);
+            EBM_ASSERT(std::isnan(sampleSquaredError) || FloatEbmType { 0 } <= sampleSquaredError);
+            sumSquareError += sampleSquaredError;
+            *pResidualError = static_cast<FloatStorageType>(residualError);
+            ++pResidualError;
+
+            iTensorBinCombined >>= cBitsPerItemMax;
+         } while(pResidualErrorInnerEnd != pResidualError);
+      } while(pResidualErrorExit != pResidualError);
+
+      // first time through?
+      if(pResidualErrorTrueEnd != pResidualError) {
+         pResidualErrorInnerEnd = pResidualErrorTrueEnd;
+         pResidualErrorExit = pResidualErrorTrueEnd;
+         goto one_last_loop;
+      }
+      return sumSquareError;
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
+class ApplyModelUpdateValidationNormalTarget final {
+public:
+
+   ApplyModelUpdateValidationNormalTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static FloatEbmType Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples
+   ) {
+      static_assert(IsClassification(compilerLearningTypeOrCountTargetClassesPossible), "compilerLearningTypeOrCountTargetClassesPossible needs to be a classification");
+      static_assert(compilerLearningTypeOrCountTargetClassesPossible <= k_cCompilerOptimizedTargetClassesMax, "We can't have this many items in a data pack.");
+
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
+      EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
+      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+
+      if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
+         return ApplyModelUpdateValidationInternal<compilerLearningTypeOrCountTargetClassesPossible, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+            pBooster,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples
+         );
+      } else {
+         return ApplyModelUpdateValidationNormalTarget<
+            compilerLearningTypeOrCountTargetClassesPossible + 1
+         >::Func(
+            pBooster,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples
+         );
+      }
+   }
+};
+
+template<>
+class ApplyModelUpdateValidationNormalTarget<k_cCompilerOptimizedTargetClassesMax + 1> final {
+public:
+
+   ApplyModelUpdateValidationNormalTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static FloatEbmType Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples
+   ) {
+      static_assert(IsClassification(k_cCompilerOptimizedTargetClassesMax), "k_cCompilerOptimizedTargetClassesMax needs to be a classification");
+
+      EBM_ASSERT(IsClassification(pBooster->GetRuntimeLearningTypeOrCountTargetClasses()));
+      EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pBooster->GetRuntimeLearningTypeOrCountTargetClasses());
+
+      return ApplyModelUpdateValidationInternal<k_dynamicClassification, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+         pBooster,
+         pFeatureGroup,
+         aModelFeatureGroupUpdateTensor,
+         iSampleFirst,
+         cSamples
+      );
+   }
+};
+
+template<size_t compilerCountItemsPerBitPackedDataUnit>
+class ApplyModelUpdateValidationSIMDBinary final {
+public:
+
+   ApplyModelUpdateValidationSIMDBinary() = delete; // this is a static class.  Do not construct
+
+   static FloatEbmType Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples
+   ) {
+      constexpr size_t cLanes = SimdVector::k_cLanes;
+
+      const size_t runtimeCountItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+      DataSetByFeatureGroup * const pValidationSet = pBooster->GetValidationSet();
+
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(iSampleFirst + cSamples <= pValidationSet->GetCountSamples());
+      EBM_ASSERT(0 < pFeatureGroup->GetCountFeatures());
+
+      const size_t cItemsPerBitPackedDataUnit = GET_COUNT_ITEMS_PER_BIT_PACKED_DATA_UNIT(
+         compilerCountItemsPerBitPackedDataUnit,
+         runtimeCountItemsPerBitPackedDataUnit
+      );
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+      // we only shift between items, so a full width item never gets shifted.  The modulo keeps the compiler from
+      // warning about a 64 bit shift in the code that it can't see is never reached
+      const size_t cBitsShift = cBitsPerItemMax % k_cBitsForStorageType;
+      // chunks start on a bit packed data unit boundary
+      EBM_ASSERT(0 == iSampleFirst % cItemsPerBitPackedDataUnit);
+
+      FloatEbmType sumLogLoss = FloatEbmType { 0 };
+      const StorageDataType * pInputData =
+         pValidationSet->GetInputDataPointer(pFeatureGroup) + iSampleFirst / cItemsPerBitPackedDataUnit;
+      const StorageDataType * pTargetData = pValidationSet->GetTargetDataPointer() + iSampleFirst;
+      FloatStorageType * pPredictorScores = pValidationSet->GetPredictorScores<FloatStorageType>() + iSampleFirst;
+
+      // the same blocks as ApplyModelUpdateTrainingSIMD.  We compute the log loss a vector at a time, but we still
+      // add the samples into sumLogLoss one at a time and in order, since adding the lanes separately would give
+      // each CPU variant a different sum
+      size_t aiTensorBins[k_cBitsForStorageType * cLanes];
+      FloatEbmType aSampleLogLoss[cLanes];
+      size_t cSamplesRemaining = cSamples;
+      do {
+         const size_t cDataUnits = EbmMin(cLanes, (cSamplesRemaining - 1) / cItemsPerBitPackedDataUnit + 1);
+         const StorageDataType * const pInputDataEnd = pInputData + cDataUnits;
+         size_t * piTensorBin = aiTensorBins;
+         do {
+            // we store the already multiplied dimensional value in *pInputData
+            size_t iTensorBinCombined = static_cast<size_t>(*pInputData);
+            ++pInputData;
+            *piTensorBin = maskBits & iTensorBinCombined;
+            ++piTensorBin;
+            for(size_t iItem = 1; iItem < cItemsPerBitPackedDataUnit; ++iItem) {
+               iTensorBinCombined >>= cBitsShift;
+               *piTensorBin = maskBits & iTensorBinCombined;
+               ++piTensorBin;
+            }
+         } while(pInputDataEnd != pInputData);
+
+         const size_t cSamplesBlock = EbmMin(cSamplesRemaining, cDataUnits * cItemsPerBitPackedDataUnit);
+         cSamplesRemaining -= cSamplesBlock;
+
+         const size_t * piTensorBinCur = aiTensorBins;
+         const size_t * const piTensorBinVectorsEnd = aiTensorBins + (cSamplesBlock - cSamplesBlock % cLanes);
+         while(piTensorBinVectorsEnd != piTensorBinCur) {
+            const SimdVector smallChange = SimdVector::Gather(aModelFeatureGroupUpdateTensor, piTensorBinCur);
+            piTensorBinCur += cLanes;
+            const SimdVector predictorScore = SimdVector::Load(pPredictorScores) + smallChange;
+            predictorScore.Store(pPredictorScores);
+            pPredictorScores += cLanes;
+            const SimdVector signs = SimdVector::LoadSignsFromBinaryTargets(pTargetData);
+            pTargetData += cLanes;
+            const SimdVector sampleLogLoss = ComputeSingleSampleLogLossBinaryClassification(predictorScore, signs);
+            sampleLogLoss.Store(aSampleLogLoss);
+            for(size_t iLane = 0; iLane < cLanes; ++iLane) {
+               EBM_ASSERT(std::isnan(aSampleLogLoss[iLane]) || FloatEbmType { 0 } <= aSampleLogLoss[iLane]);
+               sumLogLoss += aSampleLogLoss[iLane];
+            }
+         }
+
+         const size_t * const piTensorBinEnd = aiTensorBins + cSamplesBlock;
+         while(piTensorBinEnd != piTensorBinCur) {
+            const FloatEbmType smallChange = aModelFeatureGroupUpdateTensor[*piTensorBinCur];
+            ++piTensorBinCur;
+            size_t targetData = static_cast<size_t>(*pTargetData);
+            ++pTargetData;
+            const FloatEbmType predictorScore = static_cast<FloatEbmType>(*pPredictorScores) + smallChange;
+            *pPredictorScores = static_cast<FloatStorageType>(predictorScore);
+            ++pPredictorScores;
+            const FloatEbmType sampleLogLoss = EbmStatistics::ComputeSingleSampleLogLossBinaryClassification(predictorScore, targetData);
+            EBM_ASSERT(std::isnan(sampleLogLoss) || FloatEbmType { 0 } <= sampleLogLoss);
+            sumLogLoss += sampleLogLoss;
+         }
+      } while(0 != cSamplesRemaining);
+      return sumLogLoss;
+   }
+};
+
+template<size_t compilerCountItemsPerBitPackedDataUnitPossible>
+class ApplyModelUpdateValidationSIMDBinaryPacking final {
+public:
+
+   ApplyModelUpdateValidationSIMDBinaryPacking() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static FloatEbmType Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples
+   ) {
+      const size_t runtimeCountItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+
+      EBM_ASSERT(1 <= runtimeCountItemsPerBitPackedDataUnit);
+      EBM_ASSERT(runtimeCountItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      static_assert(compilerCountItemsPerBitPackedDataUnitPossible <= k_cBitsForStorageType, "We can't have this many items in a data pack.");
+      if(compilerCountItemsPerBitPackedDataUnitPossible == runtimeCountItemsPerBitPackedDataUnit) {
+         return ApplyModelUpdateValidationSIMDBinary<compilerCountItemsPerBitPackedDataUnitPossible>::Func(
+            pBooster,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples
+         );
+      } else {
+         return ApplyModelUpdateValidationSIMDBinaryPacking<
+            GetNextCountItemsBitPacked(compilerCountItemsPerBitPackedDataUnitPossible)
+         >::Func(
+            pBooster,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples
+         );
+      }
+   }
+};
+
+template<>
+class ApplyModelUpdateValidationSIMDBinaryPacking<k_cItemsPerBitPackedDataUnitDynamic> final {
+public:
+
+   ApplyModelUpdateValidationSIMDBinaryPacking() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static FloatEbmType Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      const size_t iSampleFirst,
+      const size_t cSamples
+   ) {
+      EBM_ASSERT(1 <= pFeatureGroup->GetCountItemsPerBitPackedDataUnit());
+      EBM_ASSERT(pFeatureGroup->GetCountItemsPerBitPackedDataUnit() <= k_cBitsForStorageType);
+      return ApplyModelUpdateValidationSIMDBinary<k_cItemsPerBitPackedDataUnitDynamic>::Func(
+         pBooster,
+         pFeatureGroup,
+         aModelFeatureGroupUpdateTensor,
+         iSampleFirst,
+         cSamples
+      );
+   }
+};
+
+// returns the sum of the metric over the samples [iSampleFirst, iSampleFirst + cSamples)
+static FloatEbmType ApplyModelUpdateValidationChunk(
+   Booster * const pBooster,
+   const FeatureGroup * const pFeatureGroup,
+   const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+   const size_t iSampleFirst,
+   const size_t cSamples
+) {
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
+
+   FloatEbmType ret;
+   if(0 == pFeatureGroup->GetCountFeatures()) {
+      if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
+         ret = ApplyModelUpdateValidationZeroFeaturesTarget<2>::Func(
+            pBooster,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples
+         );
+      } else {
+         EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
+         ret = ApplyModelUpdateValidationZeroFeatures<k_regression>::Func(
+            pBooster,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples
+         );
+      }
+   } else {
+      // k_bUseSIMD is false if we have no SIMD instructions for this variant and build.  Only binary 
+      // classification has a vector path here since the log loss, with its exp and log, is where the time goes
+#ifdef EXPAND_BINARY_LOGITS
+      // binary classification has 2 logits per sample then, so it's multiclass as far as our SIMD path is concerned
+      constexpr bool bSIMDBinary = false;
+#else // EXPAND_BINARY_LOGITS
+      constexpr bool bSIMDBinary = k_bUseSIMD;
+#endif // EXPAND_BINARY_LOGITS
+
+      if(bSIMDBinary && IsBinaryClassification(runtimeLearningTypeOrCountTargetClasses)) {
+         // we start at the maximum number of items per data unit so that every packing width that 
+         // GetNextCountItemsBitPacked produces gets its own compile time specialization
+         ret = ApplyModelUpdateValidationSIMDBinaryPacking<k_cBitsForStorageType>::Func(
+            pBooster,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor,
+            iSampleFirst,
+            cSamples
+         );
+      } else {
+         // there isn't much benefit in eliminating the loop that unpacks a data unit unless we're also unpacking that to SIMD code
+         // Our default packing structure is to bin continuous values to 256 values, and we have 64 bit packing structures, so we usually
+         // have more than 8 values per memory fetch.  Eliminating the inner loop for multiclass is valuable since we can have low numbers like 3 class,
+         // 4 class, etc, but by the time we get to 8 loops with exp inside and a lot of other instructures we should worry that our code expansion
+         // will exceed the L1 instruction cache size.  With SIMD we do 8 times the work in the same number of instructions so these are lesser issues
+
+         if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
+            ret = ApplyModelUpdateValidationNormalTarget<2>::Func(
+               pBooster,
+               pFeatureGroup,
+               aModelFeatureGroupUpdateTensor,
+               iSampleFirst,
+               cSamples
+            );
+         } else {
+            EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
+            ret = ApplyModelUpdateValidationInternal<k_regression, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+               pBooster,
+               pFeatureGroup,
+               aModelFeatureGroupUpdateTensor,
+               iSampleFirst,
+               cSamples
+            );
+         }
+      }
+   }
+
+   return ret;
+}
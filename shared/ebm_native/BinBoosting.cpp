@@ -21,7 +21,10 @@
 #include "HistogramTargetEntry.h"
 #include "HistogramBucket.h"
 
-template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+#include "Threading.h"
+#include "CpuDispatch.h"
+
+template<typename TFloat, ptrdiff_t compilerLearningTypeOrCountTargetClasses>
 class BinBoostingZeroDimensions final {
 public:
 
@@ -52,9 +55,9 @@ public:
       EBM_ASSERT(0 < cSamples);
 
       const size_t * pCountOccurrences = pTrainingSet->GetCountOccurrences();
-      const FloatEbmType * pResidualError = pTrainingSet->GetDataSetByFeatureGroup()->GetResidualPointer();
+      const TFloat * pResidualError = pTrainingSet->GetDataSetByFeatureGroup()->GetResidualPointer<TFloat>();
       // this shouldn't overflow since we're accessing existing memory
-      const FloatEbmType * const pResidualErrorEnd = pResidualError + cVectorLength * cSamples;
+      const TFloat * const pResidualErrorEnd = pResidualError + cVectorLength * cSamples;
 
       HistogramBucketVectorEntry<bClassification> * const pHistogramBucketVectorEntry =
          pHistogramBucketEntry->GetHistogramBucketVectorEntry();
@@ -116,14 +119,15 @@ public:
             ptrdiff_t { 2 } == runtimeLearningTypeOrCountTargetClasses && !bExpandBinaryLogits ||
             0 <= k_iZeroResidual ||
             std::isnan(residualTotalDebug) ||
-            -k_epsilonResidualError < residualTotalDebug && residualTotalDebug < k_epsilonResidualError
+            -GetEpsilonResidualErrorTotal<TFloat>(cVectorLength) < residualTotalDebug && 
+            residualTotalDebug < GetEpsilonResidualErrorTotal<TFloat>(cVectorLength)
          );
       } while(pResidualErrorEnd != pResidualError);
       LOG_0(TraceLevelVerbose, "Exited BinDataSetTrainingZeroDimensions");
    }
 };
 
-template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
+template<typename TFloat, ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
 class BinBoostingZeroDimensionsTarget final {
 public:
 
@@ -142,13 +146,13 @@ public:
       EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
-         BinBoostingZeroDimensions<compilerLearningTypeOrCountTargetClassesPossible>::Func(
+         BinBoostingZeroDimensions<TFloat, compilerLearningTypeOrCountTargetClassesPossible>::Func(
             pBooster,
             pTrainingSet,
             pHistogramBucketEntryBase
          );
       } else {
-         BinBoostingZeroDimensionsTarget<compilerLearningTypeOrCountTargetClassesPossible + 1>::Func(
+         BinBoostingZeroDimensionsTarget<TFloat, compilerLearningTypeOrCountTargetClassesPossible + 1>::Func(
             pBooster,
             pTrainingSet,
             pHistogramBucketEntryBase
@@ -157,8 +161,8 @@ public:
    }
 };
 
-template<>
-class BinBoostingZeroDimensionsTarget<k_cCompilerOptimizedTargetClassesMax + 1> final {
+template<typename TFloat>
+class BinBoostingZeroDimensionsTarget<TFloat, k_cCompilerOptimizedTargetClassesMax + 1> final {
 public:
 
    BinBoostingZeroDimensionsTarget() = delete; // this is a static class.  Do not construct
@@ -173,7 +177,7 @@ public:
       EBM_ASSERT(IsClassification(pBooster->GetRuntimeLearningTypeOrCountTargetClasses()));
       EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pBooster->GetRuntimeLearningTypeOrCountTargetClasses());
 
-      BinBoostingZeroDimensions<k_dynamicClassification>::Func(
+      BinBoostingZeroDimensions<TFloat, k_dynamicClassification>::Func(
          pBooster,
          pTrainingSet,
          pHistogramBucketEntryBase
@@ -181,414 +185,189 @@ public:
    }
 };
 
-template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, size_t compilerCountItemsPerBitPackedDataUnit>
-class BinBoostingInternal final {
-public:
-
-   BinBoostingInternal() = delete; // this is a static class.  Do not construct
-
-   static void Func(
-      Booster * const pBooster,
-      const FeatureGroup * const pFeatureGroup,
-      const SamplingSet * const pTrainingSet,
-      HistogramBucketBase * const aHistogramBucketBase
-#ifndef NDEBUG
-      , const unsigned char * const aHistogramBucketsEndDebug
-#endif // NDEBUG
-   ) {
-      constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
-
-      LOG_0(TraceLevelVerbose, "Entered BinDataSetTraining");
-
-      HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const aHistogramBuckets =
-         aHistogramBucketBase->GetHistogramBucket<bClassification>();
-
-      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
-
-      const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
-         compilerLearningTypeOrCountTargetClasses,
-         runtimeLearningTypeOrCountTargetClasses
-      );
-      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
-
-      const size_t cItemsPerBitPackedDataUnit = GET_COUNT_ITEMS_PER_BIT_PACKED_DATA_UNIT(
-         compilerCountItemsPerBitPackedDataUnit,
-         pFeatureGroup->GetCountItemsPerBitPackedDataUnit()
+template<typename TFloat>
+static void BinBoostingZeroDimensionsStorage(
+   Booster * const pBooster,
+   const SamplingSet * const pTrainingSet,
+   HistogramBucketBase * const pHistogramBucketEntryBase
+) {
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
+   if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
+      BinBoostingZeroDimensionsTarget<TFloat, 2>::Func(
+         pBooster,
+         pTrainingSet,
+         pHistogramBucketEntryBase
       );
-      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
-      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
-      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
-      EBM_ASSERT(1 <= cBitsPerItemMax);
-      EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
-      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
-      EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength)); // we're accessing allocated memory
-      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
-
-      const size_t cSamples = pTrainingSet->GetDataSetByFeatureGroup()->GetCountSamples();
-      EBM_ASSERT(0 < cSamples);
-
-      const size_t * pCountOccurrences = pTrainingSet->GetCountOccurrences();
-      const StorageDataType * pInputData = pTrainingSet->GetDataSetByFeatureGroup()->GetInputDataPointer(pFeatureGroup);
-      const FloatEbmType * pResidualError = pTrainingSet->GetDataSetByFeatureGroup()->GetResidualPointer();
-
-      // this shouldn't overflow since we're accessing existing memory
-      const FloatEbmType * const pResidualErrorTrueEnd = pResidualError + cVectorLength * cSamples;
-      const FloatEbmType * pResidualErrorExit = pResidualErrorTrueEnd;
-      size_t cItemsRemaining = cSamples;
-      if(cSamples <= cItemsPerBitPackedDataUnit) {
-         goto one_last_loop;
-      }
-      pResidualErrorExit = pResidualErrorTrueEnd - cVectorLength * ((cSamples - 1) % cItemsPerBitPackedDataUnit + 1);
-      EBM_ASSERT(pResidualError < pResidualErrorExit);
-      EBM_ASSERT(pResidualErrorExit < pResidualErrorTrueEnd);
-
-      do {
-         // this loop gets about twice as slow if you add a single unpredictable branching if statement based on count, even if you still access all the memory
-         // in complete sequential order, so we'll probably want to use non-branching instructions for any solution like conditional selection or multiplication
-         // this loop gets about 3 times slower if you use a bad pseudo random number generator like rand(), although it might be better if you inlined rand().
-         // this loop gets about 10 times slower if you use a proper pseudo random number generator like std::default_random_engine
-         // taking all the above together, it seems unlikley we'll use a method of separating sets via single pass randomized set splitting.  Even if count is 
-         // stored in memory if shouldn't increase the time spent fetching it by 2 times, unless our bottleneck when threading is overwhelmingly memory pressure
-         // related, and even then we could store the count for a single bit aleviating the memory pressure greatly, if we use the right sampling method 
-
-         // TODO : try using a sampling method with non-repeating samples, and put the count into a bit.  Then unwind that loop either at the byte level 
-         //   (8 times) or the uint64_t level.  This can be done without branching and doesn't require random number generators
-
-         cItemsRemaining = cItemsPerBitPackedDataUnit;
-         // TODO : jumping back into this loop and changing cItemsRemaining to a dynamic value that isn't compile time determinable
-         // causes this function to NOT be optimized as much as it could if we had two separate loops.  We're just trying this out for now though
-      one_last_loop:;
-         // we store the already multiplied dimensional value in *pInputData
-         size_t iTensorBinCombined = static_cast<size_t>(*pInputData);
-         ++pInputData;
-         do {
-            const size_t iTensorBin = maskBits & iTensorBinCombined;
-
-            HistogramBucket<bClassification> * const pHistogramBucketEntry = GetHistogramBucketByIndex(
-               cBytesPerHistogramBucket,
-               aHistogramBuckets,
-               iTensorBin
-            );
-
-            ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pHistogramBucketEntry, aHistogramBucketsEndDebug);
-            const size_t cOccurences = *pCountOccurrences;
-            ++pCountOccurrences;
-            pHistogramBucketEntry->SetCountSamplesInBucket(pHistogramBucketEntry->GetCountSamplesInBucket() + cOccurences);
-            const FloatEbmType cFloatOccurences = static_cast<FloatEbmType>(cOccurences);
-            HistogramBucketVectorEntry<bClassification> * pHistogramBucketVectorEntry = 
-               pHistogramBucketEntry->GetHistogramBucketVectorEntry();
-
-            size_t iVector = 0;
-
-#ifndef NDEBUG
-#ifdef EXPAND_BINARY_LOGITS
-            constexpr bool bExpandBinaryLogits = true;
-#else // EXPAND_BINARY_LOGITS
-            constexpr bool bExpandBinaryLogits = false;
-#endif // EXPAND_BINARY_LOGITS
-            FloatEbmType residualTotalDebug = 0;
-#endif // NDEBUG
-            do {
-               const FloatEbmType residualError = *pResidualError;
-               EBM_ASSERT(
-                  !bClassification ||
-                  ptrdiff_t { 2 } == runtimeLearningTypeOrCountTargetClasses && !bExpandBinaryLogits ||
-                  static_cast<ptrdiff_t>(iVector) != k_iZeroResidual ||
-                  0 == residualError
-               );
-#ifndef NDEBUG
-               residualTotalDebug += residualError;
-#endif // NDEBUG
-               pHistogramBucketVectorEntry[iVector].m_sumResidualError += cFloatOccurences * residualError;
-               if(bClassification) {
-                  // TODO : this code gets executed for each SamplingSet set.  I could probably execute it once and then all the
-                  //   SamplingSet sets would have this value, but I would need to store the computation in a new memory place, and it might 
-                  //   make more sense to calculate this values in the CPU rather than put more pressure on memory.  I think controlling this should be 
-                  //   done in a MACRO and we should use a class to hold the residualError and this computation from that value and then comment out the 
-                  //   computation if not necssary and access it through an accessor so that we can make the change entirely via macro
-                  const FloatEbmType denominator = EbmStatistics::ComputeNewtonRaphsonStep(residualError);
-                  pHistogramBucketVectorEntry[iVector].SetSumDenominator(
-                     pHistogramBucketVectorEntry[iVector].GetSumDenominator() + cFloatOccurences * denominator
-                  );
-               }
-               ++pResidualError;
-               ++iVector;
-               // if we use this specific format where (iVector < cVectorLength) then the compiler collapses alway the loop for small cVectorLength values
-               // if we make this (iVector != cVectorLength) then the loop is not collapsed
-               // the compiler seems to not mind if we make this a for loop or do loop in terms of collapsing away the loop
-            } while(iVector < cVectorLength);
-
-            EBM_ASSERT(
-               !bClassification ||
-               ptrdiff_t { 2 } == runtimeLearningTypeOrCountTargetClasses && !bExpandBinaryLogits ||
-               0 <= k_iZeroResidual ||
-               -k_epsilonResidualError < residualTotalDebug && residualTotalDebug < k_epsilonResidualError
-            );
-
-            iTensorBinCombined >>= cBitsPerItemMax;
-            // TODO : try replacing cItemsRemaining with a pResidualErrorInnerLoopEnd which eliminates one subtact operation, but might make it harder for 
-            //   the compiler to optimize the loop away
-            --cItemsRemaining;
-         } while(0 != cItemsRemaining);
-      } while(pResidualErrorExit != pResidualError);
-
-      // first time through?
-      if(pResidualErrorTrueEnd != pResidualError) {
-         LOG_0(TraceLevelVerbose, "Handling last BinDataSetTraining loop");
-
-         EBM_ASSERT(0 == (pResidualErrorTrueEnd - pResidualError) % cVectorLength);
-         cItemsRemaining = (pResidualErrorTrueEnd - pResidualError) / cVectorLength;
-         EBM_ASSERT(0 < cItemsRemaining);
-         EBM_ASSERT(cItemsRemaining <= cItemsPerBitPackedDataUnit);
-
-         pResidualErrorExit = pResidualErrorTrueEnd;
-
-         goto one_last_loop;
-      }
-
-      LOG_0(TraceLevelVerbose, "Exited BinDataSetTraining");
-   }
-};
-
-template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
-class BinBoostingNormalTarget final {
-public:
-
-   BinBoostingNormalTarget() = delete; // this is a static class.  Do not construct
-
-   INLINE_ALWAYS static void Func(
-      Booster * const pBooster,
-      const FeatureGroup * const pFeatureGroup,
-      const SamplingSet * const pTrainingSet,
-      HistogramBucketBase * const aHistogramBucketBase
-#ifndef NDEBUG
-      , const unsigned char * const aHistogramBucketsEndDebug
-#endif // NDEBUG
-   ) {
-      static_assert(IsClassification(compilerLearningTypeOrCountTargetClassesPossible), "compilerLearningTypeOrCountTargetClassesPossible needs to be a classification");
-      static_assert(compilerLearningTypeOrCountTargetClassesPossible <= k_cCompilerOptimizedTargetClassesMax, "We can't have this many items in a data pack.");
-
-      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
-      EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
-
-      if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
-         BinBoostingInternal<compilerLearningTypeOrCountTargetClassesPossible, k_cItemsPerBitPackedDataUnitDynamic>::Func(
-            pBooster,
-            pFeatureGroup,
-            pTrainingSet,
-            aHistogramBucketBase
-#ifndef NDEBUG
-            , aHistogramBucketsEndDebug
-#endif // NDEBUG
-         );
-      } else {
-         BinBoostingNormalTarget<compilerLearningTypeOrCountTargetClassesPossible + 1>::Func(
-            pBooster,
-            pFeatureGroup,
-            pTrainingSet,
-            aHistogramBucketBase
-#ifndef NDEBUG
-            , aHistogramBucketsEndDebug
-#endif // NDEBUG
-         );
-      }
-   }
-};
-
-template<>
-class BinBoostingNormalTarget<k_cCompilerOptimizedTargetClassesMax + 1> final {
-public:
-
-   BinBoostingNormalTarget() = delete; // this is a static class.  Do not construct
-
-   INLINE_ALWAYS static void Func(
-      Booster * const pBooster,
-      const FeatureGroup * const pFeatureGroup,
-      const SamplingSet * const pTrainingSet,
-      HistogramBucketBase * const aHistogramBucketBase
-#ifndef NDEBUG
-      , const unsigned char * const aHistogramBucketsEndDebug
-#endif // NDEBUG
-   ) {
-      static_assert(IsClassification(k_cCompilerOptimizedTargetClassesMax), "k_cCompilerOptimizedTargetClassesMax needs to be a classification");
-
-      EBM_ASSERT(IsClassification(pBooster->GetRuntimeLearningTypeOrCountTargetClasses()));
-      EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pBooster->GetRuntimeLearningTypeOrCountTargetClasses());
-
-      BinBoostingInternal<k_dynamicClassification, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+   } else {
+      EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
+      BinBoostingZeroDimensions<TFloat, k_regression>::Func(
          pBooster,
-         pFeatureGroup,
          pTrainingSet,
-         aHistogramBucketBase
-#ifndef NDEBUG
-         , aHistogramBucketsEndDebug
-#endif // NDEBUG
+         pHistogramBucketEntryBase
       );
    }
-};
-
-template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, size_t compilerCountItemsPerBitPackedDataUnitPossible>
-class BinBoostingSIMDPacking final {
-public:
-
-   BinBoostingSIMDPacking() = delete; // this is a static class.  Do not construct
+}
 
-   INLINE_ALWAYS static void Func(
-      Booster * const pBooster,
-      const FeatureGroup * const pFeatureGroup,
-      const SamplingSet * const pTrainingSet,
-      HistogramBucketBase * const aHistogramBucketBase
-#ifndef NDEBUG
-      , const unsigned char * const aHistogramBucketsEndDebug
-#endif // NDEBUG
-   ) {
-      const size_t runtimeCountItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+static size_t GetCountMainHistogramBuckets(const FeatureGroup * const pFeatureGroup) {
+   // binning only writes to the main space, not the auxiliary buckets that our caller might have allocated after it
+   size_t cHistogramBuckets = 1;
+   const size_t cDimensions = pFeatureGroup->GetCountFeatures();
+   for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+      const size_t cBins = pFeatureGroup->GetFeatureGroupEntries()[iDimension].m_pFeature->GetCountBins();
+      // our caller allocated at least this many buckets, so none of these can overflow
+      EBM_ASSERT(!IsMultiplyError(cHistogramBuckets, cBins));
+      cHistogramBuckets *= cBins;
+   }
+   return cHistogramBuckets;
+}
 
-      EBM_ASSERT(1 <= runtimeCountItemsPerBitPackedDataUnit);
-      EBM_ASSERT(runtimeCountItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
-      static_assert(compilerCountItemsPerBitPackedDataUnitPossible <= k_cBitsForStorageType, "We can't have this many items in a data pack.");
-      if(compilerCountItemsPerBitPackedDataUnitPossible == runtimeCountItemsPerBitPackedDataUnit) {
-         BinBoostingInternal<compilerLearningTypeOrCountTargetClasses, compilerCountItemsPerBitPackedDataUnitPossible>::Func(
-            pBooster,
-            pFeatureGroup,
-            pTrainingSet,
-            aHistogramBucketBase
-#ifndef NDEBUG
-            , aHistogramBucketsEndDebug
-#endif // NDEBUG
-         );
-      } else {
-         BinBoostingSIMDPacking<
-            compilerLearningTypeOrCountTargetClasses,
-            GetNextCountItemsBitPacked(compilerCountItemsPerBitPackedDataUnitPossible)
-         >::Func(
-            pBooster,
-            pFeatureGroup,
-            pTrainingSet,
-            aHistogramBucketBase
-#ifndef NDEBUG
-            , aHistogramBucketsEndDebug
-#endif // NDEBUG
-         );
-      }
+#define CPU_VARIANT_KERNEL "BinBoostingKernel.h"
+#define CPU_VARIANT_KERNEL_FLOAT_STORAGE
+#include "CpuVariantKernels.h"
+
+// below this many samples per shard the cost of zeroing and merging a private copy of the histogram isn't worth it
+constexpr size_t k_cSamplesPerBinShardMin = 65536;
+// the shard count is fixed by the data alone, so it can't scale with the thread count.  Past this many shards the 
+// threads are better spent on other inner bags or boosters anyways
+constexpr size_t k_cBinShardsMax = 64;
+
+static size_t GetCountSamplesPerBinShard(const FeatureGroup * const pFeatureGroup, const size_t cSamples) {
+   EBM_ASSERT(1 <= cSamples);
+   // each shard needs enough samples to pay for zeroing and merging its private buckets
+   const size_t cShards = EbmMax(size_t { 1 }, EbmMin(k_cBinShardsMax, 
+      cSamples / EbmMax(k_cSamplesPerBinShardMin, GetCountMainHistogramBuckets(pFeatureGroup))));
+   if(size_t { 1 } == cShards) {
+      return cSamples;
    }
-};
+   // shards start on a bit packed data unit boundary so that they can be unpacked independently
+   const size_t cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+   const size_t cDataUnits = (cSamples - size_t { 1 }) / cItemsPerBitPackedDataUnit + size_t { 1 };
+   const size_t cDataUnitsPerShard = (cDataUnits - size_t { 1 }) / cShards + size_t { 1 };
+   return cDataUnitsPerShard * cItemsPerBitPackedDataUnit;
+}
 
-template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
-class BinBoostingSIMDPacking<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitDynamic> final {
-public:
+// The histograms are summed shard by shard and the shards are merged in order, so the floating point sums depend on
+// how the samples are split into shards.  The split only depends on the data, which makes the histograms, and therefore
+// the models, bitwise identical for any number of threads
+extern size_t GetCountBinShards(const FeatureGroup * const pFeatureGroup, const size_t cSamples) {
+   if(nullptr == pFeatureGroup || size_t { 0 } == cSamples) {
+      return 1;
+   }
+   return (cSamples - size_t { 1 }) / GetCountSamplesPerBinShard(pFeatureGroup, cSamples) + size_t { 1 };
+}
 
-   BinBoostingSIMDPacking() = delete; // this is a static class.  Do not construct
+struct BinShardsTaskContext {
+
+   BinShardsTaskContext() = default; // preserve our POD status
+   ~BinShardsTaskContext() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   Booster * m_pBooster;
+   const FeatureGroup * m_pFeatureGroup;
+   const SamplingSet * m_pTrainingSet;
+   size_t m_cSamples;
+   // every shard except the last has this many samples, which is a multiple of the items per bit packed data unit
+   size_t m_cSamplesPerShard;
+   size_t m_cHistogramBuckets;
+   size_t m_iShardFirst;
+   size_t m_cShardBuffers;
+   size_t m_cBytesShardBuffer;
+   // the first shard is binned into our caller's buckets, and shard N into private buffer (N - 1) % m_cShardBuffers
+   HistogramBucketBase * m_aHistogramBucketBase;
+   HistogramBucketBase * m_aShardBuffers;
+};
+static_assert(std::is_standard_layout<BinShardsTaskContext>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<BinShardsTaskContext>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<BinShardsTaskContext>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+template<bool bClassification>
+static void ZeroHistogramBuckets(
+   const size_t cVectorLength,
+   const size_t cHistogramBuckets,
+   HistogramBucketBase * const aHistogramBucketBase
+) {
+   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+   HistogramBucket<bClassification> * const aHistogramBuckets = aHistogramBucketBase->GetHistogramBucket<bClassification>();
+   for(size_t i = 0; i < cHistogramBuckets; ++i) {
+      GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBuckets, i)->Zero(cVectorLength);
+   }
+}
 
-   INLINE_ALWAYS static void Func(
-      Booster * const pBooster,
-      const FeatureGroup * const pFeatureGroup,
-      const SamplingSet * const pTrainingSet,
-      HistogramBucketBase * const aHistogramBucketBase
-#ifndef NDEBUG
-      , const unsigned char * const aHistogramBucketsEndDebug
-#endif // NDEBUG
-   ) {
-      EBM_ASSERT(1 <= pFeatureGroup->GetCountItemsPerBitPackedDataUnit());
-      EBM_ASSERT(pFeatureGroup->GetCountItemsPerBitPackedDataUnit() <= k_cBitsForStorageType);
-      BinBoostingInternal<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitDynamic>::Func(
-         pBooster,
-         pFeatureGroup,
-         pTrainingSet,
-         aHistogramBucketBase
-#ifndef NDEBUG
-         , aHistogramBucketsEndDebug
-#endif // NDEBUG
+template<bool bClassification>
+static void AddHistogramBuckets(
+   const size_t cVectorLength,
+   const size_t cHistogramBuckets,
+   HistogramBucketBase * const aHistogramBucketBaseTo,
+   const HistogramBucketBase * const aHistogramBucketBaseFrom
+) {
+   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+   HistogramBucket<bClassification> * const aHistogramBucketsTo = aHistogramBucketBaseTo->GetHistogramBucket<bClassification>();
+   const HistogramBucket<bClassification> * const aHistogramBucketsFrom = 
+      aHistogramBucketBaseFrom->GetHistogramBucket<bClassification>();
+   for(size_t i = 0; i < cHistogramBuckets; ++i) {
+      GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBucketsTo, i)->Add(
+         *GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBucketsFrom, i),
+         cVectorLength
       );
    }
-};
+}
 
-template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
-class BinBoostingSIMDTarget final {
-public:
+INLINE_ALWAYS static HistogramBucketBase * GetShardBuffer(
+   const BinShardsTaskContext * const pTaskContext, 
+   const size_t iShard
+) {
+   EBM_ASSERT(size_t { 1 } <= iShard);
+   return reinterpret_cast<HistogramBucketBase *>(reinterpret_cast<char *>(pTaskContext->m_aShardBuffers) + 
+      pTaskContext->m_cBytesShardBuffer * ((iShard - size_t { 1 }) % pTaskContext->m_cShardBuffers));
+}
 
-   BinBoostingSIMDTarget() = delete; // this is a static class.  Do not construct
+static void BinShardTask(void * const pContext, const size_t iThread, const size_t iTask) {
+   UNUSED(iThread);
+   const BinShardsTaskContext * const pTaskContext = static_cast<const BinShardsTaskContext *>(pContext);
+   Booster * const pBooster = pTaskContext->m_pBooster;
 
-   INLINE_ALWAYS static void Func(
-      Booster * const pBooster,
-      const FeatureGroup * const pFeatureGroup,
-      const SamplingSet * const pTrainingSet,
-      HistogramBucketBase * const aHistogramBucketBase
-#ifndef NDEBUG
-      , const unsigned char * const aHistogramBucketsEndDebug
-#endif // NDEBUG
-   ) {
-      static_assert(IsClassification(compilerLearningTypeOrCountTargetClassesPossible), "compilerLearningTypeOrCountTargetClassesPossible needs to be a classification");
-      static_assert(compilerLearningTypeOrCountTargetClassesPossible <= k_cCompilerOptimizedTargetClassesMax, "We can't have this many items in a data pack.");
+   const size_t iShard = pTaskContext->m_iShardFirst + iTask;
+   const size_t iSampleFirst = pTaskContext->m_cSamplesPerShard * iShard;
+   EBM_ASSERT(iSampleFirst < pTaskContext->m_cSamples);
+   const size_t cSamples = EbmMin(pTaskContext->m_cSamplesPerShard, pTaskContext->m_cSamples - iSampleFirst);
 
-      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
-      EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+   HistogramBucketBase * aHistogramBucketBase = pTaskContext->m_aHistogramBucketBase;
+   if(size_t { 0 } != iShard) {
+      aHistogramBucketBase = GetShardBuffer(pTaskContext, iShard);
 
-      if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
-         BinBoostingSIMDPacking<
-            compilerLearningTypeOrCountTargetClassesPossible,
-            k_cItemsPerBitPackedDataUnitMax
-         >::Func(
-            pBooster,
-            pFeatureGroup,
-            pTrainingSet,
-            aHistogramBucketBase
-#ifndef NDEBUG
-            , aHistogramBucketsEndDebug
-#endif // NDEBUG
-         );
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
+      const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+      if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
+         ZeroHistogramBuckets<true>(cVectorLength, pTaskContext->m_cHistogramBuckets, aHistogramBucketBase);
       } else {
-         BinBoostingSIMDTarget<compilerLearningTypeOrCountTargetClassesPossible + 1>::Func(
-            pBooster,
-            pFeatureGroup,
-            pTrainingSet,
-            aHistogramBucketBase
-#ifndef NDEBUG
-            , aHistogramBucketsEndDebug
-#endif // NDEBUG
-         );
+         ZeroHistogramBuckets<false>(cVectorLength, pTaskContext->m_cHistogramBuckets, aHistogramBucketBase);
       }
    }
-};
-
-template<>
-class BinBoostingSIMDTarget<k_cCompilerOptimizedTargetClassesMax + 1> final {
-public:
-
-   BinBoostingSIMDTarget() = delete; // this is a static class.  Do not construct
-
-   INLINE_ALWAYS static void Func(
-      Booster * const pBooster,
-      const FeatureGroup * const pFeatureGroup,
-      const SamplingSet * const pTrainingSet,
-      HistogramBucketBase * const aHistogramBucketBase
-#ifndef NDEBUG
-      , const unsigned char * const aHistogramBucketsEndDebug
-#endif // NDEBUG
-   ) {
-      static_assert(IsClassification(k_cCompilerOptimizedTargetClassesMax), "k_cCompilerOptimizedTargetClassesMax needs to be a classification");
-
-      EBM_ASSERT(IsClassification(pBooster->GetRuntimeLearningTypeOrCountTargetClasses()));
-      EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pBooster->GetRuntimeLearningTypeOrCountTargetClasses());
 
-      BinBoostingSIMDPacking<k_dynamicClassification, k_cItemsPerBitPackedDataUnitMax>::Func(
-         pBooster,
-         pFeatureGroup,
-         pTrainingSet,
-         aHistogramBucketBase
+   SELECT_CPU_VARIANT_STORAGE(pTaskContext->m_pTrainingSet->GetDataSetByFeatureGroup()->IsFloat32Storage(), BinBoostingShard)(
+      pBooster,
+      pTaskContext->m_pFeatureGroup,
+      pTaskContext->m_pTrainingSet,
+      iSampleFirst,
+      cSamples,
+      aHistogramBucketBase
 #ifndef NDEBUG
-         , aHistogramBucketsEndDebug
+      , reinterpret_cast<const unsigned char *>(aHistogramBucketBase) + pTaskContext->m_cBytesShardBuffer
 #endif // NDEBUG
-      );
-   }
-};
+   );
+}
 
 extern void BinBoosting(
    Booster * const pBooster,
    const FeatureGroup * const pFeatureGroup,
    const SamplingSet * const pTrainingSet,
+   const size_t cShardBuffers,
+   const size_t cBytesShardBuffer,
+   HistogramBucketBase * const aShardBuffers,
    HistogramBucketBase * const aHistogramBucketBase
 #ifndef NDEBUG
    , const unsigned char * const aHistogramBucketsEndDebug
@@ -599,86 +378,76 @@ extern void BinBoosting(
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
 
    if(nullptr == pFeatureGroup) {
-      if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
-         BinBoostingZeroDimensionsTarget<2>::Func(
-            pBooster,
-            pTrainingSet,
-            aHistogramBucketBase
-         );
+      if(pTrainingSet->GetDataSetByFeatureGroup()->IsFloat32Storage()) {
+         BinBoostingZeroDimensionsStorage<float>(pBooster, pTrainingSet, aHistogramBucketBase);
       } else {
-         EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
-         BinBoostingZeroDimensions<k_regression>::Func(
+         BinBoostingZeroDimensionsStorage<FloatEbmType>(pBooster, pTrainingSet, aHistogramBucketBase);
+      }
+   } else {
+      const size_t cSamples = pTrainingSet->GetDataSetByFeatureGroup()->GetCountSamples();
+      EBM_ASSERT(0 < cSamples);
+
+      const size_t cSamplesPerShard = GetCountSamplesPerBinShard(pFeatureGroup, cSamples);
+      const size_t cShards = (cSamples - size_t { 1 }) / cSamplesPerShard + size_t { 1 };
+      if(size_t { 1 } == cShards) {
+         SELECT_CPU_VARIANT_STORAGE(pTrainingSet->GetDataSetByFeatureGroup()->IsFloat32Storage(), BinBoostingShard)(
             pBooster,
+            pFeatureGroup,
             pTrainingSet,
+            0,
+            cSamples,
             aHistogramBucketBase
-         );
-      }
-   } else {
-      EBM_ASSERT(1 <= pFeatureGroup->GetCountFeatures());
-      if(k_bUseSIMD) {
-         // TODO : enable SIMD(AVX-512) to work
-
-         // 64 - do 8 at a time and unroll the loop 8 times.  These are bool features and are common.  Put the unrolled inner loop into a function
-         // 32 - do 8 at a time and unroll the loop 4 times.  These are bool features and are common.  Put the unrolled inner loop into a function
-         // 21 - do 8 at a time and unroll the loop 3 times (ignore the last 3 with a mask)
-         // 16 - do 8 at a time and unroll the loop 2 times.  These are bool features and are common.  Put the unrolled inner loop into a function
-         // 12 - do 8 of them, shift the low 4 upwards and then load the next 12 and take the top 4, repeat.
-         // 10 - just drop this down to packing 8 together
-         // 9 - just drop this down to packing 8 together
-         // 8 - do all 8 at a time without an inner loop.  This is one of the most common values.  256 binned values
-         // 7,6,5,4,3,2,1 - use a mask to exclude the non-used conditions and process them like the 8.  These are rare since they require more than 256 values
-
-         if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
-            BinBoostingSIMDTarget<2>::Func(
-               pBooster,
-               pFeatureGroup,
-               pTrainingSet,
-               aHistogramBucketBase
-#ifndef NDEBUG
-               , aHistogramBucketsEndDebug
-#endif // NDEBUG
-            );
-         } else {
-            EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
-            BinBoostingSIMDPacking<k_regression, k_cItemsPerBitPackedDataUnitMax>::Func(
-               pBooster,
-               pFeatureGroup,
-               pTrainingSet,
-               aHistogramBucketBase
 #ifndef NDEBUG
-               , aHistogramBucketsEndDebug
+            , aHistogramBucketsEndDebug
 #endif // NDEBUG
-            );
-         }
+         );
       } else {
-         // there isn't much benefit in eliminating the loop that unpacks a data unit unless we're also unpacking that to SIMD code
-         // Our default packing structure is to bin continuous values to 256 values, and we have 64 bit packing structures, so we usually
-         // have more than 8 values per memory fetch.  Eliminating the inner loop for multiclass is valuable since we can have low numbers like 3 class,
-         // 4 class, etc, but by the time we get to 8 loops with exp inside and a lot of other instructures we should worry that our code expansion
-         // will exceed the L1 instruction cache size.  With SIMD we do 8 times the work in the same number of instructions so these are lesser issues
-
-         if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
-            BinBoostingNormalTarget<2>::Func(
-               pBooster,
-               pFeatureGroup,
-               pTrainingSet,
-               aHistogramBucketBase
-#ifndef NDEBUG
-               , aHistogramBucketsEndDebug
-#endif // NDEBUG
-            );
-         } else {
-            EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
-            BinBoostingInternal<k_regression, k_cItemsPerBitPackedDataUnitDynamic>::Func(
-               pBooster,
-               pFeatureGroup,
-               pTrainingSet,
-               aHistogramBucketBase
-#ifndef NDEBUG
-               , aHistogramBucketsEndDebug
-#endif // NDEBUG
-            );
-         }
+         // our caller gets the shard count from GetCountBinShards and provides at least one private buffer
+         EBM_ASSERT(1 <= cShardBuffers);
+         EBM_ASSERT(nullptr != aShardBuffers);
+
+         const bool bClassification = IsClassification(runtimeLearningTypeOrCountTargetClasses);
+         const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+         // our caller checked this when allocating aHistogramBucketBase
+         EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength));
+         const size_t cHistogramBuckets = GetCountMainHistogramBuckets(pFeatureGroup);
+         EBM_ASSERT(!IsMultiplyError(cHistogramBuckets, GetHistogramBucketSize(bClassification, cVectorLength)));
+         EBM_ASSERT(cHistogramBuckets * GetHistogramBucketSize(bClassification, cVectorLength) <= cBytesShardBuffer);
+
+         BinShardsTaskContext taskContext;
+         taskContext.m_pBooster = pBooster;
+         taskContext.m_pFeatureGroup = pFeatureGroup;
+         taskContext.m_pTrainingSet = pTrainingSet;
+         taskContext.m_cSamples = cSamples;
+         taskContext.m_cSamplesPerShard = cSamplesPerShard;
+         taskContext.m_cHistogramBuckets = cHistogramBuckets;
+         taskContext.m_cShardBuffers = EbmMin(cShardBuffers, cShards - size_t { 1 });
+         taskContext.m_cBytesShardBuffer = cBytesShardBuffer;
+         taskContext.m_aHistogramBucketBase = aHistogramBucketBase;
+         taskContext.m_aShardBuffers = aShardBuffers;
+
+         // With fewer buffers than shards we bin the shards in waves that each fill every buffer.  The first wave also
+         // bins shard 0 into our caller's buckets.  Merging each wave in shard order gives the same sums as having a
+         // buffer per shard, so neither the thread count nor the buffer count changes the result
+         size_t iShardFirst = 0;
+         size_t iShardNext = size_t { 1 } + taskContext.m_cShardBuffers;
+         do {
+            const size_t iShardEnd = EbmMin(iShardNext, cShards);
+            const size_t cTasks = iShardEnd - iShardFirst;
+            taskContext.m_iShardFirst = iShardFirst;
+            RunParallelTasks(cTasks, cTasks, BinShardTask, &taskContext);
+
+            for(size_t iShard = EbmMax(size_t { 1 }, iShardFirst); iShard < iShardEnd; ++iShard) {
+               const HistogramBucketBase * const aShardBuffer = GetShardBuffer(&taskContext, iShard);
+               if(bClassification) {
+                  AddHistogramBuckets<true>(cVectorLength, cHistogramBuckets, aHistogramBucketBase, aShardBuffer);
+               } else {
+                  AddHistogramBuckets<false>(cVectorLength, cHistogramBuckets, aHistogramBucketBase, aShardBuffer);
+               }
+            }
+            iShardFirst = iShardEnd;
+            iShardNext = iShardEnd + taskContext.m_cShardBuffers;
+         } while(iShardFirst < cShards);
       }
    }
 
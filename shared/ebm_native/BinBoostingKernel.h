@@ -0,0 +1,553 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+// BinBoosting.cpp only includes this through CpuVariantKernels.h, once for each CPU variant, so there is no include 
+// guard and nothing gets included here
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, size_t compilerCountItemsPerBitPackedDataUnit>
+class BinBoostingInternal final {
+public:
+
+   BinBoostingInternal() = delete; // this is a static class.  Do not construct
+
+   static void Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const SamplingSet * const pTrainingSet,
+      const size_t iSampleFirst,
+      const size_t cSamples,
+      HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+
+      LOG_0(TraceLevelVerbose, "Entered BinDataSetTraining");
+
+      HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const aHistogramBuckets =
+         aHistogramBucketBase->GetHistogramBucket<bClassification>();
+
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
+
+      const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
+         compilerLearningTypeOrCountTargetClasses,
+         runtimeLearningTypeOrCountTargetClasses
+      );
+      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+
+      const size_t cItemsPerBitPackedDataUnit = GET_COUNT_ITEMS_PER_BIT_PACKED_DATA_UNIT(
+         compilerCountItemsPerBitPackedDataUnit,
+         pFeatureGroup->GetCountItemsPerBitPackedDataUnit()
+      );
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+      EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength)); // we're accessing allocated memory
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+
+      // we bin the samples [iSampleFirst, iSampleFirst + cSamples), which starts on a bit packed data unit boundary
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(0 == iSampleFirst % cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(iSampleFirst + cSamples <= pTrainingSet->GetDataSetByFeatureGroup()->GetCountSamples());
+
+      const size_t * pCountOccurrences = pTrainingSet->GetCountOccurrences() + iSampleFirst;
+      const StorageDataType * pInputData = pTrainingSet->GetDataSetByFeatureGroup()->GetInputDataPointer(pFeatureGroup) + 
+         iSampleFirst / cItemsPerBitPackedDataUnit;
+      const FloatStorageType * pResidualError = pTrainingSet->GetDataSetByFeatureGroup()->GetResidualPointer<FloatStorageType>() + 
+         cVectorLength * iSampleFirst;
+
+      // this shouldn't overflow since we're accessing existing memory
+      const FloatStorageType * const pResidualErrorTrueEnd = pResidualError + cVectorLength * cSamples;
+      const FloatStorageType * pResidualErrorExit = pResidualErrorTrueEnd;
+      size_t cItemsRemaining = cSamples;
+      if(cSamples <= cItemsPerBitPackedDataUnit) {
+         goto one_last_loop;
+      }
+      pResidualErrorExit = pResidualErrorTrueEnd - cVectorLength * ((cSamples - 1) % cItemsPerBitPackedDataUnit + 1);
+      EBM_ASSERT(pResidualError < pResidualErrorExit);
+      EBM_ASSERT(pResidualErrorExit < pResidualErrorTrueEnd);
+
+      do {
+         // this loop gets about twice as slow if you add a single unpredictable branching if statement based on count, even if you still access all the memory
+         // in complete sequential order, so we'll probably want to use non-branching instructions for any solution like conditional selection or multiplication
+         // this loop gets about 3 times slower if you use a bad pseudo random number generator like rand(), although it might be better if you inlined rand().
+         // this loop gets about 10 times slower if you use a proper pseudo random number generator like std::default_random_engine
+         // taking all the above together, it seems unlikley we'll use a method of separating sets via single pass randomized set splitting.  Even if count is 
+         // stored in memory if shouldn't increase the time spent fetching it by 2 times, unless our bottleneck when threading is overwhelmingly memory pressure
+         // related, and even then we could store the count for a single bit aleviating the memory pressure greatly, if we use the right sampling method 
+
+         // TODO : try using a sampling method with non-repeating samples, and put the count into a bit.  Then unwind that loop either at the byte level 
+         //   (8 times) or the uint64_t level.  This can be done without branching and doesn't require random number generators
+
+         cItemsRemaining = cItemsPerBitPackedDataUnit;
+         // TODO : jumping back into this loop and changing cItemsRemaining to a dynamic value that isn't compile time determinable
+         // causes this function to NOT be optimized as much as it could if we had two separate loops.  We're just trying this out for now though
+      one_last_loop:;
+         // we store the already multiplied dimensional value in *pInputData
+         size_t iTensorBinCombined = static_cast<size_t>(*pInputData);
+         ++pInputData;
+         do {
+            const size_t iTensorBin = maskBits & iTensorBinCombined;
+
+            HistogramBucket<bClassification> * const pHistogramBucketEntry = GetHistogramBucketByIndex(
+               cBytesPerHistogramBucket,
+               aHistogramBuckets,
+               iTensorBin
+            );
+
+            ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pHistogramBucketEntry, aHistogramBucketsEndDebug);
+            const size_t cOccurences = *pCountOccurrences;
+            ++pCountOccurrences;
+            pHistogramBucketEntry->SetCountSamplesInBucket(pHistogramBucketEntry->GetCountSamplesInBucket() + cOccurences);
+            const FloatEbmType cFloatOccurences = static_cast<FloatEbmType>(cOccurences);
+            HistogramBucketVectorEntry<bClassification> * pHistogramBucketVectorEntry = 
+               pHistogramBucketEntry->GetHistogramBucketVectorEntry();
+
+            size_t iVector = 0;
+
+#ifndef NDEBUG
+#ifdef EXPAND_BINARY_LOGITS
+            constexpr bool bExpandBinaryLogits = true;
+#else // EXPAND_BINARY_LOGITS
+            constexpr bool bExpandBinaryLogits = false;
+#endif // EXPAND_BINARY_LOGITS
+            FloatEbmType residualTotalDebug = 0;
+#endif // NDEBUG
+            do {
+               const FloatEbmType residualError = *pResidualError;
+               EBM_ASSERT(
+                  !bClassification ||
+                  ptrdiff_t { 2 } == runtimeLearningTypeOrCountTargetClasses && !bExpandBinaryLogits ||
+                  static_cast<ptrdiff_t>(iVector) != k_iZeroResidual ||
+                  0 == residualError
+               );
+#ifndef NDEBUG
+               residualTotalDebug += residualError;
+#endif // NDEBUG
+               pHistogramBucketVectorEntry[iVector].m_sumResidualError += cFloatOccurences * residualError;
+               if(bClassification) {
+                  // TODO : this code gets executed for each SamplingSet set.  I could probably execute it once and then all the
+                  //   SamplingSet sets would have this value, but I would need to store the computation in a new memory place, and it might 
+                  //   make more sense to calculate this values in the CPU rather than put more pressure on memory.  I think controlling this should be 
+                  //   done in a MACRO and we should use a class to hold the residualError and this computation from that value and then comment out the 
+                  //   computation if not necssary and access it through an accessor so that we can make the change entirely via macro
+                  const FloatEbmType denominator = EbmStatistics::ComputeNewtonRaphsonStep(residualError);
+                  pHistogramBucketVectorEntry[iVector].SetSumDenominator(
+                     pHistogramBucketVectorEntry[iVector].GetSumDenominator() + cFloatOccurences * denominator
+                  );
+               }
+               ++pResidualError;
+               ++iVector;
+               // if we use this specific format where (iVector < cVectorLength) then the compiler collapses alway the loop for small cVectorLength values
+               // if we make this (iVector != cVectorLength) then the loop is not collapsed
+               // the compiler seems to not mind if we make this a for loop or do loop in terms of collapsing away the loop
+            } while(iVector < cVectorLength);
+
+            EBM_ASSERT(
+               !bClassification ||
+               ptrdiff_t { 2 } == runtimeLearningTypeOrCountTargetClasses && !bExpandBinaryLogits ||
+               0 <= k_iZeroResidual ||
+               -GetEpsilonResidualErrorTotal<FloatStorageType>(cVectorLength) < residualTotalDebug && 
+               residualTotalDebug < GetEpsilonResidualErrorTotal<FloatStorageType>(cVectorLength)
+            );
+
+            iTensorBinCombined >>= cBitsPerItemMax;
+            // TODO : try replacing cItemsRemaining with a pResidualErrorInnerLoopEnd which eliminates one subtact operation, but might make it harder for 
+            //   the compiler to optimize the loop away
+            --cItemsRemaining;
+         } while(0 != cItemsRemaining);
+      } while(pResidualErrorExit != pResidualError);
+
+      // first time through?
+      if(pResidualErrorTrueEnd != pResidualError) {
+         LOG_0(TraceLevelVerbose, "Handling last BinDataSetTraining loop");
+
+         EBM_ASSERT(0 == (pResidualErrorTrueEnd - pResidualError) % cVectorLength);
+         cItemsRemaining = (pResidualErrorTrueEnd - pResidualError) / cVectorLength;
+         EBM_ASSERT(0 < cItemsRemaining);
+         EBM_ASSERT(cItemsRemaining <= cItemsPerBitPackedDataUnit);
+
+         pResidualErrorExit = pResidualErrorTrueEnd;
+
+         goto one_last_loop;
+      }
+
+      LOG_0(TraceLevelVerbose, "Exited BinDataSetTraining");
+   }
+};
+
+// Regression and binary classification add a single residual to a bucket per sample, so consecutive samples in the
+// same bucket form one long chain of dependent floating point adds through memory.  Low cardinality feature groups
+// hit the same buckets constantly, so for those we keep k_cSubHistograms interleaved copies of the histogram on the 
+// stack.  The samples of a shard take turns going into the copies, which gives the CPU that many independent chains, 
+// and at the end we add the copies into our caller's buckets in order.  The turns continue across data units, so the 
+// copy of a sample depends only on its place in the shard and not on the bit packing.  A sample that a SamplingSet 
+// didn't draw would still take a turn though, so the sums would then depend on where the undrawn samples fall.  We 
+// only use the copies for SamplingSets where every sample occurs, which makes the sums the same as for a dataset 
+// holding just the drawn samples, for every CPU variant and thread count.  k_cBinsSubHistogramsMax covers the common
+// 8 bit packing (our default binning gives 256 bins) and keeps the copies within the L1 cache
+constexpr size_t k_cSubHistograms = 4;
+constexpr size_t k_cBinsSubHistogramsMax = 256;
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, size_t compilerCountItemsPerBitPackedDataUnit>
+class BinBoostingSubHistograms final {
+public:
+
+   BinBoostingSubHistograms() = delete; // this is a static class.  Do not construct
+
+   static void Func(
+      const FeatureGroup * const pFeatureGroup,
+      const SamplingSet * const pTrainingSet,
+      const size_t iSampleFirst,
+      const size_t cSamples,
+      const size_t cHistogramBuckets,
+      HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      static_assert(IsRegression(compilerLearningTypeOrCountTargetClasses) || 
+         IsBinaryClassification(compilerLearningTypeOrCountTargetClasses), "multiclass has more than one residual per sample");
+      constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+
+      LOG_0(TraceLevelVerbose, "Entered BinBoostingSubHistograms");
+
+      HistogramBucket<bClassification> * const aHistogramBuckets = aHistogramBucketBase->GetHistogramBucket<bClassification>();
+
+      const size_t cItemsPerBitPackedDataUnit = GET_COUNT_ITEMS_PER_BIT_PACKED_DATA_UNIT(
+         compilerCountItemsPerBitPackedDataUnit,
+         pFeatureGroup->GetCountItemsPerBitPackedDataUnit()
+      );
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+      EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, 1)); // we're accessing allocated memory
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, 1);
+
+      // we bin the samples [iSampleFirst, iSampleFirst + cSamples), which starts on a bit packed data unit boundary
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(0 == iSampleFirst % cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(iSampleFirst + cSamples <= pTrainingSet->GetDataSetByFeatureGroup()->GetCountSamples());
+      EBM_ASSERT(1 <= cHistogramBuckets);
+      EBM_ASSERT(cHistogramBuckets <= k_cBinsSubHistogramsMax);
+
+      // bucket iTensorBin of copy iSub is at index iTensorBin * k_cSubHistograms + iSub, so the copies of a bucket
+      // share cache lines.  With a vector length of 1 our bucket type has no hidden entries past its end
+      static_assert(sizeof(HistogramBucket<bClassification>) == sizeof(size_t) + sizeof(HistogramBucketVectorEntry<bClassification>),
+         "HistogramBucket needs to be exactly one vector entry for us to put it in an array");
+      const size_t cSubBuckets = cHistogramBuckets * k_cSubHistograms;
+      HistogramBucket<bClassification> aSubBuckets[k_cBinsSubHistogramsMax * k_cSubHistograms];
+      for(size_t iSubBucket = 0; iSubBucket < cSubBuckets; ++iSubBucket) {
+         aSubBuckets[iSubBucket].Zero(1);
+      }
+
+      const size_t * pCountOccurrences = pTrainingSet->GetCountOccurrences() + iSampleFirst;
+      const StorageDataType * pInputData = pTrainingSet->GetDataSetByFeatureGroup()->GetInputDataPointer(pFeatureGroup) + 
+         iSampleFirst / cItemsPerBitPackedDataUnit;
+      const FloatStorageType * pResidualError = pTrainingSet->GetDataSetByFeatureGroup()->GetResidualPointer<FloatStorageType>() + iSampleFirst;
+
+      // this shouldn't overflow since we're accessing existing memory
+      const FloatStorageType * const pResidualErrorTrueEnd = pResidualError + cSamples;
+      const FloatStorageType * pResidualErrorExit = pResidualErrorTrueEnd;
+      size_t iSubHistogram = 0;
+      size_t cItemsInDataUnit = cSamples;
+      if(cSamples <= cItemsPerBitPackedDataUnit) {
+         goto one_last_loop;
+      }
+      pResidualErrorExit = pResidualErrorTrueEnd - ((cSamples - 1) % cItemsPerBitPackedDataUnit + 1);
+      EBM_ASSERT(pResidualError < pResidualErrorExit);
+      EBM_ASSERT(pResidualErrorExit < pResidualErrorTrueEnd);
+
+      do {
+         cItemsInDataUnit = cItemsPerBitPackedDataUnit;
+      one_last_loop:;
+         // we store the already multiplied dimensional value in *pInputData
+         size_t iTensorBinCombined = static_cast<size_t>(*pInputData);
+         ++pInputData;
+         size_t iItem = 0;
+         do {
+            const size_t iTensorBin = maskBits & iTensorBinCombined;
+            EBM_ASSERT(iTensorBin < cHistogramBuckets);
+            HistogramBucket<bClassification> * const pSubBucket = 
+               &aSubBuckets[iTensorBin * k_cSubHistograms + iSubHistogram];
+            iSubHistogram = (iSubHistogram + size_t { 1 }) % k_cSubHistograms;
+
+            const size_t cOccurences = *pCountOccurrences;
+            EBM_ASSERT(size_t { 1 } <= cOccurences); // our caller only uses us if every sample occurs
+            ++pCountOccurrences;
+            pSubBucket->SetCountSamplesInBucket(pSubBucket->GetCountSamplesInBucket() + cOccurences);
+            const FloatEbmType cFloatOccurences = static_cast<FloatEbmType>(cOccurences);
+            HistogramBucketVectorEntry<bClassification> * const pHistogramBucketVectorEntry = 
+               pSubBucket->GetHistogramBucketVectorEntry();
+
+            const FloatEbmType residualError = *pResidualError;
+            ++pResidualError;
+            pHistogramBucketVectorEntry->m_sumResidualError += cFloatOccurences * residualError;
+            if(bClassification) {
+               const FloatEbmType denominator = EbmStatistics::ComputeNewtonRaphsonStep(residualError);
+               pHistogramBucketVectorEntry->SetSumDenominator(
+                  pHistogramBucketVectorEntry->GetSumDenominator() + cFloatOccurences * denominator
+               );
+            }
+
+            // items have at most 8 bits here, so we never shift by the full width
+            iTensorBinCombined >>= cBitsPerItemMax;
+            ++iItem;
+         } while(cItemsInDataUnit != iItem);
+      } while(pResidualErrorExit != pResidualError);
+
+      // first time through?
+      if(pResidualErrorTrueEnd != pResidualError) {
+         cItemsInDataUnit = pResidualErrorTrueEnd - pResidualError;
+         EBM_ASSERT(0 < cItemsInDataUnit);
+         EBM_ASSERT(cItemsInDataUnit <= cItemsPerBitPackedDataUnit);
+
+         pResidualErrorExit = pResidualErrorTrueEnd;
+
+         goto one_last_loop;
+      }
+
+      size_t iSubBucket = 0;
+      for(size_t iTensorBin = 0; iTensorBin < cHistogramBuckets; ++iTensorBin) {
+         HistogramBucket<bClassification> * const pHistogramBucketEntry = GetHistogramBucketByIndex(
+            cBytesPerHistogramBucket,
+            aHistogramBuckets,
+            iTensorBin
+         );
+         ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pHistogramBucketEntry, aHistogramBucketsEndDebug);
+         const size_t iSubBucketEnd = iSubBucket + k_cSubHistograms;
+         do {
+            pHistogramBucketEntry->Add(aSubBuckets[iSubBucket], 1);
+            ++iSubBucket;
+         } while(iSubBucketEnd != iSubBucket);
+      }
+
+      LOG_0(TraceLevelVerbose, "Exited BinBoostingSubHistograms");
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+class BinBoostingSubHistogramsPacking final {
+public:
+
+   BinBoostingSubHistogramsPacking() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      const FeatureGroup * const pFeatureGroup,
+      const SamplingSet * const pTrainingSet,
+      const size_t iSampleFirst,
+      const size_t cSamples,
+      const size_t cHistogramBuckets,
+      HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      // 8 items of 8 bits each is by far the most common packing, so it gets a compile time specialization.  With a 
+      // constant shift and mask the compiler can extract the bytes directly instead of shifting in a loop
+      constexpr size_t k_cItemsPerBitPackedDataUnitByte = k_cBitsForStorageType / 8;
+      if(k_cItemsPerBitPackedDataUnitByte == pFeatureGroup->GetCountItemsPerBitPackedDataUnit()) {
+         BinBoostingSubHistograms<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitByte>::Func(
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleFirst,
+            cSamples,
+            cHistogramBuckets,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         BinBoostingSubHistograms<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleFirst,
+            cSamples,
+            cHistogramBuckets,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
+class BinBoostingNormalTarget final {
+public:
+
+   BinBoostingNormalTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const SamplingSet * const pTrainingSet,
+      const size_t iSampleFirst,
+      const size_t cSamples,
+      HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      static_assert(IsClassification(compilerLearningTypeOrCountTargetClassesPossible), "compilerLearningTypeOrCountTargetClassesPossible needs to be a classification");
+      static_assert(compilerLearningTypeOrCountTargetClassesPossible <= k_cCompilerOptimizedTargetClassesMax, "We can't have this many items in a data pack.");
+
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
+      EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
+      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+
+      if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
+         BinBoostingInternal<compilerLearningTypeOrCountTargetClassesPossible, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+            pBooster,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleFirst,
+            cSamples,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         BinBoostingNormalTarget<compilerLearningTypeOrCountTargetClassesPossible + 1>::Func(
+            pBooster,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleFirst,
+            cSamples,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
+};
+
+template<>
+class BinBoostingNormalTarget<k_cCompilerOptimizedTargetClassesMax + 1> final {
+public:
+
+   BinBoostingNormalTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      Booster * const pBooster,
+      const FeatureGroup * const pFeatureGroup,
+      const SamplingSet * const pTrainingSet,
+      const size_t iSampleFirst,
+      const size_t cSamples,
+      HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      static_assert(IsClassification(k_cCompilerOptimizedTargetClassesMax), "k_cCompilerOptimizedTargetClassesMax needs to be a classification");
+
+      EBM_ASSERT(IsClassification(pBooster->GetRuntimeLearningTypeOrCountTargetClasses()));
+      EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pBooster->GetRuntimeLearningTypeOrCountTargetClasses());
+
+      BinBoostingInternal<k_dynamicClassification, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+         pBooster,
+         pFeatureGroup,
+         pTrainingSet,
+         iSampleFirst,
+         cSamples,
+         aHistogramBucketBase
+#ifndef NDEBUG
+         , aHistogramBucketsEndDebug
+#endif // NDEBUG
+      );
+   }
+};
+
+static void BinBoostingShard(
+   Booster * const pBooster,
+   const FeatureGroup * const pFeatureGroup,
+   const SamplingSet * const pTrainingSet,
+   const size_t iSampleFirst,
+   const size_t cSamples,
+   HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+   , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+) {
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
+
+   EBM_ASSERT(1 <= pFeatureGroup->GetCountFeatures());
+#ifdef EXPAND_BINARY_LOGITS
+   // binary classification has 2 residuals per sample then, which the sub-histograms don't handle
+   constexpr bool bSubHistogramsBinary = false;
+#else // EXPAND_BINARY_LOGITS
+   constexpr bool bSubHistogramsBinary = true;
+#endif // EXPAND_BINARY_LOGITS
+   const size_t cHistogramBuckets = GetCountMainHistogramBuckets(pFeatureGroup);
+   const bool bSubHistograms = cHistogramBuckets <= k_cBinsSubHistogramsMax && !pTrainingSet->HasZeroCountSamples();
+   if(bSubHistograms && IsRegression(runtimeLearningTypeOrCountTargetClasses)) {
+      BinBoostingSubHistogramsPacking<k_regression>::Func(
+         pFeatureGroup,
+         pTrainingSet,
+         iSampleFirst,
+         cSamples,
+         cHistogramBuckets,
+         aHistogramBucketBase
+#ifndef NDEBUG
+         , aHistogramBucketsEndDebug
+#endif // NDEBUG
+      );
+   } else if(bSubHistogramsBinary && bSubHistograms && IsBinaryClassification(runtimeLearningTypeOrCountTargetClasses)) {
+      BinBoostingSubHistogramsPacking<2>::Func(
+         pFeatureGroup,
+         pTrainingSet,
+         iSampleFirst,
+         cSamples,
+         cHistogramBuckets,
+         aHistogramBucketBase
+#ifndef NDEBUG
+         , aHistogramBucketsEndDebug
+#endif // NDEBUG
+      );
+   } else {
+      // there isn't much benefit in eliminating the loop that unpacks a data unit unless we're also unpacking that to SIMD code
+      // Our default packing structure is to bin continuous values to 256 values, and we have 64 bit packing structures, so we usually
+      // have more than 8 values per memory fetch.  Eliminating the inner loop for multiclass is valuable since we can have low numbers like 3 class,
+      // 4 class, etc, but by the time we get to 8 loops with exp inside and a lot of other instructures we should worry that our code expansion
+      // will exceed the L1 instruction cache size.  With SIMD we do 8 times the work in the same number of instructions so these are lesser issues
+
+      if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
+         BinBoostingNormalTarget<2>::Func(
+            pBooster,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleFirst,
+            cSamples,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
+         BinBoostingInternal<k_regression, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+            pBooster,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleFirst,
+            cSamples,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
+}
@@ -0,0 +1,273 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <type_traits> // std::is_standard_layout
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "Threading.h"
+
+struct FeaturesBinCutsTaskContext {
+
+   FeaturesBinCutsTaskContext() = default; // preserve our POD status
+   ~FeaturesBinCutsTaskContext() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   size_t m_cSamples;
+   const FloatEbmType * m_aFeatureValues;
+   const BinningMethodType * m_aBinningMethods;
+   const IntEbmType * m_aCountSamplesPerBinMin;
+   // the position in m_aBinCutsLowerBoundInclusive of the first cut of each feature
+   const size_t * m_aiBinCutFirst;
+   IntEbmType * m_aCountBinCuts;
+   FloatEbmType * m_aBinCutsLowerBoundInclusive;
+   IntEbmType * m_aCountMissingValues;
+   FloatEbmType * m_aMinNonInfinityValue;
+   IntEbmType * m_aCountNegativeInfinity;
+   FloatEbmType * m_aMaxNonInfinityValue;
+   IntEbmType * m_aCountPositiveInfinity;
+   // one per thread so that the tasks don't need to synchronize
+   IntEbmType * m_aThreadResults;
+};
+static_assert(std::is_standard_layout<FeaturesBinCutsTaskContext>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<FeaturesBinCutsTaskContext>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<FeaturesBinCutsTaskContext>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+// each feature is one task.  Sorting a column dwarfs the cost of handing out a task, and the binning functions
+// only write to their own outputs, so the features can be binned in any order on any thread
+static void FeaturesBinCutsTask(void * const pContext, const size_t iThread, const size_t iFeature) {
+   const FeaturesBinCutsTaskContext * const pTaskContext = static_cast<const FeaturesBinCutsTaskContext *>(pContext);
+
+   const size_t cSamples = pTaskContext->m_cSamples;
+   // our caller checked that cSamples fits into an IntEbmType
+   const IntEbmType countSamples = static_cast<IntEbmType>(cSamples);
+   const FloatEbmType * const aFeatureValues = pTaskContext->m_aFeatureValues + cSamples * iFeature;
+   FloatEbmType * const aBinCutsLowerBoundInclusive =
+      pTaskContext->m_aBinCutsLowerBoundInclusive + pTaskContext->m_aiBinCutFirst[iFeature];
+
+   IntEbmType * const pCountBinCuts = &pTaskContext->m_aCountBinCuts[iFeature];
+   IntEbmType * const pCountMissingValues = &pTaskContext->m_aCountMissingValues[iFeature];
+   FloatEbmType * const pMinNonInfinityValue = &pTaskContext->m_aMinNonInfinityValue[iFeature];
+   IntEbmType * const pCountNegativeInfinity = &pTaskContext->m_aCountNegativeInfinity[iFeature];
+   FloatEbmType * const pMaxNonInfinityValue = &pTaskContext->m_aMaxNonInfinityValue[iFeature];
+   IntEbmType * const pCountPositiveInfinity = &pTaskContext->m_aCountPositiveInfinity[iFeature];
+
+   const BinningMethodType binningMethod = pTaskContext->m_aBinningMethods[iFeature];
+
+   IntEbmType ret = IntEbmType { 0 };
+   if(BinningMethod_Quantile == binningMethod || BinningMethod_QuantileHumanized == binningMethod) {
+      const IntEbmType countSamplesPerBinMin = nullptr == pTaskContext->m_aCountSamplesPerBinMin ?
+         IntEbmType { 1 } : pTaskContext->m_aCountSamplesPerBinMin[iFeature];
+      ret = GenerateQuantileBinCuts(
+         countSamples,
+         aFeatureValues,
+         countSamplesPerBinMin,
+         BinningMethod_QuantileHumanized == binningMethod ? EBM_TRUE : EBM_FALSE,
+         pCountBinCuts,
+         aBinCutsLowerBoundInclusive,
+         pCountMissingValues,
+         pMinNonInfinityValue,
+         pCountNegativeInfinity,
+         pMaxNonInfinityValue,
+         pCountPositiveInfinity
+      );
+   } else if(BinningMethod_Uniform == binningMethod) {
+      GenerateUniformBinCuts(
+         countSamples,
+         aFeatureValues,
+         pCountBinCuts,
+         aBinCutsLowerBoundInclusive,
+         pCountMissingValues,
+         pMinNonInfinityValue,
+         pCountNegativeInfinity,
+         pMaxNonInfinityValue,
+         pCountPositiveInfinity
+      );
+   } else {
+      // our caller checked that every binning method is one that we know
+      EBM_ASSERT(BinningMethod_Winsorized == binningMethod);
+      ret = GenerateWinsorizedBinCuts(
+         countSamples,
+         aFeatureValues,
+         pCountBinCuts,
+         aBinCutsLowerBoundInclusive,
+         pCountMissingValues,
+         pMinNonInfinityValue,
+         pCountNegativeInfinity,
+         pMaxNonInfinityValue,
+         pCountPositiveInfinity
+      );
+   }
+   if(IntEbmType { 0 } != ret) {
+      pTaskContext->m_aThreadResults[iThread] = ret;
+   }
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateFeaturesBinCuts(
+   IntEbmType countThreads,
+   IntEbmType countFeatures,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   const BinningMethodType * binningMethods,
+   const IntEbmType * countSamplesPerBinMin,
+   const IntEbmType * countBinCutsMax,
+   IntEbmType * countBinCutsOut,
+   FloatEbmType * binCutsLowerBoundInclusiveOut,
+   IntEbmType * countMissingValuesOut,
+   FloatEbmType * minNonInfinityValueOut,
+   IntEbmType * countNegativeInfinityOut,
+   FloatEbmType * maxNonInfinityValueOut,
+   IntEbmType * countPositiveInfinityOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered GenerateFeaturesBinCuts: countThreads=%" IntEbmTypePrintf ", countFeatures=%" IntEbmTypePrintf
+      ", countSamples=%" IntEbmTypePrintf ", featureValues=%p, binningMethods=%p, countSamplesPerBinMin=%p"
+      ", countBinCutsMax=%p, countBinCutsOut=%p, binCutsLowerBoundInclusiveOut=%p, countMissingValuesOut=%p"
+      ", minNonInfinityValueOut=%p, countNegativeInfinityOut=%p, maxNonInfinityValueOut=%p"
+      ", countPositiveInfinityOut=%p",
+      countThreads,
+      countFeatures,
+      countSamples,
+      static_cast<const void *>(featureValues),
+      static_cast<const void *>(binningMethods),
+      static_cast<const void *>(countSamplesPerBinMin),
+      static_cast<const void *>(countBinCutsMax),
+      static_cast<void *>(countBinCutsOut),
+      static_cast<void *>(binCutsLowerBoundInclusiveOut),
+      static_cast<void *>(countMissingValuesOut),
+      static_cast<void *>(minNonInfinityValueOut),
+      static_cast<void *>(countNegativeInfinityOut),
+      static_cast<void *>(maxNonInfinityValueOut),
+      static_cast<void *>(countPositiveInfinityOut)
+   );
+
+   if(countThreads < 0) {
+      LOG_0(TraceLevelError, "ERROR GenerateFeaturesBinCuts countThreads must be positive");
+      return 1;
+   }
+   if(countFeatures < 0) {
+      LOG_0(TraceLevelError, "ERROR GenerateFeaturesBinCuts countFeatures must be positive");
+      return 1;
+   }
+   if(countSamples < 0) {
+      LOG_0(TraceLevelError, "ERROR GenerateFeaturesBinCuts countSamples must be positive");
+      return 1;
+   }
+   if(0 == countFeatures) {
+      LOG_0(TraceLevelInfo, "Exited GenerateFeaturesBinCuts with no features");
+      return 0;
+   }
+   if(nullptr == binningMethods || nullptr == countBinCutsMax || nullptr == countBinCutsOut ||
+      nullptr == countMissingValuesOut || nullptr == minNonInfinityValueOut || nullptr == countNegativeInfinityOut ||
+      nullptr == maxNonInfinityValueOut || nullptr == countPositiveInfinityOut
+   ) {
+      LOG_0(TraceLevelError, "ERROR GenerateFeaturesBinCuts only featureValues, countSamplesPerBinMin and binCutsLowerBoundInclusiveOut can be nullptr");
+      return 1;
+   }
+   if(0 != countSamples && nullptr == featureValues) {
+      LOG_0(TraceLevelError, "ERROR GenerateFeaturesBinCuts featureValues cannot be nullptr if there are samples");
+      return 1;
+   }
+   if(!IsNumberConvertable<size_t>(countFeatures) || !IsNumberConvertable<size_t>(countSamples) ||
+      IsMultiplyError(static_cast<size_t>(countFeatures), static_cast<size_t>(countSamples)) ||
+      IsMultiplyError(static_cast<size_t>(countFeatures), sizeof(size_t))
+   ) {
+      LOG_0(TraceLevelError, "ERROR GenerateFeaturesBinCuts countFeatures * countSamples too large to index");
+      return 1;
+   }
+   const size_t cFeatures = static_cast<size_t>(countFeatures);
+   const size_t cSamples = static_cast<size_t>(countSamples);
+
+   size_t * const aiBinCutFirst = EbmMalloc<size_t>(cFeatures);
+   if(nullptr == aiBinCutFirst) {
+      LOG_0(TraceLevelWarning, "WARNING GenerateFeaturesBinCuts nullptr == aiBinCutFirst");
+      return 1;
+   }
+   size_t cBinCuts = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const BinningMethodType binningMethod = binningMethods[iFeature];
+      if(BinningMethod_Quantile != binningMethod && BinningMethod_QuantileHumanized != binningMethod &&
+         BinningMethod_Uniform != binningMethod && BinningMethod_Winsorized != binningMethod
+      ) {
+         LOG_0(TraceLevelError, "ERROR GenerateFeaturesBinCuts binningMethods must be BinningMethod_* values");
+         free(aiBinCutFirst);
+         return 1;
+      }
+      const IntEbmType countBinCutsMaxFeature = countBinCutsMax[iFeature];
+      if(countBinCutsMaxFeature < 0) {
+         LOG_0(TraceLevelError, "ERROR GenerateFeaturesBinCuts countBinCutsMax cannot contain negative numbers");
+         free(aiBinCutFirst);
+         return 1;
+      }
+      if(!IsNumberConvertable<size_t>(countBinCutsMaxFeature) ||
+         IsAddError(cBinCuts, static_cast<size_t>(countBinCutsMaxFeature))
+      ) {
+         LOG_0(TraceLevelError, "ERROR GenerateFeaturesBinCuts countBinCutsMax too large to index");
+         free(aiBinCutFirst);
+         return 1;
+      }
+      aiBinCutFirst[iFeature] = cBinCuts;
+      // the binning functions read the maximum from the count and then overwrite it with the number they used
+      countBinCutsOut[iFeature] = countBinCutsMaxFeature;
+      cBinCuts += static_cast<size_t>(countBinCutsMaxFeature);
+   }
+   if(0 != cBinCuts && nullptr == binCutsLowerBoundInclusiveOut) {
+      LOG_0(TraceLevelError, "ERROR GenerateFeaturesBinCuts binCutsLowerBoundInclusiveOut cannot be nullptr if there are cuts");
+      free(aiBinCutFirst);
+      return 1;
+   }
+
+   // 0 == countThreads means use the whole thread pool
+   size_t cThreads = IntEbmType { 0 } == countThreads || !IsNumberConvertable<size_t>(countThreads) ?
+      GetThreadPoolSize() : static_cast<size_t>(countThreads);
+   cThreads = EbmMin(cThreads, cFeatures);
+
+   IntEbmType * const aThreadResults = EbmMalloc<IntEbmType>(cThreads);
+   if(nullptr == aThreadResults) {
+      LOG_0(TraceLevelWarning, "WARNING GenerateFeaturesBinCuts nullptr == aThreadResults");
+      free(aiBinCutFirst);
+      return 1;
+   }
+   for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+      aThreadResults[iThread] = 0;
+   }
+
+   FeaturesBinCutsTaskContext taskContext;
+   taskContext.m_cSamples = cSamples;
+   taskContext.m_aFeatureValues = featureValues;
+   taskContext.m_aBinningMethods = binningMethods;
+   taskContext.m_aCountSamplesPerBinMin = countSamplesPerBinMin;
+   taskContext.m_aiBinCutFirst = aiBinCutFirst;
+   taskContext.m_aCountBinCuts = countBinCutsOut;
+   taskContext.m_aBinCutsLowerBoundInclusive = binCutsLowerBoundInclusiveOut;
+   taskContext.m_aCountMissingValues = countMissingValuesOut;
+   taskContext.m_aMinNonInfinityValue = minNonInfinityValueOut;
+   taskContext.m_aCountNegativeInfinity = countNegativeInfinityOut;
+   taskContext.m_aMaxNonInfinityValue = maxNonInfinityValueOut;
+   taskContext.m_aCountPositiveInfinity = countPositiveInfinityOut;
+   taskContext.m_aThreadResults = aThreadResults;
+   RunParallelTasks(cThreads, cFeatures, FeaturesBinCutsTask, &taskContext);
+
+   IntEbmType ret = 0;
+   for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+      if(0 != aThreadResults[iThread]) {
+         ret = aThreadResults[iThread];
+      }
+   }
+
+   free(aThreadResults);
+   free(aiBinCutFirst);
+
+   LOG_N(TraceLevelInfo, "Exited GenerateFeaturesBinCuts %" IntEbmTypePrintf, ret);
+   return ret;
+}
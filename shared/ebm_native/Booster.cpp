@@ -5,6 +5,7 @@
 #include "PrecompiledHeader.h"
 
 #include <stdlib.h> // free
+#include <string.h> // memcpy
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // numeric_limits
 
@@ -24,6 +25,7 @@
 // samples is somewhat independent from datasets, but relies on an indirect coupling with them
 #include "SamplingSet.h"
 #include "TreeSweep.h"
+#include "Threading.h"
 
 #include "Booster.h"
 
@@ -35,6 +37,43 @@ extern void InitializeResiduals(
    FloatEbmType * const aTempFloatVector,
    FloatEbmType * pResidualError
 );
+extern void InitializeResiduals(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const size_t cSamples,
+   const void * const aTargetData,
+   const FloatEbmType * const aPredictorScores,
+   FloatEbmType * const aTempFloatVector,
+   float * pResidualError
+);
+
+static void InitializeResidualsDataSet(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const size_t cSamples,
+   const void * const aTargetData,
+   const FloatEbmType * const aPredictorScores,
+   FloatEbmType * const aTempFloatVector,
+   DataSetByFeatureGroup * const pDataSet
+) {
+   if(pDataSet->IsFloat32Storage()) {
+      InitializeResiduals(
+         runtimeLearningTypeOrCountTargetClasses,
+         cSamples,
+         aTargetData,
+         aPredictorScores,
+         aTempFloatVector,
+         pDataSet->GetResidualPointer<float>()
+      );
+   } else {
+      InitializeResiduals(
+         runtimeLearningTypeOrCountTargetClasses,
+         cSamples,
+         aTargetData,
+         aPredictorScores,
+         aTempFloatVector,
+         pDataSet->GetResidualPointer<FloatEbmType>()
+      );
+   }
+}
 
 INLINE_ALWAYS static size_t GetCountItemsBitPacked(const size_t cBits) {
    EBM_ASSERT(size_t { 1 } <= cBits);
@@ -146,6 +185,51 @@ void Booster::Free(Booster * const pBooster) {
    LOG_0(TraceLevelInfo, "Exited Booster::Free");
 }
 
+Booster * Booster::AllocateWorker(const Booster * const pBooster) {
+   LOG_0(TraceLevelInfo, "Entered Booster::AllocateWorker");
+
+   EBM_ASSERT(nullptr != pBooster);
+   Booster * const pWorker = EbmMalloc<Booster>();
+   if(UNLIKELY(nullptr == pWorker)) {
+      LOG_0(TraceLevelWarning, "WARNING Booster::AllocateWorker nullptr == pWorker");
+      return nullptr;
+   }
+   // Booster is POD, so the worker can point to all the same features, data and models
+   memcpy(pWorker, pBooster, sizeof(*pWorker));
+   pWorker->m_pSmallChangeToModelOverwriteSingleSamplingSet = nullptr;
+   pWorker->m_pSmallChangeToModelAccumulatedFromSamplingSets = nullptr;
+   pWorker->m_pCachedThreadResources = nullptr;
+
+   const size_t cVectorLength = GetVectorLength(pBooster->m_runtimeLearningTypeOrCountTargetClasses);
+   pWorker->m_pSmallChangeToModelOverwriteSingleSamplingSet = SegmentedTensor::Allocate(k_cDimensionsMax, cVectorLength);
+   pWorker->m_pSmallChangeToModelAccumulatedFromSamplingSets = SegmentedTensor::Allocate(k_cDimensionsMax, cVectorLength);
+   pWorker->m_pCachedThreadResources = CachedBoostingThreadResources::Allocate(
+      pBooster->m_runtimeLearningTypeOrCountTargetClasses,
+      pBooster->m_cBytesArrayEquivalentSplitMax
+   );
+   if(UNLIKELY(nullptr == pWorker->m_pSmallChangeToModelOverwriteSingleSamplingSet) ||
+      UNLIKELY(nullptr == pWorker->m_pSmallChangeToModelAccumulatedFromSamplingSets) ||
+      UNLIKELY(nullptr == pWorker->m_pCachedThreadResources)
+   ) {
+      LOG_0(TraceLevelWarning, "WARNING Booster::AllocateWorker out of memory");
+      FreeWorker(pWorker);
+      return nullptr;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited Booster::AllocateWorker");
+   return pWorker;
+}
+
+void Booster::FreeWorker(Booster * const pWorker) {
+   if(nullptr != pWorker) {
+      // everything else belongs to the Booster that we were made from
+      CachedBoostingThreadResources::Free(pWorker->m_pCachedThreadResources);
+      SegmentedTensor::Free(pWorker->m_pSmallChangeToModelOverwriteSingleSamplingSet);
+      SegmentedTensor::Free(pWorker->m_pSmallChangeToModelAccumulatedFromSamplingSets);
+      free(pWorker);
+   }
+}
+
 Booster * Booster::Allocate(
    const SeedEbmType randomSeed,
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
@@ -153,6 +237,7 @@ Booster * Booster::Allocate(
    const size_t cFeatureGroups,
    const size_t cSamplingSets,
    const FloatEbmType * const optionalTempParams,
+   const bool bFloat32Storage,
    const BoolEbmType * const aFeaturesCategorical,
    const IntEbmType * const aFeaturesBinCount,
    const IntEbmType * const aFeatureGroupsFeatureCount,
@@ -166,7 +251,10 @@ Booster * Booster::Allocate(
    const void * const aValidationTargets, 
    const IntEbmType * const aValidationBinnedData, 
    const FloatEbmType * const aValidationWeights,
-   const FloatEbmType * const aValidationPredictorScores
+   const FloatEbmType * const aValidationPredictorScores,
+   DataSetByFeatureGroup * const pDataSetShared,
+   const size_t * const aiTrainingSharedSamples,
+   const size_t * const aiValidationSharedSamples
 ) {
    // optionalTempParams isn't used by default.  It's meant to provide an easy way for python or other higher
    // level languages to pass EXPERIMENTAL temporary parameters easily to the C++ code.
@@ -440,6 +528,7 @@ Booster * Booster::Allocate(
    }
    LOG_0(TraceLevelInfo, "Booster::Initialize finished feature group processing");
 
+   pBooster->m_cBytesArrayEquivalentSplitMax = cBytesArrayEquivalentSplitMax;
    pBooster->m_pCachedThreadResources = CachedBoostingThreadResources::Allocate(
       runtimeLearningTypeOrCountTargetClasses,
       cBytesArrayEquivalentSplitMax
@@ -450,38 +539,73 @@ Booster * Booster::Allocate(
       return nullptr;
    }
 
-   if(pBooster->m_trainingSet.Initialize(
-      true, 
-      bClassification, 
-      bClassification, 
-      cFeatureGroups, 
-      pBooster->m_apFeatureGroups,
-      cTrainingSamples, 
-      aTrainingBinnedData, 
-      aTrainingTargets, 
-      aTrainingPredictorScores, 
-      runtimeLearningTypeOrCountTargetClasses
-   )) {
-      LOG_0(TraceLevelWarning, "WARNING Booster::Initialize m_trainingSet.Initialize");
-      Booster::Free(pBooster);
-      return nullptr;
-   }
+   if(nullptr != pDataSetShared) {
+      // pDataSetShared was bit packed once from the data of all the boosters made together, with the same feature 
+      // groups as ours, so we only keep our own residuals, scores, and the shared samples that we use
+      if(pBooster->m_trainingSet.InitializeView(
+         true,
+         bClassification,
+         pDataSetShared,
+         cTrainingSamples,
+         aiTrainingSharedSamples,
+         aTrainingPredictorScores,
+         runtimeLearningTypeOrCountTargetClasses,
+         bFloat32Storage
+      )) {
+         LOG_0(TraceLevelWarning, "WARNING Booster::Initialize m_trainingSet.InitializeView");
+         Booster::Free(pBooster);
+         return nullptr;
+      }
+      if(pBooster->m_validationSet.InitializeView(
+         !bClassification,
+         bClassification,
+         pDataSetShared,
+         cValidationSamples,
+         aiValidationSharedSamples,
+         aValidationPredictorScores,
+         runtimeLearningTypeOrCountTargetClasses,
+         bFloat32Storage
+      )) {
+         LOG_0(TraceLevelWarning, "WARNING Booster::Initialize m_validationSet.InitializeView");
+         Booster::Free(pBooster);
+         return nullptr;
+      }
+   } else {
+      if(pBooster->m_trainingSet.Initialize(
+         true, 
+         bClassification, 
+         bClassification, 
+         cFeatureGroups, 
+         pBooster->m_apFeatureGroups,
+         cTrainingSamples, 
+         aTrainingBinnedData, 
+         aTrainingTargets, 
+         aTrainingPredictorScores, 
+         runtimeLearningTypeOrCountTargetClasses,
+         bFloat32Storage
+      )) {
+         LOG_0(TraceLevelWarning, "WARNING Booster::Initialize m_trainingSet.Initialize");
+         Booster::Free(pBooster);
+         return nullptr;
+      }
 
-   if(pBooster->m_validationSet.Initialize(
-      !bClassification, 
-      bClassification, 
-      bClassification, 
-      cFeatureGroups, 
-      pBooster->m_apFeatureGroups,
-      cValidationSamples, 
-      aValidationBinnedData, 
-      aValidationTargets, 
-      aValidationPredictorScores, 
-      runtimeLearningTypeOrCountTargetClasses
-   )) {
-      LOG_0(TraceLevelWarning, "WARNING Booster::Initialize m_validationSet.Initialize");
-      Booster::Free(pBooster);
-      return nullptr;
+      if(pBooster->m_validationSet.Initialize(
+         !bClassification, 
+         bClassification, 
+         bClassification, 
+         cFeatureGroups, 
+         pBooster->m_apFeatureGroups,
+         cValidationSamples, 
+         aValidationBinnedData, 
+         aValidationTargets, 
+         aValidationPredictorScores, 
+         runtimeLearningTypeOrCountTargetClasses,
+         bFloat32Storage
+      )) {
+         LOG_0(TraceLevelWarning, "WARNING Booster::Initialize m_validationSet.Initialize");
+         Booster::Free(pBooster);
+         return nullptr;
+      }
    }
 
    pBooster->m_randomStream.InitializeUnsigned(randomSeed, k_boosterRandomizationMix);
@@ -489,7 +613,11 @@ Booster * Booster::Allocate(
    EBM_ASSERT(nullptr == pBooster->m_apSamplingSets);
    if(0 != cTrainingSamples) {
       pBooster->m_cSamplingSets = cSamplingSets;
-      pBooster->m_apSamplingSets = SamplingSet::GenerateSamplingSets(&pBooster->m_randomStream, &pBooster->m_trainingSet, cSamplingSets);
+      pBooster->m_apSamplingSets = SamplingSet::GenerateSamplingSets(
+         &pBooster->m_randomStream, 
+         &pBooster->m_trainingSet, 
+         cSamplingSets
+      );
       if(UNLIKELY(nullptr == pBooster->m_apSamplingSets)) {
          LOG_0(TraceLevelWarning, "WARNING Booster::Initialize nullptr == m_apSamplingSets");
          Booster::Free(pBooster);
@@ -499,35 +627,35 @@ Booster * Booster::Allocate(
 
    if(bClassification) {
       if(0 != cTrainingSamples) {
-         InitializeResiduals(
+         InitializeResidualsDataSet(
             runtimeLearningTypeOrCountTargetClasses,
             cTrainingSamples,
             aTrainingTargets,
             aTrainingPredictorScores,
             pBooster->GetCachedThreadResources()->GetTempFloatVector(),
-            pBooster->m_trainingSet.GetResidualPointer()
+            &pBooster->m_trainingSet
          );
       }
    } else {
       EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
       if(0 != cTrainingSamples) {
-         InitializeResiduals(
+         InitializeResidualsDataSet(
             k_regression,
             cTrainingSamples,
             aTrainingTargets,
             aTrainingPredictorScores,
             nullptr,
-            pBooster->m_trainingSet.GetResidualPointer()
+            &pBooster->m_trainingSet
          );
       }
       if(0 != cValidationSamples) {
-         InitializeResiduals(
+         InitializeResidualsDataSet(
             k_regression,
             cValidationSamples,
             aValidationTargets,
             aValidationPredictorScores,
             nullptr,
-            pBooster->m_validationSet.GetResidualPointer()
+            &pBooster->m_validationSet
          );
       }
    }
@@ -562,7 +690,11 @@ static Booster * AllocateBoosting(
    const FloatEbmType * const aValidationWeights, 
    const FloatEbmType * const validationPredictorScores,
    const IntEbmType countInnerBags,
-   const FloatEbmType * const optionalTempParams
+   const FloatEbmType * const optionalTempParams,
+   const bool bFloat32Storage,
+   DataSetByFeatureGroup * const pDataSetShared,
+   const size_t * const aiTrainingSharedSamples,
+   const size_t * const aiValidationSharedSamples
 ) {
    // TODO : give AllocateBoosting the same calling parameter order as CreateClassificationBooster
 
@@ -597,7 +729,7 @@ static Booster * AllocateBoosting(
       LOG_0(TraceLevelError, "ERROR AllocateBoosting trainingTargets cannot be nullptr if 0 < countTrainingSamples");
       return nullptr;
    }
-   if(0 != countTrainingSamples && 0 != countFeatures && nullptr == trainingBinnedData) {
+   if(nullptr == pDataSetShared && 0 != countTrainingSamples && 0 != countFeatures && nullptr == trainingBinnedData) {
       LOG_0(TraceLevelError, "ERROR AllocateBoosting trainingBinnedData cannot be nullptr if 0 < countTrainingSamples AND 0 < countFeatures");
       return nullptr;
    }
@@ -613,7 +745,7 @@ static Booster * AllocateBoosting(
       LOG_0(TraceLevelError, "ERROR AllocateBoosting validationTargets cannot be nullptr if 0 < countValidationSamples");
       return nullptr;
    }
-   if(0 != countValidationSamples && 0 != countFeatures && nullptr == validationBinnedData) {
+   if(nullptr == pDataSetShared && 0 != countValidationSamples && 0 != countFeatures && nullptr == validationBinnedData) {
       LOG_0(TraceLevelError, "ERROR AllocateBoosting validationBinnedData cannot be nullptr if 0 < countValidationSamples AND 0 < countFeatures");
       return nullptr;
    }
@@ -679,6 +811,7 @@ static Booster * AllocateBoosting(
       cFeatureGroups,
       cInnerBags,
       optionalTempParams,
+      bFloat32Storage,
       aFeaturesCategorical,
       aFeaturesBinCount,
       aFeatureGroupsFeatureCount,
@@ -692,7 +825,10 @@ static Booster * AllocateBoosting(
       validationTargets,
       validationBinnedData,
       aValidationWeights,
-      validationPredictorScores
+      validationPredictorScores,
+      pDataSetShared,
+      aiTrainingSharedSamples,
+      aiValidationSharedSamples
    );
    if(UNLIKELY(nullptr == pBooster)) {
       LOG_0(TraceLevelWarning, "WARNING AllocateBoosting pBooster->Initialize");
@@ -701,6 +837,130 @@ static Booster * AllocateBoosting(
    return pBooster;
 }
 
+static BoosterHandle CreateClassificationBoosterInternal(
+   const SeedEbmType randomSeed,
+   const IntEbmType countTargetClasses,
+   const IntEbmType countFeatures,
+   const BoolEbmType * const featuresCategorical,
+   const IntEbmType * const featuresBinCount,
+   const IntEbmType countFeatureGroups,
+   const IntEbmType * const featureGroupsFeatureCount,
+   const IntEbmType * const featureGroupsFeatureIndexes,
+   const IntEbmType countTrainingSamples,
+   const IntEbmType * const trainingBinnedData,
+   const IntEbmType * const trainingTargets,
+   const FloatEbmType * const trainingWeights,
+   const FloatEbmType * const trainingPredictorScores,
+   const IntEbmType countValidationSamples,
+   const IntEbmType * const validationBinnedData,
+   const IntEbmType * const validationTargets,
+   const FloatEbmType * const validationWeights,
+   const FloatEbmType * const validationPredictorScores,
+   const IntEbmType countInnerBags,
+   const FloatEbmType * const optionalTempParams,
+   const ResidualStorageType residualStorage
+) {
+   if(countTargetClasses < 0) {
+      LOG_0(TraceLevelError, "ERROR CreateClassificationBooster countTargetClasses can't be negative");
+      return nullptr;
+   }
+   if(0 == countTargetClasses && (0 != countTrainingSamples || 0 != countValidationSamples)) {
+      LOG_0(TraceLevelError, "ERROR CreateClassificationBooster countTargetClasses can't be zero unless there are no training and no validation cases");
+      return nullptr;
+   }
+   if(!IsNumberConvertable<ptrdiff_t>(countTargetClasses)) {
+      LOG_0(TraceLevelWarning, "WARNING CreateClassificationBooster !IsNumberConvertable<ptrdiff_t>(countTargetClasses)");
+      return nullptr;
+   }
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = static_cast<ptrdiff_t>(countTargetClasses);
+   if(ResidualStorage_Float64 != residualStorage && ResidualStorage_Float32 != residualStorage) {
+      LOG_0(TraceLevelError, "ERROR CreateClassificationBooster residualStorage must be ResidualStorage_Float64 or ResidualStorage_Float32");
+      return nullptr;
+   }
+   const BoosterHandle boosterHandle = reinterpret_cast<BoosterHandle>(AllocateBoosting(
+      randomSeed, 
+      countFeatures, 
+      featuresCategorical,
+      featuresBinCount,
+      countFeatureGroups,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes, 
+      runtimeLearningTypeOrCountTargetClasses, 
+      countTrainingSamples, 
+      trainingTargets, 
+      trainingBinnedData, 
+      trainingWeights, 
+      trainingPredictorScores, 
+      countValidationSamples, 
+      validationTargets, 
+      validationBinnedData, 
+      validationWeights, 
+      validationPredictorScores, 
+      countInnerBags,
+      optionalTempParams,
+      ResidualStorage_Float32 == residualStorage,
+      nullptr,
+      nullptr,
+      nullptr
+   ));
+   return boosterHandle;
+}
+
+static BoosterHandle CreateRegressionBoosterInternal(
+   const SeedEbmType randomSeed,
+   const IntEbmType countFeatures,
+   const BoolEbmType * const featuresCategorical,
+   const IntEbmType * const featuresBinCount,
+   const IntEbmType countFeatureGroups,
+   const IntEbmType * const featureGroupsFeatureCount,
+   const IntEbmType * const featureGroupsFeatureIndexes,
+   const IntEbmType countTrainingSamples,
+   const IntEbmType * const trainingBinnedData,
+   const FloatEbmType * const trainingTargets,
+   const FloatEbmType * const trainingWeights,
+   const FloatEbmType * const trainingPredictorScores,
+   const IntEbmType countValidationSamples,
+   const IntEbmType * const validationBinnedData,
+   const FloatEbmType * const validationTargets,
+   const FloatEbmType * const validationWeights,
+   const FloatEbmType * const validationPredictorScores,
+   const IntEbmType countInnerBags,
+   const FloatEbmType * const optionalTempParams,
+   const ResidualStorageType residualStorage
+) {
+   if(ResidualStorage_Float64 != residualStorage && ResidualStorage_Float32 != residualStorage) {
+      LOG_0(TraceLevelError, "ERROR CreateRegressionBooster residualStorage must be ResidualStorage_Float64 or ResidualStorage_Float32");
+      return nullptr;
+   }
+   const BoosterHandle boosterHandle = reinterpret_cast<BoosterHandle>(AllocateBoosting(
+      randomSeed, 
+      countFeatures, 
+      featuresCategorical,
+      featuresBinCount,
+      countFeatureGroups, 
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes, 
+      k_regression, 
+      countTrainingSamples, 
+      trainingTargets, 
+      trainingBinnedData, 
+      trainingWeights, 
+      trainingPredictorScores, 
+      countValidationSamples, 
+      validationTargets, 
+      validationBinnedData, 
+      validationWeights,
+      validationPredictorScores, 
+      countInnerBags,
+      optionalTempParams,
+      ResidualStorage_Float32 == residualStorage,
+      nullptr,
+      nullptr,
+      nullptr
+   ));
+   return boosterHandle;
+}
+
 EBM_NATIVE_IMPORT_EXPORT_BODY BoosterHandle EBM_NATIVE_CALLING_CONVENTION CreateClassificationBooster(
    SeedEbmType randomSeed,
    IntEbmType countTargetClasses,
@@ -768,42 +1028,127 @@ EBM_NATIVE_IMPORT_EXPORT_BODY BoosterHandle EBM_NATIVE_CALLING_CONVENTION Create
       countInnerBags, 
       static_cast<const void *>(optionalTempParams)
       );
-   if(countTargetClasses < 0) {
-      LOG_0(TraceLevelError, "ERROR CreateClassificationBooster countTargetClasses can't be negative");
-      return nullptr;
-   }
-   if(0 == countTargetClasses && (0 != countTrainingSamples || 0 != countValidationSamples)) {
-      LOG_0(TraceLevelError, "ERROR CreateClassificationBooster countTargetClasses can't be zero unless there are no training and no validation cases");
-      return nullptr;
-   }
-   if(!IsNumberConvertable<ptrdiff_t>(countTargetClasses)) {
-      LOG_0(TraceLevelWarning, "WARNING CreateClassificationBooster !IsNumberConvertable<ptrdiff_t>(countTargetClasses)");
-      return nullptr;
-   }
-   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = static_cast<ptrdiff_t>(countTargetClasses);
-   const BoosterHandle boosterHandle = reinterpret_cast<BoosterHandle>(AllocateBoosting(
-      randomSeed, 
-      countFeatures, 
+   const BoosterHandle boosterHandle = CreateClassificationBoosterInternal(
+      randomSeed,
+      countTargetClasses,
+      countFeatures,
       featuresCategorical,
       featuresBinCount,
       countFeatureGroups,
       featureGroupsFeatureCount,
-      featureGroupsFeatureIndexes, 
-      runtimeLearningTypeOrCountTargetClasses, 
+      featureGroupsFeatureIndexes,
+      countTrainingSamples,
+      trainingBinnedData,
+      trainingTargets,
+      trainingWeights,
+      trainingPredictorScores,
+      countValidationSamples,
+      validationBinnedData,
+      validationTargets,
+      validationWeights,
+      validationPredictorScores,
+      countInnerBags,
+      optionalTempParams,
+      ResidualStorage_Float64
+   );
+   LOG_N(TraceLevelInfo, "Exited CreateClassificationBooster %p", static_cast<void *>(boosterHandle));
+   return boosterHandle;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY BoosterHandle EBM_NATIVE_CALLING_CONVENTION CreateClassificationBoosterWithStorage(
+   SeedEbmType randomSeed,
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const BoolEbmType * featuresCategorical,
+   const IntEbmType * featuresBinCount,
+   IntEbmType countFeatureGroups,
+   const IntEbmType * featureGroupsFeatureCount,
+   const IntEbmType * featureGroupsFeatureIndexes,
+   IntEbmType countTrainingSamples,
+   const IntEbmType * trainingBinnedData,
+   const IntEbmType * trainingTargets,
+   const FloatEbmType * trainingWeights,
+   const FloatEbmType * trainingPredictorScores,
+   IntEbmType countValidationSamples,
+   const IntEbmType * validationBinnedData,
+   const IntEbmType * validationTargets,
+   const FloatEbmType * validationWeights,
+   const FloatEbmType * validationPredictorScores,
+   IntEbmType countInnerBags,
+   const FloatEbmType * optionalTempParams,
+   ResidualStorageType residualStorage
+) {
+   LOG_N(
+      TraceLevelInfo, 
+      "Entered CreateClassificationBoosterWithStorage: "
+      "randomSeed=%" SeedEbmTypePrintf ", "
+      "countTargetClasses=%" IntEbmTypePrintf ", "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "featuresCategorical=%p, "
+      "featuresBinCount=%p, "
+      "countFeatureGroups=%" IntEbmTypePrintf ", "
+      "featureGroupsFeatureCount=%p, "
+      "featureGroupsFeatureIndexes=%p, "
+      "countTrainingSamples=%" IntEbmTypePrintf ", "
+      "trainingBinnedData=%p, "
+      "trainingTargets=%p, "
+      "trainingWeights=%p, "
+      "trainingPredictorScores=%p, "
+      "countValidationSamples=%" IntEbmTypePrintf ", "
+      "validationBinnedData=%p, "
+      "validationTargets=%p, "
+      "validationWeights=%p, "
+      "validationPredictorScores=%p, "
+      "countInnerBags=%" IntEbmTypePrintf ", "
+      "optionalTempParams=%p, "
+      "residualStorage=%" ResidualStorageTypePrintf
+      ,
+      randomSeed,
+      countTargetClasses,
+      countFeatures, 
+      static_cast<const void *>(featuresCategorical),
+      static_cast<const void *>(featuresBinCount),
+      countFeatureGroups,
+      static_cast<const void *>(featureGroupsFeatureCount),
+      static_cast<const void *>(featureGroupsFeatureIndexes), 
       countTrainingSamples, 
-      trainingTargets, 
-      trainingBinnedData, 
-      trainingWeights, 
-      trainingPredictorScores, 
+      static_cast<const void *>(trainingBinnedData), 
+      static_cast<const void *>(trainingTargets), 
+      static_cast<const void *>(trainingWeights),
+      static_cast<const void *>(trainingPredictorScores),
       countValidationSamples, 
-      validationTargets, 
-      validationBinnedData, 
-      validationWeights, 
-      validationPredictorScores, 
+      static_cast<const void *>(validationBinnedData), 
+      static_cast<const void *>(validationTargets), 
+      static_cast<const void *>(validationWeights),
+      static_cast<const void *>(validationPredictorScores),
+      countInnerBags, 
+      static_cast<const void *>(optionalTempParams),
+      residualStorage
+      );
+   const BoosterHandle boosterHandle = CreateClassificationBoosterInternal(
+      randomSeed,
+      countTargetClasses,
+      countFeatures,
+      featuresCategorical,
+      featuresBinCount,
+      countFeatureGroups,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      countTrainingSamples,
+      trainingBinnedData,
+      trainingTargets,
+      trainingWeights,
+      trainingPredictorScores,
+      countValidationSamples,
+      validationBinnedData,
+      validationTargets,
+      validationWeights,
+      validationPredictorScores,
       countInnerBags,
-      optionalTempParams
-   ));
-   LOG_N(TraceLevelInfo, "Exited CreateClassificationBooster %p", static_cast<void *>(boosterHandle));
+      optionalTempParams,
+      residualStorage
+   );
+   LOG_N(TraceLevelInfo, "Exited CreateClassificationBoosterWithStorage %p", static_cast<void *>(boosterHandle));
    return boosterHandle;
 }
 
@@ -871,32 +1216,592 @@ EBM_NATIVE_IMPORT_EXPORT_BODY BoosterHandle EBM_NATIVE_CALLING_CONVENTION Create
       countInnerBags, 
       static_cast<const void *>(optionalTempParams)
    );
-   const BoosterHandle boosterHandle = reinterpret_cast<BoosterHandle>(AllocateBoosting(
-      randomSeed, 
-      countFeatures, 
+   const BoosterHandle boosterHandle = CreateRegressionBoosterInternal(
+      randomSeed,
+      countFeatures,
       featuresCategorical,
       featuresBinCount,
-      countFeatureGroups, 
+      countFeatureGroups,
       featureGroupsFeatureCount,
-      featureGroupsFeatureIndexes, 
-      k_regression, 
+      featureGroupsFeatureIndexes,
+      countTrainingSamples,
+      trainingBinnedData,
+      trainingTargets,
+      trainingWeights,
+      trainingPredictorScores,
+      countValidationSamples,
+      validationBinnedData,
+      validationTargets,
+      validationWeights,
+      validationPredictorScores,
+      countInnerBags,
+      optionalTempParams,
+      ResidualStorage_Float64
+   );
+   LOG_N(TraceLevelInfo, "Exited CreateRegressionBooster %p", static_cast<void *>(boosterHandle));
+   return boosterHandle;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY BoosterHandle EBM_NATIVE_CALLING_CONVENTION CreateRegressionBoosterWithStorage(
+   SeedEbmType randomSeed,
+   IntEbmType countFeatures,
+   const BoolEbmType * featuresCategorical,
+   const IntEbmType * featuresBinCount,
+   IntEbmType countFeatureGroups,
+   const IntEbmType * featureGroupsFeatureCount,
+   const IntEbmType * featureGroupsFeatureIndexes,
+   IntEbmType countTrainingSamples,
+   const IntEbmType * trainingBinnedData,
+   const FloatEbmType * trainingTargets,
+   const FloatEbmType * trainingWeights,
+   const FloatEbmType * trainingPredictorScores,
+   IntEbmType countValidationSamples,
+   const IntEbmType * validationBinnedData,
+   const FloatEbmType * validationTargets,
+   const FloatEbmType * validationWeights,
+   const FloatEbmType * validationPredictorScores,
+   IntEbmType countInnerBags,
+   const FloatEbmType * optionalTempParams,
+   ResidualStorageType residualStorage
+) {
+   LOG_N(
+      TraceLevelInfo, 
+      "Entered CreateRegressionBoosterWithStorage: "
+      "randomSeed=%" SeedEbmTypePrintf ", "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "featuresCategorical=%p, "
+      "featuresBinCount=%p, "
+      "countFeatureGroups=%" IntEbmTypePrintf ", "
+      "featureGroupsFeatureCount=%p, "
+      "featureGroupsFeatureIndexes=%p, "
+      "countTrainingSamples=%" IntEbmTypePrintf ", "
+      "trainingBinnedData=%p, "
+      "trainingTargets=%p, "
+      "trainingWeights=%p, "
+      "trainingPredictorScores=%p, "
+      "countValidationSamples=%" IntEbmTypePrintf ", "
+      "validationBinnedData=%p, "
+      "validationTargets=%p, "
+      "validationWeights=%p, "
+      "validationPredictorScores=%p, "
+      "countInnerBags=%" IntEbmTypePrintf ", "
+      "optionalTempParams=%p, "
+      "residualStorage=%" ResidualStorageTypePrintf
+      ,
+      randomSeed,
+      countFeatures,
+      static_cast<const void *>(featuresCategorical),
+      static_cast<const void *>(featuresBinCount),
+      countFeatureGroups,
+      static_cast<const void *>(featureGroupsFeatureCount),
+      static_cast<const void *>(featureGroupsFeatureIndexes), 
       countTrainingSamples, 
-      trainingTargets, 
-      trainingBinnedData, 
-      trainingWeights, 
-      trainingPredictorScores, 
+      static_cast<const void *>(trainingBinnedData), 
+      static_cast<const void *>(trainingTargets), 
+      static_cast<const void *>(trainingWeights),
+      static_cast<const void *>(trainingPredictorScores),
       countValidationSamples, 
-      validationTargets, 
-      validationBinnedData, 
+      static_cast<const void *>(validationBinnedData), 
+      static_cast<const void *>(validationTargets), 
+      static_cast<const void *>(validationWeights),
+      static_cast<const void *>(validationPredictorScores),
+      countInnerBags, 
+      static_cast<const void *>(optionalTempParams),
+      residualStorage
+   );
+   const BoosterHandle boosterHandle = CreateRegressionBoosterInternal(
+      randomSeed,
+      countFeatures,
+      featuresCategorical,
+      featuresBinCount,
+      countFeatureGroups,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      countTrainingSamples,
+      trainingBinnedData,
+      trainingTargets,
+      trainingWeights,
+      trainingPredictorScores,
+      countValidationSamples,
+      validationBinnedData,
+      validationTargets,
       validationWeights,
-      validationPredictorScores, 
+      validationPredictorScores,
       countInnerBags,
-      optionalTempParams
-   ));
-   LOG_N(TraceLevelInfo, "Exited CreateRegressionBooster %p", static_cast<void *>(boosterHandle));
+      optionalTempParams,
+      residualStorage
+   );
+   LOG_N(TraceLevelInfo, "Exited CreateRegressionBoosterWithStorage %p", static_cast<void *>(boosterHandle));
    return boosterHandle;
 }
 
+// the data is bit packed once and shared, so this costs one copy of the bit packed data plus each booster's residuals,
+// scores, sampling sets, models and the list of shared samples that it trains and validates on.  A booster unpacks 
+// its own samples in order for the feature group that it's boosting on, so it boosts exactly like a separate booster 
+// made from copies of its bag's samples
+static IntEbmType AllocateBoostingBags(
+   const IntEbmType countBags,
+   const SeedEbmType * const randomSeeds,
+   const IntEbmType countFeatures,
+   const BoolEbmType * const aFeaturesCategorical,
+   const IntEbmType * const aFeaturesBinCount,
+   const IntEbmType countFeatureGroups,
+   const IntEbmType * const aFeatureGroupsFeatureCount,
+   const IntEbmType * const aFeatureGroupsFeatureIndexes,
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const IntEbmType countSamples,
+   const void * const targets,
+   const IntEbmType * const binnedData,
+   const FloatEbmType * const aWeights,
+   const FloatEbmType * const predictorScores,
+   const IntEbmType * const bagsSampleCounts,
+   const IntEbmType countInnerBags,
+   const FloatEbmType * const optionalTempParams,
+   const ResidualStorageType residualStorage,
+   BoosterHandle * const boosterHandlesOut
+) {
+   if(nullptr == boosterHandlesOut) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoostingBags boosterHandlesOut cannot be nullptr");
+      return 1;
+   }
+   if(countBags <= 0) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoostingBags countBags must be 1 or more");
+      return 1;
+   }
+   if(!IsNumberConvertable<size_t>(countBags)) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoostingBags !IsNumberConvertable<size_t>(countBags)");
+      return 1;
+   }
+   const size_t cBags = static_cast<size_t>(countBags);
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      boosterHandlesOut[iBag] = nullptr;
+   }
+   if(nullptr == randomSeeds) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoostingBags randomSeeds cannot be nullptr");
+      return 1;
+   }
+   if(ResidualStorage_Float32 == residualStorage) {
+      // TODO: the views could keep their residuals and scores as float, but until that's tested against separate 
+      // float32 boosters we refuse it instead of quietly boosting in float64
+      LOG_0(TraceLevelError, "ERROR AllocateBoostingBags boosters that share their data don't support ResidualStorage_Float32 yet");
+      return 1;
+   }
+   if(ResidualStorage_Float64 != residualStorage) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoostingBags residualStorage must be ResidualStorage_Float64");
+      return 1;
+   }
+   if(countFeatures < 0) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoostingBags countFeatures must be positive");
+      return 1;
+   }
+   if(!IsNumberConvertable<size_t>(countFeatures)) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoostingBags !IsNumberConvertable<size_t>(countFeatures)");
+      return 1;
+   }
+   if(countSamples < 0) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoostingBags countSamples must be positive");
+      return 1;
+   }
+   if(!IsNumberConvertable<size_t>(countSamples)) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoostingBags !IsNumberConvertable<size_t>(countSamples)");
+      return 1;
+   }
+   if(0 != countSamples && nullptr == targets) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoostingBags targets cannot be nullptr if 0 < countSamples");
+      return 1;
+   }
+   if(0 != countSamples && 0 != countFeatures && nullptr == binnedData) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoostingBags binnedData cannot be nullptr if 0 < countSamples AND 0 < countFeatures");
+      return 1;
+   }
+   if(0 != countSamples && nullptr == predictorScores) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoostingBags predictorScores cannot be nullptr if 0 < countSamples");
+      return 1;
+   }
+   if(0 != countSamples && nullptr == bagsSampleCounts) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoostingBags bagsSampleCounts cannot be nullptr if 0 < countSamples");
+      return 1;
+   }
+
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   const size_t cBytesTarget = IsClassification(runtimeLearningTypeOrCountTargetClasses) ? 
+      sizeof(IntEbmType) : sizeof(FloatEbmType);
+
+   if(IsMultiplyError(cBags, cSamples)) {
+      // the caller should not have been able to allocate enough memory in "bagsSampleCounts" if this didn't fit in memory
+      LOG_0(TraceLevelError, "ERROR AllocateBoostingBags IsMultiplyError(cBags, cSamples)");
+      return 1;
+   }
+   if(IsMultiplyError(cVectorLength, cSamples)) {
+      // the caller should not have been able to allocate enough memory in "predictorScores" if this didn't fit in memory
+      LOG_0(TraceLevelError, "ERROR AllocateBoostingBags IsMultiplyError(cVectorLength, cSamples)");
+      return 1;
+   }
+
+   const bool bClassification = IsClassification(runtimeLearningTypeOrCountTargetClasses);
+
+   size_t * aiSharedSamples = nullptr;
+   void * aBagTargets = nullptr;
+   FloatEbmType * aBagPredictorScores = nullptr;
+
+   DataSetByFeatureGroup dataSetShared;
+   dataSetShared.InitializeZero();
+   if(0 != cSamples) {
+      // every bag has the same feature groups, so a booster without samples checks them for us and gives us the 
+      // feature groups to bit pack the shared data with.  Packing also checks the binned data and targets
+      Booster * const pBoosterFeatureGroups = AllocateBoosting(
+         randomSeeds[0],
+         countFeatures,
+         aFeaturesCategorical,
+         aFeaturesBinCount,
+         countFeatureGroups,
+         aFeatureGroupsFeatureCount,
+         aFeatureGroupsFeatureIndexes,
+         runtimeLearningTypeOrCountTargetClasses,
+         0,
+         nullptr,
+         nullptr,
+         nullptr,
+         nullptr,
+         0,
+         nullptr,
+         nullptr,
+         nullptr,
+         nullptr,
+         countInnerBags,
+         optionalTempParams,
+         false,
+         nullptr,
+         nullptr,
+         nullptr
+      );
+      if(nullptr == pBoosterFeatureGroups) {
+         LOG_0(TraceLevelWarning, "WARNING AllocateBoostingBags nullptr == pBoosterFeatureGroups");
+         return 1;
+      }
+      const bool bFailed = dataSetShared.Initialize(
+         false,
+         false,
+         bClassification,
+         pBoosterFeatureGroups->GetCountFeatureGroups(),
+         pBoosterFeatureGroups->GetFeatureGroups(),
+         cSamples,
+         binnedData,
+         targets,
+         nullptr,
+         runtimeLearningTypeOrCountTargetClasses,
+         false
+      );
+      Booster::Free(pBoosterFeatureGroups);
+      if(bFailed) {
+         LOG_0(TraceLevelWarning, "WARNING AllocateBoostingBags dataSetShared.Initialize");
+         return 1;
+      }
+   }
+
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      const IntEbmType * const aBagSampleCounts = nullptr == bagsSampleCounts ? nullptr : 
+         &bagsSampleCounts[iBag * cSamples];
+
+      size_t cTrainingOccurrences = 0;
+      size_t cValidationOccurrences = 0;
+      bool bBadCounts = false;
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         const IntEbmType countOccurrences = aBagSampleCounts[iSample];
+         if(0 < countOccurrences) {
+            if(!IsNumberConvertable<size_t>(countOccurrences)) {
+               bBadCounts = true;
+               break;
+            }
+            const size_t cOccurrences = static_cast<size_t>(countOccurrences);
+            if(IsAddError(cTrainingOccurrences, cOccurrences)) {
+               bBadCounts = true;
+               break;
+            }
+            cTrainingOccurrences += cOccurrences;
+         } else if(countOccurrences < 0) {
+            // negate in two steps so that the most negative IntEbmType doesn't overflow
+            const IntEbmType countValidation = -(countOccurrences + 1);
+            if(!IsNumberConvertable<size_t>(countValidation)) {
+               bBadCounts = true;
+               break;
+            }
+            const size_t cValidation = static_cast<size_t>(countValidation);
+            if(IsAddError(cValidation, size_t { 1 }) || IsAddError(cValidationOccurrences, cValidation + 1)) {
+               bBadCounts = true;
+               break;
+            }
+            cValidationOccurrences += cValidation + 1;
+         }
+      }
+      if(bBadCounts || IsAddError(cTrainingOccurrences, cValidationOccurrences) ||
+         !IsNumberConvertable<IntEbmType>(cTrainingOccurrences) || 
+         !IsNumberConvertable<IntEbmType>(cValidationOccurrences) ||
+         IsMultiplyError(cVectorLength, cTrainingOccurrences + cValidationOccurrences)
+      ) {
+         LOG_0(TraceLevelError, "ERROR AllocateBoostingBags bagsSampleCounts has a count that is too large");
+         goto exit_error;
+      }
+      if(0 != cSamples && 0 == cTrainingOccurrences) {
+         LOG_0(TraceLevelError, "ERROR AllocateBoostingBags each bag needs at least one training sample in bagsSampleCounts");
+         goto exit_error;
+      }
+
+      const size_t cOccurrences = cTrainingOccurrences + cValidationOccurrences;
+      if(0 != cOccurrences) {
+         aiSharedSamples = EbmMalloc<size_t>(cOccurrences);
+         aBagTargets = EbmMalloc<void>(cOccurrences, cBytesTarget);
+         aBagPredictorScores = EbmMalloc<FloatEbmType>(cVectorLength * cOccurrences);
+         if(nullptr == aiSharedSamples || nullptr == aBagTargets || nullptr == aBagPredictorScores) {
+            LOG_0(TraceLevelWarning, "WARNING AllocateBoostingBags out of memory for the bag samples");
+            goto exit_error;
+         }
+
+         // the training samples come first, then the validation samples.  Both keep their original order, and a 
+         // sample that is in the bag more than once is repeated
+         size_t iTraining = 0;
+         size_t iValidation = cTrainingOccurrences;
+         for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+            IntEbmType countOccurrences = aBagSampleCounts[iSample];
+            while(0 != countOccurrences) {
+               size_t iOccurrence;
+               if(0 < countOccurrences) {
+                  iOccurrence = iTraining;
+                  ++iTraining;
+                  --countOccurrences;
+               } else {
+                  iOccurrence = iValidation;
+                  ++iValidation;
+                  ++countOccurrences;
+               }
+               aiSharedSamples[iOccurrence] = iSample;
+               memcpy(
+                  static_cast<char *>(aBagTargets) + iOccurrence * cBytesTarget,
+                  static_cast<const char *>(targets) + iSample * cBytesTarget,
+                  cBytesTarget
+               );
+               memcpy(
+                  &aBagPredictorScores[iOccurrence * cVectorLength],
+                  &predictorScores[iSample * cVectorLength],
+                  sizeof(*aBagPredictorScores) * cVectorLength
+               );
+            }
+         }
+         EBM_ASSERT(cTrainingOccurrences == iTraining);
+         EBM_ASSERT(cOccurrences == iValidation);
+      }
+
+      {
+         // TODO: weights are not used yet.  Once they are we'll need to gather them for each bag like the targets
+         UNUSED(aWeights);
+         Booster * const pBooster = AllocateBoosting(
+            randomSeeds[iBag],
+            countFeatures,
+            aFeaturesCategorical,
+            aFeaturesBinCount,
+            countFeatureGroups,
+            aFeatureGroupsFeatureCount,
+            aFeatureGroupsFeatureIndexes,
+            runtimeLearningTypeOrCountTargetClasses,
+            static_cast<IntEbmType>(cTrainingOccurrences),
+            aBagTargets,
+            nullptr,
+            nullptr,
+            aBagPredictorScores,
+            static_cast<IntEbmType>(cValidationOccurrences),
+            nullptr == aBagTargets ? nullptr : static_cast<const char *>(aBagTargets) + cTrainingOccurrences * cBytesTarget,
+            nullptr,
+            nullptr,
+            nullptr == aBagPredictorScores ? nullptr : aBagPredictorScores + cTrainingOccurrences * cVectorLength,
+            countInnerBags,
+            optionalTempParams,
+            false,
+            &dataSetShared,
+            aiSharedSamples,
+            nullptr == aiSharedSamples ? nullptr : aiSharedSamples + cTrainingOccurrences
+         );
+         free(aiSharedSamples);
+         free(aBagTargets);
+         free(aBagPredictorScores);
+         aiSharedSamples = nullptr;
+         aBagTargets = nullptr;
+         aBagPredictorScores = nullptr;
+         if(nullptr == pBooster) {
+            LOG_0(TraceLevelWarning, "WARNING AllocateBoostingBags nullptr == pBooster");
+            goto exit_error;
+         }
+         boosterHandlesOut[iBag] = reinterpret_cast<BoosterHandle>(pBooster);
+      }
+   }
+   // the boosters hold references to the shared data, which is freed with the last of them
+   dataSetShared.Destruct();
+   return 0;
+
+exit_error:;
+   for(size_t iBagFree = 0; iBagFree < cBags; ++iBagFree) {
+      Booster::Free(reinterpret_cast<Booster *>(boosterHandlesOut[iBagFree]));
+      boosterHandlesOut[iBagFree] = nullptr;
+   }
+   free(aiSharedSamples);
+   free(aBagTargets);
+   free(aBagPredictorScores);
+   dataSetShared.Destruct();
+   return 1;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION CreateClassificationBoosters(
+   IntEbmType countBags,
+   const SeedEbmType * randomSeeds,
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const BoolEbmType * featuresCategorical,
+   const IntEbmType * featuresBinCount,
+   IntEbmType countFeatureGroups,
+   const IntEbmType * featureGroupsFeatureCount,
+   const IntEbmType * featureGroupsFeatureIndexes,
+   IntEbmType countSamples,
+   const IntEbmType * binnedData,
+   const IntEbmType * targets,
+   const FloatEbmType * weights,
+   const FloatEbmType * predictorScores,
+   const IntEbmType * bagsSampleCounts,
+   IntEbmType countInnerBags,
+   const FloatEbmType * optionalTempParams,
+   ResidualStorageType residualStorage,
+   BoosterHandle * boosterHandlesOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered CreateClassificationBoosters: "
+      "countBags=%" IntEbmTypePrintf ", "
+      "randomSeeds=%p, "
+      "countTargetClasses=%" IntEbmTypePrintf ", "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "countFeatureGroups=%" IntEbmTypePrintf ", "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "bagsSampleCounts=%p, "
+      "countInnerBags=%" IntEbmTypePrintf ", "
+      "residualStorage=%" ResidualStorageTypePrintf ", "
+      "boosterHandlesOut=%p"
+      ,
+      countBags,
+      static_cast<const void *>(randomSeeds),
+      countTargetClasses,
+      countFeatures,
+      countFeatureGroups,
+      countSamples,
+      static_cast<const void *>(bagsSampleCounts),
+      countInnerBags,
+      residualStorage,
+      static_cast<void *>(boosterHandlesOut)
+   );
+   if(countTargetClasses < 0) {
+      LOG_0(TraceLevelError, "ERROR CreateClassificationBoosters countTargetClasses can't be negative");
+      return 1;
+   }
+   if(0 == countTargetClasses && 0 != countSamples) {
+      LOG_0(TraceLevelError, "ERROR CreateClassificationBoosters countTargetClasses can't be zero unless there are no samples");
+      return 1;
+   }
+   if(!IsNumberConvertable<ptrdiff_t>(countTargetClasses)) {
+      LOG_0(TraceLevelWarning, "WARNING CreateClassificationBoosters !IsNumberConvertable<ptrdiff_t>(countTargetClasses)");
+      return 1;
+   }
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = static_cast<ptrdiff_t>(countTargetClasses);
+   const IntEbmType ret = AllocateBoostingBags(
+      countBags,
+      randomSeeds,
+      countFeatures,
+      featuresCategorical,
+      featuresBinCount,
+      countFeatureGroups,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      runtimeLearningTypeOrCountTargetClasses,
+      countSamples,
+      targets,
+      binnedData,
+      weights,
+      predictorScores,
+      bagsSampleCounts,
+      countInnerBags,
+      optionalTempParams,
+      residualStorage,
+      boosterHandlesOut
+   );
+   LOG_N(TraceLevelInfo, "Exited CreateClassificationBoosters %" IntEbmTypePrintf, ret);
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION CreateRegressionBoosters(
+   IntEbmType countBags,
+   const SeedEbmType * randomSeeds,
+   IntEbmType countFeatures,
+   const BoolEbmType * featuresCategorical,
+   const IntEbmType * featuresBinCount,
+   IntEbmType countFeatureGroups,
+   const IntEbmType * featureGroupsFeatureCount,
+   const IntEbmType * featureGroupsFeatureIndexes,
+   IntEbmType countSamples,
+   const IntEbmType * binnedData,
+   const FloatEbmType * targets,
+   const FloatEbmType * weights,
+   const FloatEbmType * predictorScores,
+   const IntEbmType * bagsSampleCounts,
+   IntEbmType countInnerBags,
+   const FloatEbmType * optionalTempParams,
+   ResidualStorageType residualStorage,
+   BoosterHandle * boosterHandlesOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered CreateRegressionBoosters: "
+      "countBags=%" IntEbmTypePrintf ", "
+      "randomSeeds=%p, "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "countFeatureGroups=%" IntEbmTypePrintf ", "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "bagsSampleCounts=%p, "
+      "countInnerBags=%" IntEbmTypePrintf ", "
+      "residualStorage=%" ResidualStorageTypePrintf ", "
+      "boosterHandlesOut=%p"
+      ,
+      countBags,
+      static_cast<const void *>(randomSeeds),
+      countFeatures,
+      countFeatureGroups,
+      countSamples,
+      static_cast<const void *>(bagsSampleCounts),
+      countInnerBags,
+      residualStorage,
+      static_cast<void *>(boosterHandlesOut)
+   );
+   const IntEbmType ret = AllocateBoostingBags(
+      countBags,
+      randomSeeds,
+      countFeatures,
+      featuresCategorical,
+      featuresBinCount,
+      countFeatureGroups,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      k_regression,
+      countSamples,
+      targets,
+      binnedData,
+      weights,
+      predictorScores,
+      bagsSampleCounts,
+      countInnerBags,
+      optionalTempParams,
+      residualStorage,
+      boosterHandlesOut
+   );
+   LOG_N(TraceLevelInfo, "Exited CreateRegressionBoosters %" IntEbmTypePrintf, ret);
+   return ret;
+}
+
 EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION BoostingStep(
    BoosterHandle boosterHandle,
    IntEbmType indexFeatureGroup,
@@ -949,6 +1854,477 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION BoostingS
    return ApplyModelFeatureGroupUpdate(boosterHandle, indexFeatureGroup, pModelFeatureGroupUpdateTensor, validationMetricOut);
 }
 
+struct BoostingStepTaskContext {
+
+   BoostingStepTaskContext() = default; // preserve our POD status
+   ~BoostingStepTaskContext() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   const BoosterHandle * m_aBoosterHandles;
+   IntEbmType m_indexFeatureGroup;
+   GenerateUpdateOptionsType m_options;
+   FloatEbmType m_learningRate;
+   IntEbmType m_countSamplesRequiredForChildSplitMin;
+   const IntEbmType * m_aLeavesMax;
+   FloatEbmType * m_aValidationMetricsOut;
+   // one result per booster so that the tasks don't need to synchronize
+   IntEbmType * m_aResults;
+};
+static_assert(std::is_standard_layout<BoostingStepTaskContext>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<BoostingStepTaskContext>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<BoostingStepTaskContext>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+static void BoostingStepTask(void * const pContext, const size_t iThread, const size_t iTask) {
+   UNUSED(iThread);
+   const BoostingStepTaskContext * const pTaskContext = static_cast<const BoostingStepTaskContext *>(pContext);
+   // each booster has its own residuals, sampling sets, random stream and models and only reads the shared data, so 
+   // the boosters don't interact and the result can't depend on which thread runs which booster
+   pTaskContext->m_aResults[iTask] = BoostingStep(
+      pTaskContext->m_aBoosterHandles[iTask],
+      pTaskContext->m_indexFeatureGroup,
+      pTaskContext->m_options,
+      pTaskContext->m_learningRate,
+      pTaskContext->m_countSamplesRequiredForChildSplitMin,
+      pTaskContext->m_aLeavesMax,
+      nullptr == pTaskContext->m_aValidationMetricsOut ? nullptr : &pTaskContext->m_aValidationMetricsOut[iTask]
+   );
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION BoostingStepParallel(
+   IntEbmType countThreads,
+   IntEbmType countBoosters,
+   const BoosterHandle * boosterHandles,
+   IntEbmType indexFeatureGroup,
+   GenerateUpdateOptionsType options,
+   FloatEbmType learningRate,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   const IntEbmType * leavesMax,
+   FloatEbmType * validationMetricsOut
+) {
+   if(countThreads < 0) {
+      LOG_0(TraceLevelError, "ERROR BoostingStepParallel countThreads must be positive");
+      return 1;
+   }
+   if(countBoosters < 0) {
+      LOG_0(TraceLevelError, "ERROR BoostingStepParallel countBoosters must be positive");
+      return 1;
+   }
+   if(0 == countBoosters) {
+      return 0;
+   }
+   if(nullptr == boosterHandles) {
+      LOG_0(TraceLevelError, "ERROR BoostingStepParallel boosterHandles cannot be nullptr");
+      return 1;
+   }
+   if(!IsNumberConvertable<size_t>(countBoosters)) {
+      LOG_0(TraceLevelError, "ERROR BoostingStepParallel !IsNumberConvertable<size_t>(countBoosters)");
+      return 1;
+   }
+   const size_t cBoosters = static_cast<size_t>(countBoosters);
+
+   IntEbmType * const aResults = EbmMalloc<IntEbmType>(cBoosters);
+   if(nullptr == aResults) {
+      LOG_0(TraceLevelWarning, "WARNING BoostingStepParallel nullptr == aResults");
+      return 1;
+   }
+
+   BoostingStepTaskContext taskContext;
+   taskContext.m_aBoosterHandles = boosterHandles;
+   taskContext.m_indexFeatureGroup = indexFeatureGroup;
+   taskContext.m_options = options;
+   taskContext.m_learningRate = learningRate;
+   taskContext.m_countSamplesRequiredForChildSplitMin = countSamplesRequiredForChildSplitMin;
+   taskContext.m_aLeavesMax = leavesMax;
+   taskContext.m_aValidationMetricsOut = validationMetricsOut;
+   taskContext.m_aResults = aResults;
+
+   // 0 == countThreads means use the whole thread pool
+   const size_t cThreads = IntEbmType { 0 } == countThreads || !IsNumberConvertable<size_t>(countThreads) ?
+      GetThreadPoolSize() : static_cast<size_t>(countThreads);
+   RunParallelTasks(cThreads, cBoosters, BoostingStepTask, &taskContext);
+
+   IntEbmType ret = 0;
+   for(size_t iBooster = 0; iBooster < cBoosters; ++iBooster) {
+      if(0 != aResults[iBooster]) {
+         LOG_N(TraceLevelWarning, "WARNING BoostingStepParallel booster %zu returned %" IntEbmTypePrintf, iBooster, aResults[iBooster]);
+         ret = aResults[iBooster];
+      }
+   }
+   free(aResults);
+   return ret;
+}
+
+// called after each round with the lowest validation metric so far.  Returns true once the metric has failed to improve by
+// more than earlyStoppingTolerance for countEarlyStoppingRounds rounds, which is the same rule that Python and R use
+static bool IsEarlyStoppingRound(
+   const FloatEbmType bestMetric,
+   const IntEbmType countEarlyStoppingRounds,
+   const FloatEbmType earlyStoppingTolerance,
+   IntEbmType * const pcRoundsWithoutChange,
+   FloatEbmType * const pBaselineMetric
+) {
+   // TODO PK this earlyStoppingTolerance is a little inconsistent
+   //      since it triggers intermittently and only re-triggers if the
+   //      threshold is re-passed, but not based on a smooth windowed set
+   //      of checks.  We can do better by keeping a list of the last
+   //      number of measurements to have a consistent window of values.
+   //      If we only cared about the metric at the start and end of the epoch
+   //      window a circular buffer would be best choice with O(1).
+   if(0 == *pcRoundsWithoutChange) {
+      *pBaselineMetric = bestMetric;
+   }
+   if(bestMetric + earlyStoppingTolerance < *pBaselineMetric) {
+      *pcRoundsWithoutChange = 0;
+   } else {
+      ++*pcRoundsWithoutChange;
+   }
+   // a negative countEarlyStoppingRounds turns off early stopping
+   return 0 <= countEarlyStoppingRounds && countEarlyStoppingRounds <= *pcRoundsWithoutChange;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION BoostCyclic(
+   BoosterHandle boosterHandle,
+   GenerateUpdateOptionsType options,
+   FloatEbmType learningRate,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   const IntEbmType * leavesMax,
+   IntEbmType countRoundsMax,
+   IntEbmType countEarlyStoppingRounds,
+   FloatEbmType earlyStoppingTolerance,
+   IntEbmType * countRoundsOut,
+   FloatEbmType * bestMetricOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered BoostCyclic: boosterHandle=%p, options=0x%" UGenerateUpdateOptionsTypePrintf ", learningRate=%" FloatEbmTypePrintf
+      ", countSamplesRequiredForChildSplitMin=%" IntEbmTypePrintf ", leavesMax=%p, countRoundsMax=%" IntEbmTypePrintf
+      ", countEarlyStoppingRounds=%" IntEbmTypePrintf ", earlyStoppingTolerance=%" FloatEbmTypePrintf
+      ", countRoundsOut=%p, bestMetricOut=%p",
+      static_cast<void *>(boosterHandle),
+      static_cast<UGenerateUpdateOptionsType>(options), // signed to unsigned conversion is defined behavior in C++
+      learningRate,
+      countSamplesRequiredForChildSplitMin,
+      static_cast<const void *>(leavesMax),
+      countRoundsMax,
+      countEarlyStoppingRounds,
+      earlyStoppingTolerance,
+      static_cast<void *>(countRoundsOut),
+      static_cast<void *>(bestMetricOut)
+   );
+
+   // the metric can only go down, so the best metric starts at infinity, like it does when boosting from Python or R
+   FloatEbmType bestMetric = std::numeric_limits<FloatEbmType>::infinity();
+   IntEbmType cRounds = 0;
+
+   Booster * pBooster = reinterpret_cast<Booster *>(boosterHandle);
+   if(nullptr == pBooster) {
+      LOG_0(TraceLevelError, "ERROR BoostCyclic boosterHandle cannot be nullptr");
+      return 1;
+   }
+   const size_t cFeatureGroups = pBooster->GetCountFeatureGroups();
+   EBM_ASSERT(IsNumberConvertable<IntEbmType>(cFeatureGroups)); // we created the feature groups from IntEbmType counts
+
+   IntEbmType ret = 0;
+   // the number of rounds since the best metric last improved by more than earlyStoppingTolerance
+   IntEbmType cRoundsWithoutChange = 0;
+   FloatEbmType baselineMetric = std::numeric_limits<FloatEbmType>::infinity();
+   while(cRounds < countRoundsMax) {
+      ++cRounds;
+      for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         // BoostingStep keeps the best model for each feature group up to date, so we only track the metric here.
+         // All the feature groups share leavesMax, so it needs to be as long as the feature group with the most dimensions
+         FloatEbmType validationMetric;
+         ret = BoostingStep(
+            boosterHandle,
+            static_cast<IntEbmType>(iFeatureGroup),
+            options,
+            learningRate,
+            countSamplesRequiredForChildSplitMin,
+            leavesMax,
+            &validationMetric
+         );
+         if(0 != ret) {
+            LOG_N(TraceLevelWarning, "WARNING BoostCyclic BoostingStep returned %" IntEbmTypePrintf, ret);
+            goto exit_boosting;
+         }
+         if(validationMetric < bestMetric) {
+            bestMetric = validationMetric;
+         }
+      }
+
+      if(IsEarlyStoppingRound(bestMetric, countEarlyStoppingRounds, earlyStoppingTolerance, &cRoundsWithoutChange, &baselineMetric)) {
+         break;
+      }
+   }
+
+exit_boosting:;
+   if(nullptr != countRoundsOut) {
+      *countRoundsOut = cRounds;
+   }
+   if(nullptr != bestMetricOut) {
+      *bestMetricOut = bestMetric;
+   }
+   LOG_N(TraceLevelInfo, "Exited BoostCyclic: cRounds=%" IntEbmTypePrintf ", bestMetric=%" FloatEbmTypePrintf, cRounds, bestMetric);
+   return ret;
+}
+
+struct BoostJacobiTaskContext {
+
+   BoostJacobiTaskContext() = default; // preserve our POD status
+   ~BoostJacobiTaskContext() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   // one per thread, since each worker has the scratch space for generating one update at a time
+   Booster * const * m_apWorkers;
+   size_t m_iFeatureGroupFirst;
+   GenerateUpdateOptionsType m_options;
+   FloatEbmType m_learningRate;
+   IntEbmType m_countSamplesRequiredForChildSplitMin;
+   const IntEbmType * m_aLeavesMax;
+   // the rest have one item per feature group in the block
+   const SeedEbmType * m_aSeeds;
+   SegmentedTensor * const * m_apUpdates;
+   IntEbmType * m_aResults;
+};
+static_assert(std::is_standard_layout<BoostJacobiTaskContext>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<BoostJacobiTaskContext>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<BoostJacobiTaskContext>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+static void BoostJacobiTask(void * const pContext, const size_t iThread, const size_t iTask) {
+   const BoostJacobiTaskContext * const pTaskContext = static_cast<const BoostJacobiTaskContext *>(pContext);
+   Booster * const pWorker = pTaskContext->m_apWorkers[iThread];
+   const size_t iFeatureGroup = pTaskContext->m_iFeatureGroupFirst + iTask;
+
+   // each feature group gets its own seed so that the update doesn't depend on which thread generates it
+   pWorker->GetRandomStream()->InitializeUnsigned(pTaskContext->m_aSeeds[iTask], k_boosterRandomizationMix);
+
+   FloatEbmType gain; // we toss this value, but we still need to get it
+   // iFeatureGroup is below the count of feature groups, which came to us as an IntEbmType
+   const FloatEbmType * const pUpdate = GenerateModelFeatureGroupUpdate(
+      reinterpret_cast<BoosterHandle>(pWorker),
+      static_cast<IntEbmType>(iFeatureGroup),
+      pTaskContext->m_options,
+      pTaskContext->m_learningRate,
+      pTaskContext->m_countSamplesRequiredForChildSplitMin,
+      pTaskContext->m_aLeavesMax,
+      &gain
+   );
+   IntEbmType ret = 1;
+   if(nullptr != pUpdate) {
+      // the worker overwrites its update with the next feature group, so keep a copy until the block is applied
+      SegmentedTensor * const pUpdateCopy = pTaskContext->m_apUpdates[iTask];
+      pUpdateCopy->SetCountDimensions(pWorker->GetFeatureGroups()[iFeatureGroup]->GetCountFeatures());
+      // the copy might still be expanded from a different feature group in an earlier block
+      pUpdateCopy->Reset();
+      if(!pUpdateCopy->Copy(*pWorker->GetSmallChangeToModelAccumulatedFromSamplingSets())) {
+         ret = 0;
+      }
+   }
+   pTaskContext->m_aResults[iTask] = ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION BoostJacobi(
+   BoosterHandle boosterHandle,
+   IntEbmType countThreads,
+   IntEbmType countFeatureGroupsPerBlock,
+   FloatEbmType damping,
+   GenerateUpdateOptionsType options,
+   FloatEbmType learningRate,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   const IntEbmType * leavesMax,
+   IntEbmType countRoundsMax,
+   IntEbmType countEarlyStoppingRounds,
+   FloatEbmType earlyStoppingTolerance,
+   IntEbmType * countRoundsOut,
+   FloatEbmType * bestMetricOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered BoostJacobi: boosterHandle=%p, countThreads=%" IntEbmTypePrintf ", countFeatureGroupsPerBlock=%" IntEbmTypePrintf
+      ", damping=%" FloatEbmTypePrintf ", options=0x%" UGenerateUpdateOptionsTypePrintf ", learningRate=%" FloatEbmTypePrintf
+      ", countSamplesRequiredForChildSplitMin=%" IntEbmTypePrintf ", leavesMax=%p, countRoundsMax=%" IntEbmTypePrintf
+      ", countEarlyStoppingRounds=%" IntEbmTypePrintf ", earlyStoppingTolerance=%" FloatEbmTypePrintf
+      ", countRoundsOut=%p, bestMetricOut=%p",
+      static_cast<void *>(boosterHandle),
+      countThreads,
+      countFeatureGroupsPerBlock,
+      damping,
+      static_cast<UGenerateUpdateOptionsType>(options), // signed to unsigned conversion is defined behavior in C++
+      learningRate,
+      countSamplesRequiredForChildSplitMin,
+      static_cast<const void *>(leavesMax),
+      countRoundsMax,
+      countEarlyStoppingRounds,
+      earlyStoppingTolerance,
+      static_cast<void *>(countRoundsOut),
+      static_cast<void *>(bestMetricOut)
+   );
+
+   FloatEbmType bestMetric = std::numeric_limits<FloatEbmType>::infinity();
+   IntEbmType cRounds = 0;
+   if(nullptr != countRoundsOut) {
+      *countRoundsOut = cRounds;
+   }
+   if(nullptr != bestMetricOut) {
+      *bestMetricOut = bestMetric;
+   }
+
+   Booster * pBooster = reinterpret_cast<Booster *>(boosterHandle);
+   if(nullptr == pBooster) {
+      LOG_0(TraceLevelError, "ERROR BoostJacobi boosterHandle cannot be nullptr");
+      return 1;
+   }
+   if(countThreads < 0) {
+      LOG_0(TraceLevelError, "ERROR BoostJacobi countThreads must be positive");
+      return 1;
+   }
+   if(countFeatureGroupsPerBlock < 0) {
+      LOG_0(TraceLevelError, "ERROR BoostJacobi countFeatureGroupsPerBlock must be positive");
+      return 1;
+   }
+   if(IsClassification(pBooster->GetRuntimeLearningTypeOrCountTargetClasses()) && 
+      pBooster->GetRuntimeLearningTypeOrCountTargetClasses() <= ptrdiff_t { 1 }
+   ) {
+      // like BoostingStep, we predict a single class perfectly, so there is nothing to boost
+      LOG_0(TraceLevelWarning, "WARNING BoostJacobi pBooster->m_runtimeLearningTypeOrCountTargetClasses <= ptrdiff_t { 1 }");
+      if(nullptr != bestMetricOut) {
+         *bestMetricOut = FloatEbmType { 0 };
+      }
+      return 0;
+   }
+   const size_t cFeatureGroups = pBooster->GetCountFeatureGroups();
+   if(0 == cFeatureGroups || countRoundsMax <= 0) {
+      LOG_0(TraceLevelInfo, "Exited BoostJacobi with nothing to boost");
+      return 0;
+   }
+
+   // 0 == countFeatureGroupsPerBlock means all the feature groups are boosted from the same residuals
+   const size_t cFeatureGroupsPerBlock = IntEbmType { 0 } == countFeatureGroupsPerBlock || 
+      !IsNumberConvertable<size_t>(countFeatureGroupsPerBlock) ? cFeatureGroups :
+      EbmMin(static_cast<size_t>(countFeatureGroupsPerBlock), cFeatureGroups);
+   // 0 == countThreads means use the whole thread pool
+   size_t cThreads = IntEbmType { 0 } == countThreads || !IsNumberConvertable<size_t>(countThreads) ?
+      GetThreadPoolSize() : static_cast<size_t>(countThreads);
+   cThreads = EbmMin(cThreads, cFeatureGroupsPerBlock);
+
+   const size_t cVectorLength = GetVectorLength(pBooster->GetRuntimeLearningTypeOrCountTargetClasses());
+
+   Booster ** const apWorkers = EbmMalloc<Booster *>(cThreads);
+   SeedEbmType * const aSeeds = EbmMalloc<SeedEbmType>(cFeatureGroupsPerBlock);
+   SegmentedTensor ** const apUpdates = EbmMalloc<SegmentedTensor *>(cFeatureGroupsPerBlock);
+   IntEbmType * const aResults = EbmMalloc<IntEbmType>(cFeatureGroupsPerBlock);
+
+   IntEbmType ret = 0;
+   if(nullptr == apWorkers || nullptr == aSeeds || nullptr == apUpdates || nullptr == aResults) {
+      LOG_0(TraceLevelWarning, "WARNING BoostJacobi out of memory");
+      free(apWorkers);
+      free(aSeeds);
+      free(apUpdates);
+      free(aResults);
+      return 1;
+   }
+   for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+      apWorkers[iThread] = Booster::AllocateWorker(pBooster);
+      if(nullptr == apWorkers[iThread]) {
+         ret = 1;
+      }
+   }
+   for(size_t iUpdate = 0; iUpdate < cFeatureGroupsPerBlock; ++iUpdate) {
+      apUpdates[iUpdate] = SegmentedTensor::Allocate(k_cDimensionsMax, cVectorLength);
+      if(nullptr == apUpdates[iUpdate]) {
+         ret = 1;
+      }
+   }
+   if(0 != ret) {
+      LOG_0(TraceLevelWarning, "WARNING BoostJacobi out of memory");
+      goto exit_boosting;
+   }
+
+   {
+      BoostJacobiTaskContext taskContext;
+      taskContext.m_apWorkers = apWorkers;
+      taskContext.m_options = options;
+      // damping shrinks the updates that were all generated from the same residuals, since they can overshoot when 
+      // applied together.  The updates are proportional to the learning rate, so we damp that
+      taskContext.m_learningRate = learningRate * damping;
+      taskContext.m_countSamplesRequiredForChildSplitMin = countSamplesRequiredForChildSplitMin;
+      taskContext.m_aLeavesMax = leavesMax;
+      taskContext.m_aSeeds = aSeeds;
+      taskContext.m_apUpdates = apUpdates;
+      taskContext.m_aResults = aResults;
+
+      IntEbmType cRoundsWithoutChange = 0;
+      FloatEbmType baselineMetric = std::numeric_limits<FloatEbmType>::infinity();
+      while(cRounds < countRoundsMax) {
+         ++cRounds;
+         for(size_t iFeatureGroupFirst = 0; iFeatureGroupFirst < cFeatureGroups; iFeatureGroupFirst += cFeatureGroupsPerBlock) {
+            const size_t cFeatureGroupsInBlock = EbmMin(cFeatureGroupsPerBlock, cFeatureGroups - iFeatureGroupFirst);
+            for(size_t iUpdate = 0; iUpdate < cFeatureGroupsInBlock; ++iUpdate) {
+               aSeeds[iUpdate] = pBooster->GetRandomStream()->NextSeed();
+            }
+            taskContext.m_iFeatureGroupFirst = iFeatureGroupFirst;
+            RunParallelTasks(cThreads, cFeatureGroupsInBlock, BoostJacobiTask, &taskContext);
+
+            // apply the updates in feature group order so that the model doesn't depend on the thread count
+            for(size_t iUpdate = 0; iUpdate < cFeatureGroupsInBlock; ++iUpdate) {
+               ret = aResults[iUpdate];
+               if(0 != ret) {
+                  LOG_N(TraceLevelWarning, "WARNING BoostJacobi GenerateModelFeatureGroupUpdate returned %" IntEbmTypePrintf, ret);
+                  goto exit_boosting;
+               }
+               FloatEbmType validationMetric;
+               // iFeatureGroupFirst + iUpdate is below the count of feature groups, which came to us as an IntEbmType
+               ret = ApplyModelFeatureGroupUpdate(
+                  boosterHandle,
+                  static_cast<IntEbmType>(iFeatureGroupFirst + iUpdate),
+                  apUpdates[iUpdate]->GetValues(),
+                  &validationMetric
+               );
+               if(0 != ret) {
+                  LOG_N(TraceLevelWarning, "WARNING BoostJacobi ApplyModelFeatureGroupUpdate returned %" IntEbmTypePrintf, ret);
+                  goto exit_boosting;
+               }
+               if(validationMetric < bestMetric) {
+                  bestMetric = validationMetric;
+               }
+            }
+         }
+         if(IsEarlyStoppingRound(bestMetric, countEarlyStoppingRounds, earlyStoppingTolerance, &cRoundsWithoutChange, &baselineMetric)) {
+            break;
+         }
+      }
+   }
+
+exit_boosting:;
+   for(size_t iUpdate = 0; iUpdate < cFeatureGroupsPerBlock; ++iUpdate) {
+      SegmentedTensor::Free(apUpdates[iUpdate]);
+   }
+   for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+      Booster::FreeWorker(apWorkers[iThread]);
+   }
+   free(aResults);
+   free(apUpdates);
+   free(aSeeds);
+   free(apWorkers);
+
+   if(nullptr != countRoundsOut) {
+      *countRoundsOut = cRounds;
+   }
+   if(nullptr != bestMetricOut) {
+      *bestMetricOut = bestMetric;
+   }
+   LOG_N(TraceLevelInfo, "Exited BoostJacobi: cRounds=%" IntEbmTypePrintf ", bestMetric=%" FloatEbmTypePrintf, cRounds, bestMetric);
+   return ret;
+}
+
 EBM_NATIVE_IMPORT_EXPORT_BODY FloatEbmType * EBM_NATIVE_CALLING_CONVENTION GetBestModelFeatureGroup(
    BoosterHandle boosterHandle,
    IntEbmType indexFeatureGroup
@@ -52,6 +52,7 @@ class Booster final {
    SegmentedTensor * m_pSmallChangeToModelAccumulatedFromSamplingSets;
 
    CachedBoostingThreadResources * m_pCachedThreadResources;
+   size_t m_cBytesArrayEquivalentSplitMax;
 
    RandomStream m_randomStream;
 
@@ -94,6 +95,7 @@ public:
       m_pSmallChangeToModelAccumulatedFromSamplingSets = nullptr;
 
       m_pCachedThreadResources = nullptr;
+      m_cBytesArrayEquivalentSplitMax = 0;
    }
 
    INLINE_ALWAYS ptrdiff_t GetRuntimeLearningTypeOrCountTargetClasses() const {
@@ -158,6 +160,12 @@ public:
 
    static void Free(Booster * const pBooster);
 
+   // A worker shares everything with pBooster except the scratch space and random stream that 
+   // GenerateModelFeatureGroupUpdate writes to, so several workers can generate updates for different feature groups 
+   // from the same residuals at once.  Workers must not apply updates, and must be freed with FreeWorker before pBooster
+   static Booster * AllocateWorker(const Booster * const pBooster);
+   static void FreeWorker(Booster * const pWorker);
+
    static Booster * Allocate(
       const SeedEbmType randomSeed,
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
@@ -165,6 +173,7 @@ public:
       const size_t cFeatureGroups,
       const size_t cSamplingSets,
       const FloatEbmType * const optionalTempParams,
+      const bool bFloat32Storage,
       const BoolEbmType * const aFeaturesCategorical,
       const IntEbmType * const aFeaturesBinCount,
       const IntEbmType * const aFeatureGroupsFeatureCounts,
@@ -178,7 +187,10 @@ public:
       const void * const aValidationTargets, 
       const IntEbmType * const aValidationBinnedData, 
       const FloatEbmType * const aValidationWeights,
-      const FloatEbmType * const aValidationPredictorScores
+      const FloatEbmType * const aValidationPredictorScores,
+      DataSetByFeatureGroup * const pDataSetShared,
+      const size_t * const aiTrainingSharedSamples,
+      const size_t * const aiValidationSharedSamples
    );
 };
 static_assert(std::is_standard_layout<Booster>::value,
@@ -6,6 +6,7 @@
 
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // numeric_limits
+#include <algorithm> // std::partial_sort
 
 #include "ebm_native.h"
 #include "EbmInternal.h"
@@ -18,6 +19,7 @@
 #include "CachedThreadResourcesInteraction.h"
 
 #include "InteractionDetector.h"
+#include "Threading.h"
 
 #include "TensorTotalsSum.h"
 
@@ -236,65 +238,55 @@ static bool CalculateInteractionScoreInternal(
    return false;
 }
 
-// we made this a global because if we had put this variable inside the InteractionDetector object, then we would need to dereference that before getting 
-// the count.  By making this global we can send a log message incase a bad InteractionDetector object is sent into us we only decrease the count if the 
-// count is non-zero, so at worst if there is a race condition then we'll output this log message more times than desired, but we can live with that
-static int g_cLogCalculateInteractionScoreParametersMessages = 10;
-
-EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION CalculateInteractionScore(
-   InteractionDetectorHandle interactionDetectorHandle,
-   IntEbmType countFeaturesInGroup,
-   const IntEbmType * featureIndexes,
-   IntEbmType countSamplesRequiredForChildSplitMin,
-   FloatEbmType * interactionScoreOut
-) {
-   LOG_COUNTED_N(
-      &g_cLogCalculateInteractionScoreParametersMessages,
-      TraceLevelInfo,
-      TraceLevelVerbose,
-      "CalculateInteractionScore parameters: interactionDetectorHandle=%p, countFeaturesInGroup=%" IntEbmTypePrintf ", featureIndexes=%p, countSamplesRequiredForChildSplitMin=%" IntEbmTypePrintf ", interactionScoreOut=%p",
-      static_cast<void *>(interactionDetectorHandle),
-      countFeaturesInGroup,
-      static_cast<const void *>(featureIndexes),
-      countSamplesRequiredForChildSplitMin,
-      static_cast<void *>(interactionScoreOut)
-   );
-
-   InteractionDetector * pInteractionDetector = reinterpret_cast<InteractionDetector *>(interactionDetectorHandle);
-   if(nullptr == pInteractionDetector) {
-      if(LIKELY(nullptr != interactionScoreOut)) {
-         *interactionScoreOut = FloatEbmType { 0 };
+static size_t GetSamplesRequiredForChildSplitMin(const IntEbmType countSamplesRequiredForChildSplitMin) {
+   size_t cSamplesRequiredForChildSplitMin = size_t { 1 }; // this is the min value
+   if(IntEbmType { 1 } <= countSamplesRequiredForChildSplitMin) {
+      cSamplesRequiredForChildSplitMin = static_cast<size_t>(countSamplesRequiredForChildSplitMin);
+      if(!IsNumberConvertable<size_t>(countSamplesRequiredForChildSplitMin)) {
+         // we can never exceed a size_t number of samples, so let's just set it to the maximum if we were going to overflow because it will generate 
+         // the same results as if we used the true number
+         cSamplesRequiredForChildSplitMin = std::numeric_limits<size_t>::max();
       }
-      LOG_0(TraceLevelError, "ERROR CalculateInteractionScore ebmInteraction cannot be nullptr");
-      return 1;
+   } else {
+      LOG_0(TraceLevelWarning, "WARNING GetSamplesRequiredForChildSplitMin countSamplesRequiredForChildSplitMin can't be less than 1.  Adjusting to 1.");
    }
+   return cSamplesRequiredForChildSplitMin;
+}
 
-   LOG_COUNTED_0(pInteractionDetector->GetPointerCountLogEnterMessages(), TraceLevelInfo, TraceLevelVerbose, "Entered CalculateInteractionScore");
-
+// this only reads from the InteractionDetector and writes to pCachedThreadResources, so different threads can score 
+// different feature groups at the same time as long as each has its own CachedInteractionThreadResources
+static IntEbmType CalculateInteractionScoreGroup(
+   CachedInteractionThreadResources * const pCachedThreadResources,
+   InteractionDetector * const pInteractionDetector,
+   const IntEbmType countFeaturesInGroup,
+   const IntEbmType * const featureIndexes,
+   const size_t cSamplesRequiredForChildSplitMin,
+   FloatEbmType * const interactionScoreOut
+) {
    if(countFeaturesInGroup < 0) {
       if(LIKELY(nullptr != interactionScoreOut)) {
          *interactionScoreOut = FloatEbmType { 0 };
       }
-      LOG_0(TraceLevelError, "ERROR CalculateInteractionScore countFeaturesInGroup must be positive");
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScoreGroup countFeaturesInGroup must be positive");
       return 1;
    }
    if(0 != countFeaturesInGroup && nullptr == featureIndexes) {
       if(LIKELY(nullptr != interactionScoreOut)) {
          *interactionScoreOut = FloatEbmType { 0 };
       }
-      LOG_0(TraceLevelError, "ERROR CalculateInteractionScore featureIndexes cannot be nullptr if 0 < countFeaturesInGroup");
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScoreGroup featureIndexes cannot be nullptr if 0 < countFeaturesInGroup");
       return 1;
    }
    if(!IsNumberConvertable<size_t>(countFeaturesInGroup)) {
       if(LIKELY(nullptr != interactionScoreOut)) {
          *interactionScoreOut = FloatEbmType { 0 };
       }
-      LOG_0(TraceLevelError, "ERROR CalculateInteractionScore countFeaturesInGroup too large to index");
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScoreGroup countFeaturesInGroup too large to index");
       return 1;
    }
    size_t cFeaturesInGroup = static_cast<size_t>(countFeaturesInGroup);
    if(0 == cFeaturesInGroup) {
-      LOG_0(TraceLevelInfo, "INFO CalculateInteractionScore empty feature group");
+      LOG_0(TraceLevelInfo, "INFO CalculateInteractionScoreGroup empty feature group");
       if(nullptr != interactionScoreOut) {
          // we return the lowest value possible for the interaction score, but we don't return an error since we handle it even though we'd prefer our 
          // caler be smarter about this condition
@@ -304,7 +296,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION Calculate
    }
    if(0 == pInteractionDetector->GetDataSetByFeature()->GetCountSamples()) {
       // if there are zero samples, there isn't much basis to say whether there are interactions, so just return zero
-      LOG_0(TraceLevelInfo, "INFO CalculateInteractionScore zero samples");
+      LOG_0(TraceLevelInfo, "INFO CalculateInteractionScoreGroup zero samples");
       if(nullptr != interactionScoreOut) {
          // we return the lowest value possible for the interaction score, but we don't return an error since we handle it even though we'd prefer our 
          // caler be smarter about this condition
@@ -313,18 +305,6 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION Calculate
       return 0;
    }
 
-   size_t cSamplesRequiredForChildSplitMin = size_t { 1 }; // this is the min value
-   if(IntEbmType { 1 } <= countSamplesRequiredForChildSplitMin) {
-      cSamplesRequiredForChildSplitMin = static_cast<size_t>(countSamplesRequiredForChildSplitMin);
-      if(!IsNumberConvertable<size_t>(countSamplesRequiredForChildSplitMin)) {
-         // we can never exceed a size_t number of samples, so let's just set it to the maximum if we were going to overflow because it will generate 
-         // the same results as if we used the true number
-         cSamplesRequiredForChildSplitMin = std::numeric_limits<size_t>::max();
-      }
-   } else {
-      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScore countSamplesRequiredForChildSplitMin can't be less than 1.  Adjusting to 1.");
-   }
-
    const Feature * const aFeatures = pInteractionDetector->GetFeatures();
    const IntEbmType * pFeatureIndexes = featureIndexes;
    const IntEbmType * const pFeatureIndexesEnd = featureIndexes + cFeaturesInGroup;
@@ -335,14 +315,14 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION Calculate
          if(LIKELY(nullptr != interactionScoreOut)) {
             *interactionScoreOut = FloatEbmType { 0 };
          }
-         LOG_0(TraceLevelError, "ERROR CalculateInteractionScore featureIndexes value cannot be negative");
+         LOG_0(TraceLevelError, "ERROR CalculateInteractionScoreGroup featureIndexes value cannot be negative");
          return 1;
       }
       if(!IsNumberConvertable<size_t>(indexFeatureInterop)) {
          if(LIKELY(nullptr != interactionScoreOut)) {
             *interactionScoreOut = FloatEbmType { 0 };
          }
-         LOG_0(TraceLevelError, "ERROR CalculateInteractionScore featureIndexes value too big to reference memory");
+         LOG_0(TraceLevelError, "ERROR CalculateInteractionScoreGroup featureIndexes value too big to reference memory");
          return 1;
       }
       const size_t iFeatureInGroup = static_cast<size_t>(indexFeatureInterop);
@@ -350,7 +330,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION Calculate
          if(LIKELY(nullptr != interactionScoreOut)) {
             *interactionScoreOut = FloatEbmType { 0 };
          }
-         LOG_0(TraceLevelError, "ERROR CalculateInteractionScore featureIndexes value must be less than the number of features");
+         LOG_0(TraceLevelError, "ERROR CalculateInteractionScoreGroup featureIndexes value must be less than the number of features");
          return 1;
       }
       const Feature * const pFeature = &aFeatures[iFeatureInGroup];
@@ -360,7 +340,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION Calculate
             // our caler be smarter about this condition
             *interactionScoreOut = 0;
          }
-         LOG_0(TraceLevelInfo, "INFO CalculateInteractionScore feature with 0/1 value");
+         LOG_0(TraceLevelInfo, "INFO CalculateInteractionScoreGroup feature with 0/1 value");
          return 0;
       }
       ++pFeatureIndexes;
@@ -368,7 +348,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION Calculate
 
    if(k_cDimensionsMax < cFeaturesInGroup) {
       // if we try to run with more than k_cDimensionsMax we'll exceed our memory capacity, so let's exit here instead
-      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScore k_cDimensionsMax < cFeaturesInGroup");
+      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScoreGroup k_cDimensionsMax < cFeaturesInGroup");
       return 1;
    }
 
@@ -395,7 +375,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION Calculate
    } while(pFeatureIndexesEnd != pFeatureIndexes);
 
    if(ptrdiff_t { 0 } == pInteractionDetector->GetRuntimeLearningTypeOrCountTargetClasses() || ptrdiff_t { 1 } == pInteractionDetector->GetRuntimeLearningTypeOrCountTargetClasses()) {
-      LOG_0(TraceLevelInfo, "INFO CalculateInteractionScore target with 0/1 classes");
+      LOG_0(TraceLevelInfo, "INFO CalculateInteractionScoreGroup target with 0/1 classes");
       if(nullptr != interactionScoreOut) {
          // if there is only 1 classification target, then we can predict the outcome with 100% accuracy and there is no need for logits or 
          // interactions or anything else.  We return 0 since interactions have no benefit
@@ -404,16 +384,66 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION Calculate
       return 0;
    }
 
-   // TODO : be smarter about our CachedInteractionThreadResources, otherwise why have it?
+   const bool bError = CalculateInteractionScoreInternal(
+      pCachedThreadResources,
+      pInteractionDetector,
+      pFeatureGroup,
+      cSamplesRequiredForChildSplitMin,
+      interactionScoreOut
+   );
+   return bError ? IntEbmType { 1 } : IntEbmType { 0 };
+}
+
+// we made this a global because if we had put this variable inside the InteractionDetector object, then we would need to dereference that before getting 
+// the count.  By making this global we can send a log message incase a bad InteractionDetector object is sent into us we only decrease the count if the 
+// count is non-zero, so at worst if there is a race condition then we'll output this log message more times than desired, but we can live with that
+static int g_cLogCalculateInteractionScoreParametersMessages = 10;
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION CalculateInteractionScore(
+   InteractionDetectorHandle interactionDetectorHandle,
+   IntEbmType countFeaturesInGroup,
+   const IntEbmType * featureIndexes,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   FloatEbmType * interactionScoreOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogCalculateInteractionScoreParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "CalculateInteractionScore parameters: interactionDetectorHandle=%p, countFeaturesInGroup=%" IntEbmTypePrintf ", featureIndexes=%p, countSamplesRequiredForChildSplitMin=%" IntEbmTypePrintf ", interactionScoreOut=%p",
+      static_cast<void *>(interactionDetectorHandle),
+      countFeaturesInGroup,
+      static_cast<const void *>(featureIndexes),
+      countSamplesRequiredForChildSplitMin,
+      static_cast<void *>(interactionScoreOut)
+   );
+
+   InteractionDetector * pInteractionDetector = reinterpret_cast<InteractionDetector *>(interactionDetectorHandle);
+   if(nullptr == pInteractionDetector) {
+      if(LIKELY(nullptr != interactionScoreOut)) {
+         *interactionScoreOut = FloatEbmType { 0 };
+      }
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScore ebmInteraction cannot be nullptr");
+      return 1;
+   }
+
+   LOG_COUNTED_0(pInteractionDetector->GetPointerCountLogEnterMessages(), TraceLevelInfo, TraceLevelVerbose, "Entered CalculateInteractionScore");
+
+   const size_t cSamplesRequiredForChildSplitMin = GetSamplesRequiredForChildSplitMin(countSamplesRequiredForChildSplitMin);
+
    CachedInteractionThreadResources * const pCachedThreadResources = CachedInteractionThreadResources::Allocate();
    if(nullptr == pCachedThreadResources) {
+      if(LIKELY(nullptr != interactionScoreOut)) {
+         *interactionScoreOut = FloatEbmType { 0 };
+      }
       return 1;
    }
 
-   IntEbmType ret = CalculateInteractionScoreInternal(
+   const IntEbmType ret = CalculateInteractionScoreGroup(
       pCachedThreadResources,
       pInteractionDetector,
-      pFeatureGroup,
+      countFeaturesInGroup,
+      featureIndexes,
       cSamplesRequiredForChildSplitMin,
       interactionScoreOut
    );
@@ -438,3 +468,270 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION Calculate
    }
    return ret;
 }
+
+// enough feature groups per task that handing out tasks costs nothing next to binning the samples for each of them
+constexpr size_t k_cFeatureGroupsPerInteractionTask = 64;
+
+struct InteractionScoresTaskContext {
+
+   InteractionScoresTaskContext() = default; // preserve our POD status
+   ~InteractionScoresTaskContext() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   InteractionDetector * m_pInteractionDetector;
+   size_t m_cFeatureGroups;
+   const IntEbmType * m_aFeatureGroupsFeatureCount;
+   const IntEbmType * m_aFeatureGroupsFeatureIndexes;
+   // the position in m_aFeatureGroupsFeatureIndexes of the first feature of each task
+   const size_t * m_aiFeatureIndexFirst;
+   size_t m_cSamplesRequiredForChildSplitMin;
+   FloatEbmType * m_aInteractionScores;
+   // one per thread, so a thread reuses its buffers for all the feature groups that it scores
+   CachedInteractionThreadResources * const * m_apCachedThreadResources;
+   // one per thread so that the tasks don't need to synchronize
+   IntEbmType * m_aThreadResults;
+};
+static_assert(std::is_standard_layout<InteractionScoresTaskContext>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<InteractionScoresTaskContext>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<InteractionScoresTaskContext>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+static void InteractionScoresTask(void * const pContext, const size_t iThread, const size_t iTask) {
+   const InteractionScoresTaskContext * const pTaskContext = static_cast<const InteractionScoresTaskContext *>(pContext);
+
+   const size_t iFeatureGroupFirst = k_cFeatureGroupsPerInteractionTask * iTask;
+   const size_t iFeatureGroupEnd = EbmMin(iFeatureGroupFirst + k_cFeatureGroupsPerInteractionTask, pTaskContext->m_cFeatureGroups);
+   const IntEbmType * pFeatureIndexes = pTaskContext->m_aFeatureGroupsFeatureIndexes + pTaskContext->m_aiFeatureIndexFirst[iTask];
+   for(size_t iFeatureGroup = iFeatureGroupFirst; iFeatureGroup < iFeatureGroupEnd; ++iFeatureGroup) {
+      const IntEbmType countFeaturesInGroup = pTaskContext->m_aFeatureGroupsFeatureCount[iFeatureGroup];
+      const IntEbmType ret = CalculateInteractionScoreGroup(
+         pTaskContext->m_apCachedThreadResources[iThread],
+         pTaskContext->m_pInteractionDetector,
+         countFeaturesInGroup,
+         pFeatureIndexes,
+         pTaskContext->m_cSamplesRequiredForChildSplitMin,
+         &pTaskContext->m_aInteractionScores[iFeatureGroup]
+      );
+      if(0 != ret) {
+         // an error can leave the score unset, and a zero score is never chosen over a real one
+         pTaskContext->m_aInteractionScores[iFeatureGroup] = FloatEbmType { 0 };
+         pTaskContext->m_aThreadResults[iThread] = ret;
+      }
+      // our caller checked that these are positive and sum to less than SIZE_MAX
+      pFeatureIndexes += static_cast<size_t>(countFeaturesInGroup);
+   }
+}
+
+// higher scores first, and the lower feature group index first on ties so that the order doesn't depend on the sort
+class CompareInteractionScores final {
+   const FloatEbmType * m_aInteractionScores;
+
+public:
+
+   CompareInteractionScores(const FloatEbmType * const aInteractionScores) : m_aInteractionScores(aInteractionScores) {
+   }
+
+   INLINE_ALWAYS bool operator() (const size_t iFeatureGroup1, const size_t iFeatureGroup2) const {
+      const FloatEbmType score1 = m_aInteractionScores[iFeatureGroup1];
+      const FloatEbmType score2 = m_aInteractionScores[iFeatureGroup2];
+      if(score1 != score2) {
+         return score2 < score1;
+      }
+      return iFeatureGroup1 < iFeatureGroup2;
+   }
+};
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION CalculateInteractionScores(
+   InteractionDetectorHandle interactionDetectorHandle,
+   IntEbmType countThreads,
+   IntEbmType countFeatureGroups,
+   const IntEbmType * featureGroupsFeatureCount,
+   const IntEbmType * featureGroupsFeatureIndexes,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   IntEbmType countTopScores,
+   IntEbmType * topFeatureGroupIndexesOut,
+   FloatEbmType * interactionScoresOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered CalculateInteractionScores: interactionDetectorHandle=%p, countThreads=%" IntEbmTypePrintf 
+      ", countFeatureGroups=%" IntEbmTypePrintf ", featureGroupsFeatureCount=%p, featureGroupsFeatureIndexes=%p"
+      ", countSamplesRequiredForChildSplitMin=%" IntEbmTypePrintf ", countTopScores=%" IntEbmTypePrintf 
+      ", topFeatureGroupIndexesOut=%p, interactionScoresOut=%p",
+      static_cast<void *>(interactionDetectorHandle),
+      countThreads,
+      countFeatureGroups,
+      static_cast<const void *>(featureGroupsFeatureCount),
+      static_cast<const void *>(featureGroupsFeatureIndexes),
+      countSamplesRequiredForChildSplitMin,
+      countTopScores,
+      static_cast<void *>(topFeatureGroupIndexesOut),
+      static_cast<void *>(interactionScoresOut)
+   );
+
+   InteractionDetector * const pInteractionDetector = reinterpret_cast<InteractionDetector *>(interactionDetectorHandle);
+   if(nullptr == pInteractionDetector) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScores interactionDetectorHandle cannot be nullptr");
+      return 1;
+   }
+   if(countThreads < 0) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScores countThreads must be positive");
+      return 1;
+   }
+   if(countFeatureGroups < 0) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScores countFeatureGroups must be positive");
+      return 1;
+   }
+   if(countTopScores < 0) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScores countTopScores must be positive");
+      return 1;
+   }
+   if(nullptr == interactionScoresOut) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScores interactionScoresOut cannot be nullptr");
+      return 1;
+   }
+   if(0 != countTopScores && nullptr == topFeatureGroupIndexesOut) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScores topFeatureGroupIndexesOut cannot be nullptr if 0 < countTopScores");
+      return 1;
+   }
+   if(0 == countFeatureGroups) {
+      LOG_0(TraceLevelInfo, "Exited CalculateInteractionScores with no feature groups");
+      return 0;
+   }
+   if(nullptr == featureGroupsFeatureCount) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScores featureGroupsFeatureCount cannot be nullptr");
+      return 1;
+   }
+   if(!IsNumberConvertable<size_t>(countFeatureGroups) || 
+      IsMultiplyError(static_cast<size_t>(countFeatureGroups), EbmMax(sizeof(FloatEbmType), sizeof(size_t)))
+   ) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScores countFeatureGroups too large to index");
+      return 1;
+   }
+   const size_t cFeatureGroups = static_cast<size_t>(countFeatureGroups);
+   // a countTopScores of 0 means we return every score in order
+   const size_t cTopScores = 0 == countTopScores || !IsNumberConvertable<size_t>(countTopScores) ? 
+      cFeatureGroups : EbmMin(static_cast<size_t>(countTopScores), cFeatureGroups);
+
+   const size_t cTasks = (cFeatureGroups - size_t { 1 }) / k_cFeatureGroupsPerInteractionTask + size_t { 1 };
+   size_t * const aiFeatureIndexFirst = EbmMalloc<size_t>(cTasks);
+   if(nullptr == aiFeatureIndexFirst) {
+      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScores nullptr == aiFeatureIndexFirst");
+      return 1;
+   }
+   // the tasks start at arbitrary feature groups, so find where each one's features start
+   size_t cFeatureIndexes = 0;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      if(0 == iFeatureGroup % k_cFeatureGroupsPerInteractionTask) {
+         aiFeatureIndexFirst[iFeatureGroup / k_cFeatureGroupsPerInteractionTask] = cFeatureIndexes;
+      }
+      const IntEbmType countFeaturesInGroup = featureGroupsFeatureCount[iFeatureGroup];
+      if(countFeaturesInGroup < 0) {
+         LOG_0(TraceLevelError, "ERROR CalculateInteractionScores featureGroupsFeatureCount cannot contain negative numbers");
+         free(aiFeatureIndexFirst);
+         return 1;
+      }
+      if(!IsNumberConvertable<size_t>(countFeaturesInGroup) || 
+         IsAddError(cFeatureIndexes, static_cast<size_t>(countFeaturesInGroup))
+      ) {
+         LOG_0(TraceLevelError, "ERROR CalculateInteractionScores featureGroupsFeatureCount too large to index");
+         free(aiFeatureIndexFirst);
+         return 1;
+      }
+      cFeatureIndexes += static_cast<size_t>(countFeaturesInGroup);
+   }
+   if(0 != cFeatureIndexes && nullptr == featureGroupsFeatureIndexes) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScores featureGroupsFeatureIndexes cannot be nullptr if there are features");
+      free(aiFeatureIndexFirst);
+      return 1;
+   }
+
+   // 0 == countThreads means use the whole thread pool
+   size_t cThreads = IntEbmType { 0 } == countThreads || !IsNumberConvertable<size_t>(countThreads) ?
+      GetThreadPoolSize() : static_cast<size_t>(countThreads);
+   cThreads = EbmMin(cThreads, cTasks);
+
+   // with top scores we keep every score here and return the best ones
+   FloatEbmType * aInteractionScores = interactionScoresOut;
+   size_t * aiFeatureGroupsSorted = nullptr;
+   if(0 != countTopScores) {
+      aInteractionScores = EbmMalloc<FloatEbmType>(cFeatureGroups);
+      aiFeatureGroupsSorted = EbmMalloc<size_t>(cFeatureGroups);
+   }
+   CachedInteractionThreadResources ** const apCachedThreadResources = EbmMalloc<CachedInteractionThreadResources *>(cThreads);
+   IntEbmType * const aThreadResults = EbmMalloc<IntEbmType>(cThreads);
+
+   IntEbmType ret = 0;
+   if(nullptr == aInteractionScores || nullptr == apCachedThreadResources || nullptr == aThreadResults ||
+      (interactionScoresOut != aInteractionScores && nullptr == aiFeatureGroupsSorted)
+   ) {
+      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScores out of memory");
+      ret = 1;
+   } else {
+      for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+         aThreadResults[iThread] = 0;
+         apCachedThreadResources[iThread] = CachedInteractionThreadResources::Allocate();
+         if(nullptr == apCachedThreadResources[iThread]) {
+            LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScores nullptr == apCachedThreadResources[iThread]");
+            ret = 1;
+         }
+      }
+      if(0 == ret) {
+         InteractionScoresTaskContext taskContext;
+         taskContext.m_pInteractionDetector = pInteractionDetector;
+         taskContext.m_cFeatureGroups = cFeatureGroups;
+         taskContext.m_aFeatureGroupsFeatureCount = featureGroupsFeatureCount;
+         taskContext.m_aFeatureGroupsFeatureIndexes = featureGroupsFeatureIndexes;
+         taskContext.m_aiFeatureIndexFirst = aiFeatureIndexFirst;
+         taskContext.m_cSamplesRequiredForChildSplitMin = GetSamplesRequiredForChildSplitMin(countSamplesRequiredForChildSplitMin);
+         taskContext.m_aInteractionScores = aInteractionScores;
+         taskContext.m_apCachedThreadResources = apCachedThreadResources;
+         taskContext.m_aThreadResults = aThreadResults;
+         RunParallelTasks(cThreads, cTasks, InteractionScoresTask, &taskContext);
+
+         for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+            if(0 != aThreadResults[iThread]) {
+               ret = aThreadResults[iThread];
+            }
+         }
+
+         // if any feature group failed we return the error and leave the caller's top scores untouched
+         if(0 == ret && interactionScoresOut != aInteractionScores) {
+            for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+               aiFeatureGroupsSorted[iFeatureGroup] = iFeatureGroup;
+            }
+            std::partial_sort(
+               aiFeatureGroupsSorted, 
+               aiFeatureGroupsSorted + cTopScores, 
+               aiFeatureGroupsSorted + cFeatureGroups, 
+               CompareInteractionScores(aInteractionScores)
+            );
+            for(size_t iTop = 0; iTop < cTopScores; ++iTop) {
+               const size_t iFeatureGroup = aiFeatureGroupsSorted[iTop];
+               // iFeatureGroup is below countFeatureGroups
+               topFeatureGroupIndexesOut[iTop] = static_cast<IntEbmType>(iFeatureGroup);
+               interactionScoresOut[iTop] = aInteractionScores[iFeatureGroup];
+            }
+         }
+      }
+      for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+         if(nullptr != apCachedThreadResources[iThread]) {
+            CachedInteractionThreadResources::Free(apCachedThreadResources[iThread]);
+         }
+      }
+   }
+
+   free(aThreadResults);
+   free(apCachedThreadResources);
+   if(interactionScoresOut != aInteractionScores) {
+      free(aInteractionScores);
+   }
+   free(aiFeatureGroupsSorted);
+   free(aiFeatureIndexFirst);
+
+   LOG_N(TraceLevelInfo, "Exited CalculateInteractionScores %" IntEbmTypePrintf, ret);
+   return ret;
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <stdint.h> // uint32_t, uint64_t
+#include <atomic>
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+
+#include "CpuDispatch.h"
+
+#ifdef CPU_VARIANTS
+#include <cpuid.h>
+
+// the XCR0 register says which register states the operating system saves on a context switch.  The CPU can
+// support AVX while the OS doesn't, and then using the upper halves of the registers faults
+static uint64_t GetEnabledRegisterStates() {
+   uint32_t eax;
+   uint32_t edx;
+   __asm__ __volatile__("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+   return static_cast<uint64_t>(edx) << 32 | static_cast<uint64_t>(eax);
+}
+
+static CpuVariantType DetectCpuVariant() {
+   unsigned int eax;
+   unsigned int ebx;
+   unsigned int ecx;
+   unsigned int edx;
+
+   if(0 == __get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+      return CpuVariant_Generic;
+   }
+   constexpr unsigned int k_bitsAvxOs = (1u << 27) | (1u << 28); // OSXSAVE, AVX
+   if(k_bitsAvxOs != (k_bitsAvxOs & ecx)) {
+      return CpuVariant_Generic;
+   }
+   const uint64_t registerStates = GetEnabledRegisterStates();
+   constexpr uint64_t k_statesAvx = 0x6; // XMM, YMM
+   if(k_statesAvx != (k_statesAvx & registerStates)) {
+      return CpuVariant_Generic;
+   }
+
+   if(__get_cpuid_max(0, nullptr) < 7) {
+      return CpuVariant_Generic;
+   }
+   __cpuid_count(7, 0, eax, ebx, ecx, edx);
+   constexpr unsigned int k_bitsAvx2 = (1u << 3) | (1u << 5) | (1u << 8); // BMI1, AVX2, BMI2
+   if(k_bitsAvx2 != (k_bitsAvx2 & ebx)) {
+      return CpuVariant_Generic;
+   }
+
+   constexpr unsigned int k_bitsAvx512 = (1u << 16) | (1u << 17) | (1u << 30) | (1u << 31); // F, DQ, BW, VL
+   constexpr uint64_t k_statesAvx512 = 0xE0; // opmask, upper half of ZMM0-15, ZMM16-31
+   if(k_bitsAvx512 != (k_bitsAvx512 & ebx) || k_statesAvx512 != (k_statesAvx512 & registerStates)) {
+      return CpuVariant_AVX2;
+   }
+   return CpuVariant_AVX512;
+}
+
+#else // CPU_VARIANTS
+
+static CpuVariantType DetectCpuVariant() {
+   return CpuVariant_Generic;
+}
+
+#endif // CPU_VARIANTS
+
+extern CpuVariantType GetCpuVariantSupported() {
+   // C++11 guarantees that this runs once, even if several threads get here at the same time
+   static const CpuVariantType cpuVariantSupported = DetectCpuVariant();
+   return cpuVariantSupported;
+}
+
+// initialized when the library loads.  Nothing calls into our kernels before that
+static std::atomic<CpuVariantType> g_cpuVariant(GetCpuVariantSupported());
+
+CpuVariantType GetKernelCpuVariant() {
+   return g_cpuVariant.load(std::memory_order_relaxed);
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY CpuVariantType EBM_NATIVE_CALLING_CONVENTION GetCpuVariant() {
+   return GetKernelCpuVariant();
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION SetCpuVariant(CpuVariantType cpuVariant) {
+   LOG_N(TraceLevelInfo, "Entered SetCpuVariant: cpuVariant=%" CpuVariantTypePrintf, cpuVariant);
+
+   if(cpuVariant < CpuVariant_Generic) {
+      LOG_0(TraceLevelError, "ERROR SetCpuVariant cpuVariant must be a CpuVariant_* value");
+      return IntEbmType { 1 };
+   }
+   if(GetCpuVariantSupported() < cpuVariant) {
+      LOG_0(TraceLevelWarning, "WARNING SetCpuVariant cpuVariant is not supported by this CPU or build");
+      return IntEbmType { 1 };
+   }
+   g_cpuVariant.store(cpuVariant, std::memory_order_relaxed);
+
+   LOG_0(TraceLevelInfo, "Exited SetCpuVariant");
+   return IntEbmType { 0 };
+}
@@ -0,0 +1,59 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef CPU_DISPATCH_H
+#define CPU_DISPATCH_H
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "ebm_native.h"
+#include "EbmInternal.h" // INLINE_ALWAYS
+
+// We build the kernel variants with target pragmas instead of compiling whole files with -mavx2 and the like.  A
+// file compiled with -mavx2 would also compile any inline functions and templates it shares with other files for
+// AVX2, and the linker is free to keep that copy for the whole library, which then crashes on older CPUs.  The
+// pragmas only apply to the functions defined inside the CpuVariant* namespaces (see CpuVariantKernels.h), so we
+// don't need per-file flags in build.sh, the R Makevars, or the Visual Studio project.  MSVC can't change the target
+// of a single function, so like on non-x86 processors we only build CpuVariant_Generic there
+#if (defined(__clang__) || defined(__GNUC__)) && (defined(__x86_64__) || defined(__i386__))
+#define CPU_VARIANTS
+#endif // compiler and processor
+
+// The SIMD kernels use the bin indexes and targets (StorageDataType, which is size_t) directly as 64-bit vector lanes
+// next to the FloatEbmType lanes, so we only build them for 64-bit x86.  Every x64 processor has SSE2, so
+// CpuVariant_Generic gets 2 lanes there too.  The intrinsics have to be included out here since CpuVariantSimd.h is
+// included inside the CpuVariant* namespaces
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#define SIMD_X64
+// some versions of g++ warn about the deliberately undefined registers inside the AVX-512 intrinsics once they get 
+// inlined into our kernels, and the warning takes its setting from where the intrinsic is defined
+WARNING_PUSH
+WARNING_DISABLE_UNINITIALIZED_LOCAL_VARIABLE
+#include <immintrin.h>
+WARNING_POP
+#endif // 64-bit x86
+
+// returns the best variant that both the CPU and this build support.  It's safe to call during static initialization
+extern CpuVariantType GetCpuVariantSupported();
+
+// returns the variant the kernels should use right now.  This is SetCpuVariant's value, or the best variant that the
+// CPU supports if SetCpuVariant hasn't been called.  It's a single relaxed atomic load, so call it per chunk of work
+extern CpuVariantType GetKernelCpuVariant();
+
+template<typename TFunction>
+INLINE_ALWAYS TFunction SelectCpuVariant(const TFunction pGeneric, const TFunction pAvx2, const TFunction pAvx512) {
+   const CpuVariantType cpuVariant = GetKernelCpuVariant();
+   return CpuVariant_AVX512 == cpuVariant ? pAvx512 : CpuVariant_AVX2 == cpuVariant ? pAvx2 : pGeneric;
+}
+
+// picks the copy of a kernel function that CpuVariantKernels.h built for the active variant
+#define SELECT_CPU_VARIANT(FUNCTION) \
+   (SelectCpuVariant(&CpuVariantGeneric::FUNCTION, &CpuVariantAvx2::FUNCTION, &CpuVariantAvx512::FUNCTION))
+
+// like SELECT_CPU_VARIANT, but for kernels built with CPU_VARIANT_KERNEL_FLOAT_STORAGE, so we also pick the copy that
+// matches the type of the residuals and predictor scores
+#define SELECT_CPU_VARIANT_STORAGE(B_FLOAT32_STORAGE, FUNCTION) \
+   ((B_FLOAT32_STORAGE) ? SELECT_CPU_VARIANT(StorageFloat32::FUNCTION) : SELECT_CPU_VARIANT(StorageFloat64::FUNCTION))
+
+#endif // CPU_DISPATCH_H
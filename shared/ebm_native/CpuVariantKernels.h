@@ -0,0 +1,109 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+// This file deliberately has no include guard.  A kernel .cpp file includes CpuDispatch.h and everything else it
+// needs, then defines CPU_VARIANT_KERNEL as the name of the header that holds its kernels, and then includes this file
+// once.  We include the kernel header once per variant, each time inside that variant's namespace and compiled for
+// that variant's instruction set.  Kernel headers are only ever included from here, so they have no include guard and
+// cannot include anything themselves.  Anything they need has to be included by the .cpp file beforehand, which also
+// keeps the shared inline functions in those headers compiled for the baseline instruction set.  Just before each
+// kernel header we include CpuVariantSimd.h, which gives the kernels a SimdVector class as wide as the variant allows.
+// Each variant also sets k_bUseSIMD, which is what the kernels check to choose between their SIMD and scalar paths.
+// Every x64 processor has SSE2, so CpuVariant_Generic takes the SIMD paths there too, 2 lanes at a time.
+//
+// Kernels that read or write the per-sample residuals and predictor scores define CPU_VARIANT_KERNEL_FLOAT_STORAGE as 
+// well.  We then include their kernel header twice per variant, inside the StorageFloat64 and StorageFloat32 
+// namespaces, with FloatStorageType set to the type those arrays are stored in.  The kernels always compute in 
+// FloatEbmType and only convert when loading from or storing to the arrays.
+//
+// Contracting a multiply and an add into an FMA changes the rounding, and AVX-512 implies FMA, so we turn contraction
+// off inside the variants.  That way every variant gives bitwise identical results to CpuVariant_Generic.
+
+#ifndef CPU_VARIANT_KERNEL
+#error define CPU_VARIANT_KERNEL before including CpuVariantKernels.h
+#endif // CPU_VARIANT_KERNEL
+
+#ifdef CPU_VARIANT_KERNEL_FLOAT_STORAGE
+#define CPU_VARIANT_KERNEL_INCLUDE "CpuVariantKernelsStorage.h"
+#else // CPU_VARIANT_KERNEL_FLOAT_STORAGE
+#define CPU_VARIANT_KERNEL_INCLUDE CPU_VARIANT_KERNEL
+#endif // CPU_VARIANT_KERNEL_FLOAT_STORAGE
+
+namespace CpuVariantGeneric {
+#ifdef SIMD_X64
+#define SIMD_SSE2
+constexpr bool k_bUseSIMD = true;
+#else // SIMD_X64
+constexpr bool k_bUseSIMD = false;
+#endif // SIMD_X64
+#include "CpuVariantSimd.h"
+#include CPU_VARIANT_KERNEL_INCLUDE
+#undef SIMD_SSE2
+} // CpuVariantGeneric
+
+#ifdef CPU_VARIANTS
+
+#if defined(__clang__)
+// this lasts until the end of the .cpp file, which doesn't matter since the code after us is built for the baseline
+#pragma clang fp contract(off)
+#endif // __clang__
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,bmi,bmi2"))), apply_to = function)
+#else // __clang__
+#pragma GCC push_options
+#pragma GCC target("avx2,bmi,bmi2")
+#pragma GCC optimize("fp-contract=off")
+#endif // __clang__
+namespace CpuVariantAvx2 {
+#ifdef SIMD_X64
+#define SIMD_AVX2
+constexpr bool k_bUseSIMD = true;
+#else // SIMD_X64
+constexpr bool k_bUseSIMD = false;
+#endif // SIMD_X64
+#include "CpuVariantSimd.h"
+#include CPU_VARIANT_KERNEL_INCLUDE
+#undef SIMD_AVX2
+} // CpuVariantAvx2
+#if defined(__clang__)
+#pragma clang attribute pop
+#else // __clang__
+#pragma GCC pop_options
+#endif // __clang__
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f,avx512bw,avx512dq,avx512vl,avx2,bmi,bmi2"))), apply_to = function)
+#else // __clang__
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512dq,avx512vl,avx2,bmi,bmi2")
+#pragma GCC optimize("fp-contract=off")
+#endif // __clang__
+namespace CpuVariantAvx512 {
+#ifdef SIMD_X64
+#define SIMD_AVX512
+constexpr bool k_bUseSIMD = true;
+#else // SIMD_X64
+constexpr bool k_bUseSIMD = false;
+#endif // SIMD_X64
+#include "CpuVariantSimd.h"
+#include CPU_VARIANT_KERNEL_INCLUDE
+#undef SIMD_AVX512
+} // CpuVariantAvx512
+#if defined(__clang__)
+#pragma clang attribute pop
+#else // __clang__
+#pragma GCC pop_options
+#endif // __clang__
+
+#else // CPU_VARIANTS
+
+namespace CpuVariantAvx2 = CpuVariantGeneric;
+namespace CpuVariantAvx512 = CpuVariantGeneric;
+
+#endif // CPU_VARIANTS
+
+#undef CPU_VARIANT_KERNEL_INCLUDE
+#undef CPU_VARIANT_KERNEL_FLOAT_STORAGE
+#undef CPU_VARIANT_KERNEL
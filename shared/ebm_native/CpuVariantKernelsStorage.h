@@ -0,0 +1,17 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <ebm@koch.ninja>
+
+// This file deliberately has no include guard.  CpuVariantKernels.h includes it inside each CpuVariant* namespace in 
+// place of the kernel header when CPU_VARIANT_KERNEL_FLOAT_STORAGE is defined, and we include the kernel header once 
+// for each type that the residuals and predictor scores can be stored in
+
+namespace StorageFloat64 {
+typedef FloatEbmType FloatStorageType;
+#include CPU_VARIANT_KERNEL
+} // StorageFloat64
+
+namespace StorageFloat32 {
+typedef float FloatStorageType;
+#include CPU_VARIANT_KERNEL
+} // StorageFloat32
@@ -0,0 +1,467 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <ebm@koch.ninja>
+
+// CpuVariantKernels.h includes this once for each CPU variant, inside the variant's namespace and just before the kernel
+// header, so there is no include guard and nothing gets included here.  The intrinsics come from CpuDispatch.h
+//
+// CpuVariantKernels.h defines at most one of SIMD_SSE2, SIMD_AVX2, or SIMD_AVX512 to pick the width of SimdVector for
+// the variant, along with k_bUseSIMD.  If none of them is defined SimdVector has a single lane and k_bUseSIMD is false,
+// so the kernels use their scalar code instead.
+//
+// Each lane has to give us bitwise identical results to the scalar code, otherwise the model would depend on the CPU
+// and on where the chunk boundaries fall.  We only use operations that IEEE 754 rounds exactly (add, subtract, divide,
+// and conversions) and bit operations, and the compiler isn't allowed to contract anything here (see CpuVariantKernels.h)
+
+#if defined(SIMD_AVX512)
+
+static_assert(sizeof(StorageDataType) == sizeof(FloatEbmType), "the index and target lanes need to line up with the FloatEbmType lanes");
+
+class SimdVector final {
+   __m512d m_data;
+
+   INLINE_ALWAYS SimdVector(const __m512d data) : m_data(data) {
+   }
+
+public:
+
+   static constexpr size_t k_cLanes = 8;
+
+   SimdVector() = default;
+
+   INLINE_ALWAYS static SimdVector Load(const FloatEbmType * const a) {
+      return SimdVector(_mm512_loadu_pd(a));
+   }
+
+   INLINE_ALWAYS void Store(FloatEbmType * const a) const {
+      _mm512_storeu_pd(a, m_data);
+   }
+
+   // float storage is widened on load and rounded to nearest on store, exactly like static_cast does
+   INLINE_ALWAYS static SimdVector Load(const float * const a) {
+      return SimdVector(_mm512_cvtps_pd(_mm256_loadu_ps(a)));
+   }
+
+   INLINE_ALWAYS void Store(float * const a) const {
+      _mm256_storeu_ps(a, _mm512_cvtpd_ps(m_data));
+   }
+
+   INLINE_ALWAYS static SimdVector Broadcast(const FloatEbmType val) {
+      return SimdVector(_mm512_set1_pd(val));
+   }
+
+   INLINE_ALWAYS static SimdVector Gather(const FloatEbmType * const a, const size_t * const aIndexes) {
+      return SimdVector(_mm512_i64gather_pd(_mm512_loadu_si512(aIndexes), a, sizeof(FloatEbmType)));
+   }
+
+   // each lane is -0.0 if the target is 0 and +0.0 if the target is 1.  The targets can't be anything else
+   INLINE_ALWAYS static SimdVector LoadSignsFromBinaryTargets(const StorageDataType * const aTargets) {
+      const __m512i targets = _mm512_loadu_si512(aTargets);
+      return SimdVector(_mm512_castsi512_pd(_mm512_slli_epi64(_mm512_sub_epi64(targets, _mm512_set1_epi64(1)), 63)));
+   }
+
+   INLINE_ALWAYS friend SimdVector operator+ (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(_mm512_add_pd(left.m_data, right.m_data));
+   }
+
+   INLINE_ALWAYS friend SimdVector operator- (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(_mm512_sub_pd(left.m_data, right.m_data));
+   }
+
+   INLINE_ALWAYS friend SimdVector operator/ (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(_mm512_div_pd(left.m_data, right.m_data));
+   }
+
+   INLINE_ALWAYS friend SimdVector operator^ (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(_mm512_xor_pd(left.m_data, right.m_data));
+   }
+
+   INLINE_ALWAYS friend SimdVector operator| (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(_mm512_or_pd(left.m_data, right.m_data));
+   }
+
+   // the same as ExpApproxSchraudolph<true, true, true, false> in each lane.  The conversions give us garbage in the
+   // lanes that are out of range or NaN, but the instructions are defined for those values and we replace the lanes
+   INLINE_ALWAYS SimdVector ExpApproxSchraudolph(
+      const int32_t addExpSchraudolphTerm = k_expTermZeroMeanErrorForSoftmaxWithZeroedLogit
+   ) const {
+      const __m256 valFloat = _mm512_cvtpd_ps(m_data);
+      const __m256i retInt = _mm256_add_epi32(
+         _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_set1_ps(k_expMultiple), valFloat)),
+         _mm256_set1_epi32(addExpSchraudolphTerm)
+      );
+      __m512d ret = _mm512_cvtps_pd(_mm256_castsi256_ps(retInt));
+      ret = _mm512_mask_mov_pd(ret, _mm512_cmp_pd_mask(m_data, _mm512_set1_pd(k_expUnderflowPoint), _CMP_LT_OQ),
+         _mm512_setzero_pd());
+      ret = _mm512_mask_mov_pd(ret, _mm512_cmp_pd_mask(_mm512_set1_pd(k_expOverflowPoint), m_data, _CMP_LT_OQ),
+         _mm512_set1_pd(std::numeric_limits<FloatEbmType>::infinity()));
+      ret = _mm512_mask_mov_pd(ret, _mm512_cmp_pd_mask(m_data, m_data, _CMP_UNORD_Q), m_data);
+      return SimdVector(ret);
+   }
+
+   // the same as LogApproxSchraudolph<true, false, false, false> in each lane.  The lanes above the float range 
+   // convert to infinity, which gives us garbage, so we replace them like the scalar version does
+   INLINE_ALWAYS SimdVector LogApproxSchraudolph(
+      const float addLogSchraudolphTerm = k_logTermLowerBoundInputCloseToOne
+   ) const {
+      const __m256i valInt = _mm256_castps_si256(_mm512_cvtpd_ps(m_data));
+      const __m256 retFloat = _mm256_add_ps(
+         _mm256_mul_ps(_mm256_set1_ps(k_logMultiple), _mm256_cvtepi32_ps(valInt)),
+         _mm256_set1_ps(addLogSchraudolphTerm)
+      );
+      __m512d ret = _mm512_cvtps_pd(retFloat);
+      ret = _mm512_mask_mov_pd(ret, 
+         _mm512_cmp_pd_mask(_mm512_set1_pd(std::numeric_limits<float>::max()), m_data, _CMP_LT_OQ),
+         _mm512_set1_pd(std::numeric_limits<FloatEbmType>::infinity()));
+      ret = _mm512_mask_mov_pd(ret, _mm512_cmp_pd_mask(m_data, m_data, _CMP_UNORD_Q), m_data);
+      return SimdVector(ret);
+   }
+};
+
+#elif defined(SIMD_AVX2)
+
+static_assert(sizeof(StorageDataType) == sizeof(FloatEbmType), "the index and target lanes need to line up with the FloatEbmType lanes");
+
+class SimdVector final {
+   __m256d m_data;
+
+   INLINE_ALWAYS SimdVector(const __m256d data) : m_data(data) {
+   }
+
+public:
+
+   static constexpr size_t k_cLanes = 4;
+
+   SimdVector() = default;
+
+   INLINE_ALWAYS static SimdVector Load(const FloatEbmType * const a) {
+      return SimdVector(_mm256_loadu_pd(a));
+   }
+
+   INLINE_ALWAYS void Store(FloatEbmType * const a) const {
+      _mm256_storeu_pd(a, m_data);
+   }
+
+   INLINE_ALWAYS static SimdVector Load(const float * const a) {
+      return SimdVector(_mm256_cvtps_pd(_mm_loadu_ps(a)));
+   }
+
+   INLINE_ALWAYS void Store(float * const a) const {
+      _mm_storeu_ps(a, _mm256_cvtpd_ps(m_data));
+   }
+
+   INLINE_ALWAYS static SimdVector Broadcast(const FloatEbmType val) {
+      return SimdVector(_mm256_set1_pd(val));
+   }
+
+   INLINE_ALWAYS static SimdVector Gather(const FloatEbmType * const a, const size_t * const aIndexes) {
+      const __m256i indexes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(aIndexes));
+      return SimdVector(_mm256_i64gather_pd(a, indexes, sizeof(FloatEbmType)));
+   }
+
+   // each lane is -0.0 if the target is 0 and +0.0 if the target is 1.  The targets can't be anything else
+   INLINE_ALWAYS static SimdVector LoadSignsFromBinaryTargets(const StorageDataType * const aTargets) {
+      const __m256i targets = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(aTargets));
+      return SimdVector(_mm256_castsi256_pd(_mm256_slli_epi64(_mm256_sub_epi64(targets, _mm256_set1_epi64x(1)), 63)));
+   }
+
+   INLINE_ALWAYS friend SimdVector operator+ (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(_mm256_add_pd(left.m_data, right.m_data));
+   }
+
+   INLINE_ALWAYS friend SimdVector operator- (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(_mm256_sub_pd(left.m_data, right.m_data));
+   }
+
+   INLINE_ALWAYS friend SimdVector operator/ (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(_mm256_div_pd(left.m_data, right.m_data));
+   }
+
+   INLINE_ALWAYS friend SimdVector operator^ (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(_mm256_xor_pd(left.m_data, right.m_data));
+   }
+
+   INLINE_ALWAYS friend SimdVector operator| (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(_mm256_or_pd(left.m_data, right.m_data));
+   }
+
+   // the same as ExpApproxSchraudolph<true, true, true, false> in each lane.  The conversions give us garbage in the
+   // lanes that are out of range or NaN, but the instructions are defined for those values and we replace the lanes
+   INLINE_ALWAYS SimdVector ExpApproxSchraudolph(
+      const int32_t addExpSchraudolphTerm = k_expTermZeroMeanErrorForSoftmaxWithZeroedLogit
+   ) const {
+      const __m128 valFloat = _mm256_cvtpd_ps(m_data);
+      const __m128i retInt = _mm_add_epi32(
+         _mm_cvttps_epi32(_mm_mul_ps(_mm_set1_ps(k_expMultiple), valFloat)),
+         _mm_set1_epi32(addExpSchraudolphTerm)
+      );
+      __m256d ret = _mm256_cvtps_pd(_mm_castsi128_ps(retInt));
+      ret = _mm256_blendv_pd(ret, _mm256_setzero_pd(),
+         _mm256_cmp_pd(m_data, _mm256_set1_pd(k_expUnderflowPoint), _CMP_LT_OQ));
+      ret = _mm256_blendv_pd(ret, _mm256_set1_pd(std::numeric_limits<FloatEbmType>::infinity()),
+         _mm256_cmp_pd(_mm256_set1_pd(k_expOverflowPoint), m_data, _CMP_LT_OQ));
+      ret = _mm256_blendv_pd(ret, m_data, _mm256_cmp_pd(m_data, m_data, _CMP_UNORD_Q));
+      return SimdVector(ret);
+   }
+
+   // the same as LogApproxSchraudolph<true, false, false, false> in each lane.  The lanes above the float range 
+   // convert to infinity, which gives us garbage, so we replace them like the scalar version does
+   INLINE_ALWAYS SimdVector LogApproxSchraudolph(
+      const float addLogSchraudolphTerm = k_logTermLowerBoundInputCloseToOne
+   ) const {
+      const __m128i valInt = _mm_castps_si128(_mm256_cvtpd_ps(m_data));
+      const __m128 retFloat = _mm_add_ps(
+         _mm_mul_ps(_mm_set1_ps(k_logMultiple), _mm_cvtepi32_ps(valInt)),
+         _mm_set1_ps(addLogSchraudolphTerm)
+      );
+      __m256d ret = _mm256_cvtps_pd(retFloat);
+      ret = _mm256_blendv_pd(ret, _mm256_set1_pd(std::numeric_limits<FloatEbmType>::infinity()),
+         _mm256_cmp_pd(_mm256_set1_pd(std::numeric_limits<float>::max()), m_data, _CMP_LT_OQ));
+      ret = _mm256_blendv_pd(ret, m_data, _mm256_cmp_pd(m_data, m_data, _CMP_UNORD_Q));
+      return SimdVector(ret);
+   }
+};
+
+#elif defined(SIMD_SSE2)
+
+static_assert(sizeof(StorageDataType) == sizeof(FloatEbmType), "the index and target lanes need to line up with the FloatEbmType lanes");
+
+class SimdVector final {
+   __m128d m_data;
+
+   INLINE_ALWAYS SimdVector(const __m128d data) : m_data(data) {
+   }
+
+   // SSE2 doesn't have blendv, which arrived with SSE4.1
+   INLINE_ALWAYS static __m128d Blend(const __m128d ifFalse, const __m128d ifTrue, const __m128d mask) {
+      return _mm_or_pd(_mm_andnot_pd(mask, ifFalse), _mm_and_pd(mask, ifTrue));
+   }
+
+public:
+
+   static constexpr size_t k_cLanes = 2;
+
+   SimdVector() = default;
+
+   INLINE_ALWAYS static SimdVector Load(const FloatEbmType * const a) {
+      return SimdVector(_mm_loadu_pd(a));
+   }
+
+   INLINE_ALWAYS void Store(FloatEbmType * const a) const {
+      _mm_storeu_pd(a, m_data);
+   }
+
+   // two floats are only 8 bytes, so we move them through the low half of an integer register
+   INLINE_ALWAYS static SimdVector Load(const float * const a) {
+      return SimdVector(_mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(a)))));
+   }
+
+   INLINE_ALWAYS void Store(float * const a) const {
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(a), _mm_castps_si128(_mm_cvtpd_ps(m_data)));
+   }
+
+   INLINE_ALWAYS static SimdVector Broadcast(const FloatEbmType val) {
+      return SimdVector(_mm_set1_pd(val));
+   }
+
+   INLINE_ALWAYS static SimdVector Gather(const FloatEbmType * const a, const size_t * const aIndexes) {
+      return SimdVector(_mm_set_pd(a[aIndexes[1]], a[aIndexes[0]]));
+   }
+
+   // each lane is -0.0 if the target is 0 and +0.0 if the target is 1.  The targets can't be anything else
+   INLINE_ALWAYS static SimdVector LoadSignsFromBinaryTargets(const StorageDataType * const aTargets) {
+      const __m128i targets = _mm_loadu_si128(reinterpret_cast<const __m128i *>(aTargets));
+      return SimdVector(_mm_castsi128_pd(_mm_slli_epi64(_mm_sub_epi64(targets, _mm_set1_epi64x(1)), 63)));
+   }
+
+   INLINE_ALWAYS friend SimdVector operator+ (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(_mm_add_pd(left.m_data, right.m_data));
+   }
+
+   INLINE_ALWAYS friend SimdVector operator- (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(_mm_sub_pd(left.m_data, right.m_data));
+   }
+
+   INLINE_ALWAYS friend SimdVector operator/ (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(_mm_div_pd(left.m_data, right.m_data));
+   }
+
+   INLINE_ALWAYS friend SimdVector operator^ (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(_mm_xor_pd(left.m_data, right.m_data));
+   }
+
+   INLINE_ALWAYS friend SimdVector operator| (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(_mm_or_pd(left.m_data, right.m_data));
+   }
+
+   // the same as ExpApproxSchraudolph<true, true, true, false> in each lane.  The conversions give us garbage in the
+   // lanes that are out of range or NaN, but the instructions are defined for those values and we replace the lanes
+   INLINE_ALWAYS SimdVector ExpApproxSchraudolph(
+      const int32_t addExpSchraudolphTerm = k_expTermZeroMeanErrorForSoftmaxWithZeroedLogit
+   ) const {
+      const __m128 valFloat = _mm_cvtpd_ps(m_data);
+      const __m128i retInt = _mm_add_epi32(
+         _mm_cvttps_epi32(_mm_mul_ps(_mm_set1_ps(k_expMultiple), valFloat)),
+         _mm_set1_epi32(addExpSchraudolphTerm)
+      );
+      __m128d ret = _mm_cvtps_pd(_mm_castsi128_ps(retInt));
+      ret = Blend(ret, _mm_setzero_pd(), _mm_cmplt_pd(m_data, _mm_set1_pd(k_expUnderflowPoint)));
+      ret = Blend(ret, _mm_set1_pd(std::numeric_limits<FloatEbmType>::infinity()),
+         _mm_cmplt_pd(_mm_set1_pd(k_expOverflowPoint), m_data));
+      ret = Blend(ret, m_data, _mm_cmpunord_pd(m_data, m_data));
+      return SimdVector(ret);
+   }
+
+   // the same as LogApproxSchraudolph<true, false, false, false> in each lane.  The lanes above the float range 
+   // convert to infinity, which gives us garbage, so we replace them like the scalar version does.  _mm_cvtpd_ps
+   // zeros the upper two floats, and we ignore them
+   INLINE_ALWAYS SimdVector LogApproxSchraudolph(
+      const float addLogSchraudolphTerm = k_logTermLowerBoundInputCloseToOne
+   ) const {
+      const __m128i valInt = _mm_castps_si128(_mm_cvtpd_ps(m_data));
+      const __m128 retFloat = _mm_add_ps(
+         _mm_mul_ps(_mm_set1_ps(k_logMultiple), _mm_cvtepi32_ps(valInt)),
+         _mm_set1_ps(addLogSchraudolphTerm)
+      );
+      __m128d ret = _mm_cvtps_pd(retFloat);
+      ret = Blend(ret, _mm_set1_pd(std::numeric_limits<FloatEbmType>::infinity()),
+         _mm_cmplt_pd(_mm_set1_pd(std::numeric_limits<float>::max()), m_data));
+      ret = Blend(ret, m_data, _mm_cmpunord_pd(m_data, m_data));
+      return SimdVector(ret);
+   }
+};
+
+#else // SIMD_*
+
+class SimdVector final {
+   FloatEbmType m_data;
+
+   INLINE_ALWAYS SimdVector(const FloatEbmType data) : m_data(data) {
+   }
+
+   INLINE_ALWAYS static uint64_t ToBits(const FloatEbmType val) {
+      static_assert(sizeof(uint64_t) == sizeof(FloatEbmType), "we need to fit the bits of FloatEbmType into a uint64_t");
+      uint64_t bits;
+      memcpy(&bits, &val, sizeof(bits));
+      return bits;
+   }
+
+   INLINE_ALWAYS static FloatEbmType FromBits(const uint64_t bits) {
+      FloatEbmType val;
+      memcpy(&val, &bits, sizeof(val));
+      return val;
+   }
+
+public:
+
+   static constexpr size_t k_cLanes = 1;
+
+   SimdVector() = default;
+
+   INLINE_ALWAYS static SimdVector Load(const FloatEbmType * const a) {
+      return SimdVector(*a);
+   }
+
+   INLINE_ALWAYS void Store(FloatEbmType * const a) const {
+      *a = m_data;
+   }
+
+   INLINE_ALWAYS static SimdVector Load(const float * const a) {
+      return SimdVector(static_cast<FloatEbmType>(*a));
+   }
+
+   INLINE_ALWAYS void Store(float * const a) const {
+      *a = static_cast<float>(m_data);
+   }
+
+   INLINE_ALWAYS static SimdVector Broadcast(const FloatEbmType val) {
+      return SimdVector(val);
+   }
+
+   INLINE_ALWAYS static SimdVector Gather(const FloatEbmType * const a, const size_t * const aIndexes) {
+      return SimdVector(a[*aIndexes]);
+   }
+
+   // -0.0 if the target is 0 and +0.0 if the target is 1.  The target can't be anything else
+   INLINE_ALWAYS static SimdVector LoadSignsFromBinaryTargets(const StorageDataType * const aTargets) {
+      return SimdVector(0 == *aTargets ? -FloatEbmType { 0 } : FloatEbmType { 0 });
+   }
+
+   INLINE_ALWAYS friend SimdVector operator+ (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(left.m_data + right.m_data);
+   }
+
+   INLINE_ALWAYS friend SimdVector operator- (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(left.m_data - right.m_data);
+   }
+
+   INLINE_ALWAYS friend SimdVector operator/ (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(left.m_data / right.m_data);
+   }
+
+   INLINE_ALWAYS friend SimdVector operator^ (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(FromBits(ToBits(left.m_data) ^ ToBits(right.m_data)));
+   }
+
+   INLINE_ALWAYS friend SimdVector operator| (const SimdVector & left, const SimdVector & right) {
+      return SimdVector(FromBits(ToBits(left.m_data) | ToBits(right.m_data)));
+   }
+
+   INLINE_ALWAYS SimdVector ExpApproxSchraudolph(
+      const int32_t addExpSchraudolphTerm = k_expTermZeroMeanErrorForSoftmaxWithZeroedLogit
+   ) const {
+      return SimdVector(::ExpApproxSchraudolph<true, true, true, false>(m_data, addExpSchraudolphTerm));
+   }
+
+   INLINE_ALWAYS SimdVector LogApproxSchraudolph(
+      const float addLogSchraudolphTerm = k_logTermLowerBoundInputCloseToOne
+   ) const {
+      return SimdVector(::LogApproxSchraudolph<true, false, false, false>(m_data, addLogSchraudolphTerm));
+   }
+};
+
+#endif // SIMD_*
+
+static_assert(k_bUseSIMD == (1 < SimdVector::k_cLanes), "the variant's SIMD instructions and k_bUseSIMD disagree");
+
+// the same as EbmStatistics::ComputeResidualErrorBinaryClassification in each lane.  signs comes from
+// SimdVector::LoadSignsFromBinaryTargets, and flipping the sign bit is exactly the negation that the scalar version does
+INLINE_ALWAYS SimdVector ComputeResidualErrorBinaryClassification(
+   const SimdVector trainingLogOddsPrediction,
+   const SimdVector signs
+) {
+   const SimdVector one = SimdVector::Broadcast(FloatEbmType { 1 });
+   const SimdVector exponent = trainingLogOddsPrediction ^ signs;
+#ifdef FAST_EXP
+   const SimdVector exp = exponent.ExpApproxSchraudolph();
+#else // FAST_EXP
+   FloatEbmType aExp[SimdVector::k_cLanes];
+   exponent.Store(aExp);
+   for(size_t iLane = 0; iLane < SimdVector::k_cLanes; ++iLane) {
+      aExp[iLane] = std::exp(aExp[iLane]);
+   }
+   const SimdVector exp = SimdVector::Load(aExp);
+#endif // FAST_EXP
+   return (one | signs) / (one + exp);
+}
+
+// the same as EbmStatistics::ComputeSingleSampleLogLossBinaryClassification in each lane.  signs comes from
+// SimdVector::LoadSignsFromBinaryTargets.  The log loss negates the prediction for the opposite target from the
+// residual, so we flip the sign bit once more
+INLINE_ALWAYS SimdVector ComputeSingleSampleLogLossBinaryClassification(
+   const SimdVector validationLogOddsPrediction,
+   const SimdVector signs
+) {
+   const SimdVector one = SimdVector::Broadcast(FloatEbmType { 1 });
+   const SimdVector exponent = validationLogOddsPrediction ^ signs ^ SimdVector::Broadcast(-FloatEbmType { 0 });
+#ifdef FAST_LOG
+   return (one + exponent.ExpApproxSchraudolph()).LogApproxSchraudolph();
+#else // FAST_LOG
+   FloatEbmType aLogLoss[SimdVector::k_cLanes];
+   exponent.Store(aLogLoss);
+   for(size_t iLane = 0; iLane < SimdVector::k_cLanes; ++iLane) {
+      aLogLoss[iLane] = std::log(FloatEbmType { 1 } + std::exp(aLogLoss[iLane]));
+   }
+   return SimdVector::Load(aLogLoss);
+#endif // FAST_LOG
+}
@@ -7,6 +7,8 @@
 #include <stdlib.h> // free
 #include <stddef.h> // size_t, ptrdiff_t
 #include <string.h> // memcpy
+#include <atomic>
+#include <limits> // numeric_limits
 
 #include "ebm_native.h" // FloatEbmType
 #include "EbmInternal.h"
@@ -15,7 +17,11 @@
 #include "FeatureGroup.h"
 #include "DataSetBoosting.h"
 
-INLINE_RELEASE_UNTEMPLATED static FloatEbmType * ConstructResidualErrors(const size_t cSamples, const size_t cVectorLength) {
+INLINE_RELEASE_UNTEMPLATED static void * ConstructResidualErrors(
+   const size_t cSamples, 
+   const size_t cVectorLength, 
+   const bool bFloat32Storage
+) {
    LOG_0(TraceLevelInfo, "Entered DataSetByFeatureGroup::ConstructResidualErrors");
 
    EBM_ASSERT(1 <= cSamples);
@@ -27,13 +33,14 @@ INLINE_RELEASE_UNTEMPLATED static FloatEbmType * ConstructResidualErrors(const s
    }
 
    const size_t cElements = cSamples * cVectorLength;
-   FloatEbmType * aResidualErrors = EbmMalloc<FloatEbmType>(cElements);
+   void * aResidualErrors = EbmMalloc<void>(cElements, bFloat32Storage ? sizeof(float) : sizeof(FloatEbmType));
 
    LOG_0(TraceLevelInfo, "Exited DataSetByFeatureGroup::ConstructResidualErrors");
    return aResidualErrors;
 }
 
-INLINE_RELEASE_UNTEMPLATED static FloatEbmType * ConstructPredictorScores(
+template<typename TFloat>
+INLINE_RELEASE_TEMPLATED static TFloat * ConstructPredictorScores(
    const size_t cSamples, 
    const size_t cVectorLength, 
    const FloatEbmType * const aPredictorScoresFrom
@@ -50,23 +57,35 @@ INLINE_RELEASE_UNTEMPLATED static FloatEbmType * ConstructPredictorScores(
    }
 
    const size_t cElements = cSamples * cVectorLength;
-   FloatEbmType * const aPredictorScoresTo = EbmMalloc<FloatEbmType>(cElements);
+   TFloat * const aPredictorScoresTo = EbmMalloc<TFloat>(cElements);
    if(nullptr == aPredictorScoresTo) {
       LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::ConstructPredictorScores nullptr == aPredictorScoresTo");
       return nullptr;
    }
 
-   const size_t cBytes = sizeof(FloatEbmType) * cElements;
    // if there are any NaN or +- infinity values we should just propagate them and exit during boosting
-   memcpy(aPredictorScoresTo, aPredictorScoresFrom, cBytes);
+   if(std::is_same<TFloat, FloatEbmType>::value) {
+      const size_t cBytes = sizeof(FloatEbmType) * cElements;
+      memcpy(aPredictorScoresTo, aPredictorScoresFrom, cBytes);
+   } else {
+      // scores too large for a float become +-infinity, which boosting treats like any other infinity
+      const FloatEbmType * pScoreFrom = aPredictorScoresFrom;
+      TFloat * pScoreTo = aPredictorScoresTo;
+      const TFloat * const pScoreToEnd = aPredictorScoresTo + cElements;
+      do {
+         *pScoreTo = static_cast<TFloat>(*pScoreFrom);
+         ++pScoreFrom;
+         ++pScoreTo;
+      } while(pScoreToEnd != pScoreTo);
+   }
    constexpr bool bZeroingLogits = 0 <= k_iZeroClassificationLogitAtInitialize;
    if(bZeroingLogits) {
       // TODO : integrate this subtraction into the copy instead of doing it afterwards
-      FloatEbmType * pScore = aPredictorScoresTo;
-      const FloatEbmType * const pScoreExteriorEnd = pScore + cVectorLength * cSamples;
+      TFloat * pScore = aPredictorScoresTo;
+      const TFloat * const pScoreExteriorEnd = pScore + cVectorLength * cSamples;
       do {
-         FloatEbmType scoreShift = pScore[k_iZeroClassificationLogitAtInitialize];
-         const FloatEbmType * const pScoreInteriorEnd = pScore + cVectorLength;
+         TFloat scoreShift = pScore[k_iZeroClassificationLogitAtInitialize];
+         const TFloat * const pScoreInteriorEnd = pScore + cVectorLength;
          do {
             *pScore -= scoreShift;
             ++pScore;
@@ -309,7 +328,8 @@ bool DataSetByFeatureGroup::Initialize(
    const IntEbmType * const aInputDataFrom, 
    const void * const aTargets, 
    const FloatEbmType * const aPredictorScoresFrom, 
-   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const bool bFloat32Storage
 ) {
    EBM_ASSERT(nullptr == m_aResidualErrors);
    EBM_ASSERT(nullptr == m_aPredictorScores);
@@ -319,18 +339,23 @@ bool DataSetByFeatureGroup::Initialize(
    LOG_0(TraceLevelInfo, "Entered DataSetByFeatureGroup::Initialize");
    const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
 
+   // set even without samples so that the kernels we pick for this data set agree with the other data sets of the booster
+   m_bFloat32Storage = bFloat32Storage;
+
    if(0 != cSamples) {
-      FloatEbmType * aResidualErrors = nullptr;
+      void * aResidualErrors = nullptr;
       if(bAllocateResidualErrors) {
-         aResidualErrors = ConstructResidualErrors(cSamples, cVectorLength);
+         aResidualErrors = ConstructResidualErrors(cSamples, cVectorLength, bFloat32Storage);
          if(nullptr == aResidualErrors) {
             LOG_0(TraceLevelWarning, "WARNING Exited DataSetByFeatureGroup::Initialize nullptr == aResidualErrors");
             return true;
          }
       }
-      FloatEbmType * aPredictorScores = nullptr;
+      void * aPredictorScores = nullptr;
       if(bAllocatePredictorScores) {
-         aPredictorScores = ConstructPredictorScores(cSamples, cVectorLength, aPredictorScoresFrom);
+         aPredictorScores = bFloat32Storage ? 
+            static_cast<void *>(ConstructPredictorScores<float>(cSamples, cVectorLength, aPredictorScoresFrom)) :
+            static_cast<void *>(ConstructPredictorScores<FloatEbmType>(cSamples, cVectorLength, aPredictorScoresFrom));
          if(nullptr == aPredictorScores) {
             free(aResidualErrors);
             LOG_0(TraceLevelWarning, "WARNING Exited DataSetByFeatureGroup::Initialize nullptr == aPredictorScores");
@@ -372,6 +397,261 @@ bool DataSetByFeatureGroup::Initialize(
    return false;
 }
 
+bool DataSetByFeatureGroup::InitializeView(
+   const bool bAllocateResidualErrors,
+   const bool bAllocatePredictorScores,
+   DataSetByFeatureGroup * const pDataSetShared,
+   const size_t cSamples,
+   const size_t * const aiSharedSamples,
+   const FloatEbmType * const aPredictorScoresFrom,
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const bool bFloat32Storage
+) {
+   EBM_ASSERT(nullptr == m_aResidualErrors);
+   EBM_ASSERT(nullptr == m_aPredictorScores);
+   EBM_ASSERT(nullptr == m_aTargetData);
+   EBM_ASSERT(nullptr == m_aaInputData);
+   EBM_ASSERT(nullptr == m_aiSharedSamples);
+   EBM_ASSERT(nullptr == m_pcShareReferences);
+   EBM_ASSERT(nullptr != pDataSetShared);
+   // views of views would need to translate their indexes twice
+   EBM_ASSERT(nullptr == pDataSetShared->m_aiSharedSamples);
+
+   LOG_0(TraceLevelInfo, "Entered DataSetByFeatureGroup::InitializeView");
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+
+   m_bFloat32Storage = bFloat32Storage;
+
+   if(0 != cSamples) {
+      EBM_ASSERT(nullptr != aiSharedSamples);
+      const size_t cFeatureGroups = pDataSetShared->m_cFeatureGroups;
+
+      void * aResidualErrors = nullptr;
+      void * aPredictorScores = nullptr;
+      size_t * aiSharedSamplesCopy = nullptr;
+      StorageDataType ** aaInputData = nullptr;
+      std::atomic<size_t> * pcShareReferences = nullptr;
+
+      if(bAllocateResidualErrors) {
+         aResidualErrors = ConstructResidualErrors(cSamples, cVectorLength, bFloat32Storage);
+         if(nullptr == aResidualErrors) {
+            LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::InitializeView nullptr == aResidualErrors");
+            goto exit_error;
+         }
+      }
+      if(bAllocatePredictorScores) {
+         aPredictorScores = bFloat32Storage ?
+            static_cast<void *>(ConstructPredictorScores<float>(cSamples, cVectorLength, aPredictorScoresFrom)) :
+            static_cast<void *>(ConstructPredictorScores<FloatEbmType>(cSamples, cVectorLength, aPredictorScoresFrom));
+         if(nullptr == aPredictorScores) {
+            LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::InitializeView nullptr == aPredictorScores");
+            goto exit_error;
+         }
+      }
+
+      aiSharedSamplesCopy = EbmMalloc<size_t>(cSamples);
+      if(nullptr == aiSharedSamplesCopy) {
+         LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::InitializeView nullptr == aiSharedSamplesCopy");
+         goto exit_error;
+      }
+      {
+         const size_t * piSharedSample = aiSharedSamples;
+         size_t * piSharedSampleCopy = aiSharedSamplesCopy;
+         const size_t * const piSharedSampleCopyEnd = aiSharedSamplesCopy + cSamples;
+         do {
+            if(pDataSetShared->m_cSamples <= *piSharedSample) {
+               LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::InitializeView pDataSetShared->m_cSamples <= *piSharedSample");
+               goto exit_error;
+            }
+            *piSharedSampleCopy = *piSharedSample;
+            ++piSharedSample;
+            ++piSharedSampleCopy;
+         } while(piSharedSampleCopyEnd != piSharedSampleCopy);
+      }
+
+      if(0 != cFeatureGroups) {
+         // GatherView fills one slot per feature group for the duration of a boosting step
+         aaInputData = EbmMalloc<StorageDataType *>(cFeatureGroups);
+         if(nullptr == aaInputData) {
+            LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::InitializeView nullptr == aaInputData");
+            goto exit_error;
+         }
+         StorageDataType ** paInputData = aaInputData;
+         const StorageDataType * const * const paInputDataEnd = aaInputData + cFeatureGroups;
+         do {
+            *paInputData = nullptr;
+            ++paInputData;
+         } while(paInputDataEnd != paInputData);
+      }
+
+      pcShareReferences = pDataSetShared->m_pcShareReferences;
+      if(nullptr == pcShareReferences) {
+         // the first time a DataSetByFeatureGroup is shared we start counting the owners.  Sharing only happens while
+         // the boosters are being created on a single thread, so only the release in Destruct needs to be atomic
+         pcShareReferences = EbmMalloc<std::atomic<size_t>>();
+         if(nullptr == pcShareReferences) {
+            LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::InitializeView nullptr == pcShareReferences");
+            goto exit_error;
+         }
+         std::atomic_init(pcShareReferences, size_t { 1 });
+         pDataSetShared->m_pcShareReferences = pcShareReferences;
+      }
+      pcShareReferences->fetch_add(size_t { 1 }, std::memory_order_relaxed);
+
+      m_aResidualErrors = aResidualErrors;
+      m_aPredictorScores = aPredictorScores;
+      m_aaInputData = aaInputData;
+      m_cSamples = cSamples;
+      m_cFeatureGroups = cFeatureGroups;
+      m_aiSharedSamples = aiSharedSamplesCopy;
+      m_aTargetDataShared = pDataSetShared->m_aTargetData;
+      m_aaInputDataShared = pDataSetShared->m_aaInputData;
+      m_pcShareReferences = pcShareReferences;
+      goto exit_ok;
+
+   exit_error:;
+      free(aResidualErrors);
+      free(aPredictorScores);
+      free(aiSharedSamplesCopy);
+      free(aaInputData);
+      LOG_0(TraceLevelWarning, "WARNING Exited DataSetByFeatureGroup::InitializeView");
+      return true;
+   }
+
+exit_ok:;
+   LOG_0(TraceLevelInfo, "Exited DataSetByFeatureGroup::InitializeView");
+
+   return false;
+}
+
+bool DataSetByFeatureGroup::GatherView(const FeatureGroup * const pFeatureGroup, const bool bTargets) {
+   EBM_ASSERT(nullptr != pFeatureGroup);
+
+   if(nullptr == m_aiSharedSamples) {
+      // we own our data, or have no samples
+      return false;
+   }
+   EBM_ASSERT(0 < m_cSamples);
+
+   LOG_0(TraceLevelVerbose, "Entered DataSetByFeatureGroup::GatherView");
+
+   const size_t * const aiSharedSamples = m_aiSharedSamples;
+   const size_t * const piSharedSampleEnd = aiSharedSamples + m_cSamples;
+
+   if(bTargets) {
+      EBM_ASSERT(nullptr == m_aTargetData);
+      EBM_ASSERT(nullptr != m_aTargetDataShared);
+      StorageDataType * const aTargetData = EbmMalloc<StorageDataType>(m_cSamples);
+      if(nullptr == aTargetData) {
+         LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::GatherView nullptr == aTargetData");
+         return true;
+      }
+      const size_t * piSharedSample = aiSharedSamples;
+      StorageDataType * pTargetData = aTargetData;
+      do {
+         *pTargetData = m_aTargetDataShared[*piSharedSample];
+         ++pTargetData;
+         ++piSharedSample;
+      } while(piSharedSampleEnd != piSharedSample);
+      m_aTargetData = aTargetData;
+   }
+
+   if(0 != pFeatureGroup->GetCountFeatures()) {
+      const size_t iInputData = pFeatureGroup->GetIndexInputData();
+      EBM_ASSERT(iInputData < m_cFeatureGroups);
+      EBM_ASSERT(nullptr != m_aaInputData);
+      EBM_ASSERT(nullptr == m_aaInputData[iInputData]);
+      const StorageDataType * const aInputDataShared = m_aaInputDataShared[iInputData];
+      EBM_ASSERT(nullptr != aInputDataShared);
+
+      const size_t cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+
+      const size_t cDataUnits = (m_cSamples - 1) / cItemsPerBitPackedDataUnit + 1; // this can't overflow or underflow
+      StorageDataType * const aInputData = EbmMalloc<StorageDataType>(cDataUnits);
+      if(nullptr == aInputData) {
+         LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::GatherView nullptr == aInputData");
+         if(bTargets) {
+            free(m_aTargetData);
+            m_aTargetData = nullptr;
+         }
+         return true;
+      }
+
+      // pack our samples in order exactly as ConstructInputData would, including the partially filled last data unit, 
+      // so the kernels group and visit them like they would in a data set of just our samples
+      const size_t * piSharedSample = aiSharedSamples;
+      StorageDataType * pInputData = aInputData;
+      size_t bits = 0;
+      size_t shift = 0;
+      const size_t shiftEnd = cBitsPerItemMax * cItemsPerBitPackedDataUnit;
+      do {
+         const size_t iSharedSample = *piSharedSample;
+         const size_t iTensorBin = maskBits & static_cast<size_t>(aInputDataShared[iSharedSample / cItemsPerBitPackedDataUnit] >>
+            (iSharedSample % cItemsPerBitPackedDataUnit * cBitsPerItemMax));
+         bits |= iTensorBin << shift;
+         shift += cBitsPerItemMax;
+         if(shiftEnd == shift) {
+            EBM_ASSERT(IsNumberConvertable<StorageDataType>(bits));
+            *pInputData = static_cast<StorageDataType>(bits);
+            ++pInputData;
+            bits = 0;
+            shift = 0;
+         }
+         ++piSharedSample;
+      } while(piSharedSampleEnd != piSharedSample);
+      if(0 != shift) {
+         EBM_ASSERT(IsNumberConvertable<StorageDataType>(bits));
+         *pInputData = static_cast<StorageDataType>(bits);
+         ++pInputData;
+      }
+      EBM_ASSERT(aInputData + cDataUnits == pInputData);
+
+      m_aaInputData[iInputData] = aInputData;
+   }
+
+   LOG_0(TraceLevelVerbose, "Exited DataSetByFeatureGroup::GatherView");
+   return false;
+}
+
+void DataSetByFeatureGroup::ReleaseView(const FeatureGroup * const pFeatureGroup, const bool bTargets) {
+   EBM_ASSERT(nullptr != pFeatureGroup);
+
+   if(nullptr == m_aiSharedSamples) {
+      return;
+   }
+
+   if(bTargets) {
+      free(m_aTargetData);
+      m_aTargetData = nullptr;
+   }
+   if(0 != pFeatureGroup->GetCountFeatures()) {
+      const size_t iInputData = pFeatureGroup->GetIndexInputData();
+      EBM_ASSERT(iInputData < m_cFeatureGroups);
+      EBM_ASSERT(nullptr != m_aaInputData);
+      free(m_aaInputData[iInputData]);
+      m_aaInputData[iInputData] = nullptr;
+   }
+}
+
+INLINE_RELEASE_UNTEMPLATED static void FreeInputData(const size_t cFeatureGroups, StorageDataType * const * const aaInputData) {
+   if(nullptr != aaInputData) {
+      EBM_ASSERT(0 < cFeatureGroups);
+      StorageDataType * const * paInputData = aaInputData;
+      const StorageDataType * const * const paInputDataEnd = aaInputData + cFeatureGroups;
+      do {
+         free(*paInputData);
+         ++paInputData;
+      } while(paInputDataEnd != paInputData);
+      free(const_cast<StorageDataType * *>(aaInputData));
+   }
+}
+
 WARNING_PUSH
 WARNING_DISABLE_USING_UNINITIALIZED_MEMORY
 void DataSetByFeatureGroup::Destruct() {
@@ -379,17 +659,30 @@ void DataSetByFeatureGroup::Destruct() {
 
    free(m_aResidualErrors);
    free(m_aPredictorScores);
-   free(m_aTargetData);
 
-   if(nullptr != m_aaInputData) {
-      EBM_ASSERT(0 < m_cFeatureGroups);
-      StorageDataType * * paInputData = m_aaInputData;
-      const StorageDataType * const * const paInputDataEnd = m_aaInputData + m_cFeatureGroups;
-      do {
-         free(*paInputData);
-         ++paInputData;
-      } while(paInputDataEnd != paInputData);
-      free(m_aaInputData);
+   const bool bView = nullptr != m_aiSharedSamples;
+   if(bView) {
+      free(m_aiSharedSamples);
+      // anything still gathered, and the slots themselves, belong to us
+      free(m_aTargetData);
+      FreeInputData(m_cFeatureGroups, m_aaInputData);
+   }
+
+   if(nullptr != m_pcShareReferences) {
+      if(size_t { 1 } != m_pcShareReferences->fetch_sub(size_t { 1 }, std::memory_order_acq_rel)) {
+         // another DataSetByFeatureGroup still uses the shared target and input data
+         LOG_0(TraceLevelInfo, "Exited DataSetByFeatureGroup::Destruct with shared data still in use");
+         return;
+      }
+      free(m_pcShareReferences);
+   }
+
+   if(bView) {
+      free(const_cast<StorageDataType *>(m_aTargetDataShared));
+      FreeInputData(m_cFeatureGroups, m_aaInputDataShared);
+   } else {
+      free(m_aTargetData);
+      FreeInputData(m_cFeatureGroups, m_aaInputData);
    }
 
    LOG_0(TraceLevelInfo, "Exited DataSetByFeatureGroup::Destruct");
@@ -7,19 +7,48 @@
 
 #include <stdlib.h> // free
 #include <stddef.h> // size_t, ptrdiff_t
+#include <atomic>
 
 #include "ebm_native.h" // FloatEbmType
 #include "EbmInternal.h" // INLINE_ALWAYS
 #include "Logging.h" // EBM_ASSERT & LOG
 #include "FeatureGroup.h"
 
+// ApplyModelUpdateTraining and ApplyModelUpdateValidation process the samples in chunks of about this many samples, in 
+// parallel.  The chunks only depend on the data, so the validation metric that we sum chunk by chunk is the same for any 
+// number of threads
+constexpr size_t k_cSamplesPerApplyUpdateChunk = 16384;
+
+INLINE_ALWAYS size_t GetCountSamplesPerApplyUpdateChunk(const FeatureGroup * const pFeatureGroup) {
+   if(0 == pFeatureGroup->GetCountFeatures()) {
+      return k_cSamplesPerApplyUpdateChunk;
+   }
+   // chunks start on a bit packed data unit boundary so that they can be unpacked independently
+   const size_t cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+   EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+   return (k_cSamplesPerApplyUpdateChunk + cItemsPerBitPackedDataUnit - size_t { 1 }) / 
+      cItemsPerBitPackedDataUnit * cItemsPerBitPackedDataUnit;
+}
+
 class DataSetByFeatureGroup final {
-   FloatEbmType * m_aResidualErrors;
-   FloatEbmType * m_aPredictorScores;
+   // the residuals and predictor scores are stored as FloatEbmType, or as float if m_bFloat32Storage.  We always compute 
+   // in FloatEbmType, so float storage only rounds the values when they are written back to memory
+   void * m_aResidualErrors;
+   void * m_aPredictorScores;
    StorageDataType * m_aTargetData;
    StorageDataType * * m_aaInputData;
    size_t m_cSamples;
    size_t m_cFeatureGroups;
+   // nullptr unless we're a view over some of the samples of a DataSetByFeatureGroup that several Boosters share.  A 
+   // view lists the shared sample behind each of its m_cSamples samples, in order, and only owns the residuals and 
+   // scores of its samples.  Its m_aTargetData and m_aaInputData hold what GatherView unpacked for the step in progress
+   size_t * m_aiSharedSamples;
+   const StorageDataType * m_aTargetDataShared;
+   StorageDataType * const * m_aaInputDataShared;
+   // nullptr if nothing shares m_aTargetData and m_aaInputData, otherwise the count of the shared data set and its 
+   // views.  The last one to be destructed frees the shared data
+   std::atomic<size_t> * m_pcShareReferences;
+   bool m_bFloat32Storage;
 
 public:
 
@@ -35,6 +64,11 @@ public:
       m_aaInputData = nullptr;
       m_cSamples = 0;
       m_cFeatureGroups = 0;
+      m_aiSharedSamples = nullptr;
+      m_aTargetDataShared = nullptr;
+      m_aaInputDataShared = nullptr;
+      m_pcShareReferences = nullptr;
+      m_bFloat32Storage = false;
    }
 
    void Destruct();
@@ -49,20 +83,57 @@ public:
       const IntEbmType * const aInputDataFrom, 
       const void * const aTargets, 
       const FloatEbmType * const aPredictorScoresFrom, 
-      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+      const bool bFloat32Storage
    );
 
-   INLINE_ALWAYS FloatEbmType * GetResidualPointer() {
+   // like Initialize, but instead of bit packing our own copy of the input data and targets we take the samples listed 
+   // in aiSharedSamples from pDataSetShared, which must have been initialized with the same feature groups.  A sample 
+   // can be listed more than once.  aPredictorScoresFrom holds the scores of our samples in the same order
+   bool InitializeView(
+      const bool bAllocateResidualErrors,
+      const bool bAllocatePredictorScores,
+      DataSetByFeatureGroup * const pDataSetShared,
+      const size_t cSamples,
+      const size_t * const aiSharedSamples,
+      const FloatEbmType * const aPredictorScoresFrom,
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+      const bool bFloat32Storage
+   );
+
+   // a view unpacks the input data of pFeatureGroup, and the targets if bTargets, into the same bit packed layout that
+   // Initialize would give a data set of just our samples, so the kernels see exactly the data of a separate booster.  
+   // Several threads can gather different feature groups at once, but only one can gather the targets.  These do 
+   // nothing if we aren't a view.  GatherView returns true if it runs out of memory
+   bool GatherView(const FeatureGroup * const pFeatureGroup, const bool bTargets);
+   void ReleaseView(const FeatureGroup * const pFeatureGroup, const bool bTargets);
+
+   INLINE_ALWAYS bool IsFloat32Storage() const {
+      return m_bFloat32Storage;
+   }
+   template<typename TFloat>
+   INLINE_ALWAYS TFloat * GetResidualPointer() {
+      static_assert(std::is_same<TFloat, FloatEbmType>::value || std::is_same<TFloat, float>::value, 
+         "residuals are stored as FloatEbmType or float");
       EBM_ASSERT(nullptr != m_aResidualErrors);
-      return m_aResidualErrors;
+      EBM_ASSERT((std::is_same<TFloat, float>::value) == m_bFloat32Storage);
+      return static_cast<TFloat *>(m_aResidualErrors);
    }
-   INLINE_ALWAYS const FloatEbmType * GetResidualPointer() const {
+   template<typename TFloat>
+   INLINE_ALWAYS const TFloat * GetResidualPointer() const {
+      static_assert(std::is_same<TFloat, FloatEbmType>::value || std::is_same<TFloat, float>::value, 
+         "residuals are stored as FloatEbmType or float");
       EBM_ASSERT(nullptr != m_aResidualErrors);
-      return m_aResidualErrors;
+      EBM_ASSERT((std::is_same<TFloat, float>::value) == m_bFloat32Storage);
+      return static_cast<const TFloat *>(m_aResidualErrors);
    }
-   INLINE_ALWAYS FloatEbmType * GetPredictorScores() {
+   template<typename TFloat>
+   INLINE_ALWAYS TFloat * GetPredictorScores() {
+      static_assert(std::is_same<TFloat, FloatEbmType>::value || std::is_same<TFloat, float>::value, 
+         "predictor scores are stored as FloatEbmType or float");
       EBM_ASSERT(nullptr != m_aPredictorScores);
-      return m_aPredictorScores;
+      EBM_ASSERT((std::is_same<TFloat, float>::value) == m_bFloat32Storage);
+      return static_cast<TFloat *>(m_aPredictorScores);
    }
    INLINE_ALWAYS const StorageDataType * GetTargetDataPointer() const {
       EBM_ASSERT(nullptr != m_aTargetData);
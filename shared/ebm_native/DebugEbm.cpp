@@ -19,11 +19,14 @@
 #include "EbmInternal.h" // INLINE_ALWAYS
 #include "Logging.h" // EBM_ASSERT & LOG
 #include "ApproximateMath.h"
+#include "EbmStatisticUtils.h"
+#include "CpuDispatch.h"
 
 //#define INCLUDE_TESTS_IN_RELEASE
 //#define ENABLE_TEST_LOG_SUM_ERRORS
 //#define ENABLE_TEST_EXP_SUM_ERRORS
 //#define ENABLE_TEST_SOFTMAX_SUM_ERRORS
+//#define ENABLE_TEST_SIMD_MATCHES_SCALAR
 //#define ENABLE_PRINTF
 
 #if !defined(NDEBUG) || defined(INCLUDE_TESTS_IN_RELEASE)
@@ -441,4 +444,76 @@ static double TestSoftmaxSumErrors() {
 extern double g_TestSoftmaxSumErrors = TestSoftmaxSumErrors();
 #endif // ENABLE_TEST_SOFTMAX_SUM_ERRORS
 
+#ifdef ENABLE_TEST_SIMD_MATCHES_SCALAR
+#define CPU_VARIANT_KERNEL "DebugEbmKernel.h"
+#include "CpuVariantKernels.h"
+
+// ebm_native_test checks that boosting is bitwise identical for every CPU variant.  This checks the individual 
+// lanes, including NaN and infinite inputs and differences in tiny residuals that never reach the model
+static double TestSimdMatchesScalarAllVariants() {
+   constexpr size_t k_cRandomVals = 4000;
+
+   // the boundaries of each special case in the scalar functions, and their neighbours
+   const FloatEbmType aSpecialVals[] = {
+      std::numeric_limits<FloatEbmType>::quiet_NaN(),
+      -std::numeric_limits<FloatEbmType>::quiet_NaN(),
+      std::numeric_limits<FloatEbmType>::infinity(),
+      -std::numeric_limits<FloatEbmType>::infinity(),
+      std::numeric_limits<FloatEbmType>::max(),
+      std::numeric_limits<FloatEbmType>::lowest(),
+      std::numeric_limits<FloatEbmType>::denorm_min(),
+      -std::numeric_limits<FloatEbmType>::denorm_min(),
+      FloatEbmType { 0 },
+      -FloatEbmType { 0 },
+      FloatEbmType { 1 },
+      FloatEbmType { -1 },
+      FloatEbmType { 2 },
+      FloatEbmType { std::numeric_limits<float>::max() },
+      std::nextafter(FloatEbmType { std::numeric_limits<float>::max() }, std::numeric_limits<FloatEbmType>::infinity()),
+      std::nextafter(FloatEbmType { std::numeric_limits<float>::max() }, FloatEbmType { 0 }),
+      FloatEbmType { std::numeric_limits<float>::min() },
+      FloatEbmType { std::numeric_limits<float>::denorm_min() },
+      FloatEbmType { k_expUnderflowPoint },
+      std::nextafter(FloatEbmType { k_expUnderflowPoint }, -std::numeric_limits<FloatEbmType>::infinity()),
+      std::nextafter(FloatEbmType { k_expUnderflowPoint }, std::numeric_limits<FloatEbmType>::infinity()),
+      FloatEbmType { k_expOverflowPoint },
+      std::nextafter(FloatEbmType { k_expOverflowPoint }, -std::numeric_limits<FloatEbmType>::infinity()),
+      std::nextafter(FloatEbmType { k_expOverflowPoint }, std::numeric_limits<FloatEbmType>::infinity()),
+   };
+   constexpr size_t k_cSpecialVals = sizeof(aSpecialVals) / sizeof(aSpecialVals[0]);
+   // a multiple of the widest SimdVector
+   constexpr size_t k_cVals = (k_cSpecialVals + k_cRandomVals + size_t { 7 }) / size_t { 8 } * size_t { 8 };
+
+   FloatEbmType aVals[k_cVals];
+   memcpy(aVals, aSpecialVals, sizeof(aSpecialVals));
+
+   // half of the random values cover the logits we see in boosting, and the other half cover every magnitude
+   std::mt19937 testRandom(52);
+   std::uniform_real_distribution<FloatEbmType> logitDistribution(FloatEbmType { -100 }, FloatEbmType { 100 });
+   std::uniform_real_distribution<FloatEbmType> exponentDistribution(FloatEbmType { -300 }, FloatEbmType { 300 });
+   for(size_t iVal = k_cSpecialVals; iVal < k_cVals; ++iVal) {
+      if(0 == iVal % 2) {
+         aVals[iVal] = logitDistribution(testRandom);
+      } else {
+         const FloatEbmType magnitude = std::pow(FloatEbmType { 10 }, exponentDistribution(testRandom));
+         aVals[iVal] = 0 == iVal % 4 ? magnitude : -magnitude;
+      }
+   }
+
+   double debugRet = CpuVariantGeneric::TestSimdMatchesScalar(k_cVals, aVals);
+   const CpuVariantType cpuVariantSupported = GetCpuVariantSupported();
+   if(CpuVariant_AVX2 <= cpuVariantSupported) {
+      debugRet += CpuVariantAvx2::TestSimdMatchesScalar(k_cVals, aVals);
+   }
+   if(CpuVariant_AVX512 <= cpuVariantSupported) {
+      debugRet += CpuVariantAvx512::TestSimdMatchesScalar(k_cVals, aVals);
+   }
+
+   // this is just to prevent the compiler for optimizing our code away on release
+   return debugRet;
+}
+// this is just to prevent the compiler for optimizing our code away on release
+double g_TestSimdMatchesScalarAllVariants = TestSimdMatchesScalarAllVariants();
+#endif // ENABLE_TEST_SIMD_MATCHES_SCALAR
+
 #endif // !defined(NDEBUG) || defined(INCLUDE_TESTS_IN_RELEASE)
\ No newline at end of file
@@ -0,0 +1,64 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <ebm@koch.ninja>
+
+// DebugEbm.cpp only includes this through CpuVariantKernels.h, once for each CPU variant, so there is no include 
+// guard and nothing gets included here
+
+// Every lane of the SimdVector math has to give bitwise the same result as the scalar function that it stands in for.
+// The error bound tests in DebugEbm.cpp measure the scalar functions, so matching them bit for bit means that the 
+// vector versions have the same error characteristics.  cVals needs to be a multiple of SimdVector::k_cLanes
+static double TestSimdMatchesScalar(const size_t cVals, const FloatEbmType * const aVals) {
+   double debugRet = 0; // this just prevents the optimizer from eliminating this code
+
+   constexpr size_t cLanes = SimdVector::k_cLanes;
+   EBM_ASSERT(0 == cVals % cLanes);
+
+   FloatEbmType aResults[cLanes];
+   StorageDataType aTargets[cLanes];
+   for(size_t iVal = 0; iVal < cVals; iVal += cLanes) {
+      const FloatEbmType * const aLaneVals = &aVals[iVal];
+      const SimdVector vals = SimdVector::Load(aLaneVals);
+
+      vals.ExpApproxSchraudolph().Store(aResults);
+      for(size_t iLane = 0; iLane < cLanes; ++iLane) {
+         const FloatEbmType expected = ExpApproxSchraudolph<true, true, true, false>(aLaneVals[iLane]);
+         EBM_ASSERT(0 == memcmp(&expected, &aResults[iLane], sizeof(expected)));
+         debugRet += aResults[iLane];
+      }
+
+      vals.LogApproxSchraudolph().Store(aResults);
+      for(size_t iLane = 0; iLane < cLanes; ++iLane) {
+         // LogForLogLoss only ever passes us positive numbers or NaN
+         if(std::isnan(aLaneVals[iLane]) || FloatEbmType { 0 } < aLaneVals[iLane]) {
+            const FloatEbmType expected = LogApproxSchraudolph<true, false, false, false>(aLaneVals[iLane]);
+            EBM_ASSERT(0 == memcmp(&expected, &aResults[iLane], sizeof(expected)));
+            debugRet += aResults[iLane];
+         }
+      }
+
+      for(size_t iLane = 0; iLane < cLanes; ++iLane) {
+         aTargets[iLane] = (iVal / cLanes + iLane) % 2;
+      }
+      const SimdVector signs = SimdVector::LoadSignsFromBinaryTargets(aTargets);
+
+      ComputeResidualErrorBinaryClassification(vals, signs).Store(aResults);
+      for(size_t iLane = 0; iLane < cLanes; ++iLane) {
+         const FloatEbmType expected = 
+            EbmStatistics::ComputeResidualErrorBinaryClassification(aLaneVals[iLane], aTargets[iLane]);
+         EBM_ASSERT(0 == memcmp(&expected, &aResults[iLane], sizeof(expected)));
+         debugRet += aResults[iLane];
+      }
+
+      ComputeSingleSampleLogLossBinaryClassification(vals, signs).Store(aResults);
+      for(size_t iLane = 0; iLane < cLanes; ++iLane) {
+         const FloatEbmType expected = 
+            EbmStatistics::ComputeSingleSampleLogLossBinaryClassification(aLaneVals[iLane], aTargets[iLane]);
+         EBM_ASSERT(0 == memcmp(&expected, &aResults[iLane], sizeof(expected)));
+         debugRet += aResults[iLane];
+      }
+   }
+
+   // this is just to prevent the compiler for optimizing our code away on release
+   return debugRet;
+}
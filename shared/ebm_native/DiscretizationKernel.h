@@ -0,0 +1,575 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+// Discretization.cpp only includes this through CpuVariantKernels.h, once for each CPU variant, so there is no include 
+// guard and nothing gets included here
+
+static void SoftmaxBinarySamples(
+   const size_t cSamples,
+   const FloatEbmType * const aLogits,
+   FloatEbmType * const aProbabilitiesOut
+) {
+   for(size_t i = 0; i < cSamples; ++i) {
+      // NOTE: we use the non-approximate std::exp because we want our predictions to match what other softmax functions
+      // will generate instead of the approximation, and ordering is more sensitive to noise than boosting
+      const FloatEbmType odds = std::exp(aLogits[i]);
+      aProbabilitiesOut[i] = odds / (FloatEbmType { 1 } + odds);
+   }
+}
+
+// Discretize has already checked the arguments, so all that's left is the loops over the samples
+static void DiscretizeSamples(
+   const size_t cSamples,
+   const FloatEbmType * const featureValues,
+   const size_t cBinCuts,
+   const FloatEbmType * const binCutsLowerBoundInclusive,
+   IntEbmType * const discretizedOut
+) {
+   EBM_ASSERT(size_t { 1 } <= cSamples);
+
+   const FloatEbmType * pValue = featureValues;
+   const FloatEbmType * const pValueEnd = featureValues + cSamples;
+   IntEbmType * pDiscretized = discretizedOut;
+
+   if(UNLIKELY(size_t { 0 } == cBinCuts)) {
+      do {
+         const FloatEbmType val = *pValue;
+         IntEbmType result;
+         result = UNPREDICTABLE(std::isnan(val)) ? IntEbmType { 0 } : IntEbmType { 1 };
+         *pDiscretized = result;
+         ++pDiscretized;
+         ++pValue;
+      } while(LIKELY(pValueEnd != pValue));
+      return;
+   }
+
+   if(PREDICTABLE(size_t { 1 } == cBinCuts)) {
+      const FloatEbmType cut0 = binCutsLowerBoundInclusive[0];
+      do {
+         const FloatEbmType val = *pValue;
+         IntEbmType result;
+
+         result = UNPREDICTABLE(cut0 <= val) ? IntEbmType { 2 } : IntEbmType { 1 };
+         result = UNPREDICTABLE(std::isnan(val)) ? IntEbmType { 0 } : result;
+
+         *pDiscretized = result;
+         ++pDiscretized;
+         ++pValue;
+      } while(LIKELY(pValueEnd != pValue));
+      return;
+   }
+
+   if(PREDICTABLE(size_t { 2 } == cBinCuts)) {
+      const FloatEbmType cut0 = binCutsLowerBoundInclusive[0];
+      const FloatEbmType cut1 = binCutsLowerBoundInclusive[1];
+      do {
+         const FloatEbmType val = *pValue;
+         IntEbmType result;
+
+         result = UNPREDICTABLE(cut0 <= val) ? IntEbmType { 2 } : IntEbmType { 1 };
+         result = UNPREDICTABLE(cut1 <= val) ? IntEbmType { 3 } : result;
+         result = UNPREDICTABLE(std::isnan(val)) ? IntEbmType { 0 } : result;
+
+         *pDiscretized = result;
+         ++pDiscretized;
+         ++pValue;
+      } while(LIKELY(pValueEnd != pValue));
+      return;
+   }
+
+   if(PREDICTABLE(size_t { 3 } == cBinCuts)) {
+      const FloatEbmType cut0 = binCutsLowerBoundInclusive[0];
+      const FloatEbmType cut1 = binCutsLowerBoundInclusive[1];
+      const FloatEbmType cut2 = binCutsLowerBoundInclusive[2];
+      do {
+         const FloatEbmType val = *pValue;
+         IntEbmType result;
+
+         result = UNPREDICTABLE(cut0 <= val) ? IntEbmType { 2 } : IntEbmType { 1 };
+         result = UNPREDICTABLE(cut1 <= val) ? IntEbmType { 3 } : result;
+         result = UNPREDICTABLE(cut2 <= val) ? IntEbmType { 4 } : result;
+         result = UNPREDICTABLE(std::isnan(val)) ? IntEbmType { 0 } : result;
+
+         *pDiscretized = result;
+         ++pDiscretized;
+         ++pValue;
+      } while(LIKELY(pValueEnd != pValue));
+      return;
+   }
+
+   if(PREDICTABLE(size_t { 4 } == cBinCuts)) {
+      const FloatEbmType cut0 = binCutsLowerBoundInclusive[0];
+      const FloatEbmType cut1 = binCutsLowerBoundInclusive[1];
+      const FloatEbmType cut2 = binCutsLowerBoundInclusive[2];
+      const FloatEbmType cut3 = binCutsLowerBoundInclusive[3];
+      do {
+         const FloatEbmType val = *pValue;
+         IntEbmType result;
+
+         result = UNPREDICTABLE(cut0 <= val) ? IntEbmType { 2 } : IntEbmType { 1 };
+         result = UNPREDICTABLE(cut1 <= val) ? IntEbmType { 3 } : result;
+         result = UNPREDICTABLE(cut2 <= val) ? IntEbmType { 4 } : result;
+         result = UNPREDICTABLE(cut3 <= val) ? IntEbmType { 5 } : result;
+         result = UNPREDICTABLE(std::isnan(val)) ? IntEbmType { 0 } : result;
+
+         *pDiscretized = result;
+         ++pDiscretized;
+         ++pValue;
+      } while(LIKELY(pValueEnd != pValue));
+      return;
+   }
+
+   if(PREDICTABLE(size_t { 5 } == cBinCuts)) {
+      const FloatEbmType cut0 = binCutsLowerBoundInclusive[0];
+      const FloatEbmType cut1 = binCutsLowerBoundInclusive[1];
+      const FloatEbmType cut2 = binCutsLowerBoundInclusive[2];
+      const FloatEbmType cut3 = binCutsLowerBoundInclusive[3];
+      const FloatEbmType cut4 = binCutsLowerBoundInclusive[4];
+      do {
+         const FloatEbmType val = *pValue;
+         IntEbmType result;
+
+         result = UNPREDICTABLE(cut0 <= val) ? IntEbmType { 2 } : IntEbmType { 1 };
+         result = UNPREDICTABLE(cut1 <= val) ? IntEbmType { 3 } : result;
+         result = UNPREDICTABLE(cut2 <= val) ? IntEbmType { 4 } : result;
+         result = UNPREDICTABLE(cut3 <= val) ? IntEbmType { 5 } : result;
+         result = UNPREDICTABLE(cut4 <= val) ? IntEbmType { 6 } : result;
+         result = UNPREDICTABLE(std::isnan(val)) ? IntEbmType { 0 } : result;
+
+         *pDiscretized = result;
+         ++pDiscretized;
+         ++pValue;
+      } while(LIKELY(pValueEnd != pValue));
+      return;
+   }
+
+   if(PREDICTABLE(size_t { 6 } == cBinCuts)) {
+      const FloatEbmType cut0 = binCutsLowerBoundInclusive[0];
+      const FloatEbmType cut1 = binCutsLowerBoundInclusive[1];
+      const FloatEbmType cut2 = binCutsLowerBoundInclusive[2];
+      const FloatEbmType cut3 = binCutsLowerBoundInclusive[3];
+      const FloatEbmType cut4 = binCutsLowerBoundInclusive[4];
+      const FloatEbmType cut5 = binCutsLowerBoundInclusive[5];
+      do {
+         const FloatEbmType val = *pValue;
+         IntEbmType result;
+
+         result = UNPREDICTABLE(cut0 <= val) ? IntEbmType { 2 } : IntEbmType { 1 };
+         result = UNPREDICTABLE(cut1 <= val) ? IntEbmType { 3 } : result;
+         result = UNPREDICTABLE(cut2 <= val) ? IntEbmType { 4 } : result;
+         result = UNPREDICTABLE(cut3 <= val) ? IntEbmType { 5 } : result;
+         result = UNPREDICTABLE(cut4 <= val) ? IntEbmType { 6 } : result;
+         result = UNPREDICTABLE(cut5 <= val) ? IntEbmType { 7 } : result;
+         result = UNPREDICTABLE(std::isnan(val)) ? IntEbmType { 0 } : result;
+
+         *pDiscretized = result;
+         ++pDiscretized;
+         ++pValue;
+      } while(LIKELY(pValueEnd != pValue));
+      return;
+   }
+
+   FloatEbmType binCutsLowerBoundInclusiveCopy[1023];
+   // the only value that should be less than this one is NaN, which always returns false for comparisons
+   // that are not NaN.  If we have a NaN value we expect this to convert us to the 0th bin for missing
+   binCutsLowerBoundInclusiveCopy[0] = -std::numeric_limits<FloatEbmType>::infinity();
+
+   if(PREDICTABLE(cBinCuts <= size_t { 14 })) {
+      constexpr size_t cPower = 16;
+      if(cPower * 4 <= cSamples) {
+         static_assert(cPower - 1 <= sizeof(binCutsLowerBoundInclusiveCopy) /
+            sizeof(binCutsLowerBoundInclusiveCopy[0]), "binCutsLowerBoundInclusiveCopy buffer not large enough");
+
+         memcpy(
+            size_t { 1 } + binCutsLowerBoundInclusiveCopy,
+            binCutsLowerBoundInclusive, 
+            sizeof(*binCutsLowerBoundInclusive) * cBinCuts
+         );
+
+         if(LIKELY(cBinCuts != cPower - size_t { 2 })) {
+            FloatEbmType * pFill = &binCutsLowerBoundInclusiveCopy[cBinCuts + size_t { 1 }];
+            const FloatEbmType * const pEndFill = &binCutsLowerBoundInclusiveCopy[cPower - size_t { 1 }];
+            do {
+               // NaN will always move us downwards into the region of valid cuts.  The first cut is always
+               // guaranteed to be non-NaN, so if we have a missing (NaN) value, then the binary search will
+               // go low first and never hit these upper NaN values.
+               *pFill = std::numeric_limits<FloatEbmType>::quiet_NaN();
+               ++pFill;
+            } while(LIKELY(pEndFill != pFill));
+         }
+
+         const FloatEbmType firstComparison = binCutsLowerBoundInclusiveCopy[cPower / 2 - 1];
+         do {
+            const FloatEbmType val = *pValue;
+            char * pResult = reinterpret_cast<char *>(binCutsLowerBoundInclusiveCopy);
+
+            pResult += UNPREDICTABLE(firstComparison <= val) ? size_t { cPower / 2 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 3 } * sizeof(FloatEbmType)) <= val) ? size_t { 4 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 1 } * sizeof(FloatEbmType)) <= val) ? size_t { 2 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult) <= val) ? size_t { 1 } * sizeof(FloatEbmType) : size_t { 0 };
+
+            const size_t result = (pResult - reinterpret_cast<char *>(binCutsLowerBoundInclusiveCopy)) / sizeof(FloatEbmType);
+
+            *pDiscretized = static_cast<IntEbmType>(result);
+            ++pDiscretized;
+            ++pValue;
+         } while(LIKELY(pValueEnd != pValue));
+         return;
+      }
+   } else if(PREDICTABLE(cBinCuts <= size_t { 30 })) {
+      constexpr size_t cPower = 32;
+      if(cPower * 4 <= cSamples) {
+         static_assert(cPower - 1 <= sizeof(binCutsLowerBoundInclusiveCopy) /
+            sizeof(binCutsLowerBoundInclusiveCopy[0]), "binCutsLowerBoundInclusiveCopy buffer not large enough");
+
+         memcpy(
+            size_t { 1 } + binCutsLowerBoundInclusiveCopy,
+            binCutsLowerBoundInclusive,
+            sizeof(*binCutsLowerBoundInclusive) * cBinCuts
+         );
+
+         if(LIKELY(cBinCuts != cPower - size_t { 2 })) {
+            FloatEbmType * pFill = &binCutsLowerBoundInclusiveCopy[cBinCuts + size_t { 1 }];
+            const FloatEbmType * const pEndFill = &binCutsLowerBoundInclusiveCopy[cPower - size_t { 1 }];
+            do {
+               // NaN will always move us downwards into the region of valid cuts.  The first cut is always
+               // guaranteed to be non-NaN, so if we have a missing (NaN) value, then the binary search will
+               // go low first and never hit these upper NaN values.
+               *pFill = std::numeric_limits<FloatEbmType>::quiet_NaN();
+               ++pFill;
+            } while(LIKELY(pEndFill != pFill));
+         }
+
+         const FloatEbmType firstComparison = binCutsLowerBoundInclusiveCopy[cPower / 2 - 1];
+         do {
+            const FloatEbmType val = *pValue;
+            char * pResult = reinterpret_cast<char *>(binCutsLowerBoundInclusiveCopy);
+
+            pResult += UNPREDICTABLE(firstComparison <= val) ? size_t { cPower / 2 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 7 } * sizeof(FloatEbmType)) <= val) ? size_t { 8 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 3 } * sizeof(FloatEbmType)) <= val) ? size_t { 4 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 1 } * sizeof(FloatEbmType)) <= val) ? size_t { 2 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult) <= val) ? size_t { 1 } * sizeof(FloatEbmType) : size_t { 0 };
+
+            const size_t result = (pResult - reinterpret_cast<char *>(binCutsLowerBoundInclusiveCopy)) / sizeof(FloatEbmType);
+
+            *pDiscretized = static_cast<IntEbmType>(result);
+            ++pDiscretized;
+            ++pValue;
+         } while(LIKELY(pValueEnd != pValue));
+         return;
+      }
+   } else if(PREDICTABLE(cBinCuts <= size_t { 62 })) {
+      constexpr size_t cPower = 64;
+      if(cPower * 4 <= cSamples) {
+         static_assert(cPower - 1 <= sizeof(binCutsLowerBoundInclusiveCopy) /
+            sizeof(binCutsLowerBoundInclusiveCopy[0]), "binCutsLowerBoundInclusiveCopy buffer not large enough");
+
+         memcpy(
+            size_t { 1 } + binCutsLowerBoundInclusiveCopy,
+            binCutsLowerBoundInclusive,
+            sizeof(*binCutsLowerBoundInclusive) * cBinCuts
+         );
+
+         if(LIKELY(cBinCuts != cPower - size_t { 2 })) {
+            FloatEbmType * pFill = &binCutsLowerBoundInclusiveCopy[cBinCuts + size_t { 1 }];
+            const FloatEbmType * const pEndFill = &binCutsLowerBoundInclusiveCopy[cPower - size_t { 1 }];
+            do {
+               // NaN will always move us downwards into the region of valid cuts.  The first cut is always
+               // guaranteed to be non-NaN, so if we have a missing (NaN) value, then the binary search will
+               // go low first and never hit these upper NaN values.
+               *pFill = std::numeric_limits<FloatEbmType>::quiet_NaN();
+               ++pFill;
+            } while(LIKELY(pEndFill != pFill));
+         }
+
+         const FloatEbmType firstComparison = binCutsLowerBoundInclusiveCopy[cPower / 2 - 1];
+         do {
+            const FloatEbmType val = *pValue;
+            char * pResult = reinterpret_cast<char *>(binCutsLowerBoundInclusiveCopy);
+
+            pResult += UNPREDICTABLE(firstComparison <= val) ? size_t { cPower / 2 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 15 } * sizeof(FloatEbmType)) <= val) ? size_t { 16 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 7 } * sizeof(FloatEbmType)) <= val) ? size_t { 8 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 3 } * sizeof(FloatEbmType)) <= val) ? size_t { 4 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 1 } * sizeof(FloatEbmType)) <= val) ? size_t { 2 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult) <= val) ? size_t { 1 } * sizeof(FloatEbmType) : size_t { 0 };
+
+            const size_t result = (pResult - reinterpret_cast<char *>(binCutsLowerBoundInclusiveCopy)) / sizeof(FloatEbmType);
+
+            *pDiscretized = static_cast<IntEbmType>(result);
+            ++pDiscretized;
+            ++pValue;
+         } while(LIKELY(pValueEnd != pValue));
+         return;
+      }
+   } else if(PREDICTABLE(cBinCuts <= size_t { 126 })) {
+      constexpr size_t cPower = 128;
+      if(cPower * 4 <= cSamples) {
+         static_assert(cPower - 1 <= sizeof(binCutsLowerBoundInclusiveCopy) /
+            sizeof(binCutsLowerBoundInclusiveCopy[0]), "binCutsLowerBoundInclusiveCopy buffer not large enough");
+
+         memcpy(
+            size_t { 1 } + binCutsLowerBoundInclusiveCopy,
+            binCutsLowerBoundInclusive,
+            sizeof(*binCutsLowerBoundInclusive) * cBinCuts
+         );
+
+         if(LIKELY(cBinCuts != cPower - size_t { 2 })) {
+            FloatEbmType * pFill = &binCutsLowerBoundInclusiveCopy[cBinCuts + size_t { 1 }];
+            const FloatEbmType * const pEndFill = &binCutsLowerBoundInclusiveCopy[cPower - size_t { 1 }];
+            do {
+               // NaN will always move us downwards into the region of valid cuts.  The first cut is always
+               // guaranteed to be non-NaN, so if we have a missing (NaN) value, then the binary search will
+               // go low first and never hit these upper NaN values.
+               *pFill = std::numeric_limits<FloatEbmType>::quiet_NaN();
+               ++pFill;
+            } while(LIKELY(pEndFill != pFill));
+         }
+
+         const FloatEbmType firstComparison = binCutsLowerBoundInclusiveCopy[cPower / 2 - 1];
+         do {
+            const FloatEbmType val = *pValue;
+            char * pResult = reinterpret_cast<char *>(binCutsLowerBoundInclusiveCopy);
+
+            pResult += UNPREDICTABLE(firstComparison <= val) ? size_t { cPower / 2 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 31 } * sizeof(FloatEbmType)) <= val) ? size_t { 32 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 15 } * sizeof(FloatEbmType)) <= val) ? size_t { 16 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 7 } * sizeof(FloatEbmType)) <= val) ? size_t { 8 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 3 } * sizeof(FloatEbmType)) <= val) ? size_t { 4 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 1 } * sizeof(FloatEbmType)) <= val) ? size_t { 2 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult) <= val) ? size_t { 1 } * sizeof(FloatEbmType) : size_t { 0 };
+
+            const size_t result = (pResult - reinterpret_cast<char *>(binCutsLowerBoundInclusiveCopy)) / sizeof(FloatEbmType);
+
+            *pDiscretized = static_cast<IntEbmType>(result);
+            ++pDiscretized;
+            ++pValue;
+         } while(LIKELY(pValueEnd != pValue));
+         return;
+      }
+   } else if(PREDICTABLE(cBinCuts <= size_t { 254 })) {
+      constexpr size_t cPower = 256;
+      if(cPower * 4 <= cSamples) {
+         static_assert(cPower - 1 <= sizeof(binCutsLowerBoundInclusiveCopy) /
+            sizeof(binCutsLowerBoundInclusiveCopy[0]), "binCutsLowerBoundInclusiveCopy buffer not large enough");
+
+         memcpy(
+            size_t { 1 } + binCutsLowerBoundInclusiveCopy,
+            binCutsLowerBoundInclusive,
+            sizeof(*binCutsLowerBoundInclusive) * cBinCuts
+         );
+
+         if(LIKELY(cBinCuts != cPower - size_t { 2 })) {
+            FloatEbmType * pFill = &binCutsLowerBoundInclusiveCopy[cBinCuts + size_t { 1 }];
+            const FloatEbmType * const pEndFill = &binCutsLowerBoundInclusiveCopy[cPower - size_t { 1 }];
+            do {
+               // NaN will always move us downwards into the region of valid cuts.  The first cut is always
+               // guaranteed to be non-NaN, so if we have a missing (NaN) value, then the binary search will
+               // go low first and never hit these upper NaN values.
+               *pFill = std::numeric_limits<FloatEbmType>::quiet_NaN();
+               ++pFill;
+            } while(LIKELY(pEndFill != pFill));
+         }
+
+         const FloatEbmType firstComparison = binCutsLowerBoundInclusiveCopy[cPower / 2 - 1];
+         do {
+            const FloatEbmType val = *pValue;
+            char * pResult = reinterpret_cast<char *>(binCutsLowerBoundInclusiveCopy);
+
+            pResult += UNPREDICTABLE(firstComparison <= val) ? size_t { cPower / 2 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 63 } * sizeof(FloatEbmType)) <= val) ? size_t { 64 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 31 } * sizeof(FloatEbmType)) <= val) ? size_t { 32 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 15 } * sizeof(FloatEbmType)) <= val) ? size_t { 16 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 7 } * sizeof(FloatEbmType)) <= val) ? size_t { 8 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 3 } * sizeof(FloatEbmType)) <= val) ? size_t { 4 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 1 } * sizeof(FloatEbmType)) <= val) ? size_t { 2 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult) <= val) ? size_t { 1 } * sizeof(FloatEbmType) : size_t { 0 };
+
+            const size_t result = (pResult - reinterpret_cast<char *>(binCutsLowerBoundInclusiveCopy)) / sizeof(FloatEbmType);
+
+            *pDiscretized = static_cast<IntEbmType>(result);
+            ++pDiscretized;
+            ++pValue;
+         } while(LIKELY(pValueEnd != pValue));
+         return;
+      }
+   } else if(PREDICTABLE(cBinCuts <= size_t { 510 })) {
+      constexpr size_t cPower = 512;
+      if(cPower * 4 <= cSamples) {
+         static_assert(cPower - 1 <= sizeof(binCutsLowerBoundInclusiveCopy) /
+            sizeof(binCutsLowerBoundInclusiveCopy[0]), "binCutsLowerBoundInclusiveCopy buffer not large enough");
+
+         memcpy(
+            size_t { 1 } + binCutsLowerBoundInclusiveCopy,
+            binCutsLowerBoundInclusive,
+            sizeof(*binCutsLowerBoundInclusive) * cBinCuts
+         );
+
+         if(LIKELY(cBinCuts != cPower - size_t { 2 })) {
+            FloatEbmType * pFill = &binCutsLowerBoundInclusiveCopy[cBinCuts + size_t { 1 }];
+            const FloatEbmType * const pEndFill = &binCutsLowerBoundInclusiveCopy[cPower - size_t { 1 }];
+            do {
+               // NaN will always move us downwards into the region of valid cuts.  The first cut is always
+               // guaranteed to be non-NaN, so if we have a missing (NaN) value, then the binary search will
+               // go low first and never hit these upper NaN values.
+               *pFill = std::numeric_limits<FloatEbmType>::quiet_NaN();
+               ++pFill;
+            } while(LIKELY(pEndFill != pFill));
+         }
+
+         const FloatEbmType firstComparison = binCutsLowerBoundInclusiveCopy[cPower / 2 - 1];
+         do {
+            const FloatEbmType val = *pValue;
+            char * pResult = reinterpret_cast<char *>(binCutsLowerBoundInclusiveCopy);
+
+            pResult += UNPREDICTABLE(firstComparison <= val) ? size_t { cPower / 2 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 127 } * sizeof(FloatEbmType)) <= val) ? size_t { 128 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 63 } * sizeof(FloatEbmType)) <= val) ? size_t { 64 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 31 } * sizeof(FloatEbmType)) <= val) ? size_t { 32 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 15 } * sizeof(FloatEbmType)) <= val) ? size_t { 16 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 7 } * sizeof(FloatEbmType)) <= val) ? size_t { 8 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 3 } * sizeof(FloatEbmType)) <= val) ? size_t { 4 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 1 } * sizeof(FloatEbmType)) <= val) ? size_t { 2 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult) <= val) ? size_t { 1 } * sizeof(FloatEbmType) : size_t { 0 };
+
+            const size_t result = (pResult - reinterpret_cast<char *>(binCutsLowerBoundInclusiveCopy)) / sizeof(FloatEbmType);
+
+            *pDiscretized = static_cast<IntEbmType>(result);
+            ++pDiscretized;
+            ++pValue;
+         } while(LIKELY(pValueEnd != pValue));
+         return;
+      }
+   } else if(PREDICTABLE(cBinCuts <= size_t { 1022 })) {
+      constexpr size_t cPower = 1024;
+      if(cPower * 4 <= cSamples) {
+         static_assert(cPower - 1 == sizeof(binCutsLowerBoundInclusiveCopy) /
+            sizeof(binCutsLowerBoundInclusiveCopy[0]), "binCutsLowerBoundInclusiveCopy buffer not large enough");
+
+         memcpy(
+            size_t { 1 } + binCutsLowerBoundInclusiveCopy,
+            binCutsLowerBoundInclusive,
+            sizeof(*binCutsLowerBoundInclusive) * cBinCuts
+         );
+
+         if(LIKELY(cBinCuts != cPower - size_t { 2 })) {
+            FloatEbmType * pFill = &binCutsLowerBoundInclusiveCopy[cBinCuts + size_t { 1 }];
+            const FloatEbmType * const pEndFill = &binCutsLowerBoundInclusiveCopy[cPower - size_t { 1 }];
+            do {
+               // NaN will always move us downwards into the region of valid cuts.  The first cut is always
+               // guaranteed to be non-NaN, so if we have a missing (NaN) value, then the binary search will
+               // go low first and never hit these upper NaN values.
+               *pFill = std::numeric_limits<FloatEbmType>::quiet_NaN();
+               ++pFill;
+            } while(LIKELY(pEndFill != pFill));
+         }
+
+         const FloatEbmType firstComparison = binCutsLowerBoundInclusiveCopy[cPower / 2 - 1];
+         do {
+            const FloatEbmType val = *pValue;
+            char * pResult = reinterpret_cast<char *>(binCutsLowerBoundInclusiveCopy);
+
+            pResult += UNPREDICTABLE(firstComparison <= val) ? size_t { cPower / 2 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 255 } * sizeof(FloatEbmType)) <= val) ? size_t { 256 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 127 } * sizeof(FloatEbmType)) <= val) ? size_t { 128 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 63 } * sizeof(FloatEbmType)) <= val) ? size_t { 64 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 31 } * sizeof(FloatEbmType)) <= val) ? size_t { 32 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 15 } * sizeof(FloatEbmType)) <= val) ? size_t { 16 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 7 } * sizeof(FloatEbmType)) <= val) ? size_t { 8 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 3 } * sizeof(FloatEbmType)) <= val) ? size_t { 4 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult + size_t { 1 } * sizeof(FloatEbmType)) <= val) ? size_t { 2 } * sizeof(FloatEbmType) : size_t { 0 };
+            pResult += UNPREDICTABLE(*reinterpret_cast<FloatEbmType *>(pResult) <= val) ? size_t { 1 } * sizeof(FloatEbmType) : size_t { 0 };
+
+            const size_t result = (pResult - reinterpret_cast<char *>(binCutsLowerBoundInclusiveCopy)) / sizeof(FloatEbmType);
+
+            *pDiscretized = static_cast<IntEbmType>(result);
+            ++pDiscretized;
+            ++pValue;
+         } while(LIKELY(pValueEnd != pValue));
+         return;
+      }
+   }
+
+   if(cBinCuts <= cSamples) {
+      // We get here with more cuts than our fixed size searches handle, or with too few samples to make copying 
+      // the cuts worthwhile.  Building an Eytzinger tree costs about 2 items per cut, so only do it when we
+      // have enough samples to pay that back.  The tree keeps the top levels of every search in the same few
+      // cache lines, which matters once the cuts no longer fit in L1.
+      DiscretizeEngine engine;
+      FloatEbmType * const aItems = EbmMalloc<FloatEbmType>(DiscretizeEngine::GetItemCount(cBinCuts));
+      if(LIKELY(nullptr != aItems)) {
+         engine.Initialize(cBinCuts, binCutsLowerBoundInclusive, aItems);
+         engine.DiscretizeMany(cSamples, featureValues, discretizedOut);
+         free(aItems);
+         return;
+      }
+      // we can still discretize without the tree, just slower
+      LOG_0(TraceLevelWarning, "WARNING Discretize nullptr == aItems");
+   }
+
+   EBM_ASSERT(cBinCuts < std::numeric_limits<size_t>::max());
+   EBM_ASSERT(size_t { 1 } <= cBinCuts);
+   EBM_ASSERT(cBinCuts - size_t { 1 } <= size_t { std::numeric_limits<ptrdiff_t>::max() });
+   const ptrdiff_t highStart = static_cast<ptrdiff_t>(cBinCuts - size_t { 1 });
+
+   // if we're going to runroll our first loop, then we need to ensure that there's a next loop after the first
+   // unrolled loop, otherwise we would need to check if we were done before the first real loop iteration.
+   // To ensure we have 2 original loop iterations, we need 1 cut in the center, 1 cut above, and 1 cut below, so 3
+   EBM_ASSERT(size_t { 3 } <= cBinCuts);
+   const size_t firstMiddle = static_cast<size_t>(highStart) >> 1;
+   EBM_ASSERT(firstMiddle < cBinCuts);
+   const FloatEbmType firstMidVal = binCutsLowerBoundInclusive[firstMiddle];
+   const ptrdiff_t firstMidLow = static_cast<ptrdiff_t>(firstMiddle) + ptrdiff_t { 1 };
+   const ptrdiff_t firstMidHigh = static_cast<ptrdiff_t>(firstMiddle) - ptrdiff_t { 1 };
+
+   do {
+      const FloatEbmType val = *pValue;
+      size_t middle = size_t { 0 };
+      if(PREDICTABLE(!std::isnan(val))) {
+         ptrdiff_t high = UNPREDICTABLE(firstMidVal <= val) ? highStart : firstMidHigh;
+         ptrdiff_t low = UNPREDICTABLE(firstMidVal <= val) ? firstMidLow : ptrdiff_t { 0 };
+         FloatEbmType midVal;
+         do {
+            EBM_ASSERT(ptrdiff_t { 0 } <= low && static_cast<size_t>(low) < cBinCuts);
+            EBM_ASSERT(ptrdiff_t { 0 } <= high && static_cast<size_t>(high) < cBinCuts);
+            EBM_ASSERT(low <= high);
+            // low is equal or lower than high, so summing them can't exceed 2 * high, and after division it
+            // can't be higher than high, so middle can't overflow ptrdiff_t after the division since high
+            // is already a ptrdiff_t.  Generally the maximum positive value of a ptrdiff_t can be doubled 
+            // when converted to a size_t, although that isn't guaranteed.  A more correct statement is that
+            // the following must be false (which we check above):
+            // "std::numeric_limits<size_t>::max() / 2 < cBinCuts - 1"
+            EBM_ASSERT(!IsAddError(static_cast<size_t>(low), static_cast<size_t>(high)));
+            middle = (static_cast<size_t>(low) + static_cast<size_t>(high)) >> 1;
+            EBM_ASSERT(middle <= static_cast<size_t>(high));
+            EBM_ASSERT(middle < cBinCuts);
+            midVal = binCutsLowerBoundInclusive[middle];
+            EBM_ASSERT(middle < size_t { std::numeric_limits<ptrdiff_t>::max() });
+            low = UNPREDICTABLE(midVal <= val) ? static_cast<ptrdiff_t>(middle) + ptrdiff_t { 1 } : low;
+            EBM_ASSERT(ptrdiff_t { 0 } <= low && static_cast<size_t>(low) <= cBinCuts);
+            high = UNPREDICTABLE(midVal <= val) ? high : static_cast<ptrdiff_t>(middle) - ptrdiff_t { 1 };
+            EBM_ASSERT(ptrdiff_t { -1 } <= high && high <= highStart);
+
+            // high can become -1 in some cases, so it needs to be ptrdiff_t.  It's tempting to try and change
+            // this code and use the Hermann Bottenbruch version that checks for low != high in the loop comparison
+            // since then we wouldn't have negative values and we could use size_t, but unfortunately that version
+            // has a check at the end where we'd need to fetch binCutsLowerBoundInclusive[low] after exiting the 
+            // loop, so this version we have here is faster given that we only need to compare to a value that
+            // we've already fetched from memory.  Also, this version makes slightly faster progress since
+            // it does middle + 1 AND middle - 1 instead of just middle - 1, so it often eliminates one loop
+            // iteration.  In practice this version will always work since no floating point type is less than 4
+            // bytes, so we shouldn't have difficulty expressing any indexes with ptrdiff_t, and our indexes
+            // for accessing memory are always size_t, so those should always work.
+         } while(LIKELY(low <= high));
+         EBM_ASSERT(size_t { 0 } <= middle && middle < cBinCuts);
+         middle = UNPREDICTABLE(midVal <= val) ? middle + size_t { 2 } : middle + size_t { 1 };
+         EBM_ASSERT(size_t { 1 } <= middle && middle <= size_t { 1 } + cBinCuts);
+      }
+      EBM_ASSERT(IsNumberConvertable<IntEbmType>(middle));
+      *pDiscretized = static_cast<IntEbmType>(middle);
+      ++pDiscretized;
+      ++pValue;
+   } while(LIKELY(pValueEnd != pValue));
+}
@@ -0,0 +1,81 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memcpy
+#include <limits> // numeric_limits
+
+#include "ebm_native.h"
+#include "EbmInternal.h" // INLINE_ALWAYS
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "DiscretizeEngine.h"
+
+INLINE_ALWAYS static size_t GetEytzingerLevels(const size_t cBinCuts) {
+   // we need room for -infinity plus the cuts in a complete tree of 2^levels - 1 nodes
+   EBM_ASSERT(!IsAddError(cBinCuts, size_t { 1 }));
+   return CountBitsRequired<size_t>(cBinCuts + size_t { 1 });
+}
+
+size_t DiscretizeEngine::GetItemCount(const size_t cBinCuts) {
+   if(cBinCuts <= k_cBinCutsLinearMax) {
+      return cBinCuts;
+   }
+   // the tree is 1-based, so we have 2^levels items including the unused item 0
+   return size_t { 1 } << GetEytzingerLevels(cBinCuts);
+}
+
+void DiscretizeEngine::InitializeFromItems(const size_t cBinCuts, const FloatEbmType * const aItems) {
+   EBM_ASSERT(size_t { 0 } == cBinCuts || nullptr != aItems);
+
+   m_cBinCuts = cBinCuts;
+   m_cLevels = cBinCuts <= k_cBinCutsLinearMax ? size_t { 0 } : GetEytzingerLevels(cBinCuts);
+   m_aItems = aItems;
+}
+
+void DiscretizeEngine::Initialize(
+   const size_t cBinCuts,
+   const FloatEbmType * const aBinCuts,
+   FloatEbmType * const aItems
+) {
+   EBM_ASSERT(size_t { 0 } == cBinCuts || nullptr != aBinCuts);
+   EBM_ASSERT(size_t { 0 } == cBinCuts || nullptr != aItems);
+
+   m_cBinCuts = cBinCuts;
+   m_aItems = aItems;
+
+   if(cBinCuts <= k_cBinCutsLinearMax) {
+      m_cLevels = 0;
+      if(size_t { 0 } != cBinCuts) {
+         memcpy(aItems, aBinCuts, sizeof(*aBinCuts) * cBinCuts);
+      }
+      return;
+   }
+
+   const size_t cLevels = GetEytzingerLevels(cBinCuts);
+   m_cLevels = cLevels;
+
+   aItems[0] = std::numeric_limits<FloatEbmType>::quiet_NaN();
+   for(size_t iLevel = 0; iLevel < cLevels; ++iLevel) {
+      // the nodes of a level are evenly spaced over the sorted order, with the first one halfway into its span
+      const size_t cNodes = size_t { 1 } << iLevel;
+      const size_t cSpan = size_t { 1 } << (cLevels - iLevel);
+      size_t iSorted = (cSpan >> 1) - size_t { 1 };
+      FloatEbmType * pItem = &aItems[cNodes];
+      const FloatEbmType * const pItemEnd = pItem + cNodes;
+      do {
+         // sorted item 0 is -infinity, then the cuts, and then NaN padding which never compares lower or equal
+         FloatEbmType item = std::numeric_limits<FloatEbmType>::quiet_NaN();
+         if(size_t { 0 } == iSorted) {
+            item = -std::numeric_limits<FloatEbmType>::infinity();
+         } else if(iSorted <= cBinCuts) {
+            item = aBinCuts[iSorted - size_t { 1 }];
+         }
+         *pItem = item;
+         iSorted += cSpan;
+         ++pItem;
+      } while(pItemEnd != pItem);
+   }
+}
@@ -0,0 +1,115 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef DISCRETIZE_ENGINE_H
+#define DISCRETIZE_ENGINE_H
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <cmath> // std::isnan
+
+#include "ebm_native.h"
+#include "EbmInternal.h" // INLINE_ALWAYS
+#include "Logging.h" // EBM_ASSERT & LOG
+
+// A DiscretizeEngine converts raw feature values into bin indexes the same way Discretize does: bin 0 is for
+// missing (NaN) values and otherwise the bin is 1 + the number of cuts that are lower or equal to the value.
+// We pick the search strategy once per feature when the engine is built, based on the number of cuts:
+//   - with few cuts we compare the value against every cut and count.  There are no dependent loads and the
+//     compiler can vectorize the comparisons, so this beats any search up to a few cache lines of cuts
+//   - with more cuts we walk an Eytzinger (breadth first) ordered copy of the cuts.  Each step is a conditional
+//     move instead of an unpredictable branch, every value takes exactly the same number of steps, and the top
+//     levels of the tree that every search touches share the same few cache lines
+constexpr size_t k_cBinCutsLinearMax = 16;
+
+class DiscretizeEngine final {
+   size_t m_cBinCuts;
+   // 0 if we compare against every cut, otherwise the depth of the complete Eytzinger tree
+   size_t m_cLevels;
+   // either the cuts in sorted order, or the 1-based Eytzinger tree with item 0 unused
+   const FloatEbmType * m_aItems;
+
+   INLINE_ALWAYS size_t DiscretizeLinear(const FloatEbmType val) const {
+      size_t iBin = 1;
+      for(size_t iBinCut = 0; iBinCut < m_cBinCuts; ++iBinCut) {
+         iBin += UNPREDICTABLE(m_aItems[iBinCut] <= val) ? size_t { 1 } : size_t { 0 };
+      }
+      // NaN compares false to every cut, so it ends up at 1 and we need to move it to the missing bin
+      return UNPREDICTABLE(std::isnan(val)) ? size_t { 0 } : iBin;
+   }
+
+   INLINE_ALWAYS size_t DiscretizeEytzinger(const FloatEbmType val) const {
+      // The tree holds -infinity, the cuts, and then NaN padding, all in sorted order.  Going right whenever the
+      // node is lower or equal to val means the leaf we land on, minus the leaf level start, is the count of
+      // items lower or equal to val.  -infinity adds the 1 for the missing bin, NaN padding never counts, and a
+      // NaN val counts nothing so it lands in bin 0 without needing a separate check.
+      const size_t cLevels = m_cLevels;
+      size_t iNode = 1;
+      for(size_t iLevel = 0; iLevel < cLevels; ++iLevel) {
+         iNode = (iNode << 1) + (UNPREDICTABLE(m_aItems[iNode] <= val) ? size_t { 1 } : size_t { 0 });
+      }
+      return iNode - (size_t { 1 } << cLevels);
+   }
+
+public:
+
+   DiscretizeEngine() = default; // preserve our POD status
+   ~DiscretizeEngine() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   // the number of FloatEbmType items that Initialize needs, which is never more than 2 * cBinCuts + 2.  The caller
+   // needs to check that this can't overflow
+   static size_t GetItemCount(const size_t cBinCuts);
+
+   // aItems needs to hold GetItemCount(cBinCuts) items and needs to outlive the engine.  The cuts must be sorted
+   // and cannot contain NaN
+   void Initialize(const size_t cBinCuts, const FloatEbmType * const aBinCuts, FloatEbmType * const aItems);
+
+   // uses items that an earlier Initialize already wrote, like the ones in a saved model file, without copying them
+   void InitializeFromItems(const size_t cBinCuts, const FloatEbmType * const aItems);
+
+   INLINE_ALWAYS const FloatEbmType * GetItems() const {
+      return m_aItems;
+   }
+
+   INLINE_ALWAYS size_t GetCountBinCuts() const {
+      return m_cBinCuts;
+   }
+
+   INLINE_ALWAYS size_t DiscretizeValue(const FloatEbmType val) const {
+      // the strategy is fixed per feature, so this branch is perfectly predictable when scoring a column
+      const size_t iBin = size_t { 0 } == m_cLevels ? DiscretizeLinear(val) : DiscretizeEytzinger(val);
+      EBM_ASSERT(iBin <= m_cBinCuts + size_t { 1 });
+      return iBin;
+   }
+
+   // the Discretize kernels in DiscretizationKernel.h call this once per CPU variant, so it needs to be inlined into
+   // them to get compiled for each variant's instruction set
+   template<typename TBin>
+   INLINE_ALWAYS void DiscretizeMany(const size_t cValues, const FloatEbmType * const aValues, TBin * const aBinsOut) const {
+      const FloatEbmType * pValue = aValues;
+      const FloatEbmType * const pValueEnd = aValues + cValues;
+      TBin * pBin = aBinsOut;
+      // hoist the strategy out of the loop so the compiler can unroll and vectorize each loop on its own
+      if(size_t { 0 } == m_cLevels) {
+         for(; pValueEnd != pValue; ++pValue) {
+            *pBin = static_cast<TBin>(DiscretizeLinear(*pValue));
+            ++pBin;
+         }
+      } else {
+         for(; pValueEnd != pValue; ++pValue) {
+            *pBin = static_cast<TBin>(DiscretizeEytzinger(*pValue));
+            ++pBin;
+         }
+      }
+   }
+};
+static_assert(std::is_standard_layout<DiscretizeEngine>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<DiscretizeEngine>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<DiscretizeEngine>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+#endif // DISCRETIZE_ENGINE_H
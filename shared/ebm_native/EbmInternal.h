@@ -174,6 +174,14 @@ constexpr FloatEbmType k_illegalGain = std::numeric_limits<FloatEbmType>::lowest
 constexpr FloatEbmType k_epsilonNegativeGainAllowed = -1e-7;
 constexpr FloatEbmType k_epsilonNegativeValidationMetricAllowed = -1e-7;
 constexpr FloatEbmType k_epsilonResidualError = 1e-7;
+// the multiclass residuals of a sample sum to zero when we compute them, but residuals stored as float are rounded 
+// one by one, so their stored sum can be off by up to half a float epsilon per class
+template<typename TFloat>
+INLINE_ALWAYS FloatEbmType GetEpsilonResidualErrorTotal(const size_t cVectorLength) {
+   return std::is_same<TFloat, float>::value ? 
+      static_cast<FloatEbmType>(cVectorLength) * static_cast<FloatEbmType>(std::numeric_limits<float>::epsilon()) : 
+      k_epsilonResidualError;
+}
 #if defined(FAST_EXP) || defined(FAST_LOG)
 // with the approximate exp function we can expect a bit of noise.  We might need to increase this further
 constexpr FloatEbmType k_epsilonResidualErrorForBinaryToMulticlass = 1e-1;
@@ -500,14 +508,6 @@ INLINE_ALWAYS T * EbmMalloc(const size_t cItems, const size_t cBytesPerItem) {
    }
 }
 
-// TODO: figure out if we really want/need to template the handling of different bit packing sizes.  It might
-//       be the case that for specific bit sizes, like 8x8, we want to keep our memory stride as small as possible
-//       but we might also find that we can apply SIMD at the outer loop level in the places where we use bit
-//       packing, so we'd load eight 64-bit numbers at a time and then keep all the interior loops.  In this case
-//       the only penalty would be one branch mispredict, but we'd be able to loop over 8 bit extractions at a time
-//       We might also pay a penalty if our stride length for the outputs is too long, but we'll have to test that
-constexpr bool k_bUseSIMD = false;
-
 // TODO eventually, eliminate these variables, and make eliminating logits a part of our regular framework
 constexpr ptrdiff_t k_iZeroResidual = -1;
 constexpr ptrdiff_t k_iZeroClassificationLogitAtInitialize = -1;
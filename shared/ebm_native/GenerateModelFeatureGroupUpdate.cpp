@@ -26,13 +26,19 @@
 #include "HistogramBucket.h"
 
 #include "Booster.h"
+#include "Threading.h"
 
 #include "TensorTotalsSum.h"
 
+extern size_t GetCountBinShards(const FeatureGroup * const pFeatureGroup, const size_t cSamples);
+
 extern void BinBoosting(
    Booster * const pBooster,
    const FeatureGroup * const pFeatureGroup,
    const SamplingSet * const pTrainingSet,
+   const size_t cShardBuffers,
+   const size_t cBytesShardBuffer,
+   HistogramBucketBase * const aShardBuffers,
    HistogramBucketBase * const aHistogramBucketBase
 #ifndef NDEBUG
    , const unsigned char * const aHistogramBucketsEndDebug
@@ -93,9 +99,9 @@ extern bool CutRandom(
 #endif // NDEBUG
 );
 
-static bool BoostZeroDimensional(
+static void BoostZeroDimensional(
    Booster * const pBooster,
-   const SamplingSet * const pTrainingSet,
+   const HistogramBucketBase * const pHistogramBucket,
    const GenerateUpdateOptionsType options,
    SegmentedTensor * const pSmallChangeToModelOverwriteSingleSamplingSet
 ) {
@@ -105,38 +111,6 @@ static bool BoostZeroDimensional(
    const bool bClassification = IsClassification(runtimeLearningTypeOrCountTargetClasses);
 
    const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
-   if(GetHistogramBucketSizeOverflow(bClassification, cVectorLength)) {
-      // TODO : move this to initialization where we execute it only once
-      LOG_0(TraceLevelWarning, "GetHistogramBucketSizeOverflow<bClassification>(cVectorLength)");
-      return true;
-   }
-   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
-
-   CachedBoostingThreadResources * const pCachedThreadResources = pBooster->GetCachedThreadResources();
-
-   HistogramBucketBase * const pHistogramBucket =
-      pCachedThreadResources->GetThreadByteBuffer1(cBytesPerHistogramBucket);
-
-   if(UNLIKELY(nullptr == pHistogramBucket)) {
-      LOG_0(TraceLevelWarning, "WARNING nullptr == pHistogramBucket");
-      return true;
-   }
-
-   if(bClassification) {
-      pHistogramBucket->GetHistogramBucket<true>()->Zero(cVectorLength);
-   } else {
-      pHistogramBucket->GetHistogramBucket<false>()->Zero(cVectorLength);
-   }
-
-   BinBoosting(
-      pBooster,
-      nullptr,
-      pTrainingSet,
-      pHistogramBucket
-#ifndef NDEBUG
-      , nullptr
-#endif // NDEBUG
-   );
 
    FloatEbmType * aValues = pSmallChangeToModelOverwriteSingleSamplingSet->GetValuePointer();
    if(bClassification) {
@@ -175,22 +149,24 @@ static bool BoostZeroDimensional(
    }
 
    LOG_0(TraceLevelVerbose, "Exited BoostZeroDimensional");
-   return false;
 }
 
 static bool BoostSingleDimensional(
    Booster * const pBooster,
    const FeatureGroup * const pFeatureGroup,
    const SamplingSet * const pTrainingSet,
+   HistogramBucketBase * const aHistogramBuckets,
    const size_t cSamplesRequiredForChildSplitMin,
    const IntEbmType countLeavesMax,
    SegmentedTensor * const pSmallChangeToModelOverwriteSingleSamplingSet,
    FloatEbmType * const pTotalGain
+#ifndef NDEBUG
+   , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
 ) {
    LOG_0(TraceLevelVerbose, "Entered BoostSingleDimensional");
 
    EBM_ASSERT(1 == pFeatureGroup->GetCountFeatures());
-   size_t cTotalBuckets = pFeatureGroup->GetFeatureGroupEntries()[0].m_pFeature->GetCountBins();
 
    EBM_ASSERT(IntEbmType { 2 } <= countLeavesMax); // otherwise we would have called BoostZeroDimensional
    size_t cLeavesMax = static_cast<size_t>(countLeavesMax);
@@ -203,70 +179,24 @@ static bool BoostSingleDimensional(
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
    const bool bClassification = IsClassification(runtimeLearningTypeOrCountTargetClasses);
    const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
-   if(GetHistogramBucketSizeOverflow(bClassification, cVectorLength)) {
-      // TODO : move this to initialization where we execute it only once
-      LOG_0(TraceLevelWarning, "WARNING GetHistogramBucketSizeOverflow<bClassification>(cVectorLength)");
-      return true;
-   }
-   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
-   if(IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket)) {
-      // TODO : move this to initialization where we execute it only once
-      LOG_0(TraceLevelWarning, "WARNING IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket)");
-      return true;
-   }
-   const size_t cBytesBuffer = cTotalBuckets * cBytesPerHistogramBucket;
 
    CachedBoostingThreadResources * const pCachedThreadResources = pBooster->GetCachedThreadResources();
 
-   HistogramBucketBase * const aHistogramBuckets = pCachedThreadResources->GetThreadByteBuffer1(cBytesBuffer);
-   if(UNLIKELY(nullptr == aHistogramBuckets)) {
-      LOG_0(TraceLevelWarning, "WARNING BoostSingleDimensional nullptr == aHistogramBuckets");
-      return true;
-   }
-
    HistogramBucketVectorEntryBase * const aSumHistogramBucketVectorEntry =
       pCachedThreadResources->GetSumHistogramBucketVectorEntryArray();
 
    if(bClassification) {
-      HistogramBucket<true> * const aHistogramBucketsLocal = aHistogramBuckets->GetHistogramBucket<true>();
-      for(size_t i = 0; i < cTotalBuckets; ++i) {
-         HistogramBucket<true> * const pHistogramBucket =
-            GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBucketsLocal, i);
-         pHistogramBucket->Zero(cVectorLength);
-      }
-
       HistogramBucketVectorEntry<true> * const aSumHistogramBucketVectorEntryLocal = aSumHistogramBucketVectorEntry->GetHistogramBucketVectorEntry<true>();
       for(size_t i = 0; i < cVectorLength; ++i) {
          aSumHistogramBucketVectorEntryLocal[i].Zero();
       }
    } else {
-      HistogramBucket<false> * const aHistogramBucketsLocal = aHistogramBuckets->GetHistogramBucket<false>();
-      for(size_t i = 0; i < cTotalBuckets; ++i) {
-         HistogramBucket<false> * const pHistogramBucket =
-            GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBucketsLocal, i);
-         pHistogramBucket->Zero(cVectorLength);
-      }
-
       HistogramBucketVectorEntry<false> * const aSumHistogramBucketVectorEntryLocal = aSumHistogramBucketVectorEntry->GetHistogramBucketVectorEntry<false>();
       for(size_t i = 0; i < cVectorLength; ++i) {
          aSumHistogramBucketVectorEntryLocal[i].Zero();
       }
    }
 
-#ifndef NDEBUG
-   const unsigned char * const aHistogramBucketsEndDebug = reinterpret_cast<unsigned char *>(aHistogramBuckets) + cBytesBuffer;
-#endif // NDEBUG
-
-   BinBoosting(
-      pBooster,
-      pFeatureGroup,
-      pTrainingSet,
-      aHistogramBuckets
-#ifndef NDEBUG
-      , aHistogramBucketsEndDebug
-#endif // NDEBUG
-   );
-
    size_t cHistogramBuckets = pFeatureGroup->GetFeatureGroupEntries()[0].m_pFeature->GetCountBins();
    // dimensions with 1 bin don't contribute anything since they always have the same value, 
    // so we pre-filter these out and handle them separately
@@ -310,107 +240,41 @@ static bool BoostSingleDimensional(
 static bool BoostMultiDimensional(
    Booster * const pBooster,
    const FeatureGroup * const pFeatureGroup,
-   const SamplingSet * const pTrainingSet,
+   HistogramBucketBase * const aHistogramBuckets,
    const size_t cSamplesRequiredForChildSplitMin,
    SegmentedTensor * const pSmallChangeToModelOverwriteSingleSamplingSet,
    FloatEbmType * const pTotalGain
+#ifndef NDEBUG
+   , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
 ) {
    LOG_0(TraceLevelVerbose, "Entered BoostMultiDimensional");
 
    const size_t cDimensions = pFeatureGroup->GetCountFeatures();
    EBM_ASSERT(2 <= cDimensions);
 
-   size_t cAuxillaryBucketsForBuildFastTotals = 0;
    size_t cTotalBucketsMainSpace = 1;
    for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
       const size_t cBins = pFeatureGroup->GetFeatureGroupEntries()[iDimension].m_pFeature->GetCountBins();
-      // we filer out 1 == cBins in allocation.  If cBins could be 1, then we'd need to check at runtime for overflow of cAuxillaryBucketsForBuildFastTotals
-      EBM_ASSERT(2 <= cBins);
-      // if this wasn't true then we'd have to check IsAddError(cAuxillaryBucketsForBuildFastTotals, cTotalBucketsMainSpace) at runtime
-      EBM_ASSERT(cAuxillaryBucketsForBuildFastTotals < cTotalBucketsMainSpace);
-      // since cBins must be 2 or more, cAuxillaryBucketsForBuildFastTotals must grow slower than cTotalBucketsMainSpace, and we checked at 
-      // allocation that cTotalBucketsMainSpace would not overflow
-      EBM_ASSERT(!IsAddError(cAuxillaryBucketsForBuildFastTotals, cTotalBucketsMainSpace));
-      cAuxillaryBucketsForBuildFastTotals += cTotalBucketsMainSpace;
       // we check for simple multiplication overflow from m_cBins in Booster->Initialize when we unpack featureGroupsFeatureIndexes
       EBM_ASSERT(!IsMultiplyError(cTotalBucketsMainSpace, cBins));
       cTotalBucketsMainSpace *= cBins;
-      // if this wasn't true then we'd have to check IsAddError(cAuxillaryBucketsForBuildFastTotals, cTotalBucketsMainSpace) at runtime
-      EBM_ASSERT(cAuxillaryBucketsForBuildFastTotals < cTotalBucketsMainSpace);
-   }
-   // we need to reserve 4 PAST the pointer we pass into SweepMultiDiemensional!!!!.  We pass in index 20 at max, so we need 24
-   const size_t cAuxillaryBucketsForSplitting = 24;
-   const size_t cAuxillaryBuckets =
-      cAuxillaryBucketsForBuildFastTotals < cAuxillaryBucketsForSplitting ? cAuxillaryBucketsForSplitting : cAuxillaryBucketsForBuildFastTotals;
-   if(IsAddError(cTotalBucketsMainSpace, cAuxillaryBuckets)) {
-      LOG_0(TraceLevelWarning, "WARNING BoostMultiDimensional IsAddError(cTotalBucketsMainSpace, cAuxillaryBuckets)");
-      return true;
    }
-   const size_t cTotalBuckets = cTotalBucketsMainSpace + cAuxillaryBuckets;
 
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
    const bool bClassification = IsClassification(runtimeLearningTypeOrCountTargetClasses);
    const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
-   if(GetHistogramBucketSizeOverflow(bClassification, cVectorLength)) {
-      LOG_0(
-         TraceLevelWarning,
-         "WARNING BoostMultiDimensional GetHistogramBucketSizeOverflow<bClassification>(cVectorLength)"
-      );
-      return true;
-   }
+   // our caller checked this when it allocated the buckets
+   EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength));
    const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
-   if(IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket)) {
-      LOG_0(TraceLevelWarning, "WARNING BoostMultiDimensional IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket)");
-      return true;
-   }
-   const size_t cBytesBuffer = cTotalBuckets * cBytesPerHistogramBucket;
-
-   CachedBoostingThreadResources * const pCachedThreadResources = pBooster->GetCachedThreadResources();
-
-   // we don't need to free this!  It's tracked and reused by pCachedThreadResources
-   HistogramBucketBase * const aHistogramBuckets = pCachedThreadResources->GetThreadByteBuffer1(cBytesBuffer);
-   if(UNLIKELY(nullptr == aHistogramBuckets)) {
-      LOG_0(TraceLevelWarning, "WARNING BoostMultiDimensional nullptr == aHistogramBuckets");
-      return true;
-   }
-
-
-   if(bClassification) {
-      HistogramBucket<true> * const aHistogramBucketsLocal = aHistogramBuckets->GetHistogramBucket<true>();
-      for(size_t i = 0; i < cTotalBuckets; ++i) {
-         HistogramBucket<true> * const pHistogramBucket =
-            GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBucketsLocal, i);
-         pHistogramBucket->Zero(cVectorLength);
-      }
-   } else {
-      HistogramBucket<false> * const aHistogramBucketsLocal = aHistogramBuckets->GetHistogramBucket<false>();
-      for(size_t i = 0; i < cTotalBuckets; ++i) {
-         HistogramBucket<false> * const pHistogramBucket =
-            GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBucketsLocal, i);
-         pHistogramBucket->Zero(cVectorLength);
-      }
-   }
 
+   // the auxiliary buckets were allocated and zeroed after the main space by our caller along with the binned buckets
    HistogramBucketBase * pAuxiliaryBucketZone = GetHistogramBucketByIndex(
       cBytesPerHistogramBucket,
       aHistogramBuckets,
       cTotalBucketsMainSpace
    );
 
-#ifndef NDEBUG
-   const unsigned char * const aHistogramBucketsEndDebug = reinterpret_cast<unsigned char *>(aHistogramBuckets) + cBytesBuffer;
-#endif // NDEBUG
-
-   BinBoosting(
-      pBooster,
-      pFeatureGroup,
-      pTrainingSet,
-      aHistogramBuckets
-#ifndef NDEBUG
-      , aHistogramBucketsEndDebug
-#endif // NDEBUG
-   );
-
 #ifndef NDEBUG
    // make a copy of the original binned buckets for debugging purposes
    size_t cTotalBucketsDebug = 1;
@@ -601,55 +465,152 @@ static bool BoostMultiDimensional(
 static bool BoostRandom(
    Booster * const pBooster,
    const FeatureGroup * const pFeatureGroup,
-   const SamplingSet * const pTrainingSet,
+   HistogramBucketBase * const aHistogramBuckets,
    const GenerateUpdateOptionsType options,
    const IntEbmType * const aLeavesMax,
    SegmentedTensor * const pSmallChangeToModelOverwriteSingleSamplingSet,
    FloatEbmType * const pTotalGain
+#ifndef NDEBUG
+   , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
 ) {
    // THIS RANDOM CUT FUNCTION IS PRIMARILY USED FOR DIFFERENTIAL PRIVACY EBMs
 
    LOG_0(TraceLevelVerbose, "Entered BoostRandom");
 
+   bool bError = CutRandom(
+      pBooster,
+      pFeatureGroup,
+      aHistogramBuckets,
+      options,
+      aLeavesMax,
+      pSmallChangeToModelOverwriteSingleSamplingSet,
+      pTotalGain
+#ifndef NDEBUG
+      , aHistogramBucketsEndDebug
+#endif // NDEBUG
+   );
+   if(bError) {
+      LOG_0(TraceLevelVerbose, "Exited BoostRandom with Error code");
+      return true;
+   }
+
+   // gain can be -infinity for regression in a super-super-super-rare condition.  
+   // See notes above regarding "gain = bestSplittingScore - splittingScoreParent"
+
+   // within a set, no split should make our model worse.  It might in our validation set, but not within the training set
+   EBM_ASSERT(std::isnan(*pTotalGain) || 
+      (!IsClassification(pBooster->GetRuntimeLearningTypeOrCountTargetClasses())) && std::isinf(*pTotalGain) ||
+      k_epsilonNegativeGainAllowed <= *pTotalGain);
+
+   LOG_0(TraceLevelVerbose, "Exited BoostRandom");
+   return false;
+}
+
+// below this many training samples binning an inner bag is cheaper than handing it to another thread
+constexpr size_t k_cSamplesParallelInnerBagsMin = 8192;
+// we keep the binned buckets of all the inner bags in a pass alive at the same time, so limit their total size
+constexpr size_t k_cBytesInnerBagPassMax = size_t { 64 } * size_t { 1024 } * size_t { 1024 };
+
+// the number of histogram buckets that each inner bag is binned into, including the auxiliary buckets that
+// BoostMultiDimensional uses to build totals and to sweep.  Returns 0 on overflow
+static size_t GetCountHistogramBuckets(
+   const FeatureGroup * const pFeatureGroup,
+   const bool bZeroDimensional,
+   const bool bRandom
+) {
+   if(bZeroDimensional) {
+      return 1;
+   }
    const size_t cDimensions = pFeatureGroup->GetCountFeatures();
    EBM_ASSERT(1 <= cDimensions);
 
-   size_t cTotalBuckets = 1;
+   size_t cAuxillaryBucketsForBuildFastTotals = 0;
+   size_t cTotalBucketsMainSpace = 1;
    for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
       const size_t cBins = pFeatureGroup->GetFeatureGroupEntries()[iDimension].m_pFeature->GetCountBins();
-      // we filer out 1 == cBins in allocation.
+      // we filer out 1 == cBins in allocation.  If cBins could be 1, then we'd need to check at runtime for overflow of cAuxillaryBucketsForBuildFastTotals
       EBM_ASSERT(2 <= cBins);
-      // we check for simple multiplication overflow from m_cBins in Booster::Initialize when we unpack featureGroupsFeatureIndexes
-      EBM_ASSERT(!IsMultiplyError(cTotalBuckets, cBins));
-      cTotalBuckets *= cBins;
+      // if this wasn't true then we'd have to check IsAddError(cAuxillaryBucketsForBuildFastTotals, cTotalBucketsMainSpace) at runtime
+      EBM_ASSERT(cAuxillaryBucketsForBuildFastTotals < cTotalBucketsMainSpace);
+      // since cBins must be 2 or more, cAuxillaryBucketsForBuildFastTotals must grow slower than cTotalBucketsMainSpace, and we checked at 
+      // allocation that cTotalBucketsMainSpace would not overflow
+      EBM_ASSERT(!IsAddError(cAuxillaryBucketsForBuildFastTotals, cTotalBucketsMainSpace));
+      cAuxillaryBucketsForBuildFastTotals += cTotalBucketsMainSpace;
+      // we check for simple multiplication overflow from m_cBins in Booster->Initialize when we unpack featureGroupsFeatureIndexes
+      EBM_ASSERT(!IsMultiplyError(cTotalBucketsMainSpace, cBins));
+      cTotalBucketsMainSpace *= cBins;
+      // if this wasn't true then we'd have to check IsAddError(cAuxillaryBucketsForBuildFastTotals, cTotalBucketsMainSpace) at runtime
+      EBM_ASSERT(cAuxillaryBucketsForBuildFastTotals < cTotalBucketsMainSpace);
+   }
+   if(bRandom || 1 == cDimensions) {
+      return cTotalBucketsMainSpace;
    }
 
+   // we need to reserve 4 PAST the pointer we pass into SweepMultiDiemensional!!!!.  We pass in index 20 at max, so we need 24
+   const size_t cAuxillaryBucketsForSplitting = 24;
+   const size_t cAuxillaryBuckets =
+      cAuxillaryBucketsForBuildFastTotals < cAuxillaryBucketsForSplitting ? cAuxillaryBucketsForSplitting : cAuxillaryBucketsForBuildFastTotals;
+   if(IsAddError(cTotalBucketsMainSpace, cAuxillaryBuckets)) {
+      LOG_0(TraceLevelWarning, "WARNING GetCountHistogramBuckets IsAddError(cTotalBucketsMainSpace, cAuxillaryBuckets)");
+      return 0;
+   }
+   return cTotalBucketsMainSpace + cAuxillaryBuckets;
+}
+
+// Binning is the only part of boosting an inner bag that visits the samples, so that's the part we do in parallel.  
+// Growing the trees consumes our RandomStream to break ties, so we grow them afterwards one inner bag at a time in
+// order, which keeps the model update identical to boosting the inner bags serially regardless of the thread count
+static size_t GetCountInnerBagsPerPass(const size_t cSamplingSets, const size_t cSamples, const size_t cBytesBuffer) {
+   EBM_ASSERT(1 <= cSamplingSets);
+   EBM_ASSERT(1 <= cBytesBuffer);
+   if(cSamplingSets <= size_t { 1 } || cSamples < k_cSamplesParallelInnerBagsMin) {
+      return 1;
+   }
+   const size_t cBagsPerPass = EbmMin(GetThreadPoolSize(), cSamplingSets);
+   return EbmMax(size_t { 1 }, EbmMin(cBagsPerPass, k_cBytesInnerBagPassMax / cBytesBuffer));
+}
+
+struct BinSamplingSetsTaskContext {
+
+   BinSamplingSetsTaskContext() = default; // preserve our POD status
+   ~BinSamplingSetsTaskContext() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   Booster * m_pBooster;
+   // nullptr when boosting zero dimensionally
+   const FeatureGroup * m_pFeatureGroup;
+   size_t m_iSamplingSetFirst;
+   size_t m_cTotalBuckets;
+   size_t m_cBytesBuffer;
+   // the number of private m_cBytesBuffer sized buffers that each inner bag bins its sample shards into
+   size_t m_cBinShardBuffers;
+   // m_cBytesBuffer bytes for each of the inner bags in the pass, followed by the shard buffers of each inner bag
+   HistogramBucketBase * m_aHistogramBuckets;
+   HistogramBucketBase * m_aBinShardBuffers;
+};
+static_assert(std::is_standard_layout<BinSamplingSetsTaskContext>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<BinSamplingSetsTaskContext>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<BinSamplingSetsTaskContext>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+static void BinSamplingSetTask(void * const pContext, const size_t iThread, const size_t iTask) {
+   UNUSED(iThread);
+   const BinSamplingSetsTaskContext * const pTaskContext = static_cast<const BinSamplingSetsTaskContext *>(pContext);
+   Booster * const pBooster = pTaskContext->m_pBooster;
+
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
    const bool bClassification = IsClassification(runtimeLearningTypeOrCountTargetClasses);
    const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
-   if(GetHistogramBucketSizeOverflow(bClassification, cVectorLength)) {
-      LOG_0(
-         TraceLevelWarning,
-         "WARNING BoostRandom GetHistogramBucketSizeOverflow<bClassification>(cVectorLength)"
-      );
-      return true;
-   }
    const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
-   if(IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket)) {
-      LOG_0(TraceLevelWarning, "WARNING BoostRandom IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket)");
-      return true;
-   }
-   const size_t cBytesBuffer = cTotalBuckets * cBytesPerHistogramBucket;
 
-   CachedBoostingThreadResources * const pCachedThreadResources = pBooster->GetCachedThreadResources();
-
-   // we don't need to free this!  It's tracked and reused by pCachedThreadResources
-   HistogramBucketBase * const aHistogramBuckets = pCachedThreadResources->GetThreadByteBuffer1(cBytesBuffer);
-   if(UNLIKELY(nullptr == aHistogramBuckets)) {
-      LOG_0(TraceLevelWarning, "WARNING BoostRandom nullptr == aHistogramBuckets");
-      return true;
-   }
+   HistogramBucketBase * const aHistogramBuckets = reinterpret_cast<HistogramBucketBase *>(
+      reinterpret_cast<char *>(pTaskContext->m_aHistogramBuckets) + pTaskContext->m_cBytesBuffer * iTask);
 
+   const size_t cTotalBuckets = pTaskContext->m_cTotalBuckets;
    if(bClassification) {
       HistogramBucket<true> * const aHistogramBucketsLocal = aHistogramBuckets->GetHistogramBucket<true>();
       for(size_t i = 0; i < cTotalBuckets; ++i) {
@@ -666,46 +627,21 @@ static bool BoostRandom(
       }
    }
 
-#ifndef NDEBUG
-   const unsigned char * const aHistogramBucketsEndDebug = reinterpret_cast<unsigned char *>(aHistogramBuckets) + cBytesBuffer;
-#endif // NDEBUG
-
+   // BinBoosting only reads the Booster and the SamplingSet, so any number of inner bags can be binned at once
    BinBoosting(
       pBooster,
-      pFeatureGroup,
-      pTrainingSet,
+      pTaskContext->m_pFeatureGroup,
+      pBooster->GetSamplingSets()[pTaskContext->m_iSamplingSetFirst + iTask],
+      pTaskContext->m_cBinShardBuffers,
+      pTaskContext->m_cBytesBuffer,
+      reinterpret_cast<HistogramBucketBase *>(reinterpret_cast<char *>(pTaskContext->m_aBinShardBuffers) + 
+         pTaskContext->m_cBytesBuffer * pTaskContext->m_cBinShardBuffers * iTask),
       aHistogramBuckets
 #ifndef NDEBUG
-      , aHistogramBucketsEndDebug
-#endif // NDEBUG
-   );
-
-   bool bError = CutRandom(
-      pBooster,
-      pFeatureGroup,
-      aHistogramBuckets,
-      options,
-      aLeavesMax,
-      pSmallChangeToModelOverwriteSingleSamplingSet,
-      pTotalGain
-#ifndef NDEBUG
-      , aHistogramBucketsEndDebug
+      , nullptr == pTaskContext->m_pFeatureGroup ? nullptr : 
+         reinterpret_cast<const unsigned char *>(aHistogramBuckets) + pTaskContext->m_cBytesBuffer
 #endif // NDEBUG
    );
-   if(bError) {
-      LOG_0(TraceLevelVerbose, "Exited BoostRandom with Error code");
-      return true;
-   }
-
-   // gain can be -infinity for regression in a super-super-super-rare condition.  
-   // See notes above regarding "gain = bestSplittingScore - splittingScoreParent"
-
-   // within a set, no split should make our model worse.  It might in our validation set, but not within the training set
-   EBM_ASSERT(std::isnan(*pTotalGain) || (!bClassification) && std::isinf(*pTotalGain) ||
-      k_epsilonNegativeGainAllowed <= *pTotalGain);
-
-   LOG_0(TraceLevelVerbose, "Exited BoostRandom");
-   return false;
 }
 
 // a*PredictorScores = logOdds for binary classification
@@ -739,91 +675,171 @@ static FloatEbmType * GenerateModelFeatureGroupUpdateInternal(
    if(nullptr != pBooster->GetSamplingSets()) {
       pBooster->GetSmallChangeToModelOverwriteSingleSamplingSet()->SetCountDimensions(cDimensions);
 
-      for(size_t iSamplingSet = 0; iSamplingSet < cSamplingSetsAfterZero; ++iSamplingSet) {
-         FloatEbmType gain;
-         if(UNLIKELY(UNLIKELY(0 == pFeatureGroup->GetCountFeatures()) || 
-            UNLIKELY(PREDICTABLE(1 == pFeatureGroup->GetCountFeatures()) && 
-            UNLIKELY(UNLIKELY(nullptr == aLeavesMax) || UNLIKELY(*aLeavesMax <= IntEbmType { 1 })))))
-         {
-            // TODO: add a log warning here that we're boosting zero dimensionally for whatever reason
-
-            if(BoostZeroDimensional(
-               pBooster,
-               pBooster->GetSamplingSets()[iSamplingSet],
-               options,
-               pBooster->GetSmallChangeToModelOverwriteSingleSamplingSet()
-            )) {
-               if(LIKELY(nullptr != pGainReturn)) {
-                  *pGainReturn = FloatEbmType { 0 };
-               }
-               return nullptr;
-            }
-            gain = FloatEbmType { 0 };
-         } else if(0 != (GenerateUpdateOptions_RandomSplits & options)) {
-            if(size_t { 1 } != cSamplesRequiredForChildSplitMin) {
-               LOG_0(TraceLevelWarning, 
-                  "WARNING GenerateModelFeatureGroupUpdateInternal cSamplesRequiredForChildSplitMin is ignored when doing random splitting"
+      const bool bZeroDimensional = UNLIKELY(0 == cDimensions) || 
+         UNLIKELY(PREDICTABLE(1 == cDimensions) && UNLIKELY(UNLIKELY(nullptr == aLeavesMax) || UNLIKELY(*aLeavesMax <= IntEbmType { 1 })));
+      const bool bRandom = !bZeroDimensional && 0 != (GenerateUpdateOptions_RandomSplits & options);
+
+      const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+      if(GetHistogramBucketSizeOverflow(bClassification, cVectorLength)) {
+         // TODO : move this to initialization where we execute it only once
+         LOG_0(TraceLevelWarning, "WARNING GenerateModelFeatureGroupUpdateInternal GetHistogramBucketSizeOverflow<bClassification>(cVectorLength)");
+         if(LIKELY(nullptr != pGainReturn)) {
+            *pGainReturn = FloatEbmType { 0 };
+         }
+         return nullptr;
+      }
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+      const size_t cTotalBuckets = GetCountHistogramBuckets(pFeatureGroup, bZeroDimensional, bRandom);
+      if(0 == cTotalBuckets || IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket)) {
+         LOG_0(TraceLevelWarning, "WARNING GenerateModelFeatureGroupUpdateInternal IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket)");
+         if(LIKELY(nullptr != pGainReturn)) {
+            *pGainReturn = FloatEbmType { 0 };
+         }
+         return nullptr;
+      }
+      const size_t cBytesBuffer = cTotalBuckets * cBytesPerHistogramBucket;
+
+      const size_t cBagsPerPass = 
+         GetCountInnerBagsPerPass(cSamplingSetsAfterZero, pBooster->GetTrainingSet()->GetCountSamples(), cBytesBuffer);
+      EBM_ASSERT(!IsMultiplyError(cBagsPerPass, cBytesBuffer)); // cBagsPerPass is 1 unless we fit in k_cBytesInnerBagPassMax
+
+      // The samples are split into a fixed number of shards that are binned separately and merged in order so that the 
+      // sums don't depend on the thread count.  The threads that aren't busy with other inner bags bin the shards of 
+      // an inner bag in parallel, one private buffer each, but we need at least one buffer to keep the same sums
+      const size_t cBinShards = bZeroDimensional ? size_t { 1 } : 
+         GetCountBinShards(pFeatureGroup, pBooster->GetTrainingSet()->GetCountSamples());
+      const size_t cBinShardBuffers = size_t { 1 } == cBinShards ? size_t { 0 } :
+         EbmMin(cBinShards - size_t { 1 }, EbmMax(size_t { 1 }, GetThreadPoolSize() / cBagsPerPass));
+      if(IsMultiplyError(cBagsPerPass * cBytesBuffer, size_t { 1 } + cBinShardBuffers)) {
+         LOG_0(TraceLevelWarning, "WARNING GenerateModelFeatureGroupUpdateInternal IsMultiplyError(cBagsPerPass * cBytesBuffer, size_t { 1 } + cBinShardBuffers)");
+         if(LIKELY(nullptr != pGainReturn)) {
+            *pGainReturn = FloatEbmType { 0 };
+         }
+         return nullptr;
+      }
+
+      // we don't need to free this!  It's tracked and reused by pCachedThreadResources
+      HistogramBucketBase * const aHistogramBucketsPass = pBooster->GetCachedThreadResources()->GetThreadByteBuffer1(
+         cBagsPerPass * cBytesBuffer * (size_t { 1 } + cBinShardBuffers));
+      if(UNLIKELY(nullptr == aHistogramBucketsPass)) {
+         LOG_0(TraceLevelWarning, "WARNING GenerateModelFeatureGroupUpdateInternal nullptr == aHistogramBucketsPass");
+         if(LIKELY(nullptr != pGainReturn)) {
+            *pGainReturn = FloatEbmType { 0 };
+         }
+         return nullptr;
+      }
+
+      BinSamplingSetsTaskContext taskContext;
+      taskContext.m_pBooster = pBooster;
+      taskContext.m_pFeatureGroup = bZeroDimensional ? nullptr : pFeatureGroup;
+      taskContext.m_cTotalBuckets = cTotalBuckets;
+      taskContext.m_cBytesBuffer = cBytesBuffer;
+      taskContext.m_cBinShardBuffers = cBinShardBuffers;
+      taskContext.m_aHistogramBuckets = aHistogramBucketsPass;
+      taskContext.m_aBinShardBuffers = reinterpret_cast<HistogramBucketBase *>(
+         reinterpret_cast<char *>(aHistogramBucketsPass) + cBagsPerPass * cBytesBuffer);
+
+      size_t iSamplingSetFirst = 0;
+      do {
+         const size_t cBagsThisPass = EbmMin(cBagsPerPass, cSamplingSetsAfterZero - iSamplingSetFirst);
+         taskContext.m_iSamplingSetFirst = iSamplingSetFirst;
+         RunParallelTasks(cBagsThisPass, cBagsThisPass, BinSamplingSetTask, &taskContext);
+
+         for(size_t iBagInPass = 0; iBagInPass < cBagsThisPass; ++iBagInPass) {
+            const size_t iSamplingSet = iSamplingSetFirst + iBagInPass;
+            HistogramBucketBase * const aHistogramBuckets = reinterpret_cast<HistogramBucketBase *>(
+               reinterpret_cast<char *>(aHistogramBucketsPass) + cBytesBuffer * iBagInPass);
+#ifndef NDEBUG
+            const unsigned char * const aHistogramBucketsEndDebug = reinterpret_cast<unsigned char *>(aHistogramBuckets) + cBytesBuffer;
+#endif // NDEBUG
+
+            FloatEbmType gain;
+            if(bZeroDimensional) {
+               // TODO: add a log warning here that we're boosting zero dimensionally for whatever reason
+
+               BoostZeroDimensional(
+                  pBooster,
+                  aHistogramBuckets,
+                  options,
+                  pBooster->GetSmallChangeToModelOverwriteSingleSamplingSet()
                );
-            }
-            // THIS RANDOM CUT OPTION IS PRIMARILY USED FOR DIFFERENTIAL PRIVACY EBMs
-            if(BoostRandom(
-               pBooster,
-               pFeatureGroup,
-               pBooster->GetSamplingSets()[iSamplingSet],
-               options,
-               aLeavesMax, 
-               pBooster->GetSmallChangeToModelOverwriteSingleSamplingSet(),
-               &gain
-            )) {
-               if(LIKELY(nullptr != pGainReturn)) {
-                  *pGainReturn = FloatEbmType { 0 };
+               gain = FloatEbmType { 0 };
+            } else if(bRandom) {
+               if(size_t { 1 } != cSamplesRequiredForChildSplitMin) {
+                  LOG_0(TraceLevelWarning, 
+                     "WARNING GenerateModelFeatureGroupUpdateInternal cSamplesRequiredForChildSplitMin is ignored when doing random splitting"
+                  );
                }
-               return nullptr;
-            }
-         } else if(1 == pFeatureGroup->GetCountFeatures()) {
-            EBM_ASSERT(nullptr != aLeavesMax); // otherwise we'd use BoostZeroDimensional above
-            if(BoostSingleDimensional(
-               pBooster,
-               pFeatureGroup,
-               pBooster->GetSamplingSets()[iSamplingSet],
-               cSamplesRequiredForChildSplitMin,
-               *aLeavesMax,
-               pBooster->GetSmallChangeToModelOverwriteSingleSamplingSet(),
-               &gain
-            )) {
-               if(LIKELY(nullptr != pGainReturn)) {
-                  *pGainReturn = FloatEbmType { 0 };
+               // THIS RANDOM CUT OPTION IS PRIMARILY USED FOR DIFFERENTIAL PRIVACY EBMs
+               if(BoostRandom(
+                  pBooster,
+                  pFeatureGroup,
+                  aHistogramBuckets,
+                  options,
+                  aLeavesMax, 
+                  pBooster->GetSmallChangeToModelOverwriteSingleSamplingSet(),
+                  &gain
+#ifndef NDEBUG
+                  , aHistogramBucketsEndDebug
+#endif // NDEBUG
+               )) {
+                  if(LIKELY(nullptr != pGainReturn)) {
+                     *pGainReturn = FloatEbmType { 0 };
+                  }
+                  return nullptr;
+               }
+            } else if(1 == cDimensions) {
+               EBM_ASSERT(nullptr != aLeavesMax); // otherwise we'd use BoostZeroDimensional above
+               if(BoostSingleDimensional(
+                  pBooster,
+                  pFeatureGroup,
+                  pBooster->GetSamplingSets()[iSamplingSet],
+                  aHistogramBuckets,
+                  cSamplesRequiredForChildSplitMin,
+                  *aLeavesMax,
+                  pBooster->GetSmallChangeToModelOverwriteSingleSamplingSet(),
+                  &gain
+#ifndef NDEBUG
+                  , aHistogramBucketsEndDebug
+#endif // NDEBUG
+               )) {
+                  if(LIKELY(nullptr != pGainReturn)) {
+                     *pGainReturn = FloatEbmType { 0 };
+                  }
+                  return nullptr;
+               }
+            } else {
+               if(BoostMultiDimensional(
+                  pBooster,
+                  pFeatureGroup,
+                  aHistogramBuckets,
+                  cSamplesRequiredForChildSplitMin,
+                  pBooster->GetSmallChangeToModelOverwriteSingleSamplingSet(),
+                  &gain
+#ifndef NDEBUG
+                  , aHistogramBucketsEndDebug
+#endif // NDEBUG
+               )) {
+                  if(LIKELY(nullptr != pGainReturn)) {
+                     *pGainReturn = FloatEbmType { 0 };
+                  }
+                  return nullptr;
                }
-               return nullptr;
             }
-         } else {
-            if(BoostMultiDimensional(
-               pBooster,
-               pFeatureGroup,
-               pBooster->GetSamplingSets()[iSamplingSet],
-               cSamplesRequiredForChildSplitMin,
-               pBooster->GetSmallChangeToModelOverwriteSingleSamplingSet(),
-               &gain
-            )) {
+            // regression can be -infinity or slightly negative in extremely rare circumstances.  
+            // See ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint for details, and the equivalent interaction function
+            EBM_ASSERT(std::isnan(gain) || (!bClassification) && std::isinf(gain) || k_epsilonNegativeGainAllowed <= gain); // we previously normalized to 0
+            totalGain += gain;
+            // the inner bags are accumulated in order so that the floating point result doesn't depend on the thread count
+            if(pBooster->GetSmallChangeToModelAccumulatedFromSamplingSets()->Add(*pBooster->GetSmallChangeToModelOverwriteSingleSamplingSet())) {
                if(LIKELY(nullptr != pGainReturn)) {
                   *pGainReturn = FloatEbmType { 0 };
                }
                return nullptr;
             }
          }
-         // regression can be -infinity or slightly negative in extremely rare circumstances.  
-         // See ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint for details, and the equivalent interaction function
-         EBM_ASSERT(std::isnan(gain) || (!bClassification) && std::isinf(gain) || k_epsilonNegativeGainAllowed <= gain); // we previously normalized to 0
-         totalGain += gain;
-         // TODO : when we thread this code, let's have each thread take a lock and update the combined line segment.  They'll each do it while the 
-         // others are working, so there should be no blocking and our final result won't require adding by the main thread
-         if(pBooster->GetSmallChangeToModelAccumulatedFromSamplingSets()->Add(*pBooster->GetSmallChangeToModelOverwriteSingleSamplingSet())) {
-            if(LIKELY(nullptr != pGainReturn)) {
-               *pGainReturn = FloatEbmType { 0 };
-            }
-            return nullptr;
-         }
-      }
+         iSamplingSetFirst += cBagsThisPass;
+      } while(cSamplingSetsAfterZero != iSamplingSetFirst);
       totalGain /= static_cast<FloatEbmType>(cSamplingSetsAfterZero);
       // regression can be -infinity or slightly negative in extremely rare circumstances.  
       // See ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint for details, and the equivalent interaction function
@@ -1068,6 +1084,17 @@ EBM_NATIVE_IMPORT_EXPORT_BODY FloatEbmType * EBM_NATIVE_CALLING_CONVENTION Gener
       return nullptr;
    }
 
+   // boosters made together with CreateClassificationBoosters or CreateRegressionBoosters unpack their samples for 
+   // this feature group from the shared data.  Other boosters own their data, so this does nothing for them
+   const FeatureGroup * const pFeatureGroup = pBooster->GetFeatureGroups()[iFeatureGroup];
+   if(pBooster->GetTrainingSet()->GatherView(pFeatureGroup, false)) {
+      if(LIKELY(nullptr != gainOut)) {
+         *gainOut = FloatEbmType { 0 };
+      }
+      LOG_0(TraceLevelWarning, "WARNING GenerateModelFeatureGroupUpdate pBooster->GetTrainingSet()->GatherView");
+      return nullptr;
+   }
+
    FloatEbmType * aModelFeatureGroupUpdateTensor = GenerateModelFeatureGroupUpdateInternal(
       pBooster,
       iFeatureGroup,
@@ -1078,6 +1105,8 @@ EBM_NATIVE_IMPORT_EXPORT_BODY FloatEbmType * EBM_NATIVE_CALLING_CONVENTION Gener
       gainOut
    );
 
+   pBooster->GetTrainingSet()->ReleaseView(pFeatureGroup, false);
+
    if(nullptr != gainOut) {
       EBM_ASSERT(!std::isnan(*gainOut)); // NaNs can happen, but we should have edited those before here
       EBM_ASSERT(!std::isinf(*gainOut)); // infinities can happen, but we should have edited those before here
@@ -0,0 +1,107 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#ifdef _WIN32
+// we don't want to require windows.h in our precompiled header since it isn't available in linux builds
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else // _WIN32
+#include <fcntl.h> // open
+#include <unistd.h> // close
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#endif // _WIN32
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+
+const void * MapFileReadOnly(const char * const filePath, size_t * const pcBytesOut) {
+   EBM_ASSERT(nullptr != filePath);
+   EBM_ASSERT(nullptr != pcBytesOut);
+
+   const HANDLE hFile = CreateFileA(
+      filePath, 
+      GENERIC_READ, 
+      FILE_SHARE_READ, 
+      nullptr, 
+      OPEN_EXISTING, 
+      FILE_ATTRIBUTE_NORMAL, 
+      nullptr
+   );
+   if(INVALID_HANDLE_VALUE == hFile) {
+      LOG_0(TraceLevelWarning, "WARNING MapFileReadOnly CreateFileA failed");
+      return nullptr;
+   }
+   LARGE_INTEGER size;
+   if(!GetFileSizeEx(hFile, &size) || size.QuadPart <= 0 || !IsNumberConvertable<size_t>(size.QuadPart)) {
+      LOG_0(TraceLevelWarning, "WARNING MapFileReadOnly the file is empty or its size is unusable");
+      CloseHandle(hFile);
+      return nullptr;
+   }
+   const HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+   // the view keeps the file and the mapping alive, so we don't need the handles after mapping
+   CloseHandle(hFile);
+   if(nullptr == hMapping) {
+      LOG_0(TraceLevelWarning, "WARNING MapFileReadOnly CreateFileMappingA failed");
+      return nullptr;
+   }
+   const void * const pMapped = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+   CloseHandle(hMapping);
+   if(nullptr == pMapped) {
+      LOG_0(TraceLevelWarning, "WARNING MapFileReadOnly MapViewOfFile failed");
+      return nullptr;
+   }
+   *pcBytesOut = static_cast<size_t>(size.QuadPart);
+   return pMapped;
+}
+
+void UnmapFile(const void * const pMapped, const size_t cBytes) {
+   UNUSED(cBytes);
+   UnmapViewOfFile(pMapped);
+}
+
+#else // _WIN32
+
+const void * MapFileReadOnly(const char * const filePath, size_t * const pcBytesOut) {
+   EBM_ASSERT(nullptr != filePath);
+   EBM_ASSERT(nullptr != pcBytesOut);
+
+   const int fd = open(filePath, O_RDONLY);
+   if(fd < 0) {
+      LOG_0(TraceLevelWarning, "WARNING MapFileReadOnly open failed");
+      return nullptr;
+   }
+   struct stat fileStat;
+   if(0 != fstat(fd, &fileStat) || fileStat.st_size <= 0 || !IsNumberConvertable<size_t>(fileStat.st_size)) {
+      LOG_0(TraceLevelWarning, "WARNING MapFileReadOnly the file is empty or its size is unusable");
+      close(fd);
+      return nullptr;
+   }
+   const size_t cBytes = static_cast<size_t>(fileStat.st_size);
+   // MAP_SHARED without write access is what lets the kernel back every process's mapping with the same pages
+   void * const pMapped = mmap(nullptr, cBytes, PROT_READ, MAP_SHARED, fd, 0);
+   // the mapping holds its own reference to the file
+   close(fd);
+   if(MAP_FAILED == pMapped) {
+      LOG_0(TraceLevelWarning, "WARNING MapFileReadOnly mmap failed");
+      return nullptr;
+   }
+   *pcBytesOut = cBytes;
+   return pMapped;
+}
+
+void UnmapFile(const void * const pMapped, const size_t cBytes) {
+   munmap(const_cast<void *>(pMapped), cBytes);
+}
+
+#endif // _WIN32
@@ -0,0 +1,19 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "EbmInternal.h" // INLINE_ALWAYS
+
+// Maps the entire file read only and shared, so every process that maps the same file shares the same physical
+// pages through the OS file cache.  The mapping starts on a page boundary.  Returns nullptr if the file can't be
+// opened or mapped, or if it's empty.
+extern const void * MapFileReadOnly(const char * const filePath, size_t * const pcBytesOut);
+
+extern void UnmapFile(const void * const pMapped, const size_t cBytes);
+
+#endif // MAPPED_FILE_H
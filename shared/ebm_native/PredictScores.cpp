@@ -0,0 +1,144 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+
+#include "Predictor.h"
+
+static IntEbmType PredictScoresInternal(
+   const IntEbmType countTargetClasses,
+   const IntEbmType countFeatures,
+   const IntEbmType * const featuresBinCutCount,
+   const FloatEbmType * const binCutsLowerBoundInclusive,
+   const IntEbmType countFeatureGroups,
+   const IntEbmType * const featureGroupsFeatureCount,
+   const IntEbmType * const featureGroupsFeatureIndexes,
+   const FloatEbmType * const modelFeatureGroupTensors,
+   const FloatEbmType * const intercept,
+   const IntEbmType countThreads,
+   const IntEbmType countSamples,
+   const FloatEbmType * const featureValues,
+   FloatEbmType * const logitsOut
+) {
+   if(!IsNumberConvertable<ptrdiff_t>(countTargetClasses)) {
+      LOG_0(TraceLevelWarning, "WARNING PredictScores !IsNumberConvertable<ptrdiff_t>(countTargetClasses)");
+      return IntEbmType { 1 };
+   }
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses =
+      countTargetClasses < IntEbmType { 0 } ? k_regression : static_cast<ptrdiff_t>(countTargetClasses);
+
+   if(IntEbmType { 0 } == countSamples) {
+      return IntEbmType { 0 };
+   }
+
+   // compiling the Predictor copies the model, which is cheap compared to scoring any meaningful batch, and 
+   // callers that score repeatedly can hold onto a PredictorHandle instead
+   Predictor * const pPredictor = Predictor::Allocate(
+      runtimeLearningTypeOrCountTargetClasses,
+      countFeatures,
+      featuresBinCutCount,
+      binCutsLowerBoundInclusive,
+      countFeatureGroups,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      modelFeatureGroupTensors,
+      intercept,
+      TensorStorage_Float64
+   );
+   if(nullptr == pPredictor) {
+      LOG_0(TraceLevelWarning, "WARNING PredictScores nullptr == pPredictor");
+      return IntEbmType { 1 };
+   }
+   const IntEbmType ret = pPredictor->PredictScores(countThreads, countSamples, featureValues, logitsOut);
+   Predictor::Free(pPredictor);
+   return ret;
+}
+
+// don't bother using a lock here.  We don't care if an extra log message is written out due to thread parallism
+static int g_cLogEnterPredictScoresParametersMessages = 25;
+static int g_cLogExitPredictScoresParametersMessages = 25;
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION PredictScores(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const IntEbmType * featuresBinCutCount,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const IntEbmType * featureGroupsFeatureCount,
+   const IntEbmType * featureGroupsFeatureIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   IntEbmType countThreads,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   FloatEbmType * logitsOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogEnterPredictScoresParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Entered PredictScores: "
+      "countTargetClasses=%" IntEbmTypePrintf ", "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "featuresBinCutCount=%p, "
+      "binCutsLowerBoundInclusive=%p, "
+      "countFeatureGroups=%" IntEbmTypePrintf ", "
+      "featureGroupsFeatureCount=%p, "
+      "featureGroupsFeatureIndexes=%p, "
+      "modelFeatureGroupTensors=%p, "
+      "intercept=%p, "
+      "countThreads=%" IntEbmTypePrintf ", "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "featureValues=%p, "
+      "logitsOut=%p"
+      ,
+      countTargetClasses,
+      countFeatures,
+      static_cast<const void *>(featuresBinCutCount),
+      static_cast<const void *>(binCutsLowerBoundInclusive),
+      countFeatureGroups,
+      static_cast<const void *>(featureGroupsFeatureCount),
+      static_cast<const void *>(featureGroupsFeatureIndexes),
+      static_cast<const void *>(modelFeatureGroupTensors),
+      static_cast<const void *>(intercept),
+      countThreads,
+      countSamples,
+      static_cast<const void *>(featureValues),
+      static_cast<void *>(logitsOut)
+   );
+
+   const IntEbmType ret = PredictScoresInternal(
+      countTargetClasses,
+      countFeatures,
+      featuresBinCutCount,
+      binCutsLowerBoundInclusive,
+      countFeatureGroups,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      modelFeatureGroupTensors,
+      intercept,
+      countThreads,
+      countSamples,
+      featureValues,
+      logitsOut
+   );
+
+   LOG_COUNTED_N(
+      &g_cLogExitPredictScoresParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Exited PredictScores: "
+      "return=%" IntEbmTypePrintf
+      ,
+      ret
+   );
+
+   return ret;
+}
@@ -0,0 +1,1182 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stdlib.h> // malloc, free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memcpy
+#include <inttypes.h> // int16_t
+#include <limits> // numeric_limits
+#include <cmath> // std::exp, std::abs, std::round
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "ApproximateMath.h"
+
+#include "Threading.h"
+#include "DiscretizeEngine.h"
+#include "MappedFile.h"
+#include "Predictor.h"
+
+// We score the samples in blocks.  For each block we discretize every used feature once and then walk all the
+// feature group tensors over the block, so the discretized values stay in L1/L2 instead of streaming the entire
+// dataset through memory once per feature group.
+constexpr size_t k_cSamplesPerPredictBlock = 512;
+// each thread discretizes its blocks into a scratch buffer of about this many items.  Models with more used features 
+// get smaller blocks
+constexpr size_t k_cPredictScratchItems = 4096;
+// blocks are a multiple of this many samples, so the logits of a block cover whole cache lines
+constexpr size_t k_cSamplesPerPredictBlockMultiple = k_cBytesCacheLine / sizeof(FloatEbmType);
+static_assert(0 == k_cSamplesPerPredictBlock % k_cSamplesPerPredictBlockMultiple, 
+   "k_cSamplesPerPredictBlock needs to be a multiple of k_cSamplesPerPredictBlockMultiple");
+// don't start more threads than we can give this many blocks each
+constexpr size_t k_cPredictBlocksPerThreadMin = 4;
+
+void Predictor::Free(Predictor * const pPredictor) {
+   LOG_0(TraceLevelInfo, "Entered Predictor::Free");
+
+   if(nullptr != pPredictor) {
+      if(nullptr != pPredictor->m_pMapped) {
+         UnmapFile(pPredictor->m_pMapped, pPredictor->m_cBytesMapped);
+      }
+      // the Predictor itself lives inside the allocation
+      free(pPredictor->m_pAllocation);
+   }
+
+   LOG_0(TraceLevelInfo, "Exited Predictor::Free");
+}
+
+// copies the tensor into pFeatureGroup's storage, which already points to enough memory, and adds the worst error
+// of any item to *pMaxLogitError.  Returns false if the tensor can't be stored in the requested precision
+static bool StoreTensor(
+   PredictorFeatureGroup * const pFeatureGroup,
+   const TensorStorageType tensorStorage,
+   const size_t cItems,
+   const FloatEbmType * const aFrom,
+   FloatEbmType * const pMaxLogitError
+) {
+   FloatEbmType maxError = FloatEbmType { 0 };
+   if(TensorStorage_Float64 == tensorStorage) {
+      memcpy(const_cast<void *>(pFeatureGroup->m_aTensor), aFrom, sizeof(*aFrom) * cItems);
+   } else if(TensorStorage_Float32 == tensorStorage) {
+      float * const aTo = static_cast<float *>(const_cast<void *>(pFeatureGroup->m_aTensor));
+      for(size_t iItem = 0; iItem < cItems; ++iItem) {
+         const float item = static_cast<float>(aFrom[iItem]);
+         aTo[iItem] = item;
+         maxError = EbmMax(maxError, std::abs(static_cast<FloatEbmType>(item) - aFrom[iItem]));
+      }
+   } else {
+      EBM_ASSERT(TensorStorage_Int16 == tensorStorage);
+      int16_t * const aTo = static_cast<int16_t *>(const_cast<void *>(pFeatureGroup->m_aTensor));
+
+      FloatEbmType itemMin = std::numeric_limits<FloatEbmType>::max();
+      FloatEbmType itemMax = std::numeric_limits<FloatEbmType>::lowest();
+      for(size_t iItem = 0; iItem < cItems; ++iItem) {
+         const FloatEbmType item = aFrom[iItem];
+         if(!std::isfinite(item)) {
+            return false;
+         }
+         itemMin = EbmMin(itemMin, item);
+         itemMax = EbmMax(itemMax, item);
+      }
+      // the range of the tensor is spread evenly over all 65536 int16_t values.  The difference can overflow to
+      // infinity for absurdly large tensors, in which case we can't quantize
+      const FloatEbmType scale = (itemMax - itemMin) / FloatEbmType { 65535 };
+      if(!std::isfinite(scale)) {
+         return false;
+      }
+      const FloatEbmType offset = itemMin + FloatEbmType { 32768 } * scale;
+      pFeatureGroup->m_tensorScale = scale;
+      pFeatureGroup->m_tensorOffset = offset;
+      for(size_t iItem = 0; iItem < cItems; ++iItem) {
+         const FloatEbmType item = aFrom[iItem];
+         FloatEbmType quantized = FloatEbmType { 0 } == scale ? FloatEbmType { 0 } : std::round((item - offset) / scale);
+         quantized = EbmMax(EbmMin(quantized, FloatEbmType { 32767 }), FloatEbmType { -32768 });
+         const int16_t itemQuantized = static_cast<int16_t>(quantized);
+         aTo[iItem] = itemQuantized;
+         // measure the error with the same arithmetic that we use when scoring
+         const FloatEbmType itemRestored = offset + scale * static_cast<FloatEbmType>(itemQuantized);
+         maxError = EbmMax(maxError, std::abs(itemRestored - item));
+      }
+   }
+   *pMaxLogitError += maxError;
+   return true;
+}
+
+Predictor * Predictor::Allocate(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const IntEbmType countFeatures,
+   const IntEbmType * const aFeaturesBinCutCount,
+   const FloatEbmType * const aBinCutsLowerBoundInclusive,
+   const IntEbmType countFeatureGroups,
+   const IntEbmType * const aFeatureGroupsFeatureCount,
+   const IntEbmType * const aFeatureGroupsFeatureIndexes,
+   const FloatEbmType * const aModelFeatureGroupTensors,
+   const FloatEbmType * const aIntercept,
+   const TensorStorageType tensorStorage
+) {
+   LOG_0(TraceLevelInfo, "Entered Predictor::Allocate");
+
+   size_t cBytesPerTensorItem;
+   if(TensorStorage_Float64 == tensorStorage) {
+      cBytesPerTensorItem = sizeof(FloatEbmType);
+   } else if(TensorStorage_Float32 == tensorStorage) {
+      cBytesPerTensorItem = sizeof(float);
+   } else if(TensorStorage_Int16 == tensorStorage) {
+      cBytesPerTensorItem = sizeof(int16_t);
+   } else {
+      LOG_0(TraceLevelError, "ERROR Predictor::Allocate unknown tensorStorage");
+      return nullptr;
+   }
+
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+
+   if(countFeatures < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR Predictor::Allocate countFeatures must be positive");
+      return nullptr;
+   }
+   if(!IsNumberConvertable<size_t>(countFeatures)) {
+      LOG_0(TraceLevelError, "ERROR Predictor::Allocate !IsNumberConvertable<size_t>(countFeatures)");
+      return nullptr;
+   }
+   const size_t cColumns = static_cast<size_t>(countFeatures);
+   if(size_t { 0 } != cColumns && nullptr == aFeaturesBinCutCount) {
+      LOG_0(TraceLevelError, "ERROR Predictor::Allocate aFeaturesBinCutCount cannot be nullptr if 0 < countFeatures");
+      return nullptr;
+   }
+   if(countFeatureGroups < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR Predictor::Allocate countFeatureGroups must be positive");
+      return nullptr;
+   }
+   if(!IsNumberConvertable<size_t>(countFeatureGroups)) {
+      LOG_0(TraceLevelError, "ERROR Predictor::Allocate !IsNumberConvertable<size_t>(countFeatureGroups)");
+      return nullptr;
+   }
+   const size_t cFeatureGroups = static_cast<size_t>(countFeatureGroups);
+   if(size_t { 0 } != cFeatureGroups) {
+      if(nullptr == aFeatureGroupsFeatureCount) {
+         LOG_0(TraceLevelError, "ERROR Predictor::Allocate aFeatureGroupsFeatureCount cannot be nullptr if 0 < countFeatureGroups");
+         return nullptr;
+      }
+      if(nullptr == aModelFeatureGroupTensors) {
+         LOG_0(TraceLevelError, "ERROR Predictor::Allocate aModelFeatureGroupTensors cannot be nullptr if 0 < countFeatureGroups");
+         return nullptr;
+      }
+   }
+
+   size_t cBinCutsAll = 0;
+   for(size_t iColumn = 0; iColumn < cColumns; ++iColumn) {
+      const IntEbmType countBinCuts = aFeaturesBinCutCount[iColumn];
+      if(countBinCuts < IntEbmType { 0 }) {
+         LOG_0(TraceLevelError, "ERROR Predictor::Allocate aFeaturesBinCutCount cannot contain negative values");
+         return nullptr;
+      }
+      if(!IsNumberConvertable<size_t>(countBinCuts)) {
+         LOG_0(TraceLevelError, "ERROR Predictor::Allocate !IsNumberConvertable<size_t>(countBinCuts)");
+         return nullptr;
+      }
+      const size_t cBinCuts = static_cast<size_t>(countBinCuts);
+      // we later add 2 to each cut count to get the number of bins, so reserve that space now
+      if(IsAddError(cBinCuts, size_t { 2 }) || IsAddError(cBinCutsAll, cBinCuts)) {
+         LOG_0(TraceLevelError, "ERROR Predictor::Allocate IsAddError(cBinCutsAll, cBinCuts)");
+         return nullptr;
+      }
+      cBinCutsAll += cBinCuts;
+   }
+   if(size_t { 0 } != cBinCutsAll && nullptr == aBinCutsLowerBoundInclusive) {
+      LOG_0(TraceLevelError, "ERROR Predictor::Allocate aBinCutsLowerBoundInclusive cannot be nullptr if there are cuts");
+      return nullptr;
+   }
+
+   size_t cDimensionsAll = 0;
+   size_t cTensorItemsAll = 0;
+   const IntEbmType * pFeatureIndex = aFeatureGroupsFeatureIndexes;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const IntEbmType countDimensions = aFeatureGroupsFeatureCount[iFeatureGroup];
+      if(countDimensions < IntEbmType { 0 }) {
+         LOG_0(TraceLevelError, "ERROR Predictor::Allocate aFeatureGroupsFeatureCount cannot contain negative values");
+         return nullptr;
+      }
+      if(!IsNumberConvertable<size_t>(countDimensions)) {
+         LOG_0(TraceLevelError, "ERROR Predictor::Allocate !IsNumberConvertable<size_t>(countDimensions)");
+         return nullptr;
+      }
+      const size_t cDimensions = static_cast<size_t>(countDimensions);
+      if(k_cDimensionsMax < cDimensions) {
+         LOG_0(TraceLevelWarning, "WARNING Predictor::Allocate k_cDimensionsMax < cDimensions");
+         return nullptr;
+      }
+      if(size_t { 0 } != cDimensions && nullptr == aFeatureGroupsFeatureIndexes) {
+         LOG_0(TraceLevelError, "ERROR Predictor::Allocate aFeatureGroupsFeatureIndexes cannot be nullptr if the feature groups have features");
+         return nullptr;
+      }
+      if(IsAddError(cDimensionsAll, cDimensions)) {
+         LOG_0(TraceLevelError, "ERROR Predictor::Allocate IsAddError(cDimensionsAll, cDimensions)");
+         return nullptr;
+      }
+      cDimensionsAll += cDimensions;
+
+      size_t cTensorItems = cVectorLength;
+      const IntEbmType * const pFeatureIndexEnd = pFeatureIndex + cDimensions;
+      for(; pFeatureIndexEnd != pFeatureIndex; ++pFeatureIndex) {
+         const IntEbmType indexFeature = *pFeatureIndex;
+         if(indexFeature < IntEbmType { 0 } || countFeatures <= indexFeature) {
+            LOG_0(TraceLevelError, "ERROR Predictor::Allocate aFeatureGroupsFeatureIndexes value must be a valid feature index");
+            return nullptr;
+         }
+         const size_t cBins = static_cast<size_t>(aFeaturesBinCutCount[static_cast<size_t>(indexFeature)]) + size_t { 2 };
+         if(IsMultiplyError(cTensorItems, cBins)) {
+            LOG_0(TraceLevelError, "ERROR Predictor::Allocate IsMultiplyError(cTensorItems, cBins)");
+            return nullptr;
+         }
+         cTensorItems *= cBins;
+      }
+      if(IsAddError(cTensorItemsAll, cTensorItems)) {
+         LOG_0(TraceLevelError, "ERROR Predictor::Allocate IsAddError(cTensorItemsAll, cTensorItems)");
+         return nullptr;
+      }
+      cTensorItemsAll += cTensorItems;
+   }
+
+   // map each caller feature index to the index of our used feature, or k_iNotUsed if no feature group uses it
+   constexpr size_t k_iNotUsed = std::numeric_limits<size_t>::max();
+   size_t * aiPredictorFeatures = nullptr;
+   size_t cFeatures = 0;
+   size_t cBinCutItemsUsed = 0;
+   if(size_t { 0 } != cColumns) {
+      aiPredictorFeatures = EbmMalloc<size_t>(cColumns);
+      if(nullptr == aiPredictorFeatures) {
+         LOG_0(TraceLevelWarning, "WARNING Predictor::Allocate nullptr == aiPredictorFeatures");
+         return nullptr;
+      }
+      for(size_t iColumn = 0; iColumn < cColumns; ++iColumn) {
+         aiPredictorFeatures[iColumn] = k_iNotUsed;
+      }
+      for(size_t iDimension = 0; iDimension < cDimensionsAll; ++iDimension) {
+         const size_t iColumn = static_cast<size_t>(aFeatureGroupsFeatureIndexes[iDimension]);
+         if(k_iNotUsed == aiPredictorFeatures[iColumn]) {
+            aiPredictorFeatures[iColumn] = cFeatures;
+            ++cFeatures;
+            // each engine needs at most 2 * cBinCuts + 2 items, which can exceed the caller's cuts
+            const size_t cBinCutItems = DiscretizeEngine::GetItemCount(static_cast<size_t>(aFeaturesBinCutCount[iColumn]));
+            if(IsAddError(cBinCutItemsUsed, cBinCutItems)) {
+               LOG_0(TraceLevelError, "ERROR Predictor::Allocate IsAddError(cBinCutItemsUsed, cBinCutItems)");
+               free(aiPredictorFeatures);
+               return nullptr;
+            }
+            cBinCutItemsUsed += cBinCutItems;
+         }
+      }
+   }
+
+   // none of these can overflow since the caller's memory already holds larger arrays of the same or larger types,
+   // with the exception of the fixed size sections which are tiny
+   const size_t cBytesPredictor = AlignToCacheLine(sizeof(Predictor));
+   const size_t cBytesFeatures = AlignToCacheLine(sizeof(PredictorFeature) * cFeatures);
+   const size_t cBytesFeatureGroups = AlignToCacheLine(sizeof(PredictorFeatureGroup) * cFeatureGroups);
+   const size_t cBytesDimensions = AlignToCacheLine(sizeof(PredictorDimension) * cDimensionsAll);
+   const size_t cBytesIntercept = AlignToCacheLine(sizeof(FloatEbmType) * cVectorLength);
+   if(IsMultiplyError(sizeof(FloatEbmType), cBinCutItemsUsed) ||
+      IsAddError(sizeof(FloatEbmType) * cBinCutItemsUsed, k_cBytesCacheLine)) 
+   {
+      LOG_0(TraceLevelError, "ERROR Predictor::Allocate cuts too large");
+      free(aiPredictorFeatures);
+      return nullptr;
+   }
+   const size_t cBytesBinCuts = AlignToCacheLine(sizeof(FloatEbmType) * cBinCutItemsUsed);
+   if(IsMultiplyError(cBytesPerTensorItem, cTensorItemsAll) ||
+      IsAddError(cBytesPerTensorItem * cTensorItemsAll, k_cBytesCacheLine))
+   {
+      LOG_0(TraceLevelError, "ERROR Predictor::Allocate tensors too large");
+      free(aiPredictorFeatures);
+      return nullptr;
+   }
+   const size_t cBytesTensors = AlignToCacheLine(cBytesPerTensorItem * cTensorItemsAll);
+
+   size_t cBytesTotal = cBytesPredictor + cBytesFeatures + cBytesFeatureGroups + cBytesDimensions + cBytesIntercept + cBytesBinCuts;
+   if(IsAddError(cBytesTotal, cBytesTensors) || IsAddError(cBytesTotal + cBytesTensors, k_cBytesCacheLine)) {
+      LOG_0(TraceLevelError, "ERROR Predictor::Allocate IsAddError(cBytesTotal, cBytesTensors)");
+      free(aiPredictorFeatures);
+      return nullptr;
+   }
+   cBytesTotal += cBytesTensors;
+
+   // malloc only guarantees alignment for the largest fundamental type, so allocate an extra cache line and
+   // move our start forward to the next cache line boundary
+   void * const pAllocation = EbmMalloc<void>(cBytesTotal + k_cBytesCacheLine);
+   if(nullptr == pAllocation) {
+      LOG_0(TraceLevelWarning, "WARNING Predictor::Allocate nullptr == pAllocation");
+      free(aiPredictorFeatures);
+      return nullptr;
+   }
+   const uintptr_t uStart = reinterpret_cast<uintptr_t>(pAllocation);
+   char * const pStart = static_cast<char *>(pAllocation) +
+      (AlignToCacheLine(static_cast<size_t>(uStart % k_cBytesCacheLine)) - static_cast<size_t>(uStart % k_cBytesCacheLine));
+   EBM_ASSERT(0 == reinterpret_cast<uintptr_t>(pStart) % k_cBytesCacheLine);
+
+   Predictor * const pPredictor = reinterpret_cast<Predictor *>(pStart);
+   pPredictor->InitializeZero();
+   pPredictor->m_pAllocation = pAllocation;
+   pPredictor->m_runtimeLearningTypeOrCountTargetClasses = runtimeLearningTypeOrCountTargetClasses;
+   pPredictor->m_cVectorLength = cVectorLength;
+   pPredictor->m_cColumns = cColumns;
+   pPredictor->m_cFeatures = cFeatures;
+   pPredictor->m_cFeatureGroups = cFeatureGroups;
+   pPredictor->m_tensorStorage = tensorStorage;
+   pPredictor->m_cLogEnterMessages = 1000;
+   pPredictor->m_cLogExitMessages = 1000;
+
+   char * pSection = pStart + cBytesPredictor;
+   PredictorFeature * const aFeatures = reinterpret_cast<PredictorFeature *>(pSection);
+   pSection += cBytesFeatures;
+   PredictorFeatureGroup * const aFeatureGroups = reinterpret_cast<PredictorFeatureGroup *>(pSection);
+   pSection += cBytesFeatureGroups;
+   PredictorDimension * const aDimensions = reinterpret_cast<PredictorDimension *>(pSection);
+   pSection += cBytesDimensions;
+   FloatEbmType * const aInterceptCopy = reinterpret_cast<FloatEbmType *>(pSection);
+   pSection += cBytesIntercept;
+   FloatEbmType * const aBinCutsCopy = reinterpret_cast<FloatEbmType *>(pSection);
+   pSection += cBytesBinCuts;
+   char * const aTensorsCopy = pSection;
+
+   pPredictor->m_aFeatures = aFeatures;
+   pPredictor->m_aFeatureGroups = aFeatureGroups;
+   pPredictor->m_aIntercept = aInterceptCopy;
+
+   for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+      aInterceptCopy[iVector] = nullptr == aIntercept ? FloatEbmType { 0 } : aIntercept[iVector];
+   }
+
+   size_t iBinCutsFrom = 0;
+   FloatEbmType * pBinCutsCopy = aBinCutsCopy;
+   for(size_t iColumn = 0; iColumn < cColumns; ++iColumn) {
+      const size_t cBinCuts = static_cast<size_t>(aFeaturesBinCutCount[iColumn]);
+      const size_t iPredictorFeature = aiPredictorFeatures[iColumn];
+      if(k_iNotUsed != iPredictorFeature) {
+         PredictorFeature * const pFeature = &aFeatures[iPredictorFeature];
+         pFeature->m_iColumn = iColumn;
+         pFeature->m_iBinned = k_iNotBinned;
+         // the search strategy is chosen per feature here based on its number of cuts
+         pFeature->m_engine.Initialize(cBinCuts, aBinCutsLowerBoundInclusive + iBinCutsFrom, pBinCutsCopy);
+         pBinCutsCopy += DiscretizeEngine::GetItemCount(cBinCuts);
+      }
+      iBinCutsFrom += cBinCuts;
+   }
+
+   size_t cBinnedFeatures = 0;
+   PredictorDimension * pDimension = aDimensions;
+   char * pTensor = aTensorsCopy;
+   const FloatEbmType * pTensorFrom = aModelFeatureGroupTensors;
+   FloatEbmType maxLogitError = FloatEbmType { 0 };
+   pFeatureIndex = aFeatureGroupsFeatureIndexes;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const size_t cDimensions = static_cast<size_t>(aFeatureGroupsFeatureCount[iFeatureGroup]);
+      PredictorFeatureGroup * const pFeatureGroup = &aFeatureGroups[iFeatureGroup];
+      pFeatureGroup->m_cDimensions = cDimensions;
+      pFeatureGroup->m_aDimensions = pDimension;
+      pFeatureGroup->m_aTensor = pTensor;
+      pFeatureGroup->m_tensorScale = FloatEbmType { 1 };
+      pFeatureGroup->m_tensorOffset = FloatEbmType { 0 };
+
+      // the first feature in the group varies fastest in the tensor, just like in SegmentedTensor
+      size_t cStride = cVectorLength;
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         const size_t iColumn = static_cast<size_t>(*pFeatureIndex);
+         const size_t iPredictorFeature = aiPredictorFeatures[iColumn];
+         PredictorFeature * const pFeature = &aFeatures[iPredictorFeature];
+         if(size_t { 1 } != cDimensions && k_iNotBinned == pFeature->m_iBinned) {
+            pFeature->m_iBinned = cBinnedFeatures;
+            ++cBinnedFeatures;
+         }
+         pDimension->m_iPredictorFeature = iPredictorFeature;
+         pDimension->m_iBinned = pFeature->m_iBinned;
+         pDimension->m_cStride = cStride;
+         cStride *= static_cast<size_t>(aFeaturesBinCutCount[iColumn]) + size_t { 2 };
+         ++pDimension;
+         ++pFeatureIndex;
+      }
+
+      // every sample gets exactly one item from each feature group, so the worst item error of each group adds up 
+      // to a bound on the error of any logit
+      if(!StoreTensor(pFeatureGroup, tensorStorage, cStride, pTensorFrom, &maxLogitError)) {
+         LOG_0(TraceLevelError, "ERROR Predictor::Allocate tensors must be finite to be quantized");
+         free(pAllocation);
+         free(aiPredictorFeatures);
+         return nullptr;
+      }
+      pTensor += cBytesPerTensorItem * cStride;
+      pTensorFrom += cStride;
+   }
+
+   pPredictor->m_cBinnedFeatures = cBinnedFeatures;
+   pPredictor->m_maxLogitError = maxLogitError;
+
+   free(aiPredictorFeatures);
+
+   LOG_0(TraceLevelInfo, "Exited Predictor::Allocate");
+   return pPredictor;
+}
+
+// When scoring we sum every feature group into the logits, and when explaining we instead write each feature 
+// group's contribution into its own slot.  Everything else, including the fused mains kernel, is shared
+template<bool bExplain>
+INLINE_ALWAYS static void StoreScore(FloatEbmType * const pOut, const FloatEbmType score) {
+   if(bExplain) {
+      *pOut = score;
+   } else {
+      *pOut += score;
+   }
+}
+
+template<typename TStorage>
+INLINE_ALWAYS static FloatEbmType LoadTensorItem(
+   const PredictorFeatureGroup * const pFeatureGroup, 
+   const TStorage * const aTensor, 
+   const size_t iItem
+) {
+   if(std::is_same<TStorage, int16_t>::value) {
+      return pFeatureGroup->m_tensorOffset + pFeatureGroup->m_tensorScale * static_cast<FloatEbmType>(aTensor[iItem]);
+   }
+   // for FloatEbmType this is a no-op, and for float it widens exactly
+   return static_cast<FloatEbmType>(aTensor[iItem]);
+}
+
+template<bool bExplain, typename TStorage>
+void Predictor::PredictBlock(
+   const size_t cSamples,
+   const size_t iSampleStart,
+   const size_t cBlockSamples,
+   const FloatEbmType * const aFeatureValues,
+   size_t * const aBinned,
+   const size_t cOutStride,
+   FloatEbmType * const aOut
+) const {
+   EBM_ASSERT(size_t { 0 } < cBlockSamples);
+   EBM_ASSERT(iSampleStart + cBlockSamples <= cSamples);
+   // explanations are [samples][feature groups][scores], and logits are [samples][scores] but they can be spaced
+   // further apart to leave room for the probabilities of binary classification
+   EBM_ASSERT((bExplain && m_cFeatureGroups * m_cVectorLength == cOutStride) || (!bExplain && m_cVectorLength <= cOutStride));
+
+   const size_t cVectorLength = m_cVectorLength;
+
+   const PredictorFeature * const pFeaturesEnd = m_aFeatures + m_cFeatures;
+   for(const PredictorFeature * pFeature = m_aFeatures; pFeaturesEnd != pFeature; ++pFeature) {
+      const size_t iBinned = pFeature->m_iBinned;
+      if(k_iNotBinned == iBinned) {
+         // only mains use this feature, and they discretize it on the fly below
+         continue;
+      }
+      pFeature->m_engine.DiscretizeMany(
+         cBlockSamples, 
+         aFeatureValues + pFeature->m_iColumn * cSamples + iSampleStart, 
+         aBinned + iBinned * cBlockSamples
+      );
+   }
+
+   FloatEbmType * pLogitsBlock = aOut + iSampleStart * cOutStride;
+
+   FloatEbmType * pLogit = pLogitsBlock;
+   if(!bExplain) {
+      FloatEbmType * const pLogitsBlockEnd = pLogitsBlock + cBlockSamples * cOutStride;
+      do {
+         for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+            pLogit[iVector] = m_aIntercept[iVector];
+         }
+         pLogit += cOutStride;
+      } while(pLogitsBlockEnd != pLogit);
+   }
+
+   const PredictorFeatureGroup * const pFeatureGroupsEnd = m_aFeatureGroups + m_cFeatureGroups;
+   for(const PredictorFeatureGroup * pFeatureGroup = m_aFeatureGroups; pFeatureGroupsEnd != pFeatureGroup; ++pFeatureGroup) {
+      const TStorage * const aTensor = static_cast<const TStorage *>(pFeatureGroup->m_aTensor);
+      const PredictorDimension * const aDimensions = pFeatureGroup->m_aDimensions;
+      const size_t cDimensions = pFeatureGroup->m_cDimensions;
+      const PredictorDimension * const pDimensionsEnd = aDimensions + cDimensions;
+
+      pLogit = pLogitsBlock;
+      if(size_t { 1 } == cDimensions) {
+         // mains are the great majority of terms, so fuse the discretization with the gather and never write or
+         // read back the bin indexes
+         const PredictorFeature * const pFeature = &m_aFeatures[aDimensions->m_iPredictorFeature];
+         const DiscretizeEngine * const pEngine = &pFeature->m_engine;
+         const FloatEbmType * pValue = aFeatureValues + pFeature->m_iColumn * cSamples + iSampleStart;
+         const FloatEbmType * const pValueEnd = pValue + cBlockSamples;
+         if(size_t { 1 } == cVectorLength) {
+            do {
+               StoreScore<bExplain>(pLogit, LoadTensorItem(pFeatureGroup, aTensor, pEngine->DiscretizeValue(*pValue)));
+               pLogit += cOutStride;
+               ++pValue;
+            } while(pValueEnd != pValue);
+         } else {
+            do {
+               const size_t iTensorItem = pEngine->DiscretizeValue(*pValue) * cVectorLength;
+               for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+                  StoreScore<bExplain>(&pLogit[iVector], LoadTensorItem(pFeatureGroup, aTensor, iTensorItem + iVector));
+               }
+               pLogit += cOutStride;
+               ++pValue;
+            } while(pValueEnd != pValue);
+         }
+         if(bExplain) {
+            pLogitsBlock += cVectorLength;
+         }
+         continue;
+      }
+
+      for(size_t iSample = 0; iSample < cBlockSamples; ++iSample) {
+         size_t iTensorItem = 0;
+         for(const PredictorDimension * pDimension = aDimensions; pDimensionsEnd != pDimension; ++pDimension) {
+            EBM_ASSERT(k_iNotBinned != pDimension->m_iBinned);
+            iTensorItem += aBinned[pDimension->m_iBinned * cBlockSamples + iSample] * pDimension->m_cStride;
+         }
+         for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+            StoreScore<bExplain>(&pLogit[iVector], LoadTensorItem(pFeatureGroup, aTensor, iTensorItem + iVector));
+         }
+         pLogit += cOutStride;
+      }
+      if(bExplain) {
+         pLogitsBlock += cVectorLength;
+      }
+   }
+}
+
+// We clamp before the approximations so that they never see NaN or values that would overflow their integer 
+// conversion, which lets us use them without their special case branches.  Without branches the link loops below
+// are simple enough for the compiler to vectorize.
+template<IntEbmType precision>
+INLINE_ALWAYS static FloatEbmType ExpLink(const FloatEbmType val) {
+   static_assert(PredictionPrecision_Exact == precision || PredictionPrecision_Approximate == precision ||
+      PredictionPrecision_Fast == precision, "unknown precision");
+   if(PredictionPrecision_Exact == precision) {
+      return std::exp(val);
+   }
+   const FloatEbmType valClamped = 
+      EbmMax(EbmMin(val, FloatEbmType { k_expOverflowPoint }), FloatEbmType { k_expUnderflowPoint });
+   if(PredictionPrecision_Approximate == precision) {
+      return ExpApproxBest<false, false, false, false>(valClamped);
+   }
+   return ExpApproxSchraudolph<false, false, false, false>(valClamped);
+}
+
+// Converts a block of logits into probabilities in place while they are still in cache.  For binary classification
+// the logit is in the first of the two slots of each sample, and for multiclass each sample has one slot per class
+template<IntEbmType precision>
+static void LinkBinaryBlock(const size_t cVectorLength, const size_t cSamples, FloatEbmType * const aOut) {
+   UNUSED(cVectorLength);
+   EBM_ASSERT(size_t { 1 } == cVectorLength);
+   FloatEbmType * pOut = aOut;
+   const FloatEbmType * const pOutEnd = aOut + cSamples * size_t { 2 };
+   do {
+      const FloatEbmType probability = FloatEbmType { 1 } / (FloatEbmType { 1 } + ExpLink<precision>(-pOut[0]));
+      pOut[0] = FloatEbmType { 1 } - probability;
+      pOut[1] = probability;
+      pOut += size_t { 2 };
+   } while(pOutEnd != pOut);
+}
+
+template<IntEbmType precision>
+static void LinkSoftmaxBlock(const size_t cVectorLength, const size_t cSamples, FloatEbmType * const aOut) {
+   EBM_ASSERT(size_t { 2 } <= cVectorLength);
+   FloatEbmType * pOut = aOut;
+   const FloatEbmType * const pOutEnd = aOut + cSamples * cVectorLength;
+   do {
+      // subtracting the biggest logit keeps every exp in [0, 1], which avoids overflow and keeps the 
+      // approximations within the range where their relative error is bounded
+      FloatEbmType logitMax = pOut[0];
+      for(size_t iVector = 1; iVector < cVectorLength; ++iVector) {
+         logitMax = EbmMax(logitMax, pOut[iVector]);
+      }
+      FloatEbmType sum = FloatEbmType { 0 };
+      for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+         const FloatEbmType odds = ExpLink<precision>(pOut[iVector] - logitMax);
+         pOut[iVector] = odds;
+         sum += odds;
+      }
+      const FloatEbmType sumInverse = FloatEbmType { 1 } / sum;
+      for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+         pOut[iVector] *= sumInverse;
+      }
+      pOut += cVectorLength;
+   } while(pOutEnd != pOut);
+}
+
+class PredictTaskContext final {
+public:
+
+   PredictTaskContext() = default; // preserve our POD status
+   ~PredictTaskContext() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   const Predictor * m_pPredictor;
+   size_t m_cSamples;
+   size_t m_cSamplesPerBlock;
+   const FloatEbmType * m_aFeatureValues;
+   // each thread gets its own slice of m_cBinnedItemsPerThread items.  nullptr if there are no binned features
+   size_t * m_aBinnedThreads;
+   size_t m_cBinnedItemsPerThread;
+   size_t m_cOutStride;
+   // nullptr unless we output probabilities
+   LinkBlockFunction m_pLinkBlockFunction;
+   // either the logits, the probabilities, or the explanations
+   FloatEbmType * m_aOut;
+};
+static_assert(std::is_standard_layout<PredictTaskContext>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<PredictTaskContext>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<PredictTaskContext>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+template<bool bExplain, typename TStorage>
+void Predictor::PredictBlockTask(void * const pContext, const size_t iThread, const size_t iTask) {
+   // each task owns a contiguous range of samples, so no two threads ever write to the same logits.  The logits of
+   // a block span a multiple of the cache line size (see k_cSamplesPerPredictBlockMultiple), so adjacent blocks don't 
+   // share cache lines either as long as the caller's buffer is aligned
+   const PredictTaskContext * const pPredictTaskContext = static_cast<const PredictTaskContext *>(pContext);
+   const Predictor * const pPredictor = pPredictTaskContext->m_pPredictor;
+   const size_t cSamples = pPredictTaskContext->m_cSamples;
+   const size_t cSamplesPerBlock = pPredictTaskContext->m_cSamplesPerBlock;
+
+   const size_t iSampleStart = iTask * cSamplesPerBlock;
+   EBM_ASSERT(iSampleStart < cSamples);
+   const size_t cBlockSamples = EbmMin(cSamples - iSampleStart, cSamplesPerBlock);
+
+   size_t * aBinned = pPredictTaskContext->m_aBinnedThreads;
+   if(nullptr != aBinned) {
+      EBM_ASSERT(cBlockSamples * pPredictor->m_cBinnedFeatures <= pPredictTaskContext->m_cBinnedItemsPerThread);
+      aBinned += iThread * pPredictTaskContext->m_cBinnedItemsPerThread;
+   }
+
+   pPredictor->PredictBlock<bExplain, TStorage>(
+      cSamples, 
+      iSampleStart, 
+      cBlockSamples, 
+      pPredictTaskContext->m_aFeatureValues, 
+      aBinned, 
+      pPredictTaskContext->m_cOutStride,
+      pPredictTaskContext->m_aOut
+   );
+
+   const LinkBlockFunction pLinkBlockFunction = pPredictTaskContext->m_pLinkBlockFunction;
+   if(nullptr != pLinkBlockFunction) {
+      EBM_ASSERT(!bExplain);
+      const size_t cOutStride = pPredictTaskContext->m_cOutStride;
+      (*pLinkBlockFunction)(
+         pPredictor->m_cVectorLength, 
+         cBlockSamples, 
+         pPredictTaskContext->m_aOut + iSampleStart * cOutStride
+      );
+   }
+}
+
+template<bool bExplain>
+IntEbmType Predictor::ScoreBlocks(
+   const IntEbmType countThreads,
+   const IntEbmType countSamples,
+   const FloatEbmType * const featureValues,
+   const size_t cOutPerSample,
+   const LinkBlockFunction pLinkBlockFunction,
+   FloatEbmType * const aOut
+) const {
+   if(countThreads < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR Predictor::ScoreBlocks countThreads must be positive");
+      return IntEbmType { 1 };
+   }
+   if(countSamples < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR Predictor::ScoreBlocks countSamples must be positive");
+      return IntEbmType { 1 };
+   }
+   if(IntEbmType { 0 } == countSamples) {
+      return IntEbmType { 0 };
+   }
+   if(!IsNumberConvertable<size_t>(countSamples)) {
+      LOG_0(TraceLevelError, "ERROR Predictor::ScoreBlocks !IsNumberConvertable<size_t>(countSamples)");
+      return IntEbmType { 1 };
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   if(IsMultiplyError(m_cVectorLength, cSamples)) {
+      LOG_0(TraceLevelError, "ERROR Predictor::ScoreBlocks IsMultiplyError(m_cVectorLength, cSamples)");
+      return IntEbmType { 1 };
+   }
+   if(IsMultiplyError(m_cColumns, cSamples)) {
+      LOG_0(TraceLevelError, "ERROR Predictor::ScoreBlocks IsMultiplyError(m_cColumns, cSamples)");
+      return IntEbmType { 1 };
+   }
+   if(IsMultiplyError(cOutPerSample, cSamples)) {
+      LOG_0(TraceLevelError, "ERROR Predictor::ScoreBlocks IsMultiplyError(cOutPerSample, cSamples)");
+      return IntEbmType { 1 };
+   }
+   if(size_t { 0 } == cOutPerSample) {
+      // explaining a model without feature groups has nothing to write
+      return IntEbmType { 0 };
+   }
+   if(nullptr == aOut) {
+      LOG_0(TraceLevelError, "ERROR Predictor::ScoreBlocks aOut cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   if(size_t { 0 } != m_cFeatures && nullptr == featureValues) {
+      LOG_0(TraceLevelError, "ERROR Predictor::ScoreBlocks featureValues cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+
+   size_t cSamplesPerBlock = k_cSamplesPerPredictBlock;
+   if(size_t { 0 } != m_cBinnedFeatures) {
+      cSamplesPerBlock = EbmMin(cSamplesPerBlock, k_cPredictScratchItems / m_cBinnedFeatures);
+      // very wide models go over k_cPredictScratchItems rather than use blocks smaller than a cache line of logits
+      cSamplesPerBlock = EbmMax(k_cSamplesPerPredictBlockMultiple, 
+         cSamplesPerBlock / k_cSamplesPerPredictBlockMultiple * k_cSamplesPerPredictBlockMultiple);
+   }
+   const size_t cBlocks = (cSamples + cSamplesPerBlock - size_t { 1 }) / cSamplesPerBlock;
+
+   // handing work to another thread costs about as much as scoring a few blocks, so only use as many threads as can 
+   // each get a reasonable number of blocks.  0 == countThreads means use the whole thread pool
+   size_t cThreads = IntEbmType { 0 } == countThreads || !IsNumberConvertable<size_t>(countThreads) ?
+      GetThreadPoolSize() : static_cast<size_t>(countThreads);
+   cThreads = EbmMax(size_t { 1 }, EbmMin(cThreads, cBlocks / k_cPredictBlocksPerThreadMin));
+
+   PredictTaskContext predictTaskContext;
+   predictTaskContext.m_pPredictor = this;
+   predictTaskContext.m_cSamples = cSamples;
+   predictTaskContext.m_cSamplesPerBlock = cSamplesPerBlock;
+   predictTaskContext.m_aFeatureValues = featureValues;
+   predictTaskContext.m_aBinnedThreads = nullptr;
+   predictTaskContext.m_cBinnedItemsPerThread = 0;
+   predictTaskContext.m_cOutStride = cOutPerSample;
+   predictTaskContext.m_pLinkBlockFunction = pLinkBlockFunction;
+   predictTaskContext.m_aOut = aOut;
+
+   void * pBinnedAllocation = nullptr;
+   if(size_t { 0 } != m_cBinnedFeatures) {
+      // one allocation per call holds the scratch of every thread, which is better than a large array on the stack of
+      // each pool thread.  Each slice starts on a cache line boundary, so the threads never share a cache line
+      if(IsMultiplyError(cSamplesPerBlock, m_cBinnedFeatures) || 
+         IsMultiplyError(sizeof(size_t), cSamplesPerBlock * m_cBinnedFeatures) || 
+         IsAddError(sizeof(size_t) * cSamplesPerBlock * m_cBinnedFeatures, k_cBytesCacheLine - size_t { 1 })) {
+         LOG_0(TraceLevelWarning, "WARNING Predictor::ScoreBlocks IsMultiplyError(cSamplesPerBlock, m_cBinnedFeatures)");
+         return IntEbmType { 1 };
+      }
+      const size_t cBytesPerThread = AlignToCacheLine(sizeof(size_t) * cSamplesPerBlock * m_cBinnedFeatures);
+      if(IsMultiplyError(cBytesPerThread, cThreads) || IsAddError(cBytesPerThread * cThreads, k_cBytesCacheLine)) {
+         LOG_0(TraceLevelWarning, "WARNING Predictor::ScoreBlocks IsMultiplyError(cBytesPerThread, cThreads)");
+         return IntEbmType { 1 };
+      }
+      // malloc only guarantees alignment for the largest fundamental type, so allocate an extra cache line and
+      // move our start forward to the next cache line boundary
+      pBinnedAllocation = EbmMalloc<void>(cBytesPerThread * cThreads + k_cBytesCacheLine);
+      if(nullptr == pBinnedAllocation) {
+         LOG_0(TraceLevelWarning, "WARNING Predictor::ScoreBlocks nullptr == pBinnedAllocation");
+         return IntEbmType { 1 };
+      }
+      const uintptr_t uStart = reinterpret_cast<uintptr_t>(pBinnedAllocation);
+      char * const pStart = static_cast<char *>(pBinnedAllocation) +
+         (AlignToCacheLine(static_cast<size_t>(uStart % k_cBytesCacheLine)) - static_cast<size_t>(uStart % k_cBytesCacheLine));
+      EBM_ASSERT(0 == reinterpret_cast<uintptr_t>(pStart) % k_cBytesCacheLine);
+      predictTaskContext.m_aBinnedThreads = reinterpret_cast<size_t *>(pStart);
+      predictTaskContext.m_cBinnedItemsPerThread = cBytesPerThread / sizeof(size_t);
+   }
+
+   ParallelTaskFunction pTaskFunction = &Predictor::PredictBlockTask<bExplain, FloatEbmType>;
+   if(TensorStorage_Float32 == m_tensorStorage) {
+      pTaskFunction = &Predictor::PredictBlockTask<bExplain, float>;
+   } else if(TensorStorage_Int16 == m_tensorStorage) {
+      pTaskFunction = &Predictor::PredictBlockTask<bExplain, int16_t>;
+   }
+   RunParallelTasks(cThreads, cBlocks, pTaskFunction, &predictTaskContext);
+
+   free(pBinnedAllocation);
+   return IntEbmType { 0 };
+}
+
+IntEbmType Predictor::PredictScores(
+   const IntEbmType countThreads,
+   const IntEbmType countSamples,
+   const FloatEbmType * const featureValues,
+   FloatEbmType * const logitsOut
+) const {
+   return ScoreBlocks<false>(countThreads, countSamples, featureValues, m_cVectorLength, nullptr, logitsOut);
+}
+
+IntEbmType Predictor::PredictProbabilities(
+   const IntEbmType countThreads,
+   const IntEbmType countSamples,
+   const FloatEbmType * const featureValues,
+   const PredictionPrecisionType precision,
+   FloatEbmType * const probabilitiesOut
+) const {
+   if(m_runtimeLearningTypeOrCountTargetClasses < ptrdiff_t { 2 }) {
+      // this includes regression, which is negative
+      LOG_0(TraceLevelError, "ERROR Predictor::PredictProbabilities probabilities need at least 2 classes");
+      return IntEbmType { 1 };
+   }
+
+   // binary classification has a single logit, but we return the probability of both classes like other
+   // classifiers do, so leave room for the second one
+   const bool bBinary = size_t { 1 } == m_cVectorLength;
+   LinkBlockFunction pLinkBlockFunction;
+   if(PredictionPrecision_Exact == precision) {
+      pLinkBlockFunction = bBinary ? 
+         &LinkBinaryBlock<PredictionPrecision_Exact> : &LinkSoftmaxBlock<PredictionPrecision_Exact>;
+   } else if(PredictionPrecision_Approximate == precision) {
+      pLinkBlockFunction = bBinary ? 
+         &LinkBinaryBlock<PredictionPrecision_Approximate> : &LinkSoftmaxBlock<PredictionPrecision_Approximate>;
+   } else if(PredictionPrecision_Fast == precision) {
+      pLinkBlockFunction = bBinary ? 
+         &LinkBinaryBlock<PredictionPrecision_Fast> : &LinkSoftmaxBlock<PredictionPrecision_Fast>;
+   } else {
+      LOG_0(TraceLevelError, "ERROR Predictor::PredictProbabilities unknown precision");
+      return IntEbmType { 1 };
+   }
+
+   return ScoreBlocks<false>(
+      countThreads, 
+      countSamples, 
+      featureValues, 
+      bBinary ? size_t { 2 } : m_cVectorLength,
+      pLinkBlockFunction, 
+      probabilitiesOut
+   );
+}
+
+IntEbmType Predictor::ExplainScores(
+   const IntEbmType countThreads,
+   const IntEbmType countSamples,
+   const FloatEbmType * const featureValues,
+   FloatEbmType * const interceptOut,
+   FloatEbmType * const contributionsOut
+) const {
+   if(nullptr != interceptOut) {
+      // the intercept is the same for every sample, so we return it once instead of as an extra column
+      for(size_t iVector = 0; iVector < m_cVectorLength; ++iVector) {
+         interceptOut[iVector] = m_aIntercept[iVector];
+      }
+   }
+   // every feature group has at least m_cVectorLength tensor items, so this multiplication can't overflow
+   return ScoreBlocks<true>(
+      countThreads, 
+      countSamples, 
+      featureValues, 
+      m_cFeatureGroups * m_cVectorLength, 
+      nullptr, 
+      contributionsOut
+   );
+}
+
+static PredictorHandle CreatePredictorInternal(
+   const IntEbmType countTargetClasses,
+   const IntEbmType countFeatures,
+   const IntEbmType * const featuresBinCutCount,
+   const FloatEbmType * const binCutsLowerBoundInclusive,
+   const IntEbmType countFeatureGroups,
+   const IntEbmType * const featureGroupsFeatureCount,
+   const IntEbmType * const featureGroupsFeatureIndexes,
+   const FloatEbmType * const modelFeatureGroupTensors,
+   const FloatEbmType * const intercept,
+   const TensorStorageType tensorStorage
+) {
+   if(!IsNumberConvertable<ptrdiff_t>(countTargetClasses)) {
+      LOG_0(TraceLevelWarning, "WARNING CreatePredictor !IsNumberConvertable<ptrdiff_t>(countTargetClasses)");
+      return nullptr;
+   }
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses =
+      countTargetClasses < IntEbmType { 0 } ? k_regression : static_cast<ptrdiff_t>(countTargetClasses);
+
+   return reinterpret_cast<PredictorHandle>(Predictor::Allocate(
+      runtimeLearningTypeOrCountTargetClasses,
+      countFeatures,
+      featuresBinCutCount,
+      binCutsLowerBoundInclusive,
+      countFeatureGroups,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      modelFeatureGroupTensors,
+      intercept,
+      tensorStorage
+   ));
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY PredictorHandle EBM_NATIVE_CALLING_CONVENTION CreatePredictor(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const IntEbmType * featuresBinCutCount,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const IntEbmType * featureGroupsFeatureCount,
+   const IntEbmType * featureGroupsFeatureIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered CreatePredictor: "
+      "countTargetClasses=%" IntEbmTypePrintf ", "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "featuresBinCutCount=%p, "
+      "binCutsLowerBoundInclusive=%p, "
+      "countFeatureGroups=%" IntEbmTypePrintf ", "
+      "featureGroupsFeatureCount=%p, "
+      "featureGroupsFeatureIndexes=%p, "
+      "modelFeatureGroupTensors=%p, "
+      "intercept=%p"
+      ,
+      countTargetClasses,
+      countFeatures,
+      static_cast<const void *>(featuresBinCutCount),
+      static_cast<const void *>(binCutsLowerBoundInclusive),
+      countFeatureGroups,
+      static_cast<const void *>(featureGroupsFeatureCount),
+      static_cast<const void *>(featureGroupsFeatureIndexes),
+      static_cast<const void *>(modelFeatureGroupTensors),
+      static_cast<const void *>(intercept)
+   );
+   const PredictorHandle predictorHandle = CreatePredictorInternal(
+      countTargetClasses,
+      countFeatures,
+      featuresBinCutCount,
+      binCutsLowerBoundInclusive,
+      countFeatureGroups,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      modelFeatureGroupTensors,
+      intercept,
+      TensorStorage_Float64
+   );
+   LOG_N(TraceLevelInfo, "Exited CreatePredictor %p", static_cast<void *>(predictorHandle));
+   return predictorHandle;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY PredictorHandle EBM_NATIVE_CALLING_CONVENTION CreatePredictorWithStorage(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const IntEbmType * featuresBinCutCount,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const IntEbmType * featureGroupsFeatureCount,
+   const IntEbmType * featureGroupsFeatureIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   TensorStorageType tensorStorage
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered CreatePredictorWithStorage: "
+      "countTargetClasses=%" IntEbmTypePrintf ", "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "featuresBinCutCount=%p, "
+      "binCutsLowerBoundInclusive=%p, "
+      "countFeatureGroups=%" IntEbmTypePrintf ", "
+      "featureGroupsFeatureCount=%p, "
+      "featureGroupsFeatureIndexes=%p, "
+      "modelFeatureGroupTensors=%p, "
+      "intercept=%p, "
+      "tensorStorage=%" TensorStorageTypePrintf
+      ,
+      countTargetClasses,
+      countFeatures,
+      static_cast<const void *>(featuresBinCutCount),
+      static_cast<const void *>(binCutsLowerBoundInclusive),
+      countFeatureGroups,
+      static_cast<const void *>(featureGroupsFeatureCount),
+      static_cast<const void *>(featureGroupsFeatureIndexes),
+      static_cast<const void *>(modelFeatureGroupTensors),
+      static_cast<const void *>(intercept),
+      tensorStorage
+   );
+   const PredictorHandle predictorHandle = CreatePredictorInternal(
+      countTargetClasses,
+      countFeatures,
+      featuresBinCutCount,
+      binCutsLowerBoundInclusive,
+      countFeatureGroups,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      modelFeatureGroupTensors,
+      intercept,
+      tensorStorage
+   );
+   LOG_N(TraceLevelInfo, "Exited CreatePredictorWithStorage %p", static_cast<void *>(predictorHandle));
+   return predictorHandle;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GetPredictorMaxLogitError(
+   PredictorHandle predictorHandle,
+   FloatEbmType * maxLogitErrorOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered GetPredictorMaxLogitError: "
+      "predictorHandle=%p, "
+      "maxLogitErrorOut=%p"
+      ,
+      static_cast<void *>(predictorHandle),
+      static_cast<void *>(maxLogitErrorOut)
+   );
+
+   const Predictor * const pPredictor = reinterpret_cast<const Predictor *>(predictorHandle);
+   if(nullptr == pPredictor) {
+      LOG_0(TraceLevelError, "ERROR GetPredictorMaxLogitError predictorHandle cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   if(nullptr == maxLogitErrorOut) {
+      LOG_0(TraceLevelError, "ERROR GetPredictorMaxLogitError maxLogitErrorOut cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   *maxLogitErrorOut = pPredictor->GetMaxLogitError();
+
+   LOG_0(TraceLevelInfo, "Exited GetPredictorMaxLogitError");
+   return IntEbmType { 0 };
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION PredictScoresWithPredictor(
+   PredictorHandle predictorHandle,
+   IntEbmType countThreads,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   FloatEbmType * logitsOut
+) {
+   Predictor * const pPredictor = reinterpret_cast<Predictor *>(predictorHandle);
+   if(nullptr == pPredictor) {
+      LOG_0(TraceLevelError, "ERROR PredictScoresWithPredictor predictorHandle cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   LOG_COUNTED_N(
+      pPredictor->GetPointerCountLogEnterMessages(),
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Entered PredictScoresWithPredictor: "
+      "predictorHandle=%p, "
+      "countThreads=%" IntEbmTypePrintf ", "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "featureValues=%p, "
+      "logitsOut=%p"
+      ,
+      static_cast<void *>(predictorHandle),
+      countThreads,
+      countSamples,
+      static_cast<const void *>(featureValues),
+      static_cast<void *>(logitsOut)
+   );
+
+   const IntEbmType ret = pPredictor->PredictScores(countThreads, countSamples, featureValues, logitsOut);
+
+   LOG_COUNTED_N(
+      pPredictor->GetPointerCountLogExitMessages(),
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Exited PredictScoresWithPredictor: "
+      "return=%" IntEbmTypePrintf
+      ,
+      ret
+   );
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION PredictProbabilitiesWithPredictor(
+   PredictorHandle predictorHandle,
+   IntEbmType countThreads,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   PredictionPrecisionType precision,
+   FloatEbmType * probabilitiesOut
+) {
+   Predictor * const pPredictor = reinterpret_cast<Predictor *>(predictorHandle);
+   if(nullptr == pPredictor) {
+      LOG_0(TraceLevelError, "ERROR PredictProbabilitiesWithPredictor predictorHandle cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   LOG_COUNTED_N(
+      pPredictor->GetPointerCountLogEnterMessages(),
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Entered PredictProbabilitiesWithPredictor: "
+      "predictorHandle=%p, "
+      "countThreads=%" IntEbmTypePrintf ", "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "featureValues=%p, "
+      "precision=%" PredictionPrecisionTypePrintf ", "
+      "probabilitiesOut=%p"
+      ,
+      static_cast<void *>(predictorHandle),
+      countThreads,
+      countSamples,
+      static_cast<const void *>(featureValues),
+      precision,
+      static_cast<void *>(probabilitiesOut)
+   );
+
+   const IntEbmType ret = pPredictor->PredictProbabilities(countThreads, countSamples, featureValues, precision, probabilitiesOut);
+
+   LOG_COUNTED_N(
+      pPredictor->GetPointerCountLogExitMessages(),
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Exited PredictProbabilitiesWithPredictor: "
+      "return=%" IntEbmTypePrintf
+      ,
+      ret
+   );
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION ExplainScores(
+   PredictorHandle predictorHandle,
+   IntEbmType countThreads,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   FloatEbmType * interceptOut,
+   FloatEbmType * contributionsOut
+) {
+   Predictor * const pPredictor = reinterpret_cast<Predictor *>(predictorHandle);
+   if(nullptr == pPredictor) {
+      LOG_0(TraceLevelError, "ERROR ExplainScores predictorHandle cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   LOG_COUNTED_N(
+      pPredictor->GetPointerCountLogEnterMessages(),
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Entered ExplainScores: "
+      "predictorHandle=%p, "
+      "countThreads=%" IntEbmTypePrintf ", "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "featureValues=%p, "
+      "interceptOut=%p, "
+      "contributionsOut=%p"
+      ,
+      static_cast<void *>(predictorHandle),
+      countThreads,
+      countSamples,
+      static_cast<const void *>(featureValues),
+      static_cast<void *>(interceptOut),
+      static_cast<void *>(contributionsOut)
+   );
+
+   const IntEbmType ret = pPredictor->ExplainScores(countThreads, countSamples, featureValues, interceptOut, contributionsOut);
+
+   LOG_COUNTED_N(
+      pPredictor->GetPointerCountLogExitMessages(),
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Exited ExplainScores: "
+      "return=%" IntEbmTypePrintf
+      ,
+      ret
+   );
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION FreePredictor(
+   PredictorHandle predictorHandle
+) {
+   LOG_N(TraceLevelInfo, "Entered FreePredictor: predictorHandle=%p", static_cast<void *>(predictorHandle));
+
+   Predictor * const pPredictor = reinterpret_cast<Predictor *>(predictorHandle);
+
+   // pPredictor is allowed to be nullptr.  We handle that inside Predictor::Free
+   Predictor::Free(pPredictor);
+
+   LOG_0(TraceLevelInfo, "Exited FreePredictor");
+}
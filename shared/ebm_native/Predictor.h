@@ -0,0 +1,257 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef PREDICTOR_H
+#define PREDICTOR_H
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <limits> // numeric_limits
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "DiscretizeEngine.h"
+
+// The Predictor is compiled once from the cuts and the model tensors and then scored many times without
+// allocating.  Everything it needs is laid out in a single allocation where each section starts on a cache line
+// boundary:
+//   [Predictor][PredictorFeature...][PredictorFeatureGroup...][PredictorDimension...][intercept][cuts...][tensors...]
+// Features that aren't used by any feature group are dropped at compile time, so they are never discretized.
+// Single feature groups (mains) are scored by a fused kernel that discretizes each raw value and gathers its score
+// directly into the logits, so only features used by pairs or higher dimensional groups have their bin indexes
+// written to scratch memory.
+// A Predictor can also be saved to a flat model file (see PredictorFile.cpp).  When loading one, the cuts, intercept
+// and tensors stay in the read only mapping of the file and only the small sections before them are built in memory.
+
+// m_iBinned value for features that are only used by mains and therefore never written to scratch memory
+constexpr size_t k_iNotBinned = std::numeric_limits<size_t>::max();
+
+// 64 bytes is the cache line size on every processor we currently target
+constexpr size_t k_cBytesCacheLine = 64;
+
+INLINE_ALWAYS size_t AlignToCacheLine(const size_t cBytes) {
+   EBM_ASSERT(!IsAddError(cBytes, k_cBytesCacheLine - size_t { 1 }));
+   return (cBytes + (k_cBytesCacheLine - size_t { 1 })) & ~(k_cBytesCacheLine - size_t { 1 });
+}
+
+class PredictorFeature final {
+public:
+
+   PredictorFeature() = default; // preserve our POD status
+   ~PredictorFeature() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   // index of the feature in the caller's featureValues
+   size_t m_iColumn;
+   // slot of this feature in the scratch bin indexes, or k_iNotBinned
+   size_t m_iBinned;
+   DiscretizeEngine m_engine;
+};
+static_assert(std::is_standard_layout<PredictorFeature>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<PredictorFeature>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<PredictorFeature>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+class PredictorDimension final {
+public:
+
+   PredictorDimension() = default; // preserve our POD status
+   ~PredictorDimension() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   // index into the Predictor's own (used only) features, not the caller's feature index
+   size_t m_iPredictorFeature;
+   // copy of PredictorFeature::m_iBinned to avoid the indirection when combining bin indexes
+   size_t m_iBinned;
+   // number of FloatEbmType items to move in the tensor per bin of this dimension, including the vector length
+   size_t m_cStride;
+};
+static_assert(std::is_standard_layout<PredictorDimension>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<PredictorDimension>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<PredictorDimension>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+class PredictorFeatureGroup final {
+public:
+
+   PredictorFeatureGroup() = default; // preserve our POD status
+   ~PredictorFeatureGroup() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   size_t m_cDimensions;
+   const PredictorDimension * m_aDimensions;
+   // FloatEbmType, float or int16_t items depending on the Predictor's TensorStorageType.  int16_t items are 
+   // restored as m_tensorOffset + m_tensorScale * item, and for the other types these are 0 and 1
+   const void * m_aTensor;
+   FloatEbmType m_tensorScale;
+   FloatEbmType m_tensorOffset;
+};
+static_assert(std::is_standard_layout<PredictorFeatureGroup>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<PredictorFeatureGroup>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<PredictorFeatureGroup>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+// converts cSamples samples of logits that are spaced apart by the output stride into probabilities in place
+typedef void (* LinkBlockFunction)(const size_t cVectorLength, const size_t cSamples, FloatEbmType * const aOut);
+
+class Predictor final {
+   // the unaligned pointer that we got from malloc and need to free
+   void * m_pAllocation;
+   // the model file that the cuts, intercept and tensors live in, or nullptr if they live in m_pAllocation
+   const void * m_pMapped;
+   size_t m_cBytesMapped;
+
+   ptrdiff_t m_runtimeLearningTypeOrCountTargetClasses;
+   size_t m_cVectorLength;
+
+   // the number of features in the caller's featureValues, including features we dropped
+   size_t m_cColumns;
+
+   size_t m_cFeatures;
+   const PredictorFeature * m_aFeatures;
+   // number of features with a scratch slot for their bin indexes
+   size_t m_cBinnedFeatures;
+
+   size_t m_cFeatureGroups;
+   const PredictorFeatureGroup * m_aFeatureGroups;
+
+   const FloatEbmType * m_aIntercept;
+
+   TensorStorageType m_tensorStorage;
+   // the sum over feature groups of the largest difference between a stored tensor item and the original
+   FloatEbmType m_maxLogitError;
+
+   int m_cLogEnterMessages;
+   int m_cLogExitMessages;
+
+   template<bool bExplain, typename TStorage>
+   void PredictBlock(
+      const size_t cSamples,
+      const size_t iSampleStart,
+      const size_t cBlockSamples,
+      const FloatEbmType * const aFeatureValues,
+      size_t * const aBinned,
+      const size_t cOutStride,
+      FloatEbmType * const aOut
+   ) const;
+
+   template<bool bExplain, typename TStorage>
+   static void PredictBlockTask(void * const pContext, const size_t iThread, const size_t iTask);
+
+   template<bool bExplain>
+   IntEbmType ScoreBlocks(
+      const IntEbmType countThreads,
+      const IntEbmType countSamples,
+      const FloatEbmType * const featureValues,
+      const size_t cOutPerSample,
+      const LinkBlockFunction pLinkBlockFunction,
+      FloatEbmType * const aOut
+   ) const;
+
+public:
+
+   Predictor() = default; // preserve our POD status
+   ~Predictor() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   INLINE_ALWAYS void InitializeZero() {
+      m_pAllocation = nullptr;
+      m_pMapped = nullptr;
+      m_cBytesMapped = 0;
+
+      m_runtimeLearningTypeOrCountTargetClasses = 0;
+      m_cVectorLength = 0;
+
+      m_cColumns = 0;
+
+      m_cFeatures = 0;
+      m_aFeatures = nullptr;
+      m_cBinnedFeatures = 0;
+
+      m_cFeatureGroups = 0;
+      m_aFeatureGroups = nullptr;
+
+      m_aIntercept = nullptr;
+
+      m_tensorStorage = TensorStorage_Float64;
+      m_maxLogitError = FloatEbmType { 0 };
+
+      m_cLogEnterMessages = 0;
+      m_cLogExitMessages = 0;
+   }
+
+   INLINE_ALWAYS ptrdiff_t GetRuntimeLearningTypeOrCountTargetClasses() const {
+      return m_runtimeLearningTypeOrCountTargetClasses;
+   }
+
+   INLINE_ALWAYS FloatEbmType GetMaxLogitError() const {
+      return m_maxLogitError;
+   }
+
+   INLINE_ALWAYS int * GetPointerCountLogEnterMessages() {
+      return &m_cLogEnterMessages;
+   }
+
+   INLINE_ALWAYS int * GetPointerCountLogExitMessages() {
+      return &m_cLogExitMessages;
+   }
+
+   IntEbmType PredictScores(
+      const IntEbmType countThreads,
+      const IntEbmType countSamples,
+      const FloatEbmType * const featureValues,
+      FloatEbmType * const logitsOut
+   ) const;
+
+   IntEbmType PredictProbabilities(
+      const IntEbmType countThreads,
+      const IntEbmType countSamples,
+      const FloatEbmType * const featureValues,
+      const PredictionPrecisionType precision,
+      FloatEbmType * const probabilitiesOut
+   ) const;
+
+   IntEbmType ExplainScores(
+      const IntEbmType countThreads,
+      const IntEbmType countSamples,
+      const FloatEbmType * const featureValues,
+      FloatEbmType * const interceptOut,
+      FloatEbmType * const contributionsOut
+   ) const;
+
+   IntEbmType SaveFile(const char * const filePath) const;
+
+   static void Free(Predictor * const pPredictor);
+   static Predictor * LoadFile(const char * const filePath);
+   static Predictor * Allocate(
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+      const IntEbmType countFeatures,
+      const IntEbmType * const aFeaturesBinCutCount,
+      const FloatEbmType * const aBinCutsLowerBoundInclusive,
+      const IntEbmType countFeatureGroups,
+      const IntEbmType * const aFeatureGroupsFeatureCount,
+      const IntEbmType * const aFeatureGroupsFeatureIndexes,
+      const FloatEbmType * const aModelFeatureGroupTensors,
+      const FloatEbmType * const aIntercept,
+      const TensorStorageType tensorStorage
+   );
+};
+static_assert(std::is_standard_layout<Predictor>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<Predictor>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<Predictor>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+#endif // PREDICTOR_H
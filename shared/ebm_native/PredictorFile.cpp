@@ -0,0 +1,592 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stdlib.h> // malloc, free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <stdio.h> // fopen, fwrite, fclose
+#include <string.h> // memcpy, memset
+#include <inttypes.h> // int16_t, uint16_t
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+
+#include "DiscretizeEngine.h"
+#include "MappedFile.h"
+#include "Predictor.h"
+
+// A flat model file is a compiled Predictor in a single pointer-free byte array, following the layout proposed at
+// the top of SegmentedTensor.h: the byte count comes first, then an endian tag that reads the same in either byte
+// order, and every reference is a 64-bit offset from the start of the file.  Each section starts on a cache line
+// boundary and files are mapped on page boundaries, so the sections are aligned in place:
+//   [FlatModelHeader][FlatFeature...][FlatFeatureGroup...][FlatDimension...][intercept][cut items...][tensors...]
+// The cut items are stored in the DiscretizeEngine's own layout and the tensors in the file's TensorStorageType,
+// so a loaded Predictor scores directly from the mapping.  Only the feature, feature group and dimension records
+// are rebuilt in memory, and every process that loads the same file shares the pages of the big sections.
+
+// 0x2222222222222222 and 0x3333333333333333 are palindromes, so we can read the tag before knowing the byte order.
+// We score in place, so files written on a host with the other byte order can't be used
+constexpr UIntEbmType k_flatEndianTagLittle = UIntEbmType { 0x2222222222222222 };
+constexpr UIntEbmType k_flatEndianTagBig = UIntEbmType { 0x3333333333333333 };
+// "EBMMODEL" in ASCII
+constexpr UIntEbmType k_flatMagic = UIntEbmType { 0x45424D4D4F44454C };
+constexpr UIntEbmType k_flatVersion = UIntEbmType { 1 };
+
+class FlatModelHeader final {
+public:
+
+   FlatModelHeader() = default; // preserve our POD status
+   ~FlatModelHeader() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   // the size of the entire file, so callers can copy it around without understanding the rest of the format
+   UIntEbmType m_cBytes;
+   UIntEbmType m_endianTag;
+   UIntEbmType m_magic;
+   UIntEbmType m_version;
+
+   // negative for regression
+   IntEbmType m_countTargetClasses;
+   UIntEbmType m_tensorStorage;
+   FloatEbmType m_maxLogitError;
+
+   UIntEbmType m_cColumns;
+   UIntEbmType m_cFeatures;
+   UIntEbmType m_cFeatureGroups;
+   UIntEbmType m_cDimensions;
+
+   // byte offsets of the sections from the start of the file
+   UIntEbmType m_iFeatures;
+   UIntEbmType m_iFeatureGroups;
+   UIntEbmType m_iDimensions;
+   UIntEbmType m_iIntercept;
+   UIntEbmType m_iBinCutItems;
+   UIntEbmType m_iTensors;
+};
+static_assert(std::is_standard_layout<FlatModelHeader>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<FlatModelHeader>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<FlatModelHeader>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+// the cut items of the features are stored back to back in feature order, each taking
+// DiscretizeEngine::GetItemCount(m_cBinCuts) items
+class FlatFeature final {
+public:
+
+   FlatFeature() = default; // preserve our POD status
+   ~FlatFeature() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   UIntEbmType m_iColumn;
+   UIntEbmType m_cBinCuts;
+};
+static_assert(std::is_standard_layout<FlatFeature>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<FlatFeature>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<FlatFeature>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+// the dimensions and tensors of the feature groups are stored back to back in feature group order
+class FlatFeatureGroup final {
+public:
+
+   FlatFeatureGroup() = default; // preserve our POD status
+   ~FlatFeatureGroup() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   UIntEbmType m_cDimensions;
+   FloatEbmType m_tensorScale;
+   FloatEbmType m_tensorOffset;
+};
+static_assert(std::is_standard_layout<FlatFeatureGroup>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<FlatFeatureGroup>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<FlatFeatureGroup>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+class FlatDimension final {
+public:
+
+   FlatDimension() = default; // preserve our POD status
+   ~FlatDimension() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   // index into the file's features
+   UIntEbmType m_iFeature;
+};
+static_assert(std::is_standard_layout<FlatDimension>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<FlatDimension>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<FlatDimension>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+static UIntEbmType GetHostEndianTag() {
+   const uint16_t probe = 1;
+   return 1 == *reinterpret_cast<const unsigned char *>(&probe) ? k_flatEndianTagLittle : k_flatEndianTagBig;
+}
+
+// returns 0 for unknown storage types
+static size_t GetBytesPerTensorItem(const UIntEbmType tensorStorage) {
+   if(static_cast<UIntEbmType>(TensorStorage_Float64) == tensorStorage) {
+      return sizeof(FloatEbmType);
+   } else if(static_cast<UIntEbmType>(TensorStorage_Float32) == tensorStorage) {
+      return sizeof(float);
+   } else if(static_cast<UIntEbmType>(TensorStorage_Int16) == tensorStorage) {
+      return sizeof(int16_t);
+   }
+   return 0;
+}
+
+IntEbmType Predictor::SaveFile(const char * const filePath) const {
+   LOG_0(TraceLevelInfo, "Entered Predictor::SaveFile");
+
+   EBM_ASSERT(nullptr != filePath);
+
+   const size_t cBytesPerTensorItem = GetBytesPerTensorItem(static_cast<UIntEbmType>(m_tensorStorage));
+   EBM_ASSERT(size_t { 0 } != cBytesPerTensorItem);
+
+   size_t cBinCutItems = 0;
+   for(size_t iFeature = 0; iFeature < m_cFeatures; ++iFeature) {
+      cBinCutItems += DiscretizeEngine::GetItemCount(m_aFeatures[iFeature].m_engine.GetCountBinCuts());
+   }
+   size_t cDimensionsAll = 0;
+   size_t cTensorItemsAll = 0;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < m_cFeatureGroups; ++iFeatureGroup) {
+      const PredictorFeatureGroup * const pFeatureGroup = &m_aFeatureGroups[iFeatureGroup];
+      size_t cTensorItems = m_cVectorLength;
+      for(size_t iDimension = 0; iDimension < pFeatureGroup->m_cDimensions; ++iDimension) {
+         const size_t iPredictorFeature = pFeatureGroup->m_aDimensions[iDimension].m_iPredictorFeature;
+         cTensorItems *= m_aFeatures[iPredictorFeature].m_engine.GetCountBinCuts() + size_t { 2 };
+      }
+      cDimensionsAll += pFeatureGroup->m_cDimensions;
+      cTensorItemsAll += cTensorItems;
+   }
+
+   // none of these can overflow since every section is the same size or smaller than its counterpart in our own
+   // allocation, which already fit
+   const size_t cBytesHeader = AlignToCacheLine(sizeof(FlatModelHeader));
+   const size_t cBytesFeatures = AlignToCacheLine(sizeof(FlatFeature) * m_cFeatures);
+   const size_t cBytesFeatureGroups = AlignToCacheLine(sizeof(FlatFeatureGroup) * m_cFeatureGroups);
+   const size_t cBytesDimensions = AlignToCacheLine(sizeof(FlatDimension) * cDimensionsAll);
+   const size_t cBytesIntercept = AlignToCacheLine(sizeof(FloatEbmType) * m_cVectorLength);
+   const size_t cBytesBinCutItems = AlignToCacheLine(sizeof(FloatEbmType) * cBinCutItems);
+   const size_t cBytesTensors = AlignToCacheLine(cBytesPerTensorItem * cTensorItemsAll);
+
+   const size_t iFeatures = cBytesHeader;
+   const size_t iFeatureGroups = iFeatures + cBytesFeatures;
+   const size_t iDimensions = iFeatureGroups + cBytesFeatureGroups;
+   const size_t iIntercept = iDimensions + cBytesDimensions;
+   const size_t iBinCutItems = iIntercept + cBytesIntercept;
+   const size_t iTensors = iBinCutItems + cBytesBinCutItems;
+   const size_t cBytesTotal = iTensors + cBytesTensors;
+
+   char * const pFile = EbmMalloc<char>(cBytesTotal);
+   if(nullptr == pFile) {
+      LOG_0(TraceLevelWarning, "WARNING Predictor::SaveFile nullptr == pFile");
+      return IntEbmType { 1 };
+   }
+   // the padding between sections is part of the file, so don't write whatever was in memory before
+   memset(pFile, 0, cBytesTotal);
+
+   FlatModelHeader * const pHeader = reinterpret_cast<FlatModelHeader *>(pFile);
+   pHeader->m_cBytes = static_cast<UIntEbmType>(cBytesTotal);
+   pHeader->m_endianTag = GetHostEndianTag();
+   pHeader->m_magic = k_flatMagic;
+   pHeader->m_version = k_flatVersion;
+   pHeader->m_countTargetClasses = static_cast<IntEbmType>(m_runtimeLearningTypeOrCountTargetClasses);
+   pHeader->m_tensorStorage = static_cast<UIntEbmType>(m_tensorStorage);
+   pHeader->m_maxLogitError = m_maxLogitError;
+   pHeader->m_cColumns = static_cast<UIntEbmType>(m_cColumns);
+   pHeader->m_cFeatures = static_cast<UIntEbmType>(m_cFeatures);
+   pHeader->m_cFeatureGroups = static_cast<UIntEbmType>(m_cFeatureGroups);
+   pHeader->m_cDimensions = static_cast<UIntEbmType>(cDimensionsAll);
+   pHeader->m_iFeatures = static_cast<UIntEbmType>(iFeatures);
+   pHeader->m_iFeatureGroups = static_cast<UIntEbmType>(iFeatureGroups);
+   pHeader->m_iDimensions = static_cast<UIntEbmType>(iDimensions);
+   pHeader->m_iIntercept = static_cast<UIntEbmType>(iIntercept);
+   pHeader->m_iBinCutItems = static_cast<UIntEbmType>(iBinCutItems);
+   pHeader->m_iTensors = static_cast<UIntEbmType>(iTensors);
+
+   FlatFeature * const aFlatFeatures = reinterpret_cast<FlatFeature *>(pFile + iFeatures);
+   FloatEbmType * pBinCutItems = reinterpret_cast<FloatEbmType *>(pFile + iBinCutItems);
+   for(size_t iFeature = 0; iFeature < m_cFeatures; ++iFeature) {
+      const PredictorFeature * const pFeature = &m_aFeatures[iFeature];
+      const size_t cBinCuts = pFeature->m_engine.GetCountBinCuts();
+      aFlatFeatures[iFeature].m_iColumn = static_cast<UIntEbmType>(pFeature->m_iColumn);
+      aFlatFeatures[iFeature].m_cBinCuts = static_cast<UIntEbmType>(cBinCuts);
+      const size_t cItems = DiscretizeEngine::GetItemCount(cBinCuts);
+      if(size_t { 0 } != cItems) {
+         memcpy(pBinCutItems, pFeature->m_engine.GetItems(), sizeof(*pBinCutItems) * cItems);
+      }
+      pBinCutItems += cItems;
+   }
+
+   FlatFeatureGroup * const aFlatFeatureGroups = reinterpret_cast<FlatFeatureGroup *>(pFile + iFeatureGroups);
+   FlatDimension * pFlatDimension = reinterpret_cast<FlatDimension *>(pFile + iDimensions);
+   char * pTensor = pFile + iTensors;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < m_cFeatureGroups; ++iFeatureGroup) {
+      const PredictorFeatureGroup * const pFeatureGroup = &m_aFeatureGroups[iFeatureGroup];
+      aFlatFeatureGroups[iFeatureGroup].m_cDimensions = static_cast<UIntEbmType>(pFeatureGroup->m_cDimensions);
+      aFlatFeatureGroups[iFeatureGroup].m_tensorScale = pFeatureGroup->m_tensorScale;
+      aFlatFeatureGroups[iFeatureGroup].m_tensorOffset = pFeatureGroup->m_tensorOffset;
+      size_t cTensorItems = m_cVectorLength;
+      for(size_t iDimension = 0; iDimension < pFeatureGroup->m_cDimensions; ++iDimension) {
+         const size_t iPredictorFeature = pFeatureGroup->m_aDimensions[iDimension].m_iPredictorFeature;
+         pFlatDimension->m_iFeature = static_cast<UIntEbmType>(iPredictorFeature);
+         ++pFlatDimension;
+         cTensorItems *= m_aFeatures[iPredictorFeature].m_engine.GetCountBinCuts() + size_t { 2 };
+      }
+      memcpy(pTensor, pFeatureGroup->m_aTensor, cBytesPerTensorItem * cTensorItems);
+      pTensor += cBytesPerTensorItem * cTensorItems;
+   }
+
+   memcpy(pFile + iIntercept, m_aIntercept, sizeof(FloatEbmType) * m_cVectorLength);
+
+   FILE * const pFileHandle = fopen(filePath, "wb");
+   if(nullptr == pFileHandle) {
+      LOG_0(TraceLevelWarning, "WARNING Predictor::SaveFile fopen failed");
+      free(pFile);
+      return IntEbmType { 1 };
+   }
+   const size_t cBytesWritten = fwrite(pFile, 1, cBytesTotal, pFileHandle);
+   const int retClose = fclose(pFileHandle);
+   free(pFile);
+   if(cBytesTotal != cBytesWritten || 0 != retClose) {
+      LOG_0(TraceLevelWarning, "WARNING Predictor::SaveFile writing the file failed");
+      return IntEbmType { 1 };
+   }
+
+   LOG_0(TraceLevelInfo, "Exited Predictor::SaveFile");
+   return IntEbmType { 0 };
+}
+
+// checks that a section of cItems items of cBytesItem bytes each starts on a cache line and fits in the file
+static bool IsSectionValid(
+   const UIntEbmType iSection,
+   const size_t cItems,
+   const size_t cBytesItem,
+   const size_t cBytesFile
+) {
+   if(!IsNumberConvertable<size_t>(iSection)) {
+      return false;
+   }
+   const size_t iSectionBytes = static_cast<size_t>(iSection);
+   if(size_t { 0 } != iSectionBytes % k_cBytesCacheLine || cBytesFile < iSectionBytes) {
+      return false;
+   }
+   if(IsMultiplyError(cItems, cBytesItem)) {
+      return false;
+   }
+   return cItems * cBytesItem <= cBytesFile - iSectionBytes;
+}
+
+// The file can come from anywhere, so before using it we check everything that scoring would otherwise trust: that
+// each section lies inside the file and that every index and tensor size is in range.  After this returns true
+// nothing in the file can make us read outside of it
+static bool IsFlatModelValid(const void * const pMapped, const size_t cBytesFile) {
+   if(cBytesFile < sizeof(FlatModelHeader)) {
+      LOG_0(TraceLevelError, "ERROR IsFlatModelValid the file is too small to be a model file");
+      return false;
+   }
+   const FlatModelHeader * const pHeader = static_cast<const FlatModelHeader *>(pMapped);
+   if(k_flatEndianTagLittle != pHeader->m_endianTag && k_flatEndianTagBig != pHeader->m_endianTag) {
+      LOG_0(TraceLevelError, "ERROR IsFlatModelValid the file is not a model file");
+      return false;
+   }
+   if(GetHostEndianTag() != pHeader->m_endianTag) {
+      LOG_0(TraceLevelError, "ERROR IsFlatModelValid the model file was written on a host with a different byte order");
+      return false;
+   }
+   if(k_flatMagic != pHeader->m_magic) {
+      LOG_0(TraceLevelError, "ERROR IsFlatModelValid the file is not a model file");
+      return false;
+   }
+   if(k_flatVersion != pHeader->m_version) {
+      LOG_0(TraceLevelError, "ERROR IsFlatModelValid unsupported model file version");
+      return false;
+   }
+   if(static_cast<UIntEbmType>(cBytesFile) != pHeader->m_cBytes) {
+      LOG_0(TraceLevelError, "ERROR IsFlatModelValid the model file is truncated or has extra bytes");
+      return false;
+   }
+   if(!IsNumberConvertable<ptrdiff_t>(pHeader->m_countTargetClasses)) {
+      LOG_0(TraceLevelError, "ERROR IsFlatModelValid !IsNumberConvertable<ptrdiff_t>(m_countTargetClasses)");
+      return false;
+   }
+   const size_t cBytesPerTensorItem = GetBytesPerTensorItem(pHeader->m_tensorStorage);
+   if(size_t { 0 } == cBytesPerTensorItem) {
+      LOG_0(TraceLevelError, "ERROR IsFlatModelValid unknown m_tensorStorage");
+      return false;
+   }
+   if(!IsNumberConvertable<size_t>(pHeader->m_cColumns) || !IsNumberConvertable<size_t>(pHeader->m_cFeatures) ||
+      !IsNumberConvertable<size_t>(pHeader->m_cFeatureGroups) || !IsNumberConvertable<size_t>(pHeader->m_cDimensions))
+   {
+      LOG_0(TraceLevelError, "ERROR IsFlatModelValid counts are too large");
+      return false;
+   }
+   const size_t cFeatures = static_cast<size_t>(pHeader->m_cFeatures);
+   const size_t cFeatureGroups = static_cast<size_t>(pHeader->m_cFeatureGroups);
+   const size_t cDimensionsAll = static_cast<size_t>(pHeader->m_cDimensions);
+   const size_t cVectorLength = GetVectorLength(pHeader->m_countTargetClasses < IntEbmType { 0 } ?
+      k_regression : static_cast<ptrdiff_t>(pHeader->m_countTargetClasses));
+
+   if(!IsSectionValid(pHeader->m_iFeatures, cFeatures, sizeof(FlatFeature), cBytesFile) ||
+      !IsSectionValid(pHeader->m_iFeatureGroups, cFeatureGroups, sizeof(FlatFeatureGroup), cBytesFile) ||
+      !IsSectionValid(pHeader->m_iDimensions, cDimensionsAll, sizeof(FlatDimension), cBytesFile) ||
+      !IsSectionValid(pHeader->m_iIntercept, cVectorLength, sizeof(FloatEbmType), cBytesFile))
+   {
+      LOG_0(TraceLevelError, "ERROR IsFlatModelValid a section is outside of the model file");
+      return false;
+   }
+
+   const char * const pFile = static_cast<const char *>(pMapped);
+   const FlatFeature * const aFlatFeatures = reinterpret_cast<const FlatFeature *>(pFile + pHeader->m_iFeatures);
+   size_t cBinCutItems = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const FlatFeature * const pFlatFeature = &aFlatFeatures[iFeature];
+      if(pHeader->m_cColumns <= pFlatFeature->m_iColumn) {
+         LOG_0(TraceLevelError, "ERROR IsFlatModelValid m_iColumn is not a valid column");
+         return false;
+      }
+      // every cut needs at least one item in the file, which also keeps GetItemCount from overflowing
+      if(static_cast<UIntEbmType>(cBytesFile / sizeof(FloatEbmType)) < pFlatFeature->m_cBinCuts) {
+         LOG_0(TraceLevelError, "ERROR IsFlatModelValid m_cBinCuts is too large");
+         return false;
+      }
+      const size_t cItems = DiscretizeEngine::GetItemCount(static_cast<size_t>(pFlatFeature->m_cBinCuts));
+      if(IsAddError(cBinCutItems, cItems)) {
+         LOG_0(TraceLevelError, "ERROR IsFlatModelValid IsAddError(cBinCutItems, cItems)");
+         return false;
+      }
+      cBinCutItems += cItems;
+   }
+   if(!IsSectionValid(pHeader->m_iBinCutItems, cBinCutItems, sizeof(FloatEbmType), cBytesFile)) {
+      LOG_0(TraceLevelError, "ERROR IsFlatModelValid the cuts are outside of the model file");
+      return false;
+   }
+
+   const FlatFeatureGroup * const aFlatFeatureGroups =
+      reinterpret_cast<const FlatFeatureGroup *>(pFile + pHeader->m_iFeatureGroups);
+   const FlatDimension * pFlatDimension = reinterpret_cast<const FlatDimension *>(pFile + pHeader->m_iDimensions);
+   size_t cDimensionsRemaining = cDimensionsAll;
+   size_t cTensorItemsAll = 0;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const UIntEbmType countDimensions = aFlatFeatureGroups[iFeatureGroup].m_cDimensions;
+      if(static_cast<UIntEbmType>(k_cDimensionsMax) < countDimensions ||
+         static_cast<UIntEbmType>(cDimensionsRemaining) < countDimensions)
+      {
+         LOG_0(TraceLevelError, "ERROR IsFlatModelValid m_cDimensions is too large");
+         return false;
+      }
+      const size_t cDimensions = static_cast<size_t>(countDimensions);
+      cDimensionsRemaining -= cDimensions;
+      size_t cTensorItems = cVectorLength;
+      const FlatDimension * const pFlatDimensionEnd = pFlatDimension + cDimensions;
+      for(; pFlatDimensionEnd != pFlatDimension; ++pFlatDimension) {
+         if(static_cast<UIntEbmType>(cFeatures) <= pFlatDimension->m_iFeature) {
+            LOG_0(TraceLevelError, "ERROR IsFlatModelValid m_iFeature is not a valid feature");
+            return false;
+         }
+         // m_cBinCuts was limited above, so adding 2 can't overflow
+         const size_t cBins = static_cast<size_t>(aFlatFeatures[pFlatDimension->m_iFeature].m_cBinCuts) + size_t { 2 };
+         if(IsMultiplyError(cTensorItems, cBins)) {
+            LOG_0(TraceLevelError, "ERROR IsFlatModelValid IsMultiplyError(cTensorItems, cBins)");
+            return false;
+         }
+         cTensorItems *= cBins;
+      }
+      if(IsAddError(cTensorItemsAll, cTensorItems)) {
+         LOG_0(TraceLevelError, "ERROR IsFlatModelValid IsAddError(cTensorItemsAll, cTensorItems)");
+         return false;
+      }
+      cTensorItemsAll += cTensorItems;
+   }
+   if(size_t { 0 } != cDimensionsRemaining) {
+      LOG_0(TraceLevelError, "ERROR IsFlatModelValid m_cDimensions does not match the feature groups");
+      return false;
+   }
+   if(!IsSectionValid(pHeader->m_iTensors, cTensorItemsAll, cBytesPerTensorItem, cBytesFile)) {
+      LOG_0(TraceLevelError, "ERROR IsFlatModelValid the tensors are outside of the model file");
+      return false;
+   }
+   return true;
+}
+
+Predictor * Predictor::LoadFile(const char * const filePath) {
+   LOG_0(TraceLevelInfo, "Entered Predictor::LoadFile");
+
+   EBM_ASSERT(nullptr != filePath);
+
+   size_t cBytesFile;
+   const void * const pMapped = MapFileReadOnly(filePath, &cBytesFile);
+   if(nullptr == pMapped) {
+      LOG_0(TraceLevelWarning, "WARNING Predictor::LoadFile nullptr == pMapped");
+      return nullptr;
+   }
+   // mappings start on a page boundary, which is what makes the sections cache line aligned in place
+   EBM_ASSERT(0 == reinterpret_cast<uintptr_t>(pMapped) % k_cBytesCacheLine);
+   if(!IsFlatModelValid(pMapped, cBytesFile)) {
+      UnmapFile(pMapped, cBytesFile);
+      return nullptr;
+   }
+
+   const char * const pFile = static_cast<const char *>(pMapped);
+   const FlatModelHeader * const pHeader = static_cast<const FlatModelHeader *>(pMapped);
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pHeader->m_countTargetClasses < IntEbmType { 0 } ?
+      k_regression : static_cast<ptrdiff_t>(pHeader->m_countTargetClasses);
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   const TensorStorageType tensorStorage = static_cast<TensorStorageType>(pHeader->m_tensorStorage);
+   const size_t cBytesPerTensorItem = GetBytesPerTensorItem(pHeader->m_tensorStorage);
+   const size_t cFeatures = static_cast<size_t>(pHeader->m_cFeatures);
+   const size_t cFeatureGroups = static_cast<size_t>(pHeader->m_cFeatureGroups);
+   const size_t cDimensionsAll = static_cast<size_t>(pHeader->m_cDimensions);
+
+   // the file holds these same sections with smaller records, so our sizes can't overflow
+   const size_t cBytesPredictor = AlignToCacheLine(sizeof(Predictor));
+   const size_t cBytesFeatures = AlignToCacheLine(sizeof(PredictorFeature) * cFeatures);
+   const size_t cBytesFeatureGroups = AlignToCacheLine(sizeof(PredictorFeatureGroup) * cFeatureGroups);
+   const size_t cBytesDimensions = AlignToCacheLine(sizeof(PredictorDimension) * cDimensionsAll);
+   const size_t cBytesTotal = cBytesPredictor + cBytesFeatures + cBytesFeatureGroups + cBytesDimensions;
+
+   void * const pAllocation = EbmMalloc<void>(cBytesTotal + k_cBytesCacheLine);
+   if(nullptr == pAllocation) {
+      LOG_0(TraceLevelWarning, "WARNING Predictor::LoadFile nullptr == pAllocation");
+      UnmapFile(pMapped, cBytesFile);
+      return nullptr;
+   }
+   const uintptr_t uStart = reinterpret_cast<uintptr_t>(pAllocation);
+   char * const pStart = static_cast<char *>(pAllocation) +
+      (AlignToCacheLine(static_cast<size_t>(uStart % k_cBytesCacheLine)) - static_cast<size_t>(uStart % k_cBytesCacheLine));
+   EBM_ASSERT(0 == reinterpret_cast<uintptr_t>(pStart) % k_cBytesCacheLine);
+
+   Predictor * const pPredictor = reinterpret_cast<Predictor *>(pStart);
+   pPredictor->InitializeZero();
+   pPredictor->m_pAllocation = pAllocation;
+   pPredictor->m_pMapped = pMapped;
+   pPredictor->m_cBytesMapped = cBytesFile;
+   pPredictor->m_runtimeLearningTypeOrCountTargetClasses = runtimeLearningTypeOrCountTargetClasses;
+   pPredictor->m_cVectorLength = cVectorLength;
+   pPredictor->m_cColumns = static_cast<size_t>(pHeader->m_cColumns);
+   pPredictor->m_cFeatures = cFeatures;
+   pPredictor->m_cFeatureGroups = cFeatureGroups;
+   pPredictor->m_tensorStorage = tensorStorage;
+   pPredictor->m_maxLogitError = pHeader->m_maxLogitError;
+   pPredictor->m_aIntercept = reinterpret_cast<const FloatEbmType *>(pFile + pHeader->m_iIntercept);
+   pPredictor->m_cLogEnterMessages = 1000;
+   pPredictor->m_cLogExitMessages = 1000;
+
+   char * pSection = pStart + cBytesPredictor;
+   PredictorFeature * const aFeatures = reinterpret_cast<PredictorFeature *>(pSection);
+   pSection += cBytesFeatures;
+   PredictorFeatureGroup * const aFeatureGroups = reinterpret_cast<PredictorFeatureGroup *>(pSection);
+   pSection += cBytesFeatureGroups;
+   PredictorDimension * const aDimensions = reinterpret_cast<PredictorDimension *>(pSection);
+
+   pPredictor->m_aFeatures = aFeatures;
+   pPredictor->m_aFeatureGroups = aFeatureGroups;
+
+   const FlatFeature * const aFlatFeatures = reinterpret_cast<const FlatFeature *>(pFile + pHeader->m_iFeatures);
+   const FloatEbmType * pBinCutItems = reinterpret_cast<const FloatEbmType *>(pFile + pHeader->m_iBinCutItems);
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const size_t cBinCuts = static_cast<size_t>(aFlatFeatures[iFeature].m_cBinCuts);
+      PredictorFeature * const pFeature = &aFeatures[iFeature];
+      pFeature->m_iColumn = static_cast<size_t>(aFlatFeatures[iFeature].m_iColumn);
+      pFeature->m_iBinned = k_iNotBinned;
+      pFeature->m_engine.InitializeFromItems(cBinCuts, pBinCutItems);
+      pBinCutItems += DiscretizeEngine::GetItemCount(cBinCuts);
+   }
+
+   // the scratch slots aren't stored, so assign them the same way Allocate does
+   const FlatFeatureGroup * const aFlatFeatureGroups =
+      reinterpret_cast<const FlatFeatureGroup *>(pFile + pHeader->m_iFeatureGroups);
+   const FlatDimension * pFlatDimension = reinterpret_cast<const FlatDimension *>(pFile + pHeader->m_iDimensions);
+   size_t cBinnedFeatures = 0;
+   PredictorDimension * pDimension = aDimensions;
+   const char * pTensor = pFile + pHeader->m_iTensors;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const size_t cDimensions = static_cast<size_t>(aFlatFeatureGroups[iFeatureGroup].m_cDimensions);
+      PredictorFeatureGroup * const pFeatureGroup = &aFeatureGroups[iFeatureGroup];
+      pFeatureGroup->m_cDimensions = cDimensions;
+      pFeatureGroup->m_aDimensions = pDimension;
+      pFeatureGroup->m_aTensor = pTensor;
+      pFeatureGroup->m_tensorScale = aFlatFeatureGroups[iFeatureGroup].m_tensorScale;
+      pFeatureGroup->m_tensorOffset = aFlatFeatureGroups[iFeatureGroup].m_tensorOffset;
+
+      size_t cStride = cVectorLength;
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         const size_t iPredictorFeature = static_cast<size_t>(pFlatDimension->m_iFeature);
+         PredictorFeature * const pFeature = &aFeatures[iPredictorFeature];
+         if(size_t { 1 } != cDimensions && k_iNotBinned == pFeature->m_iBinned) {
+            pFeature->m_iBinned = cBinnedFeatures;
+            ++cBinnedFeatures;
+         }
+         pDimension->m_iPredictorFeature = iPredictorFeature;
+         pDimension->m_iBinned = pFeature->m_iBinned;
+         pDimension->m_cStride = cStride;
+         cStride *= pFeature->m_engine.GetCountBinCuts() + size_t { 2 };
+         ++pDimension;
+         ++pFlatDimension;
+      }
+      pTensor += cBytesPerTensorItem * cStride;
+   }
+   pPredictor->m_cBinnedFeatures = cBinnedFeatures;
+
+   LOG_0(TraceLevelInfo, "Exited Predictor::LoadFile");
+   return pPredictor;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION SavePredictorToFile(
+   PredictorHandle predictorHandle,
+   const char * filePath
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered SavePredictorToFile: "
+      "predictorHandle=%p, "
+      "filePath=%p"
+      ,
+      static_cast<void *>(predictorHandle),
+      static_cast<const void *>(filePath)
+   );
+
+   const Predictor * const pPredictor = reinterpret_cast<const Predictor *>(predictorHandle);
+   if(nullptr == pPredictor) {
+      LOG_0(TraceLevelError, "ERROR SavePredictorToFile predictorHandle cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   if(nullptr == filePath) {
+      LOG_0(TraceLevelError, "ERROR SavePredictorToFile filePath cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   const IntEbmType ret = pPredictor->SaveFile(filePath);
+
+   LOG_N(TraceLevelInfo, "Exited SavePredictorToFile %" IntEbmTypePrintf, ret);
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY PredictorHandle EBM_NATIVE_CALLING_CONVENTION CreatePredictorFromFile(
+   const char * filePath
+) {
+   LOG_N(TraceLevelInfo, "Entered CreatePredictorFromFile: filePath=%p", static_cast<const void *>(filePath));
+
+   if(nullptr == filePath) {
+      LOG_0(TraceLevelError, "ERROR CreatePredictorFromFile filePath cannot be nullptr");
+      return nullptr;
+   }
+   const PredictorHandle predictorHandle = reinterpret_cast<PredictorHandle>(Predictor::LoadFile(filePath));
+
+   LOG_N(TraceLevelInfo, "Exited CreatePredictorFromFile %p", static_cast<void *>(predictorHandle));
+   return predictorHandle;
+}
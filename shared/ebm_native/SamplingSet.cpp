@@ -38,6 +38,10 @@ SamplingSet * SamplingSet::GenerateSingleSamplingSet(
       const size_t iCountOccurrences = pRandomStream->Next(cSamples);
       ++aCountOccurrences[iCountOccurrences];
    }
+   bool bZeroCountSamples = false;
+   for(size_t i = 0; i < cSamples; ++i) {
+      bZeroCountSamples |= size_t { 0 } == aCountOccurrences[i];
+   }
 
    SamplingSet * pRet = EbmMalloc<SamplingSet>();
    if(nullptr == pRet) {
@@ -48,6 +52,7 @@ SamplingSet * SamplingSet::GenerateSingleSamplingSet(
 
    pRet->m_pOriginDataSet = pOriginDataSet;
    pRet->m_aCountOccurrences = aCountOccurrences;
+   pRet->m_bZeroCountSamples = bZeroCountSamples;
 
    LOG_0(TraceLevelVerbose, "Exited SamplingSet::GenerateSingleSamplingSet");
    return pRet;
@@ -80,6 +85,7 @@ SamplingSet * SamplingSet::GenerateFlatSamplingSet(const DataSetByFeatureGroup *
 
    pRet->m_pOriginDataSet = pOriginDataSet;
    pRet->m_aCountOccurrences = aCountOccurrences;
+   pRet->m_bZeroCountSamples = false;
 
    LOG_0(TraceLevelInfo, "Exited SamplingSet::GenerateFlatSamplingSet");
    return pRet;
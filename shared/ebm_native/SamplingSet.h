@@ -24,6 +24,8 @@ class SamplingSet final {
    // FractionalType or both, and perf how this changes things.  We don't get a benefit anywhere by storing 
    // the raw data in both formats since it is never converted anyways, but this count is!
    size_t * m_aCountOccurrences;
+   // true if any sample of m_pOriginDataSet has a count of zero, which happens when we draw with replacement
+   bool m_bZeroCountSamples;
 
    // we take owernship of the aCounts array.  We do not take ownership of the pOriginDataSet since many 
    // SamplingSet objects will refer to the original one
@@ -61,6 +63,10 @@ public:
       return m_aCountOccurrences;
    }
 
+   bool HasZeroCountSamples() const {
+      return m_bZeroCountSamples;
+   }
+
    static void FreeSamplingSets(const size_t cSamplingSets, SamplingSet ** const apSamplingSets);
    static SamplingSet ** GenerateSamplingSets(
       RandomStream * const pRandomStream, 
@@ -0,0 +1,326 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <new> // placement new
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+
+#include "Threading.h"
+
+// std::thread needs to be constructed, so we can't keep these in our malloc-ed arrays.  Beyond this many threads
+// we'd be limited by memory bandwidth anyways for everything we currently parallelize
+constexpr size_t k_cThreadsMax = 256;
+
+size_t GetHardwareThreadCount() {
+   // hardware_concurrency is allowed to return 0 if it can't determine the number of threads
+   const unsigned int cHardwareThreads = std::thread::hardware_concurrency();
+   return unsigned { 0 } == cHardwareThreads ? size_t { 1 } : static_cast<size_t>(cHardwareThreads);
+}
+
+// A call to RunParallelTasks posts one of these from its stack.  Any idle worker in the pool can join it and take
+// tasks from it until there are none left, so the work of a large job spreads over the whole pool while jobs posted
+// concurrently by other threads (like separate Boosters, or a nested call from inside a task) share the same workers.
+// The thread that posts a job always works on it too, so a job finishes even if every worker is busy elsewhere.
+struct ParallelJob final {
+   ParallelTaskFunction m_pTaskFunction;
+   void * m_pContext;
+   size_t m_cTasks;
+   size_t m_cThreads;
+   std::atomic<size_t> m_iNextTask;
+
+   // the below are guarded by ThreadPool::m_mutex
+   size_t m_iNextThread;
+   size_t m_cWorkersInside;
+   bool m_bPosted;
+   ParallelJob * m_pPrev;
+   ParallelJob * m_pNext;
+};
+
+class ThreadPool final {
+   std::mutex m_mutex;
+   // signaled when a job is posted or the workers need to exit
+   std::condition_variable m_conditionWork;
+   // signaled when the last worker leaves a job
+   std::condition_variable m_conditionLeft;
+
+   // signaled when StopWorkers has joined every worker
+   std::condition_variable m_conditionStopped;
+
+   // the jobs that can use more threads, oldest first
+   ParallelJob * m_pJobsFirst;
+   ParallelJob * m_pJobsLast;
+
+   // the total number of threads we run on, including the threads that call RunParallelTasks
+   size_t m_cThreads;
+   size_t m_cWorkers;
+   bool m_bExit;
+   // StopWorkers is joining the workers with m_mutex released.  Until it finishes, m_aWorkers[0, m_cWorkers) still
+   // hold joinable threads, so nobody else may start or join workers
+   bool m_bStopping;
+   std::thread m_aWorkers[k_cThreadsMax];
+   // written with m_mutex held when a worker starts and kept until it's joined, so unlike m_aWorkers we can read them
+   // while StopWorkers is joining
+   std::thread::id m_aWorkerIds[k_cThreadsMax];
+
+   void Unpost(ParallelJob * const pJob) {
+      if(pJob->m_bPosted) {
+         pJob->m_bPosted = false;
+         if(nullptr == pJob->m_pPrev) {
+            m_pJobsFirst = pJob->m_pNext;
+         } else {
+            pJob->m_pPrev->m_pNext = pJob->m_pNext;
+         }
+         if(nullptr == pJob->m_pNext) {
+            m_pJobsLast = pJob->m_pPrev;
+         } else {
+            pJob->m_pNext->m_pPrev = pJob->m_pPrev;
+         }
+      }
+   }
+
+   void Worker() {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      while(true) {
+         while(!m_bExit && nullptr == m_pJobsFirst) {
+            m_conditionWork.wait(lock);
+         }
+         if(m_bExit) {
+            return;
+         }
+         ParallelJob * const pJob = m_pJobsFirst;
+         const size_t iThread = pJob->m_iNextThread;
+         ++pJob->m_iNextThread;
+         EBM_ASSERT(iThread < pJob->m_cThreads);
+         if(pJob->m_cThreads == pJob->m_iNextThread) {
+            Unpost(pJob);
+         }
+         ++pJob->m_cWorkersInside;
+         lock.unlock();
+
+         RunTasks(pJob, iThread);
+
+         lock.lock();
+         // there are no tasks left to hand out, so don't let more workers join
+         Unpost(pJob);
+         --pJob->m_cWorkersInside;
+         if(size_t { 0 } == pJob->m_cWorkersInside) {
+            m_conditionLeft.notify_all();
+         }
+      }
+   }
+
+   static void WorkerThread(ThreadPool * const pThreadPool) {
+      pThreadPool->Worker();
+   }
+
+   // call with m_mutex held
+   bool IsWorker() const {
+      const std::thread::id idThis = std::this_thread::get_id();
+      for(size_t iWorker = 0; iWorker < m_cWorkers; ++iWorker) {
+         if(idThis == m_aWorkerIds[iWorker]) {
+            return true;
+         }
+      }
+      return false;
+   }
+
+   // call with m_mutex held.  Returns the workers to their initial state of not running.  This must not be called 
+   // from one of our workers since it would wait to join itself
+   void StopWorkers(std::unique_lock<std::mutex> & lock) {
+      // if another thread is already stopping the workers, let it finish instead of joining the same threads twice
+      while(m_bStopping) {
+         m_conditionStopped.wait(lock);
+      }
+      if(size_t { 0 } == m_cWorkers) {
+         return;
+      }
+      m_bStopping = true;
+      m_bExit = true;
+      m_conditionWork.notify_all();
+      lock.unlock();
+      // m_cWorkers can't change while m_bStopping is set, so we can read it without the lock
+      for(size_t iWorker = 0; iWorker < m_cWorkers; ++iWorker) {
+         m_aWorkers[iWorker].join();
+      }
+      lock.lock();
+      m_cWorkers = 0;
+      m_bExit = false;
+      m_bStopping = false;
+      m_conditionStopped.notify_all();
+   }
+
+public:
+
+   ThreadPool() :
+      m_pJobsFirst(nullptr),
+      m_pJobsLast(nullptr),
+      m_cThreads(0),
+      m_cWorkers(0),
+      m_bExit(false),
+      m_bStopping(false) {
+   }
+
+   static void RunTasks(ParallelJob * const pJob, const size_t iThread) {
+      while(true) {
+         const size_t iTask = pJob->m_iNextTask.fetch_add(size_t { 1 }, std::memory_order_relaxed);
+         if(pJob->m_cTasks <= iTask) {
+            break;
+         }
+         (*pJob->m_pTaskFunction)(pJob->m_pContext, iThread, iTask);
+      }
+   }
+
+   // call with m_mutex held
+   size_t GetCountThreads() {
+      if(size_t { 0 } == m_cThreads) {
+         m_cThreads = EbmMin(GetHardwareThreadCount(), k_cThreadsMax);
+      }
+      return m_cThreads;
+   }
+
+   size_t GetCountThreadsLocked() {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return GetCountThreads();
+   }
+
+   // returns true if called from one of our workers, which can happen from inside a task or a log callback
+   bool SetCountThreads(const size_t cThreads) {
+      EBM_ASSERT(1 <= cThreads);
+      EBM_ASSERT(cThreads <= k_cThreadsMax);
+      std::unique_lock<std::mutex> lock(m_mutex);
+      if(IsWorker()) {
+         return true;
+      }
+      if(cThreads != m_cThreads) {
+         m_cThreads = cThreads;
+         // the workers are started again the next time we have a job
+         StopWorkers(lock);
+      }
+      return false;
+   }
+
+   void Run(ParallelJob * const pJob) {
+      std::unique_lock<std::mutex> lock(m_mutex);
+
+      // while the workers are being stopped we can't start new ones, and the workers we have are leaving, so the 
+      // calling thread does all the work.  We can't wait for the stop to finish since we might be running inside a 
+      // task on one of the workers being joined
+      const size_t cWorkersWanted = GetCountThreads() - size_t { 1 };
+      if(!m_bStopping && m_cWorkers < cWorkersWanted) {
+         try {
+            for(; m_cWorkers < cWorkersWanted; ++m_cWorkers) {
+               m_aWorkers[m_cWorkers] = std::thread(WorkerThread, this);
+               m_aWorkerIds[m_cWorkers] = m_aWorkers[m_cWorkers].get_id();
+            }
+         } catch(...) {
+            // we can run out of threads or memory.  The workers that did start, and the calling thread, do the work
+            LOG_0(TraceLevelWarning, "WARNING ThreadPool::Run exception creating thread");
+         }
+      }
+
+      // the calling thread is thread 0
+      pJob->m_iNextThread = 1;
+      pJob->m_cWorkersInside = 0;
+      pJob->m_bPosted = false;
+      if(!m_bStopping && size_t { 1 } < pJob->m_cThreads && size_t { 0 } != m_cWorkers) {
+         pJob->m_bPosted = true;
+         pJob->m_pNext = nullptr;
+         pJob->m_pPrev = m_pJobsLast;
+         if(nullptr == m_pJobsLast) {
+            m_pJobsFirst = pJob;
+         } else {
+            m_pJobsLast->m_pNext = pJob;
+         }
+         m_pJobsLast = pJob;
+         if(size_t { 2 } == pJob->m_cThreads) {
+            m_conditionWork.notify_one();
+         } else {
+            m_conditionWork.notify_all();
+         }
+      }
+      lock.unlock();
+
+      RunTasks(pJob, 0);
+
+      lock.lock();
+      Unpost(pJob);
+      // the job lives on our caller's stack, so wait for the workers that are still finishing their last task
+      while(size_t { 0 } != pJob->m_cWorkersInside) {
+         m_conditionLeft.wait(lock);
+      }
+   }
+};
+
+// The pool is never destroyed.  A static destructor would join the workers during library unload, which deadlocks 
+// on Windows since the exiting workers need the loader lock that DLL_PROCESS_DETACH holds.  Instead the idle workers 
+// stay blocked on m_conditionWork until the OS tears down the process, so the pool's members must outlive them.
+alignas(ThreadPool) static unsigned char g_threadPoolStorage[sizeof(ThreadPool)];
+static ThreadPool & g_threadPool = *new(g_threadPoolStorage) ThreadPool();
+
+size_t GetThreadPoolSize() {
+   return g_threadPool.GetCountThreadsLocked();
+}
+
+void RunParallelTasks(
+   const size_t cThreads,
+   const size_t cTasks,
+   const ParallelTaskFunction pTaskFunction,
+   void * const pContext
+) {
+   EBM_ASSERT(nullptr != pTaskFunction);
+
+   const size_t cThreadsUsable = EbmMin(EbmMin(cThreads, cTasks), k_cThreadsMax);
+   if(cThreadsUsable <= size_t { 1 }) {
+      for(size_t iTask = 0; iTask < cTasks; ++iTask) {
+         (*pTaskFunction)(pContext, 0, iTask);
+      }
+      return;
+   }
+
+   ParallelJob job;
+   job.m_pTaskFunction = pTaskFunction;
+   job.m_pContext = pContext;
+   job.m_cTasks = cTasks;
+   job.m_cThreads = cThreadsUsable;
+   job.m_iNextTask.store(size_t { 0 }, std::memory_order_relaxed);
+   g_threadPool.Run(&job);
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION SetThreadCount(IntEbmType countThreads) {
+   LOG_N(TraceLevelInfo, "Entered SetThreadCount: countThreads=%" IntEbmTypePrintf, countThreads);
+
+   if(countThreads < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR SetThreadCount countThreads must be zero or positive");
+      return IntEbmType { 1 };
+   }
+   size_t cThreads = k_cThreadsMax;
+   if(IsNumberConvertable<size_t>(countThreads) && static_cast<size_t>(countThreads) < k_cThreadsMax) {
+      cThreads = static_cast<size_t>(countThreads);
+   }
+   if(size_t { 0 } == cThreads) {
+      cThreads = EbmMin(GetHardwareThreadCount(), k_cThreadsMax);
+   }
+   if(g_threadPool.SetCountThreads(cThreads)) {
+      LOG_0(TraceLevelError, "ERROR SetThreadCount cannot be called from one of our pool threads");
+      return IntEbmType { 1 };
+   }
+
+   LOG_0(TraceLevelInfo, "Exited SetThreadCount");
+   return IntEbmType { 0 };
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GetThreadCount() {
+   const size_t cThreads = GetThreadPoolSize();
+   EBM_ASSERT(IsNumberConvertable<IntEbmType>(cThreads)); // cThreads is at most k_cThreadsMax
+   return static_cast<IntEbmType>(cThreads);
+}
@@ -0,0 +1,36 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef THREADING_H
+#define THREADING_H
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "EbmInternal.h" // INLINE_ALWAYS
+
+// iThread is in the range [0, cThreads) and is unique among the threads running concurrently, so callers can
+// use it to index per-thread scratch space.  iTask is in the range [0, cTasks) and each task runs exactly once.
+typedef void (* ParallelTaskFunction)(void * const pContext, const size_t iThread, const size_t iTask);
+
+// returns the number of threads the hardware can run simultaneously, or 1 if that is unknown
+extern size_t GetHardwareThreadCount();
+
+// returns the number of threads in our thread pool, including the threads that call RunParallelTasks.  This is what
+// SetThreadCount configured, or the hardware thread count by default, and is what kernels should size their work by
+extern size_t GetThreadPoolSize();
+
+// Runs every task on up to cThreads threads (including the calling thread) and returns after all of them finish.
+// The other threads come from a pool of GetThreadPoolSize() - 1 workers that every caller shares, so concurrent and 
+// nested calls don't oversubscribe the machine, and a call can get fewer threads than it asked for if the pool is busy.
+// Tasks are handed out dynamically, so there is no guarantee about which thread runs which task or in which order,
+// and callers needing determinism should only write task-private outputs.  If we fail to create threads we finish
+// the work on the threads we have, so this function cannot fail.
+extern void RunParallelTasks(
+   const size_t cThreads,
+   const size_t cTasks,
+   const ParallelTaskFunction pTaskFunction,
+   void * const pContext
+);
+
+#endif // THREADING_H
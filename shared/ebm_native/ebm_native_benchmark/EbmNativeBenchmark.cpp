@@ -0,0 +1,293 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+// Scoring benchmark.  We build synthetic models that cover the shapes we see in practice (number of terms, bins,
+// pairs and classes), score synthetic rows through the public API, and write one JSON document to stdout so that
+// results can be compared mechanically between builds.  Progress goes to stderr.
+//
+// usage: ebm_native_benchmark [-quick] [-threads N]
+//   -quick      fewer rows and repetitions, for smoke testing the benchmark itself
+//   -threads N  the thread count for the multithreaded batch measurement.  0, the default, uses every hardware thread
+
+#include <stddef.h> // size_t
+#include <stdio.h> // printf, fprintf
+#include <stdlib.h> // atoi
+#include <string.h> // strcmp
+#include <inttypes.h> // uint64_t
+#include <vector>
+#include <algorithm> // std::sort
+#include <chrono>
+#include <limits>
+
+#include "ebm_native.h"
+
+struct BenchmarkModel {
+   const char * m_sName;
+   // negative for regression
+   IntEbmType m_countTargetClasses;
+   size_t m_cFeatures;
+   size_t m_cBinCuts;
+   size_t m_cPairs;
+   TensorStorageType m_tensorStorage;
+};
+
+static const BenchmarkModel k_aModels[] {
+   { "binary_mains_small", 2, 10, 31, 0, TensorStorage_Float64 },
+   { "binary_mains_pairs", 2, 50, 255, 10, TensorStorage_Float64 },
+   { "binary_mains_pairs_int16", 2, 50, 255, 10, TensorStorage_Int16 },
+   { "binary_wide", 2, 500, 255, 50, TensorStorage_Float64 },
+   { "binary_fine_bins", 2, 20, 1023, 5, TensorStorage_Float64 },
+   { "regression_mains_pairs", -1, 50, 255, 10, TensorStorage_Float64 },
+   { "multiclass_mains_pairs", 5, 50, 63, 10, TensorStorage_Float64 },
+};
+
+static const char * GetStorageName(const TensorStorageType tensorStorage) {
+   if(TensorStorage_Float32 == tensorStorage) {
+      return "float32";
+   } else if(TensorStorage_Int16 == tensorStorage) {
+      return "int16";
+   }
+   return "float64";
+}
+
+// a fixed generator so that every run and every build scores exactly the same models and rows
+class BenchmarkRandom {
+   uint64_t m_state;
+public:
+   explicit BenchmarkRandom(const uint64_t seed) : m_state(seed) {
+   }
+
+   double Next() {
+      // splitmix64
+      m_state += 0x9E3779B97F4A7C15;
+      uint64_t z = m_state;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+      z = z ^ (z >> 31);
+      return static_cast<double>(z >> 11) / static_cast<double>(uint64_t { 1 } << 53);
+   }
+
+   double Next(const double low, const double high) {
+      return low + (high - low) * Next();
+   }
+};
+
+static PredictorHandle CreateBenchmarkPredictor(const BenchmarkModel & model) {
+   BenchmarkRandom random(12345);
+
+   const size_t cVectorLength = model.m_countTargetClasses <= 2 ? 1 : static_cast<size_t>(model.m_countTargetClasses);
+   const size_t cBins = model.m_cBinCuts + 2;
+
+   std::vector<IntEbmType> featuresBinCutCount(model.m_cFeatures, static_cast<IntEbmType>(model.m_cBinCuts));
+   std::vector<FloatEbmType> binCuts;
+   for(size_t iFeature = 0; iFeature < model.m_cFeatures; ++iFeature) {
+      // evenly spaced cuts over [-3, 3) with a random shift per feature
+      const double shift = random.Next(-0.1, 0.1);
+      for(size_t iCut = 0; iCut < model.m_cBinCuts; ++iCut) {
+         binCuts.push_back(shift - 3.0 + 6.0 * static_cast<double>(iCut) / static_cast<double>(model.m_cBinCuts));
+      }
+   }
+
+   std::vector<IntEbmType> featureGroupsFeatureCount;
+   std::vector<IntEbmType> featureGroupsFeatureIndexes;
+   size_t cTensorItems = 0;
+   for(size_t iFeature = 0; iFeature < model.m_cFeatures; ++iFeature) {
+      featureGroupsFeatureCount.push_back(1);
+      featureGroupsFeatureIndexes.push_back(static_cast<IntEbmType>(iFeature));
+      cTensorItems += cBins * cVectorLength;
+   }
+   for(size_t iPair = 0; iPair < model.m_cPairs; ++iPair) {
+      featureGroupsFeatureCount.push_back(2);
+      featureGroupsFeatureIndexes.push_back(static_cast<IntEbmType>((2 * iPair) % model.m_cFeatures));
+      featureGroupsFeatureIndexes.push_back(static_cast<IntEbmType>((2 * iPair + 1) % model.m_cFeatures));
+      cTensorItems += cBins * cBins * cVectorLength;
+   }
+   std::vector<FloatEbmType> tensors(cTensorItems);
+   for(size_t iItem = 0; iItem < cTensorItems; ++iItem) {
+      tensors[iItem] = random.Next(-0.5, 0.5);
+   }
+   std::vector<FloatEbmType> intercept(cVectorLength);
+   for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+      intercept[iVector] = random.Next(-1.0, 1.0);
+   }
+
+   return CreatePredictorWithStorage(
+      model.m_countTargetClasses,
+      static_cast<IntEbmType>(model.m_cFeatures),
+      &featuresBinCutCount[0],
+      &binCuts[0],
+      static_cast<IntEbmType>(featureGroupsFeatureCount.size()),
+      &featureGroupsFeatureCount[0],
+      &featureGroupsFeatureIndexes[0],
+      &tensors[0],
+      &intercept[0],
+      model.m_tensorStorage
+   );
+}
+
+// returns rows [cFeatures][cRows], which is the layout the API takes.  About 1% of the values are missing
+static std::vector<FloatEbmType> CreateBenchmarkRows(const size_t cFeatures, const size_t cRows) {
+   BenchmarkRandom random(67890);
+   std::vector<FloatEbmType> featureValues(cFeatures * cRows);
+   for(size_t i = 0; i < featureValues.size(); ++i) {
+      const double val = random.Next(-3.5, 3.5);
+      featureValues[i] = random.Next() < 0.01 ? std::numeric_limits<FloatEbmType>::quiet_NaN() : val;
+   }
+   return featureValues;
+}
+
+static double GetSeconds(
+   const std::chrono::steady_clock::time_point start,
+   const std::chrono::steady_clock::time_point end
+) {
+   return std::chrono::duration<double>(end - start).count();
+}
+
+// scores every row as one batch repeatedly and returns the median rows per second
+static bool MeasureBatch(
+   const PredictorHandle predictorHandle,
+   const IntEbmType countThreads,
+   const size_t cRows,
+   const size_t cRepetitions,
+   const std::vector<FloatEbmType> & featureValues,
+   std::vector<FloatEbmType> & logits,
+   double * const pRowsPerSecond
+) {
+   std::vector<double> rowsPerSecond;
+   // the first pass warms up the caches, the page tables of the output, and the threads
+   for(size_t iRepetition = 0; iRepetition <= cRepetitions; ++iRepetition) {
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      const IntEbmType ret = PredictScoresWithPredictor(
+         predictorHandle,
+         countThreads,
+         static_cast<IntEbmType>(cRows),
+         &featureValues[0],
+         &logits[0]
+      );
+      const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+      if(0 != ret) {
+         return false;
+      }
+      if(0 != iRepetition) {
+         rowsPerSecond.push_back(static_cast<double>(cRows) / GetSeconds(start, end));
+      }
+   }
+   std::sort(rowsPerSecond.begin(), rowsPerSecond.end());
+   *pRowsPerSecond = rowsPerSecond[rowsPerSecond.size() / 2];
+   return true;
+}
+
+// scores one row per call, which is what an online service does, and returns the latency percentiles
+static bool MeasureSingleRow(
+   const PredictorHandle predictorHandle,
+   const size_t cFeatures,
+   const size_t cCalls,
+   const std::vector<FloatEbmType> & featureValues,
+   const size_t cRows,
+   double * const pP50Microseconds,
+   double * const pP99Microseconds
+) {
+   // the batch layout is [features][rows], so gather the single rows up front to keep that out of the timings
+   const size_t cSingleRows = std::min(cRows, size_t { 1000 });
+   std::vector<FloatEbmType> singleRows(cSingleRows * cFeatures);
+   for(size_t iRow = 0; iRow < cSingleRows; ++iRow) {
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         singleRows[iRow * cFeatures + iFeature] = featureValues[iFeature * cRows + iRow];
+      }
+   }
+   FloatEbmType logits[64];
+
+   std::vector<double> latencies;
+   latencies.reserve(cCalls);
+   for(size_t iCall = 0; iCall < cCalls + cSingleRows; ++iCall) {
+      const FloatEbmType * const pRow = &singleRows[(iCall % cSingleRows) * cFeatures];
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      const IntEbmType ret = PredictScoresWithPredictor(predictorHandle, 1, 1, pRow, logits);
+      const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+      if(0 != ret) {
+         return false;
+      }
+      // the first pass over the rows is a warm up
+      if(cSingleRows <= iCall) {
+         latencies.push_back(GetSeconds(start, end) * 1000000.0);
+      }
+   }
+   std::sort(latencies.begin(), latencies.end());
+   *pP50Microseconds = latencies[latencies.size() / 2];
+   *pP99Microseconds = latencies[latencies.size() * 99 / 100];
+   return true;
+}
+
+int main(int argc, char ** argv) {
+   bool bQuick = false;
+   IntEbmType countThreads = 0;
+   for(int iArg = 1; iArg < argc; ++iArg) {
+      if(0 == strcmp(argv[iArg], "-quick")) {
+         bQuick = true;
+      } else if(0 == strcmp(argv[iArg], "-threads") && iArg + 1 < argc) {
+         ++iArg;
+         countThreads = static_cast<IntEbmType>(atoi(argv[iArg]));
+      } else {
+         fprintf(stderr, "usage: %s [-quick] [-threads N]\n", argv[0]);
+         return 1;
+      }
+   }
+
+   const size_t cRows = bQuick ? 10000 : 200000;
+   const size_t cRepetitions = bQuick ? 3 : 11;
+   const size_t cSingleRowCalls = bQuick ? 10000 : 200000;
+
+   printf("{\n");
+   printf("  \"rows\": %zu,\n", cRows);
+   printf("  \"repetitions\": %zu,\n", cRepetitions);
+   printf("  \"single_row_calls\": %zu,\n", cSingleRowCalls);
+   printf("  \"threads\": %" PRId64 ",\n", static_cast<int64_t>(countThreads));
+   printf("  \"results\": [\n");
+
+   const size_t cModels = sizeof(k_aModels) / sizeof(k_aModels[0]);
+   for(size_t iModel = 0; iModel < cModels; ++iModel) {
+      const BenchmarkModel & model = k_aModels[iModel];
+      fprintf(stderr, "benchmarking %s\n", model.m_sName);
+
+      const PredictorHandle predictorHandle = CreateBenchmarkPredictor(model);
+      if(nullptr == predictorHandle) {
+         fprintf(stderr, "ERROR creating the predictor for %s\n", model.m_sName);
+         return 1;
+      }
+      const std::vector<FloatEbmType> featureValues = CreateBenchmarkRows(model.m_cFeatures, cRows);
+      const size_t cVectorLength = model.m_countTargetClasses <= 2 ? 1 : static_cast<size_t>(model.m_countTargetClasses);
+      std::vector<FloatEbmType> logits(cRows * cVectorLength);
+
+      double rowsPerSecondSingleThread;
+      double rowsPerSecondThreads;
+      double p50Microseconds;
+      double p99Microseconds;
+      if(!MeasureBatch(predictorHandle, 1, cRows, cRepetitions, featureValues, logits, &rowsPerSecondSingleThread) ||
+         !MeasureBatch(predictorHandle, countThreads, cRows, cRepetitions, featureValues, logits, &rowsPerSecondThreads) ||
+         !MeasureSingleRow(predictorHandle, model.m_cFeatures, cSingleRowCalls, featureValues, cRows, &p50Microseconds, &p99Microseconds))
+      {
+         fprintf(stderr, "ERROR scoring %s\n", model.m_sName);
+         FreePredictor(predictorHandle);
+         return 1;
+      }
+      FreePredictor(predictorHandle);
+
+      printf("    {\n");
+      printf("      \"name\": \"%s\",\n", model.m_sName);
+      printf("      \"classes\": %" PRId64 ",\n", static_cast<int64_t>(model.m_countTargetClasses));
+      printf("      \"features\": %zu,\n", model.m_cFeatures);
+      printf("      \"bins\": %zu,\n", model.m_cBinCuts + 2);
+      printf("      \"pairs\": %zu,\n", model.m_cPairs);
+      printf("      \"storage\": \"%s\",\n", GetStorageName(model.m_tensorStorage));
+      printf("      \"batch_rows_per_sec_1_thread\": %.1f,\n", rowsPerSecondSingleThread);
+      printf("      \"batch_rows_per_sec_threads\": %.1f,\n", rowsPerSecondThreads);
+      printf("      \"single_row_p50_us\": %.3f,\n", p50Microseconds);
+      printf("      \"single_row_p99_us\": %.3f\n", p99Microseconds);
+      printf("    }%s\n", iModel + 1 == cModels ? "" : ",");
+   }
+
+   printf("  ]\n");
+   printf("}\n");
+   return 0;
+}
@@ -131,3 +131,163 @@ TEST_CASE("Test data bit packing extremes, interaction, binary") {
 }
 
 
+
+static std::vector<FloatEbmType> BoostBitPackingForCpuVariant(
+   const bool bRegression, 
+   const IntEbmType cBins, 
+   const size_t cSamples
+) {
+   TestApi test = bRegression ? TestApi(k_learningTypeRegression) : TestApi(2, 0);
+   test.AddFeatures({ FeatureTest(cBins) });
+   test.AddFeatureGroups({ { 0 } });
+
+   std::vector<RegressionSample> trainingSamplesRegression;
+   std::vector<ClassificationSample> trainingSamplesClassification;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      // spread the samples over the bins so that neighbouring lanes look up different updates
+      const IntEbmType iBin = static_cast<IntEbmType>(iSample * 7 % static_cast<size_t>(cBins));
+      trainingSamplesRegression.push_back(RegressionSample(static_cast<FloatEbmType>(iSample % 5), { iBin }));
+      trainingSamplesClassification.push_back(ClassificationSample(static_cast<IntEbmType>(iSample % 3 % 2), { iBin }));
+   }
+   // validating on the training samples gives the validation SIMD path the same partial vectors
+   if(bRegression) {
+      test.AddTrainingSamples(trainingSamplesRegression);
+      test.AddValidationSamples(trainingSamplesRegression);
+   } else {
+      test.AddTrainingSamples(trainingSamplesClassification);
+      test.AddValidationSamples(trainingSamplesClassification);
+   }
+   test.InitializeBoosting();
+
+   std::vector<FloatEbmType> results;
+   for(int iRound = 0; iRound < 3; ++iRound) {
+      results.push_back(test.Boost(0));
+   }
+   for(IntEbmType iBin = 0; iBin < cBins && static_cast<size_t>(iBin) < cSamples * 7; ++iBin) {
+      results.push_back(test.GetCurrentModelPredictorScore(0, { static_cast<size_t>(iBin) }, bRegression ? 0 : 1));
+   }
+   return results;
+}
+
+TEST_CASE("Test data bit packing extremes, boosting, same results for every CPU variant") {
+   // the SIMD path has a separate specialization for every bit packing width and processes a different number of
+   // samples per vector in each CPU variant, so check every width and sample counts that leave partial vectors
+   const CpuVariantType cpuVariantBest = GetCpuVariant();
+   for(int iLearningType = 0; iLearningType < 2; ++iLearningType) {
+      const bool bRegression = 0 == iLearningType;
+      for(size_t exponentialBins = 1; exponentialBins < 14; ++exponentialBins) {
+         const IntEbmType exponential = static_cast<IntEbmType>(std::pow(2, exponentialBins));
+         for(IntEbmType iRange = IntEbmType { 0 }; iRange <= IntEbmType { 1 }; ++iRange) {
+            const IntEbmType cBins = exponential + iRange;
+            for(const size_t cSamples : { 1, 2, 3, 7, 9, 17, 63, 64, 65, 200 }) {
+               std::vector<FloatEbmType> first;
+               for(CpuVariantType cpuVariant = CpuVariant_Generic; cpuVariant <= cpuVariantBest; ++cpuVariant) {
+                  CHECK(0 == SetCpuVariant(cpuVariant));
+                  const std::vector<FloatEbmType> results = BoostBitPackingForCpuVariant(bRegression, cBins, cSamples);
+                  if(first.empty()) {
+                     first = results;
+                  } else {
+                     CHECK(first.size() == results.size());
+                     CHECK(0 == memcmp(&first[0], &results[0], sizeof(first[0]) * first.size()));
+                  }
+               }
+            }
+         }
+      }
+   }
+   CHECK(0 == SetCpuVariant(cpuVariantBest));
+}
+
+static std::vector<FloatEbmType> BoostBinsUsed(
+   const bool bRegression,
+   const IntEbmType cBins,
+   const IntEbmType cBinsUsed,
+   const size_t cSamples,
+   const IntEbmType countInnerBags
+) {
+   TestApi test = bRegression ? TestApi(k_learningTypeRegression) : TestApi(2, 0);
+   test.AddFeatures({ FeatureTest(cBins) });
+   test.AddFeatureGroups({ { 0 } });
+
+   std::vector<RegressionSample> trainingSamplesRegression;
+   std::vector<ClassificationSample> trainingSamplesClassification;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      // the bins only depend on cBinsUsed, so every cBins gets the same samples.  The targets aren't exact binary 
+      // fractions, so the residual sums round differently if we add them up in a different order
+      const IntEbmType iBin = static_cast<IntEbmType>(iSample * 7 % static_cast<size_t>(cBinsUsed));
+      trainingSamplesRegression.push_back(
+         RegressionSample(static_cast<FloatEbmType>(iSample % 11) * FloatEbmType { 0.1 } + FloatEbmType { 0.37 } * iBin, { iBin }));
+      trainingSamplesClassification.push_back(ClassificationSample(static_cast<IntEbmType>((iSample + iBin) % 3 % 2), { iBin }));
+   }
+   if(bRegression) {
+      test.AddTrainingSamples(trainingSamplesRegression);
+      test.AddValidationSamples(trainingSamplesRegression);
+   } else {
+      test.AddTrainingSamples(trainingSamplesClassification);
+      test.AddValidationSamples(trainingSamplesClassification);
+   }
+   test.InitializeBoosting(countInnerBags);
+
+   std::vector<FloatEbmType> results;
+   for(int iRound = 0; iRound < 5; ++iRound) {
+      results.push_back(test.Boost(0));
+   }
+   for(IntEbmType iBin = 0; iBin < cBinsUsed; ++iBin) {
+      results.push_back(test.GetCurrentModelPredictorScore(0, { static_cast<size_t>(iBin) }, bRegression ? 0 : 1));
+   }
+   return results;
+}
+
+// more than 256 bins takes the single histogram path in BinBoostingShard instead of the sub-histograms
+static constexpr IntEbmType k_cBinsSingleHistogram = 257;
+// not a multiple of any bit packing width, so the last data unit is only partly filled
+static constexpr size_t k_cSamplesPartialDataUnit = 1013;
+
+TEST_CASE("Test data bit packing extremes, boosting, sub-histograms match the single histogram") {
+   // the sub-histograms add the residuals up in a different order, so we only match within rounding.  5 rounds of 
+   // a few hundred residuals each should stay well within 1e-9 relative
+   for(int iLearningType = 0; iLearningType < 2; ++iLearningType) {
+      const bool bRegression = 0 == iLearningType;
+      // 1, 2, 4 and 8 bits per item
+      for(const IntEbmType cBins : { 2, 4, 16, 256 }) {
+         const std::vector<FloatEbmType> subHistograms =
+            BoostBinsUsed(bRegression, cBins, cBins, k_cSamplesPartialDataUnit, 0);
+         const std::vector<FloatEbmType> singleHistogram =
+            BoostBinsUsed(bRegression, k_cBinsSingleHistogram, cBins, k_cSamplesPartialDataUnit, 0);
+         CHECK(subHistograms.size() == singleHistogram.size());
+         for(size_t i = 0; i < subHistograms.size(); ++i) {
+            CHECK_APPROX_TOLERANCE(subHistograms[i], singleHistogram[i], double { 1e-9 });
+         }
+      }
+   }
+}
+
+TEST_CASE("Test data bit packing extremes, boosting, sub-histograms don't depend on the bit packing") {
+   // each pair of bin counts packs a different number of items into a data unit, and some of those counts aren't 
+   // a multiple of the number of sub-histograms.  The samples take turns through the sub-histograms regardless
+   for(int iLearningType = 0; iLearningType < 2; ++iLearningType) {
+      const bool bRegression = 0 == iLearningType;
+      for(const IntEbmType cBins : { 2, 4, 8, 16, 64 }) {
+         const std::vector<FloatEbmType> tight = BoostBinsUsed(bRegression, cBins, cBins, k_cSamplesPartialDataUnit, 0);
+         const std::vector<FloatEbmType> wider = BoostBinsUsed(bRegression, cBins + 1, cBins, k_cSamplesPartialDataUnit, 0);
+         CHECK(tight.size() == wider.size());
+         CHECK(0 == memcmp(&tight[0], &wider[0], sizeof(tight[0]) * tight.size()));
+      }
+   }
+}
+
+TEST_CASE("Test data bit packing extremes, boosting, inner bags with zero count samples use the single histogram") {
+   // bootstrap sampling leaves some samples with a count of zero.  Those bin in sample order like the single 
+   // histogram does, so we match it exactly
+   for(int iLearningType = 0; iLearningType < 2; ++iLearningType) {
+      const bool bRegression = 0 == iLearningType;
+      for(const IntEbmType cBins : { 2, 4, 16, 256 }) {
+         const std::vector<FloatEbmType> subHistograms =
+            BoostBinsUsed(bRegression, cBins, cBins, k_cSamplesPartialDataUnit, 2);
+         const std::vector<FloatEbmType> singleHistogram =
+            BoostBinsUsed(bRegression, k_cBinsSingleHistogram, cBins, k_cSamplesPartialDataUnit, 2);
+         CHECK(subHistograms.size() == singleHistogram.size());
+         CHECK(0 == memcmp(&subHistograms[0], &singleHistogram[0], sizeof(subHistograms[0]) * subHistograms.size()));
+      }
+   }
+}
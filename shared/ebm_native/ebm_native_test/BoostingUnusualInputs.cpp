@@ -1397,3 +1397,1413 @@ TEST_CASE("Random splitting, no cuts, binary, sums") {
    CHECK_APPROX(validationMetric, 0.87428283691406250f);
 }
 
+
+enum class BagSplits {
+   // every bag trains on the first samples and validates on the rest, like separate training and validation data
+   Shared,
+   // each bag holds out different samples and skips some
+   Interleaved,
+   // like Interleaved, but some samples are in a bag more than once
+   InterleavedRepeated
+};
+
+static IntEbmType GetBagSampleCount(const BagSplits bagSplits, const IntEbmType iBag, const IntEbmType iSample) {
+   constexpr IntEbmType k_cTrainingSamples = 23;
+   if(BagSplits::Shared == bagSplits) {
+      return iSample < k_cTrainingSamples ? IntEbmType { 1 } : IntEbmType { -1 };
+   }
+   const bool bRepeated = BagSplits::InterleavedRepeated == bagSplits;
+   switch((iSample * 7 + iBag * 5) % 9) {
+   case 0:
+      return -1;
+   case 1:
+      return 0;
+   case 2:
+      return bRepeated ? IntEbmType { 2 } : IntEbmType { 1 };
+   case 3:
+      return bRepeated ? IntEbmType { -2 } : IntEbmType { -1 };
+   default:
+      return 1;
+   }
+}
+
+static void CheckBoostersMatchSeparateBoosters(
+   TestCaseHidden & testCaseHidden, 
+   const IntEbmType countTargetClasses,
+   const BagSplits bagSplits,
+   const IntEbmType countInnerBags,
+   const size_t cRounds
+) {
+   // countTargetClasses < 0 means regression
+   constexpr IntEbmType k_cBags = 5;
+   constexpr IntEbmType k_cSamples = 34;
+
+   const IntEbmType cClasses = countTargetClasses < 0 ? IntEbmType { 1 } : countTargetClasses;
+   const size_t cScores = countTargetClasses <= 2 ? size_t { 1 } : static_cast<size_t>(countTargetClasses);
+
+   const BoolEbmType featuresCategorical[] = { EBM_FALSE, EBM_FALSE, EBM_TRUE };
+   const IntEbmType featuresBinCount[] = { 5, 3, 4 };
+   const IntEbmType featureGroupsFeatureCount[] = { 1, 1, 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] = { 0, 1, 2, 0, 2 };
+   constexpr IntEbmType cFeatureGroups = 4;
+
+   std::vector<IntEbmType> binnedData(3 * k_cSamples);
+   std::vector<IntEbmType> classes(k_cSamples);
+   std::vector<FloatEbmType> values(k_cSamples);
+   for(IntEbmType iSample = 0; iSample < k_cSamples; ++iSample) {
+      binnedData[iSample] = (iSample * 7) % featuresBinCount[0];
+      binnedData[k_cSamples + iSample] = (iSample * 5 + 1) % featuresBinCount[1];
+      binnedData[2 * k_cSamples + iSample] = (iSample * 3 + 2) % featuresBinCount[2];
+      classes[iSample] = (iSample * 11 + iSample / 3) % cClasses;
+      values[iSample] = static_cast<FloatEbmType>((iSample * 13) % 17) - FloatEbmType { 4 };
+   }
+   const std::vector<FloatEbmType> predictorScores(cScores * k_cSamples, FloatEbmType { 0 });
+
+   SeedEbmType randomSeeds[k_cBags];
+   std::vector<IntEbmType> bagsSampleCounts(k_cBags * k_cSamples);
+   for(IntEbmType iBag = 0; iBag < k_cBags; ++iBag) {
+      randomSeeds[iBag] = k_randomSeed + static_cast<SeedEbmType>(iBag * 1013);
+      for(IntEbmType iSample = 0; iSample < k_cSamples; ++iSample) {
+         bagsSampleCounts[iBag * k_cSamples + iSample] = GetBagSampleCount(bagSplits, iBag, iSample);
+      }
+   }
+
+   BoosterHandle sharedBoosters[k_cBags];
+   BoosterHandle separateBoosters[k_cBags];
+   IntEbmType ret;
+   if(countTargetClasses < 0) {
+      ret = CreateRegressionBoosters(
+         k_cBags, randomSeeds, 3, featuresCategorical, featuresBinCount, cFeatureGroups, featureGroupsFeatureCount, 
+         featureGroupsFeatureIndexes, k_cSamples, &binnedData[0], &values[0], nullptr, &predictorScores[0], 
+         &bagsSampleCounts[0], countInnerBags, nullptr, ResidualStorage_Float64, sharedBoosters
+      );
+   } else {
+      ret = CreateClassificationBoosters(
+         k_cBags, randomSeeds, countTargetClasses, 3, featuresCategorical, featuresBinCount, cFeatureGroups, 
+         featureGroupsFeatureCount, featureGroupsFeatureIndexes, k_cSamples, &binnedData[0], &classes[0], nullptr, 
+         &predictorScores[0], &bagsSampleCounts[0], countInnerBags, nullptr, ResidualStorage_Float64, sharedBoosters
+      );
+   }
+   CHECK(0 == ret);
+
+   // each separate booster gets copies of its bag's training and validation samples in their original order
+   for(IntEbmType iBag = 0; iBag < k_cBags; ++iBag) {
+      std::vector<IntEbmType> aiTraining;
+      std::vector<IntEbmType> aiValidation;
+      for(IntEbmType iSample = 0; iSample < k_cSamples; ++iSample) {
+         const IntEbmType countOccurrences = GetBagSampleCount(bagSplits, iBag, iSample);
+         for(IntEbmType iOccurrence = 0; iOccurrence < countOccurrences; ++iOccurrence) {
+            aiTraining.push_back(iSample);
+         }
+         for(IntEbmType iOccurrence = 0; iOccurrence < -countOccurrences; ++iOccurrence) {
+            aiValidation.push_back(iSample);
+         }
+      }
+      const std::vector<IntEbmType> * const apiSamples[] = { &aiTraining, &aiValidation };
+      std::vector<IntEbmType> splitBinnedData[2];
+      std::vector<IntEbmType> splitClasses[2];
+      std::vector<FloatEbmType> splitValues[2];
+      std::vector<FloatEbmType> splitPredictorScores[2];
+      for(size_t iSplit = 0; iSplit < 2; ++iSplit) {
+         const std::vector<IntEbmType> & aiSamples = *apiSamples[iSplit];
+         for(IntEbmType iFeature = 0; iFeature < 3; ++iFeature) {
+            for(const IntEbmType iSample : aiSamples) {
+               splitBinnedData[iSplit].push_back(binnedData[iFeature * k_cSamples + iSample]);
+            }
+         }
+         for(const IntEbmType iSample : aiSamples) {
+            splitClasses[iSplit].push_back(classes[iSample]);
+            splitValues[iSplit].push_back(values[iSample]);
+         }
+         splitPredictorScores[iSplit].resize(cScores * aiSamples.size() + 1, FloatEbmType { 0 });
+         // keep the vectors non-empty so that we can always index them
+         splitBinnedData[iSplit].push_back(0);
+         splitClasses[iSplit].push_back(0);
+         splitValues[iSplit].push_back(0);
+      }
+      const IntEbmType cTraining = static_cast<IntEbmType>(aiTraining.size());
+      const IntEbmType cValidation = static_cast<IntEbmType>(aiValidation.size());
+      if(countTargetClasses < 0) {
+         separateBoosters[iBag] = CreateRegressionBooster(
+            randomSeeds[iBag], 3, featuresCategorical, featuresBinCount, cFeatureGroups, featureGroupsFeatureCount,
+            featureGroupsFeatureIndexes, cTraining, &splitBinnedData[0][0], &splitValues[0][0], nullptr,
+            &splitPredictorScores[0][0], cValidation, &splitBinnedData[1][0], &splitValues[1][0], nullptr,
+            &splitPredictorScores[1][0], countInnerBags, nullptr
+         );
+      } else {
+         separateBoosters[iBag] = CreateClassificationBooster(
+            randomSeeds[iBag], countTargetClasses, 3, featuresCategorical, featuresBinCount, cFeatureGroups, 
+            featureGroupsFeatureCount, featureGroupsFeatureIndexes, cTraining, &splitBinnedData[0][0],
+            &splitClasses[0][0], nullptr, &splitPredictorScores[0][0], cValidation, &splitBinnedData[1][0],
+            &splitClasses[1][0], nullptr, &splitPredictorScores[1][0], countInnerBags, nullptr
+         );
+      }
+      CHECK(nullptr != separateBoosters[iBag]);
+   }
+
+   FloatEbmType sharedMetrics[k_cBags];
+   for(size_t iRound = 0; iRound < cRounds; ++iRound) {
+      for(IntEbmType iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         ret = BoostingStepParallel(
+            3,
+            k_cBags,
+            sharedBoosters,
+            iFeatureGroup,
+            GenerateUpdateOptions_Default,
+            k_learningRateDefault,
+            k_countSamplesRequiredForChildSplitMinDefault,
+            &k_leavesMaxDefault[0],
+            sharedMetrics
+         );
+         CHECK(0 == ret);
+         for(IntEbmType iBag = 0; iBag < k_cBags; ++iBag) {
+            FloatEbmType separateMetric = FloatEbmType { 0 };
+            ret = BoostingStep(
+               separateBoosters[iBag],
+               iFeatureGroup,
+               GenerateUpdateOptions_Default,
+               k_learningRateDefault,
+               k_countSamplesRequiredForChildSplitMinDefault,
+               &k_leavesMaxDefault[0],
+               &separateMetric
+            );
+            CHECK(0 == ret);
+            CHECK(separateMetric == sharedMetrics[iBag]);
+         }
+      }
+   }
+
+   // the bags boost differently, but each one matches its separate booster
+   const FloatEbmType * const aFirstBag = GetCurrentModelFeatureGroup(sharedBoosters[0], 3);
+   const FloatEbmType * const aSecondBag = GetCurrentModelFeatureGroup(sharedBoosters[1], 3);
+   const size_t cPairItems = static_cast<size_t>(featuresBinCount[0] * featuresBinCount[2]) * cScores;
+   CHECK(0 != memcmp(aFirstBag, aSecondBag, sizeof(*aFirstBag) * cPairItems));
+
+   for(IntEbmType iBag = 0; iBag < k_cBags; ++iBag) {
+      const IntEbmType * pFeatureIndex = featureGroupsFeatureIndexes;
+      for(IntEbmType iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         size_t cItems = cScores;
+         for(IntEbmType iDimension = 0; iDimension < featureGroupsFeatureCount[iFeatureGroup]; ++iDimension) {
+            cItems *= static_cast<size_t>(featuresBinCount[*pFeatureIndex]);
+            ++pFeatureIndex;
+         }
+         const FloatEbmType * const aaShared[] = {
+            GetBestModelFeatureGroup(sharedBoosters[iBag], iFeatureGroup),
+            GetCurrentModelFeatureGroup(sharedBoosters[iBag], iFeatureGroup)
+         };
+         const FloatEbmType * const aaSeparate[] = {
+            GetBestModelFeatureGroup(separateBoosters[iBag], iFeatureGroup),
+            GetCurrentModelFeatureGroup(separateBoosters[iBag], iFeatureGroup)
+         };
+         for(size_t iModel = 0; iModel < 2; ++iModel) {
+            CHECK(0 == memcmp(aaShared[iModel], aaSeparate[iModel], sizeof(*aaShared[iModel]) * cItems));
+         }
+      }
+   }
+
+   // the shared data must outlive the booster that created it
+   FreeBooster(sharedBoosters[0]);
+   ret = BoostingStepParallel(
+      0,
+      k_cBags - 1,
+      &sharedBoosters[1],
+      3,
+      GenerateUpdateOptions_Default,
+      k_learningRateDefault,
+      k_countSamplesRequiredForChildSplitMinDefault,
+      &k_leavesMaxDefault[0],
+      nullptr
+   );
+   CHECK(0 == ret);
+   for(IntEbmType iBag = 0; iBag < k_cBags; ++iBag) {
+      if(0 != iBag) {
+         FreeBooster(sharedBoosters[iBag]);
+      }
+      FreeBooster(separateBoosters[iBag]);
+   }
+}
+
+TEST_CASE("CreateRegressionBoosters, shared data boosts the same as separate boosters") {
+   CheckBoostersMatchSeparateBoosters(testCaseHidden, k_learningTypeRegression, BagSplits::Shared, 3, 15);
+}
+
+TEST_CASE("CreateClassificationBoosters, shared data boosts the same as separate boosters, binary") {
+   CheckBoostersMatchSeparateBoosters(testCaseHidden, 2, BagSplits::Shared, 3, 15);
+}
+
+TEST_CASE("CreateClassificationBoosters, shared data boosts the same as separate boosters, multiclass") {
+   CheckBoostersMatchSeparateBoosters(testCaseHidden, 3, BagSplits::Shared, 3, 15);
+}
+
+TEST_CASE("CreateRegressionBoosters, each bag boosts on its own split") {
+   CheckBoostersMatchSeparateBoosters(testCaseHidden, k_learningTypeRegression, BagSplits::Interleaved, 0, 15);
+   CheckBoostersMatchSeparateBoosters(testCaseHidden, k_learningTypeRegression, BagSplits::Interleaved, 3, 15);
+}
+
+TEST_CASE("CreateClassificationBoosters, each bag boosts on its own split, binary") {
+   CheckBoostersMatchSeparateBoosters(testCaseHidden, 2, BagSplits::Interleaved, 0, 15);
+   CheckBoostersMatchSeparateBoosters(testCaseHidden, 2, BagSplits::Interleaved, 3, 15);
+}
+
+TEST_CASE("CreateClassificationBoosters, each bag boosts on its own split, multiclass") {
+   CheckBoostersMatchSeparateBoosters(testCaseHidden, 3, BagSplits::Interleaved, 0, 15);
+   CheckBoostersMatchSeparateBoosters(testCaseHidden, 3, BagSplits::Interleaved, 3, 15);
+}
+
+TEST_CASE("CreateRegressionBoosters, repeated samples in the bags") {
+   CheckBoostersMatchSeparateBoosters(testCaseHidden, k_learningTypeRegression, BagSplits::InterleavedRepeated, 0, 15);
+   CheckBoostersMatchSeparateBoosters(testCaseHidden, k_learningTypeRegression, BagSplits::InterleavedRepeated, 3, 15);
+}
+
+TEST_CASE("CreateClassificationBoosters, repeated samples in the bags, binary") {
+   CheckBoostersMatchSeparateBoosters(testCaseHidden, 2, BagSplits::InterleavedRepeated, 0, 15);
+   CheckBoostersMatchSeparateBoosters(testCaseHidden, 2, BagSplits::InterleavedRepeated, 3, 15);
+}
+
+TEST_CASE("CreateClassificationBoosters, repeated samples in the bags, multiclass") {
+   CheckBoostersMatchSeparateBoosters(testCaseHidden, 3, BagSplits::InterleavedRepeated, 0, 15);
+   CheckBoostersMatchSeparateBoosters(testCaseHidden, 3, BagSplits::InterleavedRepeated, 3, 15);
+}
+
+TEST_CASE("CreateClassificationBoosters, bad bagsSampleCounts, return error") {
+   const BoolEbmType featuresCategorical[] = { EBM_FALSE };
+   const IntEbmType featuresBinCount[] = { 2 };
+   const IntEbmType featureGroupsFeatureCount[] = { 1 };
+   const IntEbmType featureGroupsFeatureIndexes[] = { 0 };
+   const IntEbmType binnedData[] = { 0, 1, 1 };
+   const IntEbmType classes[] = { 0, 1, 0 };
+   const FloatEbmType predictorScores[] = { 0, 0, 0 };
+   const SeedEbmType randomSeeds[] = { k_randomSeed, k_randomSeed + 1 };
+   // the second bag has no training samples
+   const IntEbmType bagsSampleCounts[] = { 1, 1, -1, -1, 0, -1 };
+
+   BoosterHandle boosters[2];
+   IntEbmType ret = CreateClassificationBoosters(
+      2, randomSeeds, 2, 1, featuresCategorical, featuresBinCount, 1, featureGroupsFeatureCount, 
+      featureGroupsFeatureIndexes, 3, binnedData, classes, nullptr, predictorScores, bagsSampleCounts, 0, nullptr, 
+      ResidualStorage_Float64, boosters
+   );
+   CHECK(0 != ret);
+   CHECK(nullptr == boosters[0]);
+   CHECK(nullptr == boosters[1]);
+
+   ret = CreateClassificationBoosters(
+      2, randomSeeds, 2, 1, featuresCategorical, featuresBinCount, 1, featureGroupsFeatureCount, 
+      featureGroupsFeatureIndexes, 3, binnedData, classes, nullptr, predictorScores, nullptr, 0, nullptr, 
+      ResidualStorage_Float64, boosters
+   );
+   CHECK(0 != ret);
+   CHECK(nullptr == boosters[0]);
+   CHECK(nullptr == boosters[1]);
+}
+
+TEST_CASE("CreateClassificationBoosters and CreateRegressionBoosters, float32 residual storage, return error") {
+   const BoolEbmType featuresCategorical[] = { EBM_FALSE };
+   const IntEbmType featuresBinCount[] = { 2 };
+   const IntEbmType featureGroupsFeatureCount[] = { 1 };
+   const IntEbmType featureGroupsFeatureIndexes[] = { 0 };
+   const IntEbmType binnedData[] = { 0, 1, 1 };
+   const IntEbmType classes[] = { 0, 1, 0 };
+   const FloatEbmType values[] = { 1, 2, 3 };
+   const FloatEbmType predictorScores[] = { 0, 0, 0 };
+   const SeedEbmType randomSeeds[] = { k_randomSeed, k_randomSeed + 1 };
+   const IntEbmType bagsSampleCounts[] = { 1, 1, -1, -1, 1, 1 };
+
+   const ResidualStorageType residualStoragesBad[] = { ResidualStorage_Float32, ResidualStorage_Float32 + 1, -1 };
+   for(const ResidualStorageType residualStorage : residualStoragesBad) {
+      BoosterHandle boosters[2];
+      IntEbmType ret = CreateClassificationBoosters(
+         2, randomSeeds, 2, 1, featuresCategorical, featuresBinCount, 1, featureGroupsFeatureCount, 
+         featureGroupsFeatureIndexes, 3, binnedData, classes, nullptr, predictorScores, bagsSampleCounts, 0, nullptr, 
+         residualStorage, boosters
+      );
+      CHECK(0 != ret);
+      CHECK(nullptr == boosters[0]);
+      CHECK(nullptr == boosters[1]);
+
+      ret = CreateRegressionBoosters(
+         2, randomSeeds, 1, featuresCategorical, featuresBinCount, 1, featureGroupsFeatureCount, 
+         featureGroupsFeatureIndexes, 3, binnedData, values, nullptr, predictorScores, bagsSampleCounts, 0, nullptr, 
+         residualStorage, boosters
+      );
+      CHECK(0 != ret);
+      CHECK(nullptr == boosters[0]);
+      CHECK(nullptr == boosters[1]);
+   }
+}
+
+TEST_CASE("GenerateModelFeatureGroupUpdate, inner bags binned in parallel, boosting is repeatable") {
+   // enough samples that the inner bags are binned on separate threads
+   constexpr IntEbmType k_cSamples = 10000;
+   constexpr IntEbmType k_cInnerBags = 7;
+   constexpr size_t k_cRounds = 3;
+
+   const BoolEbmType featuresCategorical[] = { EBM_FALSE, EBM_FALSE };
+   const IntEbmType featuresBinCount[] = { 6, 4 };
+   const IntEbmType featureGroupsFeatureCount[] = { 0, 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] = { 0, 0, 1 };
+   constexpr IntEbmType cFeatureGroups = 3;
+   const GenerateUpdateOptionsType options[] = { GenerateUpdateOptions_Default, GenerateUpdateOptions_RandomSplits };
+
+   std::vector<IntEbmType> binnedData(2 * k_cSamples);
+   std::vector<IntEbmType> targets(k_cSamples);
+   for(IntEbmType iSample = 0; iSample < k_cSamples; ++iSample) {
+      binnedData[iSample] = (iSample * 7) % featuresBinCount[0];
+      binnedData[k_cSamples + iSample] = (iSample * 5 + iSample / 11) % featuresBinCount[1];
+      targets[iSample] = (iSample * 11 + iSample / 3) % 3;
+   }
+   const std::vector<FloatEbmType> predictorScores(3 * k_cSamples, FloatEbmType { 0 });
+
+   BoosterHandle boosters[2];
+   for(size_t iBooster = 0; iBooster < 2; ++iBooster) {
+      boosters[iBooster] = CreateClassificationBooster(
+         k_randomSeed, 3, 2, featuresCategorical, featuresBinCount, cFeatureGroups, featureGroupsFeatureCount,
+         featureGroupsFeatureIndexes, k_cSamples, &binnedData[0], &targets[0], nullptr, &predictorScores[0], k_cSamples,
+         &binnedData[0], &targets[0], nullptr, &predictorScores[0], k_cInnerBags, nullptr
+      );
+      CHECK(nullptr != boosters[iBooster]);
+   }
+
+   for(size_t iRound = 0; iRound < k_cRounds; ++iRound) {
+      for(IntEbmType iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         for(const GenerateUpdateOptionsType option : options) {
+            FloatEbmType metrics[2];
+            for(size_t iBooster = 0; iBooster < 2; ++iBooster) {
+               const IntEbmType ret = BoostingStep(
+                  boosters[iBooster],
+                  iFeatureGroup,
+                  option,
+                  k_learningRateDefault,
+                  k_countSamplesRequiredForChildSplitMinDefault,
+                  &k_leavesMaxDefault[0],
+                  &metrics[iBooster]
+               );
+               CHECK(0 == ret);
+            }
+            CHECK(!std::isnan(metrics[0]));
+            CHECK(metrics[0] == metrics[1]);
+         }
+      }
+   }
+
+   const FloatEbmType * const aFirst = GetCurrentModelFeatureGroup(boosters[0], 2);
+   const FloatEbmType * const aSecond = GetCurrentModelFeatureGroup(boosters[1], 2);
+   const size_t cPairItems = static_cast<size_t>(featuresBinCount[0] * featuresBinCount[1]) * size_t { 3 };
+   CHECK(0 == memcmp(aFirst, aSecond, sizeof(*aFirst) * cPairItems));
+
+   FreeBooster(boosters[0]);
+   FreeBooster(boosters[1]);
+}
+
+TEST_CASE("BinBoosting, samples binned in shards, same update as a small dataset with the same pattern") {
+   // integer residuals are summed exactly in any order, so sharding the samples can't change the update.  Repeating
+   // the pattern a power of 2 times scales every sum and count by the same amount, which leaves each mean unchanged
+   constexpr IntEbmType k_cPattern = 64;
+   constexpr IntEbmType k_cRepeats = 4096;
+
+   const BoolEbmType featuresCategorical[] = { EBM_FALSE, EBM_FALSE };
+   const IntEbmType featuresBinCount[] = { 5, 3 };
+   const IntEbmType featureGroupsFeatureCount[] = { 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] = { 0, 0, 1 };
+   constexpr IntEbmType cFeatureGroups = 2;
+
+   BoosterHandle boosters[2];
+   for(size_t iBooster = 0; iBooster < 2; ++iBooster) {
+      const IntEbmType cSamples = 0 == iBooster ? k_cPattern : k_cPattern * k_cRepeats;
+      std::vector<IntEbmType> binnedData(2 * cSamples);
+      std::vector<FloatEbmType> targets(cSamples);
+      for(IntEbmType iSample = 0; iSample < cSamples; ++iSample) {
+         const IntEbmType iPattern = iSample % k_cPattern;
+         binnedData[iSample] = (iPattern * 7) % featuresBinCount[0];
+         binnedData[cSamples + iSample] = (iPattern / 5) % featuresBinCount[1];
+         targets[iSample] = static_cast<FloatEbmType>((iPattern * 13) % 11) - FloatEbmType { 5 };
+      }
+      const std::vector<FloatEbmType> predictorScores(cSamples, FloatEbmType { 0 });
+      boosters[iBooster] = CreateRegressionBooster(
+         k_randomSeed, 2, featuresCategorical, featuresBinCount, cFeatureGroups, featureGroupsFeatureCount,
+         featureGroupsFeatureIndexes, cSamples, &binnedData[0], &targets[0], nullptr, &predictorScores[0], cSamples,
+         &binnedData[0], &targets[0], nullptr, &predictorScores[0], 0, nullptr
+      );
+      CHECK(nullptr != boosters[iBooster]);
+   }
+
+   for(IntEbmType iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const FloatEbmType * aUpdates[2];
+      for(size_t iBooster = 0; iBooster < 2; ++iBooster) {
+         aUpdates[iBooster] = GenerateModelFeatureGroupUpdate(
+            boosters[iBooster],
+            iFeatureGroup,
+            GenerateUpdateOptions_Default,
+            k_learningRateDefault,
+            k_countSamplesRequiredForChildSplitMinDefault,
+            &k_leavesMaxDefault[0],
+            nullptr
+         );
+         CHECK(nullptr != aUpdates[iBooster]);
+      }
+      const size_t cItems = 0 == iFeatureGroup ? size_t { 5 } : size_t { 15 };
+      CHECK(0 == memcmp(aUpdates[0], aUpdates[1], sizeof(*aUpdates[0]) * cItems));
+   }
+
+   FreeBooster(boosters[0]);
+   FreeBooster(boosters[1]);
+}
+
+static void CheckChunkedUpdatesMatchSmallDataset(TestCaseHidden & testCaseHidden, const IntEbmType countTargetClasses) {
+   // countTargetClasses < 0 means regression.  The large dataset repeats the small one enough times to be split into 
+   // several chunks when applying updates, so both should boost to the same model and validation metric
+   constexpr IntEbmType k_cPattern = 50;
+   constexpr IntEbmType k_cRepeats = 1024;
+   constexpr size_t k_cRounds = 3;
+
+   const IntEbmType cClasses = countTargetClasses < 0 ? IntEbmType { 1 } : countTargetClasses;
+   const size_t cScores = countTargetClasses <= 2 ? size_t { 1 } : static_cast<size_t>(countTargetClasses);
+
+   const BoolEbmType featuresCategorical[] = { EBM_FALSE, EBM_TRUE };
+   const IntEbmType featuresBinCount[] = { 7, 3 };
+   const IntEbmType featureGroupsFeatureCount[] = { 0, 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] = { 0, 0, 1 };
+   constexpr IntEbmType cFeatureGroups = 3;
+
+   BoosterHandle boosters[2];
+   for(size_t iBooster = 0; iBooster < 2; ++iBooster) {
+      const IntEbmType cSamples = 0 == iBooster ? k_cPattern : k_cPattern * k_cRepeats;
+      std::vector<IntEbmType> binnedData(2 * cSamples);
+      std::vector<IntEbmType> classes(cSamples);
+      std::vector<FloatEbmType> values(cSamples);
+      for(IntEbmType iSample = 0; iSample < cSamples; ++iSample) {
+         const IntEbmType iPattern = iSample % k_cPattern;
+         binnedData[iSample] = (iPattern * 3) % featuresBinCount[0];
+         binnedData[cSamples + iSample] = (iPattern / 7) % featuresBinCount[1];
+         classes[iSample] = (iPattern * 11 + iPattern / 4) % cClasses;
+         values[iSample] = static_cast<FloatEbmType>((iPattern * 13) % 17) - FloatEbmType { 6 };
+      }
+      const std::vector<FloatEbmType> predictorScores(cScores * cSamples, FloatEbmType { 0 });
+      if(countTargetClasses < 0) {
+         boosters[iBooster] = CreateRegressionBooster(
+            k_randomSeed, 2, featuresCategorical, featuresBinCount, cFeatureGroups, featureGroupsFeatureCount,
+            featureGroupsFeatureIndexes, cSamples, &binnedData[0], &values[0], nullptr, &predictorScores[0], cSamples,
+            &binnedData[0], &values[0], nullptr, &predictorScores[0], 0, nullptr
+         );
+      } else {
+         boosters[iBooster] = CreateClassificationBooster(
+            k_randomSeed, countTargetClasses, 2, featuresCategorical, featuresBinCount, cFeatureGroups, 
+            featureGroupsFeatureCount, featureGroupsFeatureIndexes, cSamples, &binnedData[0], &classes[0], nullptr, 
+            &predictorScores[0], cSamples, &binnedData[0], &classes[0], nullptr, &predictorScores[0], 0, nullptr
+         );
+      }
+      CHECK(nullptr != boosters[iBooster]);
+   }
+
+   for(size_t iRound = 0; iRound < k_cRounds; ++iRound) {
+      for(IntEbmType iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         FloatEbmType metrics[2];
+         for(size_t iBooster = 0; iBooster < 2; ++iBooster) {
+            const IntEbmType ret = BoostingStep(
+               boosters[iBooster],
+               iFeatureGroup,
+               GenerateUpdateOptions_Default,
+               k_learningRateDefault,
+               k_countSamplesRequiredForChildSplitMinDefault,
+               &k_leavesMaxDefault[0],
+               &metrics[iBooster]
+            );
+            CHECK(0 == ret);
+         }
+         CHECK_APPROX(metrics[1], metrics[0]);
+      }
+   }
+
+   const FloatEbmType * const aSmall = GetCurrentModelFeatureGroup(boosters[0], 2);
+   const FloatEbmType * const aLarge = GetCurrentModelFeatureGroup(boosters[1], 2);
+   const size_t cPairItems = static_cast<size_t>(featuresBinCount[0] * featuresBinCount[1]) * cScores;
+   for(size_t iItem = 0; iItem < cPairItems; ++iItem) {
+      CHECK_APPROX(aLarge[iItem], aSmall[iItem]);
+   }
+
+   FreeBooster(boosters[0]);
+   FreeBooster(boosters[1]);
+}
+
+TEST_CASE("ApplyModelUpdate, samples updated in chunks, regression") {
+   CheckChunkedUpdatesMatchSmallDataset(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("ApplyModelUpdate, samples updated in chunks, binary") {
+   CheckChunkedUpdatesMatchSmallDataset(testCaseHidden, 2);
+}
+
+TEST_CASE("ApplyModelUpdate, samples updated in chunks, multiclass") {
+   CheckChunkedUpdatesMatchSmallDataset(testCaseHidden, 5);
+}
+
+TEST_CASE("SetThreadCount, boosting gives bitwise identical results for any thread count") {
+   // enough samples to bin the inner bags in parallel, to apply updates in several chunks and to bin several shards of 
+   // the samples.  With 1 thread the shards are binned in waves through a single private buffer
+   constexpr IntEbmType k_cSamples = 300000;
+   constexpr IntEbmType k_cInnerBags = 3;
+   constexpr size_t k_cRounds = 2;
+   const IntEbmType threadCounts[] = { 1, 2, 7, 64 };
+
+   const BoolEbmType featuresCategorical[] = { EBM_FALSE, EBM_FALSE };
+   const IntEbmType featuresBinCount[] = { 9, 4 };
+   const IntEbmType featureGroupsFeatureCount[] = { 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] = { 0, 0, 1 };
+   constexpr IntEbmType cFeatureGroups = 2;
+
+   std::vector<IntEbmType> binnedData(2 * k_cSamples);
+   std::vector<IntEbmType> targets(k_cSamples);
+   for(IntEbmType iSample = 0; iSample < k_cSamples; ++iSample) {
+      binnedData[iSample] = (iSample * 7 + iSample / 13) % featuresBinCount[0];
+      binnedData[k_cSamples + iSample] = (iSample * 5 + iSample / 11) % featuresBinCount[1];
+      targets[iSample] = (iSample * 11 + iSample / 3) % 3;
+   }
+   const std::vector<FloatEbmType> predictorScores(3 * k_cSamples, FloatEbmType { 0 });
+
+   CHECK(0 != SetThreadCount(-1));
+
+   std::vector<FloatEbmType> firstMetrics;
+   std::vector<FloatEbmType> firstModel;
+   for(const IntEbmType countThreads : threadCounts) {
+      CHECK(0 == SetThreadCount(countThreads));
+      CHECK(countThreads == GetThreadCount());
+
+      BoosterHandle booster = CreateClassificationBooster(
+         k_randomSeed, 3, 2, featuresCategorical, featuresBinCount, cFeatureGroups, featureGroupsFeatureCount,
+         featureGroupsFeatureIndexes, k_cSamples, &binnedData[0], &targets[0], nullptr, &predictorScores[0], 
+         k_cSamples, &binnedData[0], &targets[0], nullptr, &predictorScores[0], k_cInnerBags, nullptr
+      );
+      CHECK(nullptr != booster);
+
+      std::vector<FloatEbmType> metrics;
+      for(size_t iRound = 0; iRound < k_cRounds; ++iRound) {
+         for(IntEbmType iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+            FloatEbmType metric = FloatEbmType { 0 };
+            CHECK(0 == BoostingStep(
+               booster,
+               iFeatureGroup,
+               GenerateUpdateOptions_Default,
+               k_learningRateDefault,
+               k_countSamplesRequiredForChildSplitMinDefault,
+               &k_leavesMaxDefault[0],
+               &metric
+            ));
+            metrics.push_back(metric);
+         }
+      }
+      const FloatEbmType * const aModel = GetCurrentModelFeatureGroup(booster, 1);
+      const std::vector<FloatEbmType> model(aModel, aModel + featuresBinCount[0] * featuresBinCount[1] * 3);
+      FreeBooster(booster);
+
+      if(firstMetrics.empty()) {
+         firstMetrics = metrics;
+         firstModel = model;
+      } else {
+         CHECK(0 == memcmp(&firstMetrics[0], &metrics[0], sizeof(metrics[0]) * metrics.size()));
+         CHECK(0 == memcmp(&firstModel[0], &model[0], sizeof(model[0]) * model.size()));
+      }
+   }
+
+   CHECK(0 == SetThreadCount(0));
+   CHECK(1 <= GetThreadCount());
+}
+
+// boosts on its own thread so that the test can change the thread count while the pool is running tasks
+static void BoostForThreadCountChanges(
+   const std::vector<IntEbmType> * const pBinnedData,
+   const std::vector<FloatEbmType> * const pTargets,
+   const size_t cBoosters,
+   std::vector<FloatEbmType> * const pMetrics,
+   std::atomic<bool> * const pbDone
+) {
+   const BoolEbmType featuresCategorical[] = { EBM_FALSE, EBM_FALSE };
+   const IntEbmType featuresBinCount[] = { 9, 4 };
+   const IntEbmType featureGroupsFeatureCount[] = { 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] = { 0, 0, 1 };
+   const IntEbmType cSamples = static_cast<IntEbmType>(pTargets->size());
+   const std::vector<FloatEbmType> predictorScores(pTargets->size(), FloatEbmType { 0 });
+
+   for(size_t iBooster = 0; iBooster < cBoosters; ++iBooster) {
+      BoosterHandle booster = CreateRegressionBooster(
+         k_randomSeed, 2, featuresCategorical, featuresBinCount, 2, featureGroupsFeatureCount,
+         featureGroupsFeatureIndexes, cSamples, &(*pBinnedData)[0], &(*pTargets)[0], nullptr, &predictorScores[0],
+         cSamples, &(*pBinnedData)[0], &(*pTargets)[0], nullptr, &predictorScores[0], 2, nullptr
+      );
+      FloatEbmType metric = FloatEbmType { -1 };
+      if(nullptr != booster) {
+         // many short steps so that the thread count changes land between and inside the parallel calls
+         for(size_t iStep = 0; iStep < 40; ++iStep) {
+            if(0 != BoostingStep(
+               booster,
+               static_cast<IntEbmType>(iStep % 2),
+               GenerateUpdateOptions_Default,
+               k_learningRateDefault,
+               k_countSamplesRequiredForChildSplitMinDefault,
+               &k_leavesMaxDefault[0],
+               &metric
+            )) {
+               metric = FloatEbmType { -1 };
+               break;
+            }
+         }
+         FreeBooster(booster);
+      }
+      pMetrics->push_back(metric);
+   }
+   pbDone->store(true);
+}
+
+// changes the thread count until the boosting thread finishes, counting the calls that fail
+static void ChangeThreadCounts(const size_t iStart, const std::atomic<bool> * const pbDone, size_t * const pcFailures) {
+   const IntEbmType threadCounts[] = { 3, 1, 2, 0, 5, 2, 0 };
+   constexpr size_t k_cThreadCounts = sizeof(threadCounts) / sizeof(threadCounts[0]);
+
+   size_t iThreadCount = iStart;
+   while(!pbDone->load()) {
+      if(0 != SetThreadCount(threadCounts[iThreadCount % k_cThreadCounts])) {
+         ++*pcFailures;
+      }
+      ++iThreadCount;
+      std::this_thread::yield();
+   }
+}
+
+TEST_CASE("SetThreadCount, called while another thread is boosting, boosting is unaffected") {
+   // enough samples to bin the inner bags in parallel and to apply updates in several chunks
+   constexpr IntEbmType k_cSamples = 40000;
+   constexpr size_t k_cBoosters = 4;
+
+   std::vector<IntEbmType> binnedData(2 * k_cSamples);
+   std::vector<FloatEbmType> targets(k_cSamples);
+   for(IntEbmType iSample = 0; iSample < k_cSamples; ++iSample) {
+      binnedData[iSample] = (iSample * 7 + iSample / 13) % 9;
+      binnedData[k_cSamples + iSample] = (iSample * 5 + iSample / 11) % 4;
+      targets[iSample] = static_cast<FloatEbmType>((iSample * 11 + iSample / 3) % 17);
+   }
+
+   std::atomic<bool> bExpectedDone(false);
+   std::vector<FloatEbmType> expectedMetrics;
+   CHECK(0 == SetThreadCount(4));
+   BoostForThreadCountChanges(&binnedData, &targets, 1, &expectedMetrics, &bExpectedDone);
+   CHECK(FloatEbmType { 0 } <= expectedMetrics[0]);
+
+   std::atomic<bool> bDone(false);
+   std::vector<FloatEbmType> metrics;
+   std::thread boostThread(BoostForThreadCountChanges, &binnedData, &targets, k_cBoosters, &metrics, &bDone);
+   // stopping the workers while they run tasks, and from two threads at once, must neither crash nor change the 
+   // results since the threads that post jobs finish any work the exiting workers leave behind
+   size_t cFailuresOther = 0;
+   std::thread changeThread(ChangeThreadCounts, size_t { 3 }, &bDone, &cFailuresOther);
+   size_t cFailures = 0;
+   ChangeThreadCounts(0, &bDone, &cFailures);
+   changeThread.join();
+   boostThread.join();
+
+   CHECK(0 == cFailures);
+   CHECK(0 == cFailuresOther);
+   CHECK(k_cBoosters == metrics.size());
+   for(const FloatEbmType metric : metrics) {
+      CHECK(0 == memcmp(&expectedMetrics[0], &metric, sizeof(metric)));
+   }
+
+   CHECK(0 == SetThreadCount(0));
+   CHECK(1 <= GetThreadCount());
+}
+
+static std::thread::id g_idThreadCountTest;
+static std::atomic<size_t> g_cSetThreadCountFromPool(0);
+static std::atomic<size_t> g_cSetThreadCountFromPoolAccepted(0);
+
+static void EBM_NATIVE_CALLING_CONVENTION SetThreadCountFromPool(TraceEbmType traceLevel, const char * message) {
+   UNUSED(traceLevel);
+   UNUSED(message);
+   // SetThreadCount logs too, so don't call it again from its own messages
+   static thread_local bool t_bInside = false;
+   if(!t_bInside && std::this_thread::get_id() != g_idThreadCountTest) {
+      t_bInside = true;
+      ++g_cSetThreadCountFromPool;
+      if(0 == SetThreadCount(2)) {
+         ++g_cSetThreadCountFromPoolAccepted;
+      }
+      t_bInside = false;
+   }
+}
+
+TEST_CASE("SetThreadCount, called on a pool thread, return error") {
+   // enough samples and inner bags that the pool threads bin some of the inner bags
+   constexpr IntEbmType k_cSamples = 40000;
+
+   std::vector<IntEbmType> binnedData(2 * k_cSamples);
+   std::vector<FloatEbmType> targets(k_cSamples);
+   for(IntEbmType iSample = 0; iSample < k_cSamples; ++iSample) {
+      binnedData[iSample] = (iSample * 7 + iSample / 13) % 9;
+      binnedData[k_cSamples + iSample] = (iSample * 5 + iSample / 11) % 4;
+      targets[iSample] = static_cast<FloatEbmType>((iSample * 11 + iSample / 3) % 17);
+   }
+   const std::vector<FloatEbmType> predictorScores(k_cSamples, FloatEbmType { 0 });
+   const BoolEbmType featuresCategorical[] = { EBM_FALSE, EBM_FALSE };
+   const IntEbmType featuresBinCount[] = { 9, 4 };
+   const IntEbmType featureGroupsFeatureCount[] = { 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] = { 0, 0, 1 };
+
+   CHECK(0 == SetThreadCount(4));
+   BoosterHandle booster = CreateRegressionBooster(
+      k_randomSeed, 2, featuresCategorical, featuresBinCount, 2, featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes, k_cSamples, &binnedData[0], &targets[0], nullptr, &predictorScores[0],
+      k_cSamples, &binnedData[0], &targets[0], nullptr, &predictorScores[0], 4, nullptr
+   );
+   CHECK(nullptr != booster);
+
+   g_idThreadCountTest = std::this_thread::get_id();
+   g_cSetThreadCountFromPool = 0;
+   g_cSetThreadCountFromPoolAccepted = 0;
+   g_pLogMessageHook = &SetThreadCountFromPool;
+   // the pool threads only join a step if they wake up before the calling thread finishes it, so keep boosting until
+   // they've logged something
+   for(size_t iStep = 0; iStep < 1000 && 0 == g_cSetThreadCountFromPool; ++iStep) {
+      FloatEbmType metric;
+      CHECK(0 == BoostingStep(
+         booster,
+         static_cast<IntEbmType>(iStep % 2),
+         GenerateUpdateOptions_Default,
+         k_learningRateDefault,
+         k_countSamplesRequiredForChildSplitMinDefault,
+         &k_leavesMaxDefault[0],
+         &metric
+      ));
+   }
+   g_pLogMessageHook = nullptr;
+   FreeBooster(booster);
+
+   CHECK(0 != g_cSetThreadCountFromPool);
+   CHECK(0 == g_cSetThreadCountFromPoolAccepted);
+   CHECK(4 == GetThreadCount());
+
+   CHECK(0 == SetThreadCount(0));
+}
+
+static void CheckBoostingSameForEveryCpuVariant(
+   TestCaseHidden & testCaseHidden,
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const ResidualStorageType residualStorage
+) {
+   constexpr IntEbmType k_cSamples = 20000;
+   constexpr size_t k_cRounds = 3;
+
+   const BoolEbmType featuresCategorical[] = { EBM_FALSE, EBM_FALSE };
+   const IntEbmType featuresBinCount[] = { 9, 300 };
+   const IntEbmType featureGroupsFeatureCount[] = { 1, 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] = { 0, 1, 0, 1 };
+   constexpr IntEbmType cFeatureGroups = 3;
+   const size_t cScores = k_learningTypeRegression == learningTypeOrCountTargetClasses || 2 == learningTypeOrCountTargetClasses ?
+      size_t { 1 } : static_cast<size_t>(learningTypeOrCountTargetClasses);
+
+   std::vector<IntEbmType> binnedData(2 * k_cSamples);
+   std::vector<IntEbmType> targetsClassification(k_cSamples);
+   std::vector<FloatEbmType> targetsRegression(k_cSamples);
+   for(IntEbmType iSample = 0; iSample < k_cSamples; ++iSample) {
+      binnedData[iSample] = (iSample * 7 + iSample / 13) % featuresBinCount[0];
+      binnedData[k_cSamples + iSample] = (iSample * 5 + iSample / 11) % featuresBinCount[1];
+      if(k_learningTypeRegression != learningTypeOrCountTargetClasses) {
+         targetsClassification[iSample] = (iSample * 11 + iSample / 3) % learningTypeOrCountTargetClasses;
+      }
+      targetsRegression[iSample] = static_cast<FloatEbmType>((iSample * 13) % 11) - FloatEbmType { 5 };
+   }
+   // with a single score, every 101st one reaches past the points where the approximate exp underflows and overflows.
+   // Softmax doesn't keep its residuals balanced that far out, which the multiclass debug checks catch
+   std::vector<FloatEbmType> predictorScores(cScores * k_cSamples);
+   for(size_t iScore = 0; iScore < predictorScores.size(); ++iScore) {
+      const FloatEbmType score = static_cast<FloatEbmType>(static_cast<IntEbmType>(iScore % 23) - 11) * FloatEbmType { 0.5 };
+      predictorScores[iScore] = 1 == cScores && 0 == iScore % 101 ? score * FloatEbmType { 40 } : score;
+   }
+
+   const CpuVariantType cpuVariantBest = GetCpuVariant();
+   CHECK(CpuVariant_Generic <= cpuVariantBest);
+   CHECK(cpuVariantBest <= CpuVariant_AVX512);
+
+   std::vector<FloatEbmType> firstMetrics;
+   std::vector<FloatEbmType> firstModel;
+   for(CpuVariantType cpuVariant = CpuVariant_Generic; cpuVariant <= cpuVariantBest; ++cpuVariant) {
+      CHECK(0 == SetCpuVariant(cpuVariant));
+      CHECK(cpuVariant == GetCpuVariant());
+
+      BoosterHandle booster;
+      if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+         booster = CreateRegressionBoosterWithStorage(
+            k_randomSeed, 2, featuresCategorical, featuresBinCount, cFeatureGroups, featureGroupsFeatureCount,
+            featureGroupsFeatureIndexes, k_cSamples, &binnedData[0], &targetsRegression[0], nullptr,
+            &predictorScores[0], k_cSamples, &binnedData[0], &targetsRegression[0], nullptr, &predictorScores[0],
+            2, nullptr, residualStorage
+         );
+      } else {
+         booster = CreateClassificationBoosterWithStorage(
+            k_randomSeed, learningTypeOrCountTargetClasses, 2, featuresCategorical, featuresBinCount, cFeatureGroups,
+            featureGroupsFeatureCount, featureGroupsFeatureIndexes, k_cSamples, &binnedData[0],
+            &targetsClassification[0], nullptr, &predictorScores[0], k_cSamples, &binnedData[0],
+            &targetsClassification[0], nullptr, &predictorScores[0], 2, nullptr, residualStorage
+         );
+      }
+      CHECK(nullptr != booster);
+
+      std::vector<FloatEbmType> metrics;
+      for(size_t iRound = 0; iRound < k_cRounds; ++iRound) {
+         for(IntEbmType iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+            FloatEbmType metric = FloatEbmType { 0 };
+            CHECK(0 == BoostingStep(
+               booster,
+               iFeatureGroup,
+               GenerateUpdateOptions_Default,
+               k_learningRateDefault,
+               k_countSamplesRequiredForChildSplitMinDefault,
+               &k_leavesMaxDefault[0],
+               &metric
+            ));
+            metrics.push_back(metric);
+         }
+      }
+      const FloatEbmType * const aModel = GetCurrentModelFeatureGroup(booster, 2);
+      const std::vector<FloatEbmType> model(aModel, aModel + featuresBinCount[0] * featuresBinCount[1] * cScores);
+      FreeBooster(booster);
+
+      if(firstMetrics.empty()) {
+         firstMetrics = metrics;
+         firstModel = model;
+      } else {
+         CHECK(0 == memcmp(&firstMetrics[0], &metrics[0], sizeof(metrics[0]) * metrics.size()));
+         CHECK(0 == memcmp(&firstModel[0], &model[0], sizeof(model[0]) * model.size()));
+      }
+   }
+
+   CHECK(0 != SetCpuVariant(cpuVariantBest + 1));
+   CHECK(0 != SetCpuVariant(-1));
+   CHECK(cpuVariantBest == GetCpuVariant());
+}
+
+TEST_CASE("SetCpuVariant, boosting gives bitwise identical results for every CPU variant, regression") {
+   CheckBoostingSameForEveryCpuVariant(testCaseHidden, k_learningTypeRegression, ResidualStorage_Float64);
+}
+
+TEST_CASE("SetCpuVariant, boosting gives bitwise identical results for every CPU variant, binary") {
+   CheckBoostingSameForEveryCpuVariant(testCaseHidden, 2, ResidualStorage_Float64);
+}
+
+TEST_CASE("SetCpuVariant, boosting gives bitwise identical results for every CPU variant, multiclass") {
+   CheckBoostingSameForEveryCpuVariant(testCaseHidden, 3, ResidualStorage_Float64);
+}
+
+TEST_CASE("SetCpuVariant, float32 residual storage gives bitwise identical results for every CPU variant, regression") {
+   CheckBoostingSameForEveryCpuVariant(testCaseHidden, k_learningTypeRegression, ResidualStorage_Float32);
+}
+
+TEST_CASE("SetCpuVariant, float32 residual storage gives bitwise identical results for every CPU variant, binary") {
+   CheckBoostingSameForEveryCpuVariant(testCaseHidden, 2, ResidualStorage_Float32);
+}
+
+TEST_CASE("SetCpuVariant, float32 residual storage gives bitwise identical results for every CPU variant, multiclass") {
+   CheckBoostingSameForEveryCpuVariant(testCaseHidden, 3, ResidualStorage_Float32);
+}
+
+TEST_CASE("SetCpuVariant, binary residuals and log loss at extreme scores are bitwise identical for every CPU variant") {
+   // the vector exp and log have to match the scalar ones in every lane, including at the boundaries of each special 
+   // case, so start each sample from one of these scores.  The validation metric holds the log loss of every sample
+   // and the model holds the sums of their residuals
+   constexpr FloatEbmType k_expUnderflowPoint = FloatEbmType { -87.25 };
+   constexpr FloatEbmType k_expOverflowPoint = FloatEbmType { 88.5 };
+   const FloatEbmType specialScores[] = {
+      std::numeric_limits<FloatEbmType>::max(),
+      std::numeric_limits<FloatEbmType>::lowest(),
+      std::numeric_limits<FloatEbmType>::denorm_min(),
+      -std::numeric_limits<FloatEbmType>::denorm_min(),
+      FloatEbmType { 0 },
+      -FloatEbmType { 0 },
+      FloatEbmType { 1 },
+      FloatEbmType { -1 },
+      FloatEbmType { 2 },
+      FloatEbmType { std::numeric_limits<float>::max() },
+      std::nextafter(FloatEbmType { std::numeric_limits<float>::max() }, std::numeric_limits<FloatEbmType>::infinity()),
+      std::nextafter(FloatEbmType { std::numeric_limits<float>::max() }, FloatEbmType { 0 }),
+      FloatEbmType { std::numeric_limits<float>::min() },
+      FloatEbmType { std::numeric_limits<float>::denorm_min() },
+      k_expUnderflowPoint,
+      std::nextafter(k_expUnderflowPoint, -std::numeric_limits<FloatEbmType>::infinity()),
+      std::nextafter(k_expUnderflowPoint, std::numeric_limits<FloatEbmType>::infinity()),
+      k_expOverflowPoint,
+      std::nextafter(k_expOverflowPoint, -std::numeric_limits<FloatEbmType>::infinity()),
+      std::nextafter(k_expOverflowPoint, std::numeric_limits<FloatEbmType>::infinity()),
+   };
+   constexpr size_t k_cSpecialScores = sizeof(specialScores) / sizeof(specialScores[0]);
+   constexpr size_t k_cRandomScores = 4000;
+
+   // two thirds of the random scores cover the logits we see in boosting, and the rest cover every magnitude
+   std::vector<FloatEbmType> scores(specialScores, specialScores + k_cSpecialScores);
+   std::mt19937 testRandom(52);
+   std::uniform_real_distribution<FloatEbmType> logitDistribution(FloatEbmType { -10 }, FloatEbmType { 10 });
+   std::uniform_real_distribution<FloatEbmType> wideLogitDistribution(FloatEbmType { -100 }, FloatEbmType { 100 });
+   std::uniform_real_distribution<FloatEbmType> exponentDistribution(FloatEbmType { -300 }, FloatEbmType { 300 });
+   for(size_t iScore = 0; iScore < k_cRandomScores; ++iScore) {
+      if(1 == iScore % 3) {
+         scores.push_back(logitDistribution(testRandom));
+      } else if(2 == iScore % 3) {
+         scores.push_back(wideLogitDistribution(testRandom));
+      } else {
+         const FloatEbmType magnitude = std::pow(FloatEbmType { 10 }, exponentDistribution(testRandom));
+         scores.push_back(0 == iScore % 2 ? magnitude : -magnitude);
+      }
+   }
+   // a huge log loss would swamp the small ones in the metric, so boost groups of scores with similar magnitudes
+   std::sort(scores.begin(), scores.end(), [](const FloatEbmType score1, const FloatEbmType score2) {
+      return std::abs(score1) < std::abs(score2);
+   });
+
+   // the groups are a multiple of every SIMD width, and each sample gets its own bin in the feature
+   constexpr IntEbmType k_cSamplesPerGroup = 64;
+   const BoolEbmType featuresCategorical[] = { EBM_FALSE };
+   const IntEbmType featuresBinCount[] = { k_cSamplesPerGroup };
+   const IntEbmType featureGroupsFeatureCount[] = { 1 };
+   const IntEbmType featureGroupsFeatureIndexes[] = { 0 };
+   std::vector<IntEbmType> binnedData(k_cSamplesPerGroup);
+   for(IntEbmType iSample = 0; iSample < k_cSamplesPerGroup; ++iSample) {
+      binnedData[iSample] = iSample;
+   }
+
+   const CpuVariantType cpuVariantBest = GetCpuVariant();
+   for(size_t iBoost = 0; iBoost < (scores.size() + k_cSamplesPerGroup - 1) / k_cSamplesPerGroup * 2; ++iBoost) {
+      // the log loss of a wrong prediction is about as large as the score and would swamp the log loss of the right 
+      // ones, so we boost each group once with every prediction right and once with every prediction wrong
+      const size_t iGroupFirst = iBoost / 2 * k_cSamplesPerGroup;
+      const bool bPredictionsRight = 0 == iBoost % 2;
+      std::vector<FloatEbmType> predictorScores(k_cSamplesPerGroup);
+      std::vector<IntEbmType> targets(k_cSamplesPerGroup);
+      for(size_t iSample = 0; iSample < k_cSamplesPerGroup; ++iSample) {
+         // pad the last group by wrapping around to the smallest scores
+         predictorScores[iSample] = scores[(iGroupFirst + iSample) % scores.size()];
+         targets[iSample] = (FloatEbmType { 0 } < predictorScores[iSample]) == bPredictionsRight ? 1 : 0;
+      }
+
+      FloatEbmType firstMetric = FloatEbmType { 0 };
+      std::vector<FloatEbmType> firstModel;
+      for(CpuVariantType cpuVariant = CpuVariant_Generic; cpuVariant <= cpuVariantBest; ++cpuVariant) {
+         CHECK(0 == SetCpuVariant(cpuVariant));
+
+         BoosterHandle booster = CreateClassificationBooster(
+            k_randomSeed, 2, 1, featuresCategorical, featuresBinCount, 1, featureGroupsFeatureCount,
+            featureGroupsFeatureIndexes, k_cSamplesPerGroup, &binnedData[0], &targets[0], nullptr, &predictorScores[0],
+            k_cSamplesPerGroup, &binnedData[0], &targets[0], nullptr, &predictorScores[0], 0, nullptr
+         );
+         CHECK(nullptr != booster);
+
+         FloatEbmType metric = FloatEbmType { 0 };
+         CHECK(0 == BoostingStep(
+            booster,
+            0,
+            GenerateUpdateOptions_Default,
+            k_learningRateDefault,
+            1,
+            &k_leavesMaxDefault[0],
+            &metric
+         ));
+         const FloatEbmType * const aModel = GetCurrentModelFeatureGroup(booster, 0);
+         const std::vector<FloatEbmType> model(aModel, aModel + k_cSamplesPerGroup);
+         FreeBooster(booster);
+
+         if(CpuVariant_Generic == cpuVariant) {
+            firstMetric = metric;
+            firstModel = model;
+         } else {
+            CHECK(0 == memcmp(&firstMetric, &metric, sizeof(metric)));
+            CHECK(0 == memcmp(&firstModel[0], &model[0], sizeof(model[0]) * model.size()));
+         }
+      }
+   }
+   CHECK(0 == SetCpuVariant(cpuVariantBest));
+}
+
+// boosts the same data with float64 and float32 residual storage, and returns the metrics of every step and the final
+// pair model of each in metrics[0] and models[0] for float64 and metrics[1] and models[1] for float32
+static void BoostWithEachResidualStorage(
+   TestCaseHidden & testCaseHidden,
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const size_t cRounds,
+   std::vector<FloatEbmType> metrics[2],
+   std::vector<FloatEbmType> models[2]
+) {
+   constexpr IntEbmType k_cSamples = 5000;
+
+   const BoolEbmType featuresCategorical[] = { EBM_FALSE, EBM_FALSE };
+   const IntEbmType featuresBinCount[] = { 9, 7 };
+   const IntEbmType featureGroupsFeatureCount[] = { 1, 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] = { 0, 1, 0, 1 };
+   constexpr IntEbmType cFeatureGroups = 3;
+   const size_t cScores = k_learningTypeRegression == learningTypeOrCountTargetClasses || 2 == learningTypeOrCountTargetClasses ?
+      size_t { 1 } : static_cast<size_t>(learningTypeOrCountTargetClasses);
+
+   std::vector<IntEbmType> binnedData(2 * k_cSamples);
+   std::vector<IntEbmType> targetsClassification(k_cSamples);
+   std::vector<FloatEbmType> targetsRegression(k_cSamples);
+   for(IntEbmType iSample = 0; iSample < k_cSamples; ++iSample) {
+      binnedData[iSample] = (iSample * 7 + iSample / 13) % featuresBinCount[0];
+      binnedData[k_cSamples + iSample] = (iSample * 5 + iSample / 11) % featuresBinCount[1];
+      if(k_learningTypeRegression != learningTypeOrCountTargetClasses) {
+         targetsClassification[iSample] = (binnedData[iSample] + iSample / 3) % 5 < 2 ? 
+            0 : (iSample * 11 + binnedData[k_cSamples + iSample]) % learningTypeOrCountTargetClasses;
+      }
+      targetsRegression[iSample] = static_cast<FloatEbmType>(binnedData[iSample] * 3 - binnedData[k_cSamples + iSample]) + 
+         static_cast<FloatEbmType>((iSample * 13) % 11) * FloatEbmType { 0.1 };
+   }
+   std::vector<FloatEbmType> predictorScores(cScores * k_cSamples);
+   for(size_t iScore = 0; iScore < predictorScores.size(); ++iScore) {
+      predictorScores[iScore] = static_cast<FloatEbmType>(static_cast<IntEbmType>(iScore % 23) - 11) * FloatEbmType { 0.1 };
+   }
+
+   const ResidualStorageType residualStorages[] = { ResidualStorage_Float64, ResidualStorage_Float32 };
+   for(size_t iStorage = 0; iStorage < 2; ++iStorage) {
+      BoosterHandle booster;
+      if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+         booster = CreateRegressionBoosterWithStorage(
+            k_randomSeed, 2, featuresCategorical, featuresBinCount, cFeatureGroups, featureGroupsFeatureCount,
+            featureGroupsFeatureIndexes, k_cSamples, &binnedData[0], &targetsRegression[0], nullptr,
+            &predictorScores[0], k_cSamples, &binnedData[0], &targetsRegression[0], nullptr, &predictorScores[0],
+            0, nullptr, residualStorages[iStorage]
+         );
+      } else {
+         booster = CreateClassificationBoosterWithStorage(
+            k_randomSeed, learningTypeOrCountTargetClasses, 2, featuresCategorical, featuresBinCount, cFeatureGroups,
+            featureGroupsFeatureCount, featureGroupsFeatureIndexes, k_cSamples, &binnedData[0],
+            &targetsClassification[0], nullptr, &predictorScores[0], k_cSamples, &binnedData[0],
+            &targetsClassification[0], nullptr, &predictorScores[0], 0, nullptr, residualStorages[iStorage]
+         );
+      }
+      CHECK(nullptr != booster);
+
+      for(size_t iRound = 0; iRound < cRounds; ++iRound) {
+         for(IntEbmType iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+            FloatEbmType metric = FloatEbmType { 0 };
+            CHECK(0 == BoostingStep(
+               booster,
+               iFeatureGroup,
+               GenerateUpdateOptions_Default,
+               k_learningRateDefault,
+               k_countSamplesRequiredForChildSplitMinDefault,
+               &k_leavesMaxDefault[0],
+               &metric
+            ));
+            metrics[iStorage].push_back(metric);
+         }
+      }
+      const FloatEbmType * const aModel = GetCurrentModelFeatureGroup(booster, 2);
+      models[iStorage].assign(aModel, aModel + featuresBinCount[0] * featuresBinCount[1] * cScores);
+      FreeBooster(booster);
+   }
+}
+
+static void CheckFloat32StorageCloseToFloat64(
+   TestCaseHidden & testCaseHidden,
+   const ptrdiff_t learningTypeOrCountTargetClasses
+) {
+   std::vector<FloatEbmType> metrics[2];
+   std::vector<FloatEbmType> models[2];
+   BoostWithEachResidualStorage(testCaseHidden, learningTypeOrCountTargetClasses, 20, metrics, models);
+
+   // every residual and score is rounded to float, which moves them by a relative 2^-24 at most, and nothing sums in float
+   for(size_t iMetric = 0; iMetric < metrics[0].size(); ++iMetric) {
+      CHECK_APPROX_TOLERANCE(metrics[1][iMetric], metrics[0][iMetric], 1e-5);
+   }
+   for(size_t iModel = 0; iModel < models[0].size(); ++iModel) {
+      CHECK_APPROX_TOLERANCE(models[1][iModel], models[0][iModel], 1e-5);
+   }
+}
+
+TEST_CASE("float32 residual storage boosts close to float64, regression") {
+   CheckFloat32StorageCloseToFloat64(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("float32 residual storage boosts close to float64, binary") {
+   CheckFloat32StorageCloseToFloat64(testCaseHidden, 2);
+}
+
+TEST_CASE("float32 residual storage boosts close to float64, multiclass") {
+   CheckFloat32StorageCloseToFloat64(testCaseHidden, 3);
+}
+
+static void CheckFloat32StorageLongRunCloseToFloat64(
+   TestCaseHidden & testCaseHidden,
+   const ptrdiff_t learningTypeOrCountTargetClasses
+) {
+   std::vector<FloatEbmType> metrics[2];
+   std::vector<FloatEbmType> models[2];
+   BoostWithEachResidualStorage(testCaseHidden, learningTypeOrCountTargetClasses, 1000, metrics, models);
+
+   // Over a long run the float rounding compounds, and once the residuals get small it can tip a near tie to a 
+   // different cut, after which single model values no longer track each other to 2^-24.  The model as a whole has to 
+   // stay equivalent though, so we bound what it predicts: the validation metric of every step stays within a relative 
+   // 1e-4 of float64, and every model value stays within 1e-2 of the largest float64 model value (plus 1 so that we 
+   // don't demand more than that absolutely).  On this data the worst we see is a relative 1.2e-6 for the metric and 
+   // 3.9e-4 for the model
+   for(size_t iMetric = 0; iMetric < metrics[0].size(); ++iMetric) {
+      CHECK_APPROX_TOLERANCE(metrics[1][iMetric], metrics[0][iMetric], 1e-4);
+   }
+   FloatEbmType modelMax = FloatEbmType { 0 };
+   for(const FloatEbmType model : models[0]) {
+      modelMax = std::max(modelMax, std::abs(model));
+   }
+   for(size_t iModel = 0; iModel < models[0].size(); ++iModel) {
+      CHECK(std::abs(models[1][iModel] - models[0][iModel]) <= FloatEbmType { 1e-2 } * (FloatEbmType { 1 } + modelMax));
+   }
+}
+
+TEST_CASE("float32 residual storage boosts close to float64 over a long run, regression") {
+   CheckFloat32StorageLongRunCloseToFloat64(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("float32 residual storage boosts close to float64 over a long run, binary") {
+   CheckFloat32StorageLongRunCloseToFloat64(testCaseHidden, 2);
+}
+
+TEST_CASE("float32 residual storage boosts close to float64 over a long run, multiclass") {
+   CheckFloat32StorageLongRunCloseToFloat64(testCaseHidden, 3);
+}
+
+TEST_CASE("residual storage, unknown storage type, fails") {
+   const BoolEbmType featuresCategorical[] = { EBM_FALSE };
+   const IntEbmType featuresBinCount[] = { 2 };
+   const IntEbmType featureGroupsFeatureCount[] = { 1 };
+   const IntEbmType featureGroupsFeatureIndexes[] = { 0 };
+   const IntEbmType binnedData[] = { 0, 1 };
+   const IntEbmType targetsClassification[] = { 0, 1 };
+   const FloatEbmType targetsRegression[] = { 1, 2 };
+   const FloatEbmType predictorScores[] = { 0, 0 };
+
+   const ResidualStorageType residualStoragesBad[] = { ResidualStorage_Float32 + 1, -1 };
+   for(const ResidualStorageType residualStorage : residualStoragesBad) {
+      CHECK(nullptr == CreateRegressionBoosterWithStorage(
+         k_randomSeed, 1, featuresCategorical, featuresBinCount, 1, featureGroupsFeatureCount,
+         featureGroupsFeatureIndexes, 2, binnedData, targetsRegression, nullptr, predictorScores, 
+         2, binnedData, targetsRegression, nullptr, predictorScores, 0, nullptr, residualStorage
+      ));
+      CHECK(nullptr == CreateClassificationBoosterWithStorage(
+         k_randomSeed, 2, 1, featuresCategorical, featuresBinCount, 1, featureGroupsFeatureCount,
+         featureGroupsFeatureIndexes, 2, binnedData, targetsClassification, nullptr, predictorScores, 
+         2, binnedData, targetsClassification, nullptr, predictorScores, 0, nullptr, residualStorage
+      ));
+   }
+}
+
+static void CheckBoostCyclicMatchesBoostingSteps(
+   TestCaseHidden & testCaseHidden,
+   const IntEbmType countRoundsMax,
+   const IntEbmType countEarlyStoppingRounds,
+   const FloatEbmType earlyStoppingTolerance,
+   const IntEbmType countRoundsExpectedMax
+) {
+   constexpr IntEbmType k_cSamples = 200;
+   const BoolEbmType featuresCategorical[] = { EBM_FALSE, EBM_FALSE };
+   const IntEbmType featuresBinCount[] = { 5, 3 };
+   const IntEbmType featureGroupsFeatureCount[] = { 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] = { 0, 0, 1 };
+   constexpr IntEbmType cFeatureGroups = 2;
+
+   std::vector<IntEbmType> binnedData(2 * k_cSamples);
+   std::vector<IntEbmType> targets(k_cSamples);
+   for(IntEbmType iSample = 0; iSample < k_cSamples; ++iSample) {
+      binnedData[iSample] = (iSample * 7 + iSample / 13) % featuresBinCount[0];
+      binnedData[k_cSamples + iSample] = (iSample * 5 + iSample / 11) % featuresBinCount[1];
+      targets[iSample] = (iSample * 11 + iSample / 3) % 2;
+   }
+   const std::vector<FloatEbmType> predictorScores(k_cSamples, FloatEbmType { 0 });
+
+   BoosterHandle boosterCyclic = CreateClassificationBooster(
+      k_randomSeed, 2, 2, featuresCategorical, featuresBinCount, cFeatureGroups, featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes, k_cSamples, &binnedData[0], &targets[0], nullptr, &predictorScores[0],
+      k_cSamples, &binnedData[0], &targets[0], nullptr, &predictorScores[0], 2, nullptr
+   );
+   BoosterHandle boosterSteps = CreateClassificationBooster(
+      k_randomSeed, 2, 2, featuresCategorical, featuresBinCount, cFeatureGroups, featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes, k_cSamples, &binnedData[0], &targets[0], nullptr, &predictorScores[0],
+      k_cSamples, &binnedData[0], &targets[0], nullptr, &predictorScores[0], 2, nullptr
+   );
+   CHECK(nullptr != boosterCyclic);
+   CHECK(nullptr != boosterSteps);
+
+   IntEbmType countRounds = -1;
+   FloatEbmType bestMetric = FloatEbmType { -1 };
+   CHECK(0 == BoostCyclic(
+      boosterCyclic,
+      GenerateUpdateOptions_Default,
+      k_learningRateDefault,
+      k_countSamplesRequiredForChildSplitMinDefault,
+      &k_leavesMaxDefault[0],
+      countRoundsMax,
+      countEarlyStoppingRounds,
+      earlyStoppingTolerance,
+      &countRounds,
+      &bestMetric
+   ));
+   CHECK(1 <= countRounds);
+   CHECK(countRounds <= countRoundsExpectedMax);
+
+   // the same early stopping that the Python and R packages used to do around BoostingStep
+   IntEbmType countRoundsSteps = 0;
+   FloatEbmType bestMetricSteps = std::numeric_limits<FloatEbmType>::infinity();
+   FloatEbmType baselineMetric = std::numeric_limits<FloatEbmType>::infinity();
+   IntEbmType cRoundsWithoutChange = 0;
+   while(countRoundsSteps < countRoundsMax) {
+      ++countRoundsSteps;
+      for(IntEbmType iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         FloatEbmType metric = FloatEbmType { 0 };
+         CHECK(0 == BoostingStep(
+            boosterSteps,
+            iFeatureGroup,
+            GenerateUpdateOptions_Default,
+            k_learningRateDefault,
+            k_countSamplesRequiredForChildSplitMinDefault,
+            &k_leavesMaxDefault[0],
+            &metric
+         ));
+         bestMetricSteps = std::min(bestMetricSteps, metric);
+      }
+      if(0 == cRoundsWithoutChange) {
+         baselineMetric = bestMetricSteps;
+      }
+      if(bestMetricSteps + earlyStoppingTolerance < baselineMetric) {
+         cRoundsWithoutChange = 0;
+      } else {
+         ++cRoundsWithoutChange;
+      }
+      if(0 <= countEarlyStoppingRounds && countEarlyStoppingRounds <= cRoundsWithoutChange) {
+         break;
+      }
+   }
+   CHECK(countRoundsSteps == countRounds);
+   CHECK(0 == memcmp(&bestMetricSteps, &bestMetric, sizeof(bestMetric)));
+
+   const FloatEbmType * const aModelCyclic = GetBestModelFeatureGroup(boosterCyclic, 1);
+   const FloatEbmType * const aModelSteps = GetBestModelFeatureGroup(boosterSteps, 1);
+   CHECK(0 == memcmp(aModelCyclic, aModelSteps, sizeof(*aModelCyclic) * featuresBinCount[0] * featuresBinCount[1]));
+
+   FreeBooster(boosterCyclic);
+   FreeBooster(boosterSteps);
+}
+
+TEST_CASE("BoostCyclic, early stopping, same as calling BoostingStep") {
+   CheckBoostCyclicMatchesBoostingSteps(testCaseHidden, 1000, 3, FloatEbmType { 1e-4 }, 200);
+}
+
+TEST_CASE("BoostCyclic, early stopping disabled, runs every round") {
+   CheckBoostCyclicMatchesBoostingSteps(testCaseHidden, 25, -1, FloatEbmType { 0 }, 25);
+}
+
+TEST_CASE("BoostCyclic, nullptr boosterHandle, returns error") {
+   IntEbmType countRounds = -1;
+   FloatEbmType bestMetric = FloatEbmType { -1 };
+   CHECK(0 != BoostCyclic(
+      nullptr,
+      GenerateUpdateOptions_Default,
+      k_learningRateDefault,
+      k_countSamplesRequiredForChildSplitMinDefault,
+      &k_leavesMaxDefault[0],
+      10,
+      -1,
+      FloatEbmType { 0 },
+      &countRounds,
+      &bestMetric
+   ));
+}
+
+static void CheckBoostJacobiSameForAnyThreadCount(
+   TestCaseHidden & testCaseHidden,
+   const IntEbmType countFeatureGroupsPerBlock,
+   const FloatEbmType damping
+) {
+   constexpr IntEbmType k_cSamples = 300;
+   const BoolEbmType featuresCategorical[] = { EBM_FALSE, EBM_FALSE, EBM_FALSE };
+   const IntEbmType featuresBinCount[] = { 5, 3, 4 };
+   const IntEbmType featureGroupsFeatureCount[] = { 1, 1, 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] = { 0, 1, 2, 0, 2 };
+   constexpr IntEbmType cFeatureGroups = 4;
+   const size_t acTensorItems[] = { 5, 3, 4, 20 };
+
+   std::vector<IntEbmType> binnedData(3 * k_cSamples);
+   std::vector<IntEbmType> targets(k_cSamples);
+   for(IntEbmType iSample = 0; iSample < k_cSamples; ++iSample) {
+      binnedData[iSample] = (iSample * 7 + iSample / 13) % featuresBinCount[0];
+      binnedData[k_cSamples + iSample] = (iSample * 5 + iSample / 11) % featuresBinCount[1];
+      binnedData[2 * k_cSamples + iSample] = (iSample * 3 + iSample / 7) % featuresBinCount[2];
+      targets[iSample] = (binnedData[iSample] + binnedData[2 * k_cSamples + iSample] + iSample / 17) % 2;
+   }
+   const std::vector<FloatEbmType> predictorScores(k_cSamples, FloatEbmType { 0 });
+
+   BoosterHandle boosters[3];
+   FloatEbmType bestMetrics[3];
+   const IntEbmType threadCounts[] = { 1, 3, 0 };
+   for(size_t iBooster = 0; iBooster < 3; ++iBooster) {
+      boosters[iBooster] = CreateClassificationBooster(
+         k_randomSeed, 2, 3, featuresCategorical, featuresBinCount, cFeatureGroups, featureGroupsFeatureCount,
+         featureGroupsFeatureIndexes, k_cSamples, &binnedData[0], &targets[0], nullptr, &predictorScores[0],
+         k_cSamples, &binnedData[0], &targets[0], nullptr, &predictorScores[0], 2, nullptr
+      );
+      CHECK(nullptr != boosters[iBooster]);
+
+      IntEbmType countRounds = -1;
+      bestMetrics[iBooster] = FloatEbmType { -1 };
+      CHECK(0 == BoostJacobi(
+         boosters[iBooster],
+         threadCounts[iBooster],
+         countFeatureGroupsPerBlock,
+         damping,
+         GenerateUpdateOptions_Default,
+         k_learningRateDefault,
+         k_countSamplesRequiredForChildSplitMinDefault,
+         &k_leavesMaxDefault[0],
+         30,
+         -1,
+         FloatEbmType { 0 },
+         &countRounds,
+         &bestMetrics[iBooster]
+      ));
+      CHECK(30 == countRounds);
+      // better than predicting 50% for every sample
+      CHECK(bestMetrics[iBooster] < FloatEbmType { 0.69 });
+   }
+
+   for(size_t iBooster = 1; iBooster < 3; ++iBooster) {
+      CHECK(0 == memcmp(&bestMetrics[0], &bestMetrics[iBooster], sizeof(bestMetrics[0])));
+      for(IntEbmType iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         const FloatEbmType * const aModel0 = GetCurrentModelFeatureGroup(boosters[0], iFeatureGroup);
+         const FloatEbmType * const aModel = GetCurrentModelFeatureGroup(boosters[iBooster], iFeatureGroup);
+         CHECK(0 == memcmp(aModel0, aModel, sizeof(*aModel0) * acTensorItems[iFeatureGroup]));
+      }
+   }
+
+   for(size_t iBooster = 0; iBooster < 3; ++iBooster) {
+      FreeBooster(boosters[iBooster]);
+   }
+}
+
+TEST_CASE("BoostJacobi, all feature groups in one block, same model for any thread count") {
+   CheckBoostJacobiSameForAnyThreadCount(testCaseHidden, 0, FloatEbmType { 0.5 });
+}
+
+TEST_CASE("BoostJacobi, blocks of 3 feature groups, same model for any thread count") {
+   CheckBoostJacobiSameForAnyThreadCount(testCaseHidden, 3, FloatEbmType { 1 });
+}
+
+TEST_CASE("BoostJacobi, nullptr boosterHandle, returns error") {
+   IntEbmType countRounds = -1;
+   FloatEbmType bestMetric = FloatEbmType { -1 };
+   CHECK(0 != BoostJacobi(
+      nullptr,
+      0,
+      0,
+      FloatEbmType { 1 },
+      GenerateUpdateOptions_Default,
+      k_learningRateDefault,
+      k_countSamplesRequiredForChildSplitMinDefault,
+      &k_leavesMaxDefault[0],
+      10,
+      -1,
+      FloatEbmType { 0 },
+      &countRounds,
+      &bestMetric
+   ));
+   CHECK(0 == countRounds);
+}
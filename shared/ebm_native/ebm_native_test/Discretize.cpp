@@ -62,42 +62,72 @@ TEST_CASE("Discretize, increasing lengths") {
       featureValues[11 * iCutPoint + 10] = -std::numeric_limits<FloatEbmType>::infinity();
    }
 
-   for(size_t cBinCuts = 0; cBinCuts < cBinCutsEnd; ++cBinCuts) {
-      // the first pass fills in all values, then we permute the addresses randomly, but our first and last
-      // values are fixed
-      const size_t cRemoveLow = 0 == cBinCuts % 3 ? size_t { 0 } : size_t { 1 };
-      const size_t cRemoveHigh = 0 == cBinCuts % 7 ? size_t { 0 } : size_t { 1 };
-
-      const size_t cSamples = cData - cRemoveLow - cRemoveHigh;
-      memset(singleFeatureDiscretized + cRemoveLow, 0, cSamples * sizeof(*singleFeatureDiscretized));
-      Discretize(
-         static_cast<IntEbmType>(cSamples),
-         featureValues + cRemoveLow,
-         cBinCuts,
-         binCutsLowerBoundInclusive,
-         singleFeatureDiscretized + cRemoveLow
-      );
-
-      for(size_t iCutPoint = 0; iCutPoint < cBinCutsEnd; ++iCutPoint) {
-         CHECK(singleFeatureDiscretized[11 * iCutPoint + 0] == IntEbmType { 1 });
-         CHECK(singleFeatureDiscretized[11 * iCutPoint + 1] == IntEbmType { 0 });
-
-         CHECK(singleFeatureDiscretized[11 * iCutPoint + 2] == IntEbmType { 1 });
-         CHECK(singleFeatureDiscretized[11 * iCutPoint + 3] == (size_t { 0 } == cBinCuts ? IntEbmType { 1 } : IntEbmType { 2 }));
-
-         CHECK(singleFeatureDiscretized[11 * iCutPoint + 4] == IntEbmType { 1 } + static_cast<IntEbmType>(std::min(iCutPoint, cBinCuts)));
-         CHECK(singleFeatureDiscretized[11 * iCutPoint + 5] == IntEbmType { 1 } + static_cast<IntEbmType>(std::min(iCutPoint + 1, cBinCuts)));
-         CHECK(singleFeatureDiscretized[11 * iCutPoint + 6] == IntEbmType { 1 } + static_cast<IntEbmType>(std::min(iCutPoint + 1, cBinCuts)));
-         CHECK(singleFeatureDiscretized[11 * iCutPoint + 7] == IntEbmType { 1 } + static_cast<IntEbmType>(cBinCuts));
-         CHECK(singleFeatureDiscretized[11 * iCutPoint + 8] == IntEbmType { 1 } + static_cast<IntEbmType>(cBinCuts));
-
-         CHECK(singleFeatureDiscretized[11 * iCutPoint + 9] == IntEbmType { 0 });
-         CHECK(singleFeatureDiscretized[11 * iCutPoint + 10] == IntEbmType { 1 });
+   // Discretize is built once per CPU variant, and every variant has to give us the same bins
+   const CpuVariantType cpuVariantBest = GetCpuVariant();
+   for(CpuVariantType cpuVariant = CpuVariant_Generic; cpuVariant <= cpuVariantBest; ++cpuVariant) {
+      CHECK(0 == SetCpuVariant(cpuVariant));
+      for(size_t cBinCuts = 0; cBinCuts < cBinCutsEnd; ++cBinCuts) {
+         // the first pass fills in all values, then we permute the addresses randomly, but our first and last
+         // values are fixed
+         const size_t cRemoveLow = 0 == cBinCuts % 3 ? size_t { 0 } : size_t { 1 };
+         const size_t cRemoveHigh = 0 == cBinCuts % 7 ? size_t { 0 } : size_t { 1 };
+
+         const size_t cSamples = cData - cRemoveLow - cRemoveHigh;
+         memset(singleFeatureDiscretized + cRemoveLow, 0, cSamples * sizeof(*singleFeatureDiscretized));
+         Discretize(
+            static_cast<IntEbmType>(cSamples),
+            featureValues + cRemoveLow,
+            cBinCuts,
+            binCutsLowerBoundInclusive,
+            singleFeatureDiscretized + cRemoveLow
+         );
+
+         for(size_t iCutPoint = 0; iCutPoint < cBinCutsEnd; ++iCutPoint) {
+            CHECK(singleFeatureDiscretized[11 * iCutPoint + 0] == IntEbmType { 1 });
+            CHECK(singleFeatureDiscretized[11 * iCutPoint + 1] == IntEbmType { 0 });
+
+            CHECK(singleFeatureDiscretized[11 * iCutPoint + 2] == IntEbmType { 1 });
+            CHECK(singleFeatureDiscretized[11 * iCutPoint + 3] == (size_t { 0 } == cBinCuts ? IntEbmType { 1 } : IntEbmType { 2 }));
+
+            CHECK(singleFeatureDiscretized[11 * iCutPoint + 4] == IntEbmType { 1 } + static_cast<IntEbmType>(std::min(iCutPoint, cBinCuts)));
+            CHECK(singleFeatureDiscretized[11 * iCutPoint + 5] == IntEbmType { 1 } + static_cast<IntEbmType>(std::min(iCutPoint + 1, cBinCuts)));
+            CHECK(singleFeatureDiscretized[11 * iCutPoint + 6] == IntEbmType { 1 } + static_cast<IntEbmType>(std::min(iCutPoint + 1, cBinCuts)));
+            CHECK(singleFeatureDiscretized[11 * iCutPoint + 7] == IntEbmType { 1 } + static_cast<IntEbmType>(cBinCuts));
+            CHECK(singleFeatureDiscretized[11 * iCutPoint + 8] == IntEbmType { 1 } + static_cast<IntEbmType>(cBinCuts));
+
+            CHECK(singleFeatureDiscretized[11 * iCutPoint + 9] == IntEbmType { 0 });
+            CHECK(singleFeatureDiscretized[11 * iCutPoint + 10] == IntEbmType { 1 });
+         }
       }
    }
+   CHECK(0 == SetCpuVariant(cpuVariantBest));
 
    delete[] binCutsLowerBoundInclusive;
    delete[] featureValues;
    delete[] singleFeatureDiscretized;
 }
 
+
+TEST_CASE("Softmax, binary, same for every CPU variant") {
+   constexpr size_t cSamples = 37;
+   FloatEbmType logits[cSamples];
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      logits[iSample] = static_cast<FloatEbmType>(iSample) * FloatEbmType { 1.5 } - FloatEbmType { 27 };
+   }
+   logits[0] = -std::numeric_limits<FloatEbmType>::infinity();
+   logits[1] = FloatEbmType { 0 };
+
+   const CpuVariantType cpuVariantBest = GetCpuVariant();
+   for(CpuVariantType cpuVariant = CpuVariant_Generic; cpuVariant <= cpuVariantBest; ++cpuVariant) {
+      CHECK(0 == SetCpuVariant(cpuVariant));
+      FloatEbmType probabilities[cSamples];
+      CHECK(0 == Softmax(2, static_cast<IntEbmType>(cSamples), logits, probabilities));
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         const FloatEbmType odds = std::exp(logits[iSample]);
+         CHECK(odds / (FloatEbmType { 1 } + odds) == probabilities[iSample]);
+      }
+      CHECK(FloatEbmType { 0 } == probabilities[0]);
+      CHECK(FloatEbmType { 0.5 } == probabilities[1]);
+   }
+   CHECK(0 == SetCpuVariant(cpuVariantBest));
+}
@@ -56,8 +56,13 @@ extern void FAILED(const double val, TestCaseHidden * const pTestCaseHidden, con
 #pragma optimize("", on)
 #endif // _MSC_VER
 
+LOG_MESSAGE_FUNCTION g_pLogMessageHook = nullptr;
+
 void EBM_NATIVE_CALLING_CONVENTION LogMessage(TraceEbmType traceLevel, const char * message) {
    strlen(message); // test that the string memory is accessible
+   if(nullptr != g_pLogMessageHook) {
+      (*g_pLogMessageHook)(traceLevel, message);
+   }
    if(traceLevel <= TraceLevelOff) {
       // don't display log messages during tests, but having this code here makes it easy to turn on when needed
       printf("\n%s: %s\n", GetTraceLevelString(traceLevel), message);
@@ -15,6 +15,7 @@ enum class TestPriority {
    RandomNumbers,
    SuggestGraphBounds,
    Discretize,
+   PredictScores,
    GenerateUniformBinCuts,
    GenerateWinsorizedBinCuts,
    GenerateQuantileBinCuts
@@ -44,6 +45,10 @@ constexpr inline bool AlwaysFalse() {
 
 int RegisterTestHidden(const TestCaseHidden & testCaseHidden);
 
+// when set, our log callback also calls this.  The library logs from its pool threads too, so tests can use it to call 
+// into the library from inside a parallel operation.  Set it before starting and clear it after the calls finish
+extern LOG_MESSAGE_FUNCTION g_pLogMessageHook;
+
 #define CONCATENATE_STRINGS(t1, t2) t1##t2
 #define CONCATENATE_TOKENS(t1, t2) CONCATENATE_STRINGS(t1, t2)
 #define TEST_CASE(description) \
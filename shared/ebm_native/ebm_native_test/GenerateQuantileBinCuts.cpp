@@ -1593,3 +1593,145 @@ TEST_CASE("GenerateQuantileBinCuts, chunky randomized check") {
    }
 }
 
+
+TEST_CASE("GenerateFeaturesBinCuts, every binning method, same as binning each feature") {
+   constexpr size_t cFeatures = 8;
+   constexpr size_t cSamples = 1000;
+   const BinningMethodType binningMethods[cFeatures] = {
+      BinningMethod_Quantile, BinningMethod_QuantileHumanized, BinningMethod_Uniform, BinningMethod_Winsorized,
+      BinningMethod_Quantile, BinningMethod_Uniform, BinningMethod_Winsorized, BinningMethod_QuantileHumanized
+   };
+   const IntEbmType countSamplesPerBinMin[cFeatures] = { 1, 3, 1, 1, 50, 1, 1, 2 };
+   const IntEbmType countBinCutsMax[cFeatures] = { 254, 30, 10, 20, 0, 5, 7, 100 };
+
+   std::vector<FloatEbmType> featureValues(cFeatures * cSamples);
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         FloatEbmType val = static_cast<FloatEbmType>((iSample * (2 * iFeature + 7) + iFeature) % 113) / 7.0;
+         if(0 == iSample % (11 + iFeature)) {
+            val = std::numeric_limits<FloatEbmType>::quiet_NaN();
+         } else if(0 == iSample % (37 + iFeature)) {
+            val = std::numeric_limits<FloatEbmType>::infinity();
+         } else if(0 == iSample % (41 + iFeature)) {
+            val = -std::numeric_limits<FloatEbmType>::infinity();
+         }
+         featureValues[iFeature * cSamples + iSample] = val;
+      }
+   }
+
+   size_t cBinCuts = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      cBinCuts += static_cast<size_t>(countBinCutsMax[iFeature]);
+   }
+
+   std::vector<IntEbmType> countBinCutsExpected(cFeatures);
+   std::vector<FloatEbmType> binCutsExpected(cBinCuts);
+   std::vector<IntEbmType> countMissingValuesExpected(cFeatures);
+   std::vector<FloatEbmType> minNonInfinityValueExpected(cFeatures);
+   std::vector<IntEbmType> countNegativeInfinityExpected(cFeatures);
+   std::vector<FloatEbmType> maxNonInfinityValueExpected(cFeatures);
+   std::vector<IntEbmType> countPositiveInfinityExpected(cFeatures);
+   size_t iBinCutFirst = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      countBinCutsExpected[iFeature] = countBinCutsMax[iFeature];
+      const FloatEbmType * const aFeatureValues = &featureValues[iFeature * cSamples];
+      FloatEbmType * const aBinCuts = &binCutsExpected[0] + iBinCutFirst;
+      IntEbmType ret = 0;
+      if(BinningMethod_Uniform == binningMethods[iFeature]) {
+         GenerateUniformBinCuts(
+            cSamples, aFeatureValues, &countBinCutsExpected[iFeature], aBinCuts, &countMissingValuesExpected[iFeature],
+            &minNonInfinityValueExpected[iFeature], &countNegativeInfinityExpected[iFeature],
+            &maxNonInfinityValueExpected[iFeature], &countPositiveInfinityExpected[iFeature]
+         );
+      } else if(BinningMethod_Winsorized == binningMethods[iFeature]) {
+         ret = GenerateWinsorizedBinCuts(
+            cSamples, aFeatureValues, &countBinCutsExpected[iFeature], aBinCuts, &countMissingValuesExpected[iFeature],
+            &minNonInfinityValueExpected[iFeature], &countNegativeInfinityExpected[iFeature],
+            &maxNonInfinityValueExpected[iFeature], &countPositiveInfinityExpected[iFeature]
+         );
+      } else {
+         ret = GenerateQuantileBinCuts(
+            cSamples, aFeatureValues, countSamplesPerBinMin[iFeature],
+            BinningMethod_QuantileHumanized == binningMethods[iFeature] ? EBM_TRUE : EBM_FALSE,
+            &countBinCutsExpected[iFeature], aBinCuts, &countMissingValuesExpected[iFeature],
+            &minNonInfinityValueExpected[iFeature], &countNegativeInfinityExpected[iFeature],
+            &maxNonInfinityValueExpected[iFeature], &countPositiveInfinityExpected[iFeature]
+         );
+      }
+      CHECK(0 == ret);
+      iBinCutFirst += static_cast<size_t>(countBinCutsMax[iFeature]);
+   }
+
+   for(IntEbmType countThreads : { IntEbmType { 1 }, IntEbmType { 3 }, IntEbmType { 0 } }) {
+      std::vector<IntEbmType> countBinCuts(cFeatures);
+      std::vector<FloatEbmType> binCuts(cBinCuts);
+      std::vector<IntEbmType> countMissingValues(cFeatures);
+      std::vector<FloatEbmType> minNonInfinityValue(cFeatures);
+      std::vector<IntEbmType> countNegativeInfinity(cFeatures);
+      std::vector<FloatEbmType> maxNonInfinityValue(cFeatures);
+      std::vector<IntEbmType> countPositiveInfinity(cFeatures);
+      const IntEbmType ret = GenerateFeaturesBinCuts(
+         countThreads,
+         cFeatures,
+         cSamples,
+         &featureValues[0],
+         binningMethods,
+         countSamplesPerBinMin,
+         countBinCutsMax,
+         &countBinCuts[0],
+         &binCuts[0],
+         &countMissingValues[0],
+         &minNonInfinityValue[0],
+         &countNegativeInfinity[0],
+         &maxNonInfinityValue[0],
+         &countPositiveInfinity[0]
+      );
+      CHECK(0 == ret);
+
+      iBinCutFirst = 0;
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         CHECK(countBinCutsExpected[iFeature] == countBinCuts[iFeature]);
+         CHECK(countMissingValuesExpected[iFeature] == countMissingValues[iFeature]);
+         CHECK(minNonInfinityValueExpected[iFeature] == minNonInfinityValue[iFeature]);
+         CHECK(countNegativeInfinityExpected[iFeature] == countNegativeInfinity[iFeature]);
+         CHECK(maxNonInfinityValueExpected[iFeature] == maxNonInfinityValue[iFeature]);
+         CHECK(countPositiveInfinityExpected[iFeature] == countPositiveInfinity[iFeature]);
+         if(countBinCutsExpected[iFeature] == countBinCuts[iFeature]) {
+            for(size_t iCut = 0; iCut < static_cast<size_t>(countBinCuts[iFeature]); ++iCut) {
+               CHECK(binCutsExpected[iBinCutFirst + iCut] == binCuts[iBinCutFirst + iCut]);
+            }
+         }
+         iBinCutFirst += static_cast<size_t>(countBinCutsMax[iFeature]);
+      }
+   }
+}
+
+TEST_CASE("GenerateFeaturesBinCuts, unknown binning method") {
+   const FloatEbmType featureValues[] = { 1, 2, 3, 4 };
+   const BinningMethodType binningMethods[] = { EBM_BINNING_METHOD_CAST(4) };
+   const IntEbmType countBinCutsMax[] = { 2 };
+   IntEbmType countBinCuts;
+   FloatEbmType binCuts[2];
+   IntEbmType countMissingValues;
+   FloatEbmType minNonInfinityValue;
+   IntEbmType countNegativeInfinity;
+   FloatEbmType maxNonInfinityValue;
+   IntEbmType countPositiveInfinity;
+   const IntEbmType ret = GenerateFeaturesBinCuts(
+      0,
+      1,
+      4,
+      featureValues,
+      binningMethods,
+      nullptr,
+      countBinCutsMax,
+      &countBinCuts,
+      binCuts,
+      &countMissingValues,
+      &minNonInfinityValue,
+      &countNegativeInfinity,
+      &maxNonInfinityValue,
+      &countPositiveInfinity
+   );
+   CHECK(0 != ret);
+}
@@ -135,3 +135,110 @@ TEST_CASE("FeatureGroup with one feature with one state, interaction, multiclass
 }
 
 
+TEST_CASE("CalculateInteractionScores, many pairs, same scores as CalculateInteractionScore") {
+   constexpr IntEbmType k_cSamples = 1000;
+   constexpr IntEbmType k_cFeatures = 6;
+   const BoolEbmType featuresCategorical[k_cFeatures] = { EBM_FALSE, EBM_FALSE, EBM_TRUE, EBM_FALSE, EBM_FALSE, EBM_FALSE };
+   // the last feature has only one bin, so its pairs score zero
+   const IntEbmType featuresBinCount[k_cFeatures] = { 3, 5, 4, 7, 2, 1 };
+
+   std::vector<IntEbmType> binnedData(k_cFeatures * k_cSamples);
+   std::vector<FloatEbmType> targets(k_cSamples);
+   for(IntEbmType iSample = 0; iSample < k_cSamples; ++iSample) {
+      for(IntEbmType iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+         binnedData[iFeature * k_cSamples + iSample] = (iSample * (iFeature + 3) + iSample / (iFeature + 5)) % featuresBinCount[iFeature];
+      }
+      targets[iSample] = static_cast<FloatEbmType>(binnedData[iSample] * binnedData[3 * k_cSamples + iSample]) +
+         static_cast<FloatEbmType>(binnedData[k_cSamples + iSample]) * FloatEbmType { 0.25 } + 
+         static_cast<FloatEbmType>(iSample % 7) * FloatEbmType { 0.125 };
+   }
+   const std::vector<FloatEbmType> predictorScores(k_cSamples, FloatEbmType { 0 });
+
+   const InteractionDetectorHandle interactionDetectorHandle = CreateRegressionInteractionDetector(
+      k_cFeatures, featuresCategorical, featuresBinCount, k_cSamples, &binnedData[0], &targets[0], nullptr, 
+      &predictorScores[0], nullptr
+   );
+   CHECK(nullptr != interactionDetectorHandle);
+
+   // more than one task's worth of feature groups by repeating every pair
+   std::vector<IntEbmType> featureGroupsFeatureCount;
+   std::vector<IntEbmType> featureGroupsFeatureIndexes;
+   std::vector<FloatEbmType> expectedScores;
+   for(size_t iRepeat = 0; iRepeat < 7; ++iRepeat) {
+      for(IntEbmType iFeature1 = 0; iFeature1 < k_cFeatures; ++iFeature1) {
+         for(IntEbmType iFeature2 = iFeature1 + 1; iFeature2 < k_cFeatures; ++iFeature2) {
+            const IntEbmType featureIndexes[] = { iFeature1, iFeature2 };
+            FloatEbmType score = FloatEbmType { -1 };
+            CHECK(0 == CalculateInteractionScore(
+               interactionDetectorHandle, 2, featureIndexes, k_countSamplesRequiredForChildSplitMinDefault, &score));
+            featureGroupsFeatureCount.push_back(2);
+            featureGroupsFeatureIndexes.push_back(iFeature1);
+            featureGroupsFeatureIndexes.push_back(iFeature2);
+            expectedScores.push_back(score);
+         }
+      }
+   }
+   const IntEbmType cFeatureGroups = static_cast<IntEbmType>(featureGroupsFeatureCount.size());
+
+   for(const IntEbmType countThreads : { IntEbmType { 1 }, IntEbmType { 3 }, IntEbmType { 0 } }) {
+      std::vector<FloatEbmType> scores(featureGroupsFeatureCount.size(), FloatEbmType { -1 });
+      CHECK(0 == CalculateInteractionScores(
+         interactionDetectorHandle,
+         countThreads,
+         cFeatureGroups,
+         &featureGroupsFeatureCount[0],
+         &featureGroupsFeatureIndexes[0],
+         k_countSamplesRequiredForChildSplitMinDefault,
+         0,
+         nullptr,
+         &scores[0]
+      ));
+      CHECK(0 == memcmp(&expectedScores[0], &scores[0], sizeof(scores[0]) * scores.size()));
+   }
+
+   // the pairs come in repeats, so the 3 best are the best pair in its first 3 repeats
+   constexpr IntEbmType k_cTopScores = 3;
+   IntEbmType topIndexes[k_cTopScores];
+   FloatEbmType topScores[k_cTopScores];
+   CHECK(0 == CalculateInteractionScores(
+      interactionDetectorHandle,
+      0,
+      cFeatureGroups,
+      &featureGroupsFeatureCount[0],
+      &featureGroupsFeatureIndexes[0],
+      k_countSamplesRequiredForChildSplitMinDefault,
+      k_cTopScores,
+      topIndexes,
+      topScores
+   ));
+   const IntEbmType cPairs = cFeatureGroups / 7;
+   const size_t iBest = std::max_element(expectedScores.begin(), expectedScores.begin() + cPairs) - expectedScores.begin();
+   for(IntEbmType iTop = 0; iTop < k_cTopScores; ++iTop) {
+      CHECK(static_cast<IntEbmType>(iBest) + iTop * cPairs == topIndexes[iTop]);
+      CHECK(expectedScores[iBest] == topScores[iTop]);
+   }
+
+   CHECK(0 != CalculateInteractionScores(
+      interactionDetectorHandle, 0, cFeatureGroups, &featureGroupsFeatureCount[0], &featureGroupsFeatureIndexes[0],
+      k_countSamplesRequiredForChildSplitMinDefault, k_cTopScores, nullptr, topScores
+   ));
+
+   // a feature index that is out of range only fails inside the task scoring it, and must not touch the top scores
+   std::vector<IntEbmType> badFeatureGroupsFeatureIndexes(featureGroupsFeatureIndexes);
+   badFeatureGroupsFeatureIndexes.back() = k_cFeatures;
+   for(IntEbmType iTop = 0; iTop < k_cTopScores; ++iTop) {
+      topIndexes[iTop] = -1;
+      topScores[iTop] = FloatEbmType { -1 };
+   }
+   CHECK(0 != CalculateInteractionScores(
+      interactionDetectorHandle, 0, cFeatureGroups, &featureGroupsFeatureCount[0], &badFeatureGroupsFeatureIndexes[0],
+      k_countSamplesRequiredForChildSplitMinDefault, k_cTopScores, topIndexes, topScores
+   ));
+   for(IntEbmType iTop = 0; iTop < k_cTopScores; ++iTop) {
+      CHECK(-1 == topIndexes[iTop]);
+      CHECK(FloatEbmType { -1 } == topScores[iTop]);
+   }
+
+   FreeInteractionDetector(interactionDetectorHandle);
+}
+
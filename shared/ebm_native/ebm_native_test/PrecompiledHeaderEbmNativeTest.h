@@ -11,3 +11,6 @@
 #include <cstddef>
 #include <assert.h>
 #include <string.h>
+#include <thread>
+#include <atomic>
+#include <random>
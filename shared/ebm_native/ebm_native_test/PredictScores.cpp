@@ -0,0 +1,901 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeaderEbmNativeTest.h"
+
+#include "ebm_native.h"
+#include "EbmNativeTest.h"
+
+static const TestPriority k_filePriority = TestPriority::PredictScores;
+
+TEST_CASE("PredictScores, zero samples") {
+   const IntEbmType featuresBinCutCount[] { 1 };
+   const FloatEbmType binCuts[] { 1.5 };
+   const IntEbmType featureGroupsFeatureCount[] { 1 };
+   const IntEbmType featureGroupsFeatureIndexes[] { 0 };
+   const FloatEbmType tensors[] { 0.1, 0.2, 0.3 };
+
+   const IntEbmType ret = PredictScores(
+      -1,
+      1,
+      featuresBinCutCount,
+      binCuts,
+      1,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      tensors,
+      nullptr,
+      0,
+      0,
+      nullptr,
+      nullptr
+   );
+   CHECK(0 == ret);
+}
+
+TEST_CASE("PredictScores, regression mains and pair") {
+   const IntEbmType featuresBinCutCount[] { 1, 2 };
+   const FloatEbmType binCuts[] { 1.5, 10, 20 };
+   const IntEbmType featureGroupsFeatureCount[] { 1, 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] { 0, 1, 0, 1 };
+   FloatEbmType tensors[3 + 4 + 12] { 0.1, 0.2, 0.3, 1, 2, 3, 4 };
+   for(size_t i = 0; i < 12; ++i) {
+      // the first feature in the group varies fastest
+      tensors[7 + i] = static_cast<FloatEbmType>(100 * (i / 3) + 10 * (i % 3));
+   }
+   const FloatEbmType intercept[] { 0.5 };
+   const FloatEbmType nan = std::numeric_limits<FloatEbmType>::quiet_NaN();
+   const FloatEbmType featureValues[] { 1.0, 2.0, nan, 15, nan, 25 };
+   FloatEbmType logits[3];
+
+   const IntEbmType ret = PredictScores(
+      -1,
+      2,
+      featuresBinCutCount,
+      binCuts,
+      3,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      tensors,
+      intercept,
+      0,
+      3,
+      featureValues,
+      logits
+   );
+   CHECK(0 == ret);
+   CHECK_APPROX(logits[0], 213.7);
+   CHECK_APPROX(logits[1], 21.8);
+   CHECK_APPROX(logits[2], 304.6);
+}
+
+TEST_CASE("PredictScores, multiclass") {
+   const IntEbmType featuresBinCutCount[] { 1 };
+   const FloatEbmType binCuts[] { 0 };
+   const IntEbmType featureGroupsFeatureCount[] { 1 };
+   const IntEbmType featureGroupsFeatureIndexes[] { 0 };
+   const FloatEbmType tensors[] { 0, 1, 2, 10, 11, 12, 20, 21, 22 };
+   const FloatEbmType intercept[] { 1, 2, 3 };
+   const FloatEbmType featureValues[] { -1, 1, std::numeric_limits<FloatEbmType>::quiet_NaN() };
+   FloatEbmType logits[3 * 3];
+
+   const IntEbmType ret = PredictScores(
+      3,
+      1,
+      featuresBinCutCount,
+      binCuts,
+      1,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      tensors,
+      intercept,
+      0,
+      3,
+      featureValues,
+      logits
+   );
+   CHECK(0 == ret);
+   CHECK_APPROX(logits[0], 11);
+   CHECK_APPROX(logits[1], 13);
+   CHECK_APPROX(logits[2], 15);
+   CHECK_APPROX(logits[3], 21);
+   CHECK_APPROX(logits[4], 23);
+   CHECK_APPROX(logits[5], 25);
+   CHECK_APPROX(logits[6], 1);
+   CHECK_APPROX(logits[7], 3);
+   CHECK_APPROX(logits[8], 5);
+}
+
+TEST_CASE("PredictScores, many samples match Discretize") {
+   constexpr size_t cSamples = 2000;
+   constexpr size_t cBinCuts = 37;
+
+   FloatEbmType binCuts[cBinCuts];
+   for(size_t i = 0; i < cBinCuts; ++i) {
+      binCuts[i] = static_cast<FloatEbmType>(i) * FloatEbmType { 2.5 };
+   }
+   FloatEbmType tensors[cBinCuts + 2];
+   for(size_t i = 0; i < cBinCuts + 2; ++i) {
+      tensors[i] = static_cast<FloatEbmType>(i) * FloatEbmType { 0.25 } - FloatEbmType { 3 };
+   }
+   FloatEbmType * const featureValues = new FloatEbmType[cSamples];
+   for(size_t i = 0; i < cSamples; ++i) {
+      featureValues[i] = static_cast<FloatEbmType>((i * 7919) % 1000) / FloatEbmType { 10 } - FloatEbmType { 5 };
+   }
+   featureValues[17] = std::numeric_limits<FloatEbmType>::quiet_NaN();
+   IntEbmType * const discretized = new IntEbmType[cSamples];
+   FloatEbmType * const logits = new FloatEbmType[cSamples];
+
+   const IntEbmType featuresBinCutCount[] { static_cast<IntEbmType>(cBinCuts) };
+   const IntEbmType featureGroupsFeatureCount[] { 1 };
+   const IntEbmType featureGroupsFeatureIndexes[] { 0 };
+
+   IntEbmType ret = Discretize(
+      static_cast<IntEbmType>(cSamples),
+      featureValues,
+      static_cast<IntEbmType>(cBinCuts),
+      binCuts,
+      discretized
+   );
+   CHECK(0 == ret);
+
+   ret = PredictScores(
+      -1,
+      1,
+      featuresBinCutCount,
+      binCuts,
+      1,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      tensors,
+      nullptr,
+      0,
+      static_cast<IntEbmType>(cSamples),
+      featureValues,
+      logits
+   );
+   CHECK(0 == ret);
+   for(size_t i = 0; i < cSamples; ++i) {
+      CHECK(tensors[static_cast<size_t>(discretized[i])] == logits[i]);
+   }
+
+   delete[] featureValues;
+   delete[] discretized;
+   delete[] logits;
+}
+
+TEST_CASE("PredictScores, every cut count matches Discretize") {
+   // crosses the boundary between the linear and tree searches and several tree depths
+   constexpr size_t cBinCutsEnd = 300;
+   constexpr size_t cSamples = 3 * cBinCutsEnd + 3;
+
+   FloatEbmType binCuts[cBinCutsEnd];
+   FloatEbmType tensors[cBinCutsEnd + 2];
+   for(size_t i = 0; i < cBinCutsEnd; ++i) {
+      binCuts[i] = static_cast<FloatEbmType>(i);
+   }
+   for(size_t i = 0; i < cBinCutsEnd + 2; ++i) {
+      tensors[i] = static_cast<FloatEbmType>(i);
+   }
+   FloatEbmType featureValues[cSamples];
+   for(size_t i = 0; i < cBinCutsEnd + 1; ++i) {
+      // land exactly on each cut and on either side of it
+      featureValues[3 * i + 0] = static_cast<FloatEbmType>(i) - FloatEbmType { 0.5 };
+      featureValues[3 * i + 1] = static_cast<FloatEbmType>(i);
+      featureValues[3 * i + 2] = static_cast<FloatEbmType>(i) + FloatEbmType { 0.5 };
+   }
+   featureValues[cSamples - 1] = std::numeric_limits<FloatEbmType>::quiet_NaN();
+   IntEbmType discretized[cSamples];
+   FloatEbmType logits[cSamples];
+
+   const IntEbmType featureGroupsFeatureCount[] { 1 };
+   const IntEbmType featureGroupsFeatureIndexes[] { 0 };
+
+   for(size_t cBinCuts = 0; cBinCuts < cBinCutsEnd; ++cBinCuts) {
+      const IntEbmType featuresBinCutCount[] { static_cast<IntEbmType>(cBinCuts) };
+
+      IntEbmType ret = Discretize(
+         static_cast<IntEbmType>(cSamples),
+         featureValues,
+         static_cast<IntEbmType>(cBinCuts),
+         binCuts,
+         discretized
+      );
+      CHECK(0 == ret);
+
+      ret = PredictScores(
+         -1,
+         1,
+         featuresBinCutCount,
+         binCuts,
+         1,
+         featureGroupsFeatureCount,
+         featureGroupsFeatureIndexes,
+         tensors,
+         nullptr,
+         0,
+         static_cast<IntEbmType>(cSamples),
+         featureValues,
+         logits
+      );
+      CHECK(0 == ret);
+      for(size_t i = 0; i < cSamples; ++i) {
+         CHECK(static_cast<FloatEbmType>(discretized[i]) == logits[i]);
+      }
+   }
+}
+
+TEST_CASE("PredictScores, invalid feature index") {
+   const IntEbmType featuresBinCutCount[] { 1 };
+   const FloatEbmType binCuts[] { 1.5 };
+   const IntEbmType featureGroupsFeatureCount[] { 1 };
+   const IntEbmType featureGroupsFeatureIndexes[] { 1 };
+   const FloatEbmType tensors[] { 0.1, 0.2, 0.3 };
+   const FloatEbmType featureValues[] { 1 };
+   FloatEbmType logits[1];
+
+   const IntEbmType ret = PredictScores(
+      -1,
+      1,
+      featuresBinCutCount,
+      binCuts,
+      1,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      tensors,
+      nullptr,
+      0,
+      1,
+      featureValues,
+      logits
+   );
+   CHECK(0 != ret);
+}
+
+TEST_CASE("CreatePredictor, single samples match batch") {
+   // feature 1 isn't used by any feature group, so the Predictor drops it
+   const IntEbmType featuresBinCutCount[] { 1, 3, 2 };
+   const FloatEbmType binCuts[] { 1.5, -1, 0, 1, 10, 20 };
+   const IntEbmType featureGroupsFeatureCount[] { 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] { 2, 0, 2 };
+   FloatEbmType tensors[4 + 12];
+   for(size_t i = 0; i < sizeof(tensors) / sizeof(tensors[0]); ++i) {
+      tensors[i] = static_cast<FloatEbmType>(i) * FloatEbmType { 1.5 } - FloatEbmType { 7 };
+   }
+   const FloatEbmType intercept[] { -0.25 };
+   const FloatEbmType nan = std::numeric_limits<FloatEbmType>::quiet_NaN();
+   constexpr size_t cSamples = 5;
+   const FloatEbmType featureValues[3 * cSamples] {
+      1.0, 2.0, nan, 1.5, -3, 
+      0, 0, 0, 0, 0, 
+      15, nan, 25, 10, -100
+   };
+   FloatEbmType logitsBatch[cSamples];
+
+   const IntEbmType retBatch = PredictScores(
+      -1,
+      3,
+      featuresBinCutCount,
+      binCuts,
+      2,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      tensors,
+      intercept,
+      0,
+      static_cast<IntEbmType>(cSamples),
+      featureValues,
+      logitsBatch
+   );
+   CHECK(0 == retBatch);
+
+   PredictorHandle predictorHandle = CreatePredictor(
+      -1,
+      3,
+      featuresBinCutCount,
+      binCuts,
+      2,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      tensors,
+      intercept
+   );
+   CHECK(nullptr != predictorHandle);
+
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      const FloatEbmType row[] { featureValues[iSample], featureValues[cSamples + iSample], featureValues[2 * cSamples + iSample] };
+      FloatEbmType logit;
+      const IntEbmType ret = PredictScoresWithPredictor(predictorHandle, 0, 1, row, &logit);
+      CHECK(0 == ret);
+      CHECK(logitsBatch[iSample] == logit);
+   }
+
+   // sample 0 has feature 0 in bin 1 and feature 2 in bin 2
+   CHECK_APPROX(logitsBatch[0], -0.25 + tensors[2] + tensors[4 + 1 + 3 * 2]);
+
+   FreePredictor(predictorHandle);
+}
+
+TEST_CASE("CreatePredictor, wider than the scratch space of a block") {
+   // mains never use the scratch space, so the width comes from pairs.  The samples cycle through 3 patterns and
+   // span several of the smallest blocks, the last one partial
+   constexpr size_t cFeatures = 10000;
+   constexpr size_t cFeatureGroups = cFeatures / 2;
+   constexpr size_t cSamples = 3 * 11;
+
+   IntEbmType * const featuresBinCutCount = new IntEbmType[cFeatures];
+   FloatEbmType * const binCuts = new FloatEbmType[cFeatures];
+   IntEbmType * const featureGroupsFeatureCount = new IntEbmType[cFeatureGroups];
+   IntEbmType * const featureGroupsFeatureIndexes = new IntEbmType[cFeatures];
+   FloatEbmType * const tensors = new FloatEbmType[cFeatureGroups * 9];
+   FloatEbmType * const featureValues = new FloatEbmType[cFeatures * cSamples];
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      featuresBinCutCount[iFeature] = 1;
+      binCuts[iFeature] = 0;
+      featureGroupsFeatureIndexes[iFeature] = static_cast<IntEbmType>(iFeature);
+      for(size_t iSample = 0; iSample < cSamples; iSample += 3) {
+         featureValues[iFeature * cSamples + iSample + 0] = -5;
+         featureValues[iFeature * cSamples + iSample + 1] = 5;
+         featureValues[iFeature * cSamples + iSample + 2] = 0 == iFeature % 2 ? -5 : 5;
+      }
+   }
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      featureGroupsFeatureCount[iFeatureGroup] = 2;
+      for(size_t iBin1 = 0; iBin1 < 3; ++iBin1) {
+         for(size_t iBin0 = 0; iBin0 < 3; ++iBin0) {
+            // the missing bin is never used, and the others are -1 below the cut and +1 above it per dimension
+            tensors[iFeatureGroup * 9 + iBin1 * 3 + iBin0] = 0 == iBin0 || 0 == iBin1 ? 100 :
+               (1 == iBin0 ? -1 : 1) + (1 == iBin1 ? -1 : 1);
+         }
+      }
+   }
+   FloatEbmType logits[cSamples];
+
+   PredictorHandle predictorHandle = CreatePredictor(
+      2,
+      static_cast<IntEbmType>(cFeatures),
+      featuresBinCutCount,
+      binCuts,
+      static_cast<IntEbmType>(cFeatureGroups),
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      tensors,
+      nullptr
+   );
+   CHECK(nullptr != predictorHandle);
+   const IntEbmType ret = PredictScoresWithPredictor(predictorHandle, 0, static_cast<IntEbmType>(cSamples), featureValues, logits);
+   CHECK(0 == ret);
+   for(size_t iSample = 0; iSample < cSamples; iSample += 3) {
+      CHECK_APPROX(logits[iSample + 0], -static_cast<double>(cFeatures));
+      CHECK_APPROX(logits[iSample + 1], static_cast<double>(cFeatures));
+      CHECK(0 == logits[iSample + 2]);
+   }
+   FreePredictor(predictorHandle);
+
+   delete[] featuresBinCutCount;
+   delete[] binCuts;
+   delete[] featureGroupsFeatureCount;
+   delete[] featureGroupsFeatureIndexes;
+   delete[] tensors;
+   delete[] featureValues;
+}
+
+TEST_CASE("PredictScoresWithPredictor, threads match single thread") {
+   constexpr size_t cSamples = 100000;
+   constexpr size_t cFeatures = 2;
+
+   const IntEbmType featuresBinCutCount[cFeatures] { 3, 5 };
+   const FloatEbmType binCuts[] { -0.5, 0, 0.5, -2, -1, 0, 1, 2 };
+   const IntEbmType featureGroupsFeatureCount[] { 1, 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] { 0, 1, 0, 1 };
+   constexpr size_t cClasses = 3;
+   FloatEbmType tensors[(5 + 7 + 5 * 7) * cClasses];
+   for(size_t i = 0; i < sizeof(tensors) / sizeof(tensors[0]); ++i) {
+      tensors[i] = static_cast<FloatEbmType>((i * 37) % 101) / FloatEbmType { 13 } - FloatEbmType { 3 };
+   }
+   const FloatEbmType intercept[cClasses] { 0.1, -0.2, 0.3 };
+
+   FloatEbmType * const featureValues = new FloatEbmType[cFeatures * cSamples];
+   for(size_t i = 0; i < cFeatures * cSamples; ++i) {
+      featureValues[i] = static_cast<FloatEbmType>((i * 7919) % 1009) / FloatEbmType { 200 } - FloatEbmType { 2.5 };
+   }
+   FloatEbmType * const logitsSingle = new FloatEbmType[cSamples * cClasses];
+   FloatEbmType * const logitsThreaded = new FloatEbmType[cSamples * cClasses];
+
+   PredictorHandle predictorHandle = CreatePredictor(
+      static_cast<IntEbmType>(cClasses),
+      static_cast<IntEbmType>(cFeatures),
+      featuresBinCutCount,
+      binCuts,
+      3,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      tensors,
+      intercept
+   );
+   CHECK(nullptr != predictorHandle);
+
+   IntEbmType ret = PredictScoresWithPredictor(predictorHandle, 1, static_cast<IntEbmType>(cSamples), featureValues, logitsSingle);
+   CHECK(0 == ret);
+   for(IntEbmType countThreads = 0; countThreads < 9; countThreads += 4) {
+      ret = PredictScoresWithPredictor(predictorHandle, countThreads, static_cast<IntEbmType>(cSamples), featureValues, logitsThreaded);
+      CHECK(0 == ret);
+      // each sample is owned by exactly one thread, so the results are bitwise identical
+      CHECK(0 == memcmp(logitsSingle, logitsThreaded, sizeof(FloatEbmType) * cSamples * cClasses));
+   }
+   FreePredictor(predictorHandle);
+
+   delete[] featureValues;
+   delete[] logitsSingle;
+   delete[] logitsThreaded;
+}
+
+TEST_CASE("PredictProbabilitiesWithPredictor, every precision matches logits") {
+   constexpr size_t cSamples = 2000;
+   const IntEbmType featuresBinCutCount[] { 40 };
+   FloatEbmType binCuts[40];
+   for(size_t i = 0; i < 40; ++i) {
+      binCuts[i] = static_cast<FloatEbmType>(i);
+   }
+   const IntEbmType featureGroupsFeatureCount[] { 1 };
+   const IntEbmType featureGroupsFeatureIndexes[] { 0 };
+   FloatEbmType featureValues[cSamples];
+   for(size_t i = 0; i < cSamples; ++i) {
+      featureValues[i] = static_cast<FloatEbmType>((i * 7919) % 4200) / FloatEbmType { 100 } - FloatEbmType { 1 };
+   }
+
+   for(IntEbmType countClasses = 2; countClasses <= 5; countClasses += 3) {
+      const size_t cClasses = static_cast<size_t>(countClasses);
+      const size_t cScores = 2 == cClasses ? size_t { 1 } : cClasses;
+      FloatEbmType tensors[42 * 5];
+      for(size_t i = 0; i < 42 * cScores; ++i) {
+         // logits from about -12 to +12 so that we cover both saturated and balanced probabilities
+         tensors[i] = static_cast<FloatEbmType>((i * 37) % 97) / FloatEbmType { 4 } - FloatEbmType { 12 };
+      }
+      const FloatEbmType intercept[] { 0.5, -0.25, 0, 1, -1 };
+
+      PredictorHandle predictorHandle = CreatePredictor(
+         countClasses,
+         1,
+         featuresBinCutCount,
+         binCuts,
+         1,
+         featureGroupsFeatureCount,
+         featureGroupsFeatureIndexes,
+         tensors,
+         intercept
+      );
+      CHECK(nullptr != predictorHandle);
+
+      FloatEbmType logits[cSamples * 5];
+      IntEbmType ret = PredictScoresWithPredictor(predictorHandle, 0, static_cast<IntEbmType>(cSamples), featureValues, logits);
+      CHECK(0 == ret);
+
+      FloatEbmType expected[cSamples * 5];
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         if(2 == cClasses) {
+            const FloatEbmType probability = FloatEbmType { 1 } / (FloatEbmType { 1 } + std::exp(-logits[iSample]));
+            expected[iSample * 2 + 0] = FloatEbmType { 1 } - probability;
+            expected[iSample * 2 + 1] = probability;
+         } else {
+            FloatEbmType sum = 0;
+            for(size_t iClass = 0; iClass < cClasses; ++iClass) {
+               sum += std::exp(logits[iSample * cClasses + iClass]);
+            }
+            for(size_t iClass = 0; iClass < cClasses; ++iClass) {
+               expected[iSample * cClasses + iClass] = std::exp(logits[iSample * cClasses + iClass]) / sum;
+            }
+         }
+      }
+
+      const PredictionPrecisionType precisions[] { 
+         PredictionPrecision_Exact, 
+         PredictionPrecision_Approximate, 
+         PredictionPrecision_Fast 
+      };
+      const FloatEbmType tolerances[] { 0.000000001, 0.0001, 0.02 };
+      for(size_t iPrecision = 0; iPrecision < 3; ++iPrecision) {
+         FloatEbmType probabilities[cSamples * 5];
+         ret = PredictProbabilitiesWithPredictor(
+            predictorHandle,
+            0,
+            static_cast<IntEbmType>(cSamples),
+            featureValues,
+            precisions[iPrecision],
+            probabilities
+         );
+         CHECK(0 == ret);
+         for(size_t i = 0; i < cSamples * cClasses; ++i) {
+            CHECK(std::abs(expected[i] - probabilities[i]) <= tolerances[iPrecision]);
+         }
+      }
+      FreePredictor(predictorHandle);
+   }
+}
+
+TEST_CASE("PredictProbabilitiesWithPredictor, regression is an error") {
+   const IntEbmType featureGroupsFeatureCount[] { 0 };
+   const FloatEbmType tensors[] { 1 };
+   FloatEbmType probabilities[2];
+
+   PredictorHandle predictorHandle = CreatePredictor(
+      -1,
+      0,
+      nullptr,
+      nullptr,
+      1,
+      featureGroupsFeatureCount,
+      nullptr,
+      tensors,
+      nullptr
+   );
+   CHECK(nullptr != predictorHandle);
+   const IntEbmType ret = PredictProbabilitiesWithPredictor(
+      predictorHandle, 
+      0, 
+      1, 
+      nullptr, 
+      PredictionPrecision_Exact, 
+      probabilities
+   );
+   CHECK(0 != ret);
+   FreePredictor(predictorHandle);
+}
+
+TEST_CASE("CreatePredictorWithStorage, logits stay within the error bound") {
+   constexpr size_t cSamples = 3000;
+   constexpr size_t cClasses = 3;
+
+   const IntEbmType featuresBinCutCount[] { 3, 5 };
+   const FloatEbmType binCuts[] { -0.5, 0, 0.5, -2, -1, 0, 1, 2 };
+   const IntEbmType featureGroupsFeatureCount[] { 1, 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] { 0, 1, 0, 1 };
+   FloatEbmType tensors[(5 + 7 + 5 * 7) * cClasses];
+   for(size_t i = 0; i < sizeof(tensors) / sizeof(tensors[0]); ++i) {
+      tensors[i] = static_cast<FloatEbmType>((i * 7919) % 1009) / FloatEbmType { 97 } - FloatEbmType { 5 };
+   }
+   const FloatEbmType intercept[cClasses] { 0.125, -1, 3 };
+   FloatEbmType * const featureValues = new FloatEbmType[2 * cSamples];
+   for(size_t i = 0; i < 2 * cSamples; ++i) {
+      featureValues[i] = static_cast<FloatEbmType>((i * 104729) % 601) / FloatEbmType { 100 } - FloatEbmType { 3 };
+   }
+   FloatEbmType * const logitsExact = new FloatEbmType[cSamples * cClasses];
+   FloatEbmType * const logits = new FloatEbmType[cSamples * cClasses];
+
+   const TensorStorageType tensorStorages[] { TensorStorage_Float64, TensorStorage_Float32, TensorStorage_Int16 };
+   FloatEbmType maxLogitErrors[3];
+   for(size_t iStorage = 0; iStorage < 3; ++iStorage) {
+      PredictorHandle predictorHandle = CreatePredictorWithStorage(
+         static_cast<IntEbmType>(cClasses),
+         2,
+         featuresBinCutCount,
+         binCuts,
+         3,
+         featureGroupsFeatureCount,
+         featureGroupsFeatureIndexes,
+         tensors,
+         intercept,
+         tensorStorages[iStorage]
+      );
+      CHECK(nullptr != predictorHandle);
+      IntEbmType ret = GetPredictorMaxLogitError(predictorHandle, &maxLogitErrors[iStorage]);
+      CHECK(0 == ret);
+      ret = PredictScoresWithPredictor(
+         predictorHandle, 
+         0, 
+         static_cast<IntEbmType>(cSamples), 
+         featureValues, 
+         0 == iStorage ? logitsExact : logits
+      );
+      CHECK(0 == ret);
+      if(0 != iStorage) {
+         for(size_t i = 0; i < cSamples * cClasses; ++i) {
+            // allow for the rounding of the sums themselves, which the bound doesn't cover
+            CHECK(std::abs(logitsExact[i] - logits[i]) <= maxLogitErrors[iStorage] * 1.000001 + 0.000000001);
+         }
+      }
+      FreePredictor(predictorHandle);
+   }
+   CHECK(0 == maxLogitErrors[0]);
+   CHECK(0 < maxLogitErrors[1]);
+   CHECK(maxLogitErrors[1] < maxLogitErrors[2]);
+   // each tensor has a range of about 10 spread over 65535 steps, and we're off by at most half a step per tensor
+   CHECK(maxLogitErrors[2] <= 3 * 0.5 * 10.5 / 65535);
+
+   delete[] featureValues;
+   delete[] logitsExact;
+   delete[] logits;
+}
+
+TEST_CASE("CreatePredictorWithStorage, int16 needs finite tensors") {
+   const IntEbmType featureGroupsFeatureCount[] { 0 };
+   const FloatEbmType tensors[] { std::numeric_limits<FloatEbmType>::infinity() };
+
+   PredictorHandle predictorHandle = CreatePredictorWithStorage(
+      -1,
+      0,
+      nullptr,
+      nullptr,
+      1,
+      featureGroupsFeatureCount,
+      nullptr,
+      tensors,
+      nullptr,
+      TensorStorage_Int16
+   );
+   CHECK(nullptr == predictorHandle);
+
+   predictorHandle = CreatePredictorWithStorage(
+      -1,
+      0,
+      nullptr,
+      nullptr,
+      1,
+      featureGroupsFeatureCount,
+      nullptr,
+      tensors,
+      nullptr,
+      3
+   );
+   CHECK(nullptr == predictorHandle);
+}
+
+TEST_CASE("CreatePredictorFromFile, scores the same as the saved predictor") {
+   constexpr size_t cSamples = 1000;
+   constexpr size_t cClasses = 3;
+   constexpr size_t cBinCuts0 = 20;
+   const char * const filePath = "PredictScores_flat_model.ebm";
+
+   // feature 1 isn't used, and feature 0 has enough cuts to be searched as a tree
+   const IntEbmType featuresBinCutCount[] { cBinCuts0, 1, 3 };
+   FloatEbmType binCuts[cBinCuts0 + 1 + 3];
+   for(size_t i = 0; i < cBinCuts0; ++i) {
+      binCuts[i] = static_cast<FloatEbmType>(i) / FloatEbmType { 4 } - FloatEbmType { 2.5 };
+   }
+   binCuts[cBinCuts0] = 100;
+   binCuts[cBinCuts0 + 1] = -1;
+   binCuts[cBinCuts0 + 2] = 0;
+   binCuts[cBinCuts0 + 3] = 1;
+   const IntEbmType featureGroupsFeatureCount[] { 1, 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] { 0, 2, 2, 0 };
+   FloatEbmType tensors[(22 + 5 + 5 * 22) * cClasses];
+   for(size_t i = 0; i < sizeof(tensors) / sizeof(tensors[0]); ++i) {
+      tensors[i] = static_cast<FloatEbmType>((i * 7919) % 1009) / FloatEbmType { 97 } - FloatEbmType { 5 };
+   }
+   const FloatEbmType intercept[cClasses] { 0.125, -1, 3 };
+   FloatEbmType * const featureValues = new FloatEbmType[3 * cSamples];
+   for(size_t i = 0; i < 3 * cSamples; ++i) {
+      featureValues[i] = 0 == i % 101 ? std::numeric_limits<FloatEbmType>::quiet_NaN() :
+         static_cast<FloatEbmType>((i * 104729) % 601) / FloatEbmType { 100 } - FloatEbmType { 3 };
+   }
+   FloatEbmType * const logitsSaved = new FloatEbmType[cSamples * cClasses];
+   FloatEbmType * const logitsLoaded = new FloatEbmType[cSamples * cClasses];
+
+   const TensorStorageType tensorStorages[] { TensorStorage_Float64, TensorStorage_Float32, TensorStorage_Int16 };
+   for(size_t iStorage = 0; iStorage < 3; ++iStorage) {
+      PredictorHandle predictorSaved = CreatePredictorWithStorage(
+         static_cast<IntEbmType>(cClasses),
+         3,
+         featuresBinCutCount,
+         binCuts,
+         3,
+         featureGroupsFeatureCount,
+         featureGroupsFeatureIndexes,
+         tensors,
+         intercept,
+         tensorStorages[iStorage]
+      );
+      CHECK(nullptr != predictorSaved);
+      IntEbmType ret = SavePredictorToFile(predictorSaved, filePath);
+      CHECK(0 == ret);
+      ret = PredictScoresWithPredictor(predictorSaved, 0, static_cast<IntEbmType>(cSamples), featureValues, logitsSaved);
+      CHECK(0 == ret);
+      FloatEbmType maxLogitErrorSaved;
+      ret = GetPredictorMaxLogitError(predictorSaved, &maxLogitErrorSaved);
+      CHECK(0 == ret);
+      FreePredictor(predictorSaved);
+
+      PredictorHandle predictorLoaded = CreatePredictorFromFile(filePath);
+      CHECK(nullptr != predictorLoaded);
+      ret = PredictScoresWithPredictor(predictorLoaded, 0, static_cast<IntEbmType>(cSamples), featureValues, logitsLoaded);
+      CHECK(0 == ret);
+      FloatEbmType maxLogitErrorLoaded;
+      ret = GetPredictorMaxLogitError(predictorLoaded, &maxLogitErrorLoaded);
+      CHECK(0 == ret);
+      CHECK(maxLogitErrorSaved == maxLogitErrorLoaded);
+      // the loaded predictor scores from the very same items, so the results are identical
+      for(size_t i = 0; i < cSamples * cClasses; ++i) {
+         CHECK(logitsSaved[i] == logitsLoaded[i]);
+      }
+      FreePredictor(predictorLoaded);
+   }
+   remove(filePath);
+
+   delete[] featureValues;
+   delete[] logitsSaved;
+   delete[] logitsLoaded;
+}
+
+TEST_CASE("CreatePredictorFromFile, rejects files that aren't complete model files") {
+   const char * const filePath = "PredictScores_flat_model_bad.ebm";
+
+   PredictorHandle predictorHandle = CreatePredictorFromFile("PredictScores_flat_model_missing.ebm");
+   CHECK(nullptr == predictorHandle);
+
+   const IntEbmType featuresBinCutCount[] { 1 };
+   const FloatEbmType binCuts[] { 0 };
+   const IntEbmType featureGroupsFeatureCount[] { 1 };
+   const IntEbmType featureGroupsFeatureIndexes[] { 0 };
+   const FloatEbmType tensors[] { 0, 1, 2 };
+   predictorHandle = CreatePredictor(
+      -1,
+      1,
+      featuresBinCutCount,
+      binCuts,
+      1,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      tensors,
+      nullptr
+   );
+   CHECK(nullptr != predictorHandle);
+   IntEbmType ret = SavePredictorToFile(predictorHandle, filePath);
+   CHECK(0 == ret);
+   FreePredictor(predictorHandle);
+
+   std::vector<char> bytes;
+   FILE * pFile = fopen(filePath, "rb");
+   CHECK(nullptr != pFile);
+   if(nullptr != pFile) {
+      char buffer[256];
+      size_t cRead;
+      while(0 != (cRead = fread(buffer, 1, sizeof(buffer), pFile))) {
+         bytes.insert(bytes.end(), buffer, buffer + cRead);
+      }
+      fclose(pFile);
+   }
+
+   // truncated
+   pFile = fopen(filePath, "wb");
+   CHECK(nullptr != pFile);
+   if(nullptr != pFile) {
+      fwrite(&bytes[0], 1, bytes.size() - 8, pFile);
+      fclose(pFile);
+   }
+   predictorHandle = CreatePredictorFromFile(filePath);
+   CHECK(nullptr == predictorHandle);
+
+   // not a model file
+   std::vector<char> garbage(bytes.size(), 'x');
+   pFile = fopen(filePath, "wb");
+   CHECK(nullptr != pFile);
+   if(nullptr != pFile) {
+      fwrite(&garbage[0], 1, garbage.size(), pFile);
+      fclose(pFile);
+   }
+   predictorHandle = CreatePredictorFromFile(filePath);
+   CHECK(nullptr == predictorHandle);
+
+   // the original bytes still load
+   pFile = fopen(filePath, "wb");
+   CHECK(nullptr != pFile);
+   if(nullptr != pFile) {
+      fwrite(&bytes[0], 1, bytes.size(), pFile);
+      fclose(pFile);
+   }
+   predictorHandle = CreatePredictorFromFile(filePath);
+   CHECK(nullptr != predictorHandle);
+   const FloatEbmType featureValues[] { -1, 1 };
+   FloatEbmType logits[2];
+   ret = PredictScoresWithPredictor(predictorHandle, 1, 2, featureValues, logits);
+   CHECK(0 == ret);
+   CHECK(1 == logits[0]);
+   CHECK(2 == logits[1]);
+   FreePredictor(predictorHandle);
+
+   remove(filePath);
+}
+
+TEST_CASE("ExplainScores, regression mains and pair") {
+   const IntEbmType featuresBinCutCount[] { 1, 2 };
+   const FloatEbmType binCuts[] { 1.5, 10, 20 };
+   const IntEbmType featureGroupsFeatureCount[] { 1, 1, 2 };
+   const IntEbmType featureGroupsFeatureIndexes[] { 0, 1, 0, 1 };
+   FloatEbmType tensors[3 + 4 + 12] { 0.1, 0.2, 0.3, 1, 2, 3, 4 };
+   for(size_t i = 0; i < 12; ++i) {
+      tensors[7 + i] = static_cast<FloatEbmType>(100 * (i / 3) + 10 * (i % 3));
+   }
+   const FloatEbmType intercept[] { 0.5 };
+   const FloatEbmType nan = std::numeric_limits<FloatEbmType>::quiet_NaN();
+   const FloatEbmType featureValues[] { 1.0, 2.0, nan, 15, nan, 25 };
+   FloatEbmType interceptOut[1];
+   FloatEbmType contributions[3 * 3];
+
+   PredictorHandle predictorHandle = CreatePredictor(
+      -1,
+      2,
+      featuresBinCutCount,
+      binCuts,
+      3,
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      tensors,
+      intercept
+   );
+   CHECK(nullptr != predictorHandle);
+   const IntEbmType ret = ExplainScores(predictorHandle, 0, 3, featureValues, interceptOut, contributions);
+   CHECK(0 == ret);
+   CHECK(0.5 == interceptOut[0]);
+   CHECK(0.2 == contributions[0]);
+   CHECK(3 == contributions[1]);
+   CHECK(210 == contributions[2]);
+   CHECK(0.3 == contributions[3]);
+   CHECK(1 == contributions[4]);
+   CHECK(20 == contributions[5]);
+   CHECK(0.1 == contributions[6]);
+   CHECK(4 == contributions[7]);
+   CHECK(300 == contributions[8]);
+   FreePredictor(predictorHandle);
+}
+
+TEST_CASE("ExplainScores, multiclass contributions sum to logits") {
+   constexpr size_t cSamples = 5000;
+   constexpr size_t cClasses = 3;
+   constexpr size_t cFeatureGroups = 3;
+
+   const IntEbmType featuresBinCutCount[] { 3, 5 };
+   const FloatEbmType binCuts[] { -0.5, 0, 0.5, -2, -1, 0, 1, 2 };
+   const IntEbmType featureGroupsFeatureCount[cFeatureGroups] { 1, 2, 1 };
+   const IntEbmType featureGroupsFeatureIndexes[] { 1, 0, 1, 0 };
+   FloatEbmType tensors[(7 + 5 * 7 + 5) * cClasses];
+   for(size_t i = 0; i < sizeof(tensors) / sizeof(tensors[0]); ++i) {
+      tensors[i] = static_cast<FloatEbmType>((i * 37) % 101) / FloatEbmType { 16 } - FloatEbmType { 3 };
+   }
+   const FloatEbmType intercept[cClasses] { -1, 0.25, 2 };
+   FloatEbmType * const featureValues = new FloatEbmType[2 * cSamples];
+   for(size_t i = 0; i < 2 * cSamples; ++i) {
+      featureValues[i] = static_cast<FloatEbmType>((i * 7919) % 601) / FloatEbmType { 100 } - FloatEbmType { 3 };
+   }
+   featureValues[3] = std::numeric_limits<FloatEbmType>::quiet_NaN();
+   FloatEbmType * const logits = new FloatEbmType[cSamples * cClasses];
+   FloatEbmType * const contributions = new FloatEbmType[cSamples * cFeatureGroups * cClasses];
+   FloatEbmType interceptOut[cClasses];
+
+   PredictorHandle predictorHandle = CreatePredictor(
+      static_cast<IntEbmType>(cClasses),
+      2,
+      featuresBinCutCount,
+      binCuts,
+      static_cast<IntEbmType>(cFeatureGroups),
+      featureGroupsFeatureCount,
+      featureGroupsFeatureIndexes,
+      tensors,
+      intercept
+   );
+   CHECK(nullptr != predictorHandle);
+   IntEbmType ret = PredictScoresWithPredictor(predictorHandle, 0, static_cast<IntEbmType>(cSamples), featureValues, logits);
+   CHECK(0 == ret);
+   ret = ExplainScores(predictorHandle, 0, static_cast<IntEbmType>(cSamples), featureValues, interceptOut, contributions);
+   CHECK(0 == ret);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      for(size_t iClass = 0; iClass < cClasses; ++iClass) {
+         FloatEbmType sum = interceptOut[iClass];
+         for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+            sum += contributions[(iSample * cFeatureGroups + iFeatureGroup) * cClasses + iClass];
+         }
+         // we add in the same order as PredictScoresWithPredictor, so the sums are identical
+         CHECK(logits[iSample * cClasses + iClass] == sum);
+      }
+   }
+   FreePredictor(predictorHandle);
+
+   delete[] featureValues;
+   delete[] logits;
+   delete[] contributions;
+}
+
+TEST_CASE("FreePredictor, nullptr") {
+   UNUSED(testCaseHidden);
+   FreePredictor(nullptr);
+}
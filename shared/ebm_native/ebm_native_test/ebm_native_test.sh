@@ -36,12 +36,14 @@ compile_all="$compile_all \"$src_path/GenerateQuantileBinCuts.cpp\""
 compile_all="$compile_all \"$src_path/GenerateUniformBinCuts.cpp\""
 compile_all="$compile_all \"$src_path/GenerateWinsorizedBinCuts.cpp\""
 compile_all="$compile_all \"$src_path/InteractionUnusualInputs.cpp\""
+compile_all="$compile_all \"$src_path/PredictScores.cpp\""
 compile_all="$compile_all \"$src_path/RandomNumbers.cpp\""
 compile_all="$compile_all \"$src_path/Rehydration.cpp\""
 compile_all="$compile_all \"$src_path/SuggestGraphBounds.cpp\""
 compile_all="$compile_all -I\"$src_path\""
 compile_all="$compile_all -I\"$root_path/shared/ebm_native/inc\""
 compile_all="$compile_all -std=c++11 -march=core2"
+compile_all="$compile_all -pthread"
 
 if [ "$os_type" = "Darwin" ]; then
    # reference on rpath & install_name: https://www.mikeash.com/pyblog/friday-qa-2009-11-06-linking-and-install-names.html
@@ -15,10 +15,20 @@ extern "C" {
 #define EBM_BOOL_CAST(EBM_VAL) (static_cast<BoolEbmType>(EBM_VAL))
 #define EBM_TRACE_CAST(EBM_VAL) (static_cast<TraceEbmType>(EBM_VAL))
 #define EBM_GENERATE_UPDATE_OPTIONS_CAST(EBM_VAL) (static_cast<GenerateUpdateOptionsType>(EBM_VAL))
+#define EBM_PREDICTION_PRECISION_CAST(EBM_VAL) (static_cast<PredictionPrecisionType>(EBM_VAL))
+#define EBM_TENSOR_STORAGE_CAST(EBM_VAL) (static_cast<TensorStorageType>(EBM_VAL))
+#define EBM_RESIDUAL_STORAGE_CAST(EBM_VAL) (static_cast<ResidualStorageType>(EBM_VAL))
+#define EBM_BINNING_METHOD_CAST(EBM_VAL) (static_cast<BinningMethodType>(EBM_VAL))
+#define EBM_CPU_VARIANT_CAST(EBM_VAL) (static_cast<CpuVariantType>(EBM_VAL))
 #else // __cplusplus
 #define EBM_BOOL_CAST(EBM_VAL) ((BoolEbmType)(EBM_VAL))
 #define EBM_TRACE_CAST(EBM_VAL) ((TraceEbmType)(EBM_VAL))
 #define EBM_GENERATE_UPDATE_OPTIONS_CAST(EBM_VAL) ((GenerateUpdateOptionsType)(EBM_VAL))
+#define EBM_PREDICTION_PRECISION_CAST(EBM_VAL) ((PredictionPrecisionType)(EBM_VAL))
+#define EBM_TENSOR_STORAGE_CAST(EBM_VAL) ((TensorStorageType)(EBM_VAL))
+#define EBM_RESIDUAL_STORAGE_CAST(EBM_VAL) ((ResidualStorageType)(EBM_VAL))
+#define EBM_BINNING_METHOD_CAST(EBM_VAL) ((BinningMethodType)(EBM_VAL))
+#define EBM_CPU_VARIANT_CAST(EBM_VAL) ((CpuVariantType)(EBM_VAL))
 #endif // __cplusplus
 
 //#define EXPAND_BINARY_LOGITS
@@ -92,6 +102,11 @@ typedef struct _InteractionDetectorHandle {
    // In C/C++ languages the caller will get an error if they try to mix these pointer types.
    char unused;
 } * InteractionDetectorHandle;
+typedef struct _PredictorHandle {
+   // this struct exists to enforce that our caller doesn't mix PredictorHandle with the other handle types.
+   // In C/C++ languages the caller will get an error if they try to mix these pointer types.
+   char unused;
+} * PredictorHandle;
 
 #ifndef PRId32
 // this should really be defined, but some compilers aren't compliant
@@ -128,6 +143,16 @@ typedef IntEbmType GenerateUpdateOptionsType;
 // technically printf hexidecimals are unsigned, so convert it first to unsigned before calling printf
 typedef UIntEbmType UGenerateUpdateOptionsType;
 #define UGenerateUpdateOptionsTypePrintf PRIx64
+typedef IntEbmType PredictionPrecisionType;
+#define PredictionPrecisionTypePrintf IntEbmTypePrintf
+typedef IntEbmType TensorStorageType;
+#define TensorStorageTypePrintf IntEbmTypePrintf
+typedef IntEbmType ResidualStorageType;
+#define ResidualStorageTypePrintf IntEbmTypePrintf
+typedef IntEbmType BinningMethodType;
+#define BinningMethodTypePrintf IntEbmTypePrintf
+typedef IntEbmType CpuVariantType;
+#define CpuVariantTypePrintf IntEbmTypePrintf
 
 #define EBM_FALSE          (EBM_BOOL_CAST(0))
 #define EBM_TRUE           (EBM_BOOL_CAST(1))
@@ -138,6 +163,41 @@ typedef UIntEbmType UGenerateUpdateOptionsType;
 #define GenerateUpdateOptions_GradientSums         (EBM_GENERATE_UPDATE_OPTIONS_CAST(0x0000000000000004))
 #define GenerateUpdateOptions_RandomSplits         (EBM_GENERATE_UPDATE_OPTIONS_CAST(0x0000000000000008))
 
+// std::exp, so probabilities match other softmax implementations
+#define PredictionPrecision_Exact        (EBM_PREDICTION_PRECISION_CAST(0))
+// Paul Mineiro's exp approximation, which is close to exact but not monotonic at the scale of its error
+#define PredictionPrecision_Approximate  (EBM_PREDICTION_PRECISION_CAST(1))
+// Schraudolph's exp approximation, which is monotonic but has a relative error of a few percent
+#define PredictionPrecision_Fast         (EBM_PREDICTION_PRECISION_CAST(2))
+
+// keep the model tensors exactly as given
+#define TensorStorage_Float64            (EBM_TENSOR_STORAGE_CAST(0))
+// half the memory, with a relative error of at most 2^-24 per tensor item
+#define TensorStorage_Float32            (EBM_TENSOR_STORAGE_CAST(1))
+// a quarter of the memory, with each tensor's range spread over 65536 evenly spaced values
+#define TensorStorage_Int16              (EBM_TENSOR_STORAGE_CAST(2))
+
+// keep the per-sample residuals and predictor scores that boosting updates as FloatEbmType
+#define ResidualStorage_Float64          (EBM_RESIDUAL_STORAGE_CAST(0))
+// half the memory traffic for the residuals and predictor scores, which are rounded to float each time they are stored
+#define ResidualStorage_Float32          (EBM_RESIDUAL_STORAGE_CAST(1))
+
+// GenerateQuantileBinCuts with isHumanized set to EBM_FALSE
+#define BinningMethod_Quantile           (EBM_BINNING_METHOD_CAST(0))
+// GenerateQuantileBinCuts with isHumanized set to EBM_TRUE
+#define BinningMethod_QuantileHumanized  (EBM_BINNING_METHOD_CAST(1))
+// GenerateUniformBinCuts
+#define BinningMethod_Uniform            (EBM_BINNING_METHOD_CAST(2))
+// GenerateWinsorizedBinCuts
+#define BinningMethod_Winsorized         (EBM_BINNING_METHOD_CAST(3))
+
+// the kernels built with the baseline compiler flags, which is SSE2 and up on x86
+#define CpuVariant_Generic               (EBM_CPU_VARIANT_CAST(0))
+// the kernels built for AVX2
+#define CpuVariant_AVX2                  (EBM_CPU_VARIANT_CAST(1))
+// the kernels built for AVX-512 (F, BW, DQ and VL)
+#define CpuVariant_AVX512                (EBM_CPU_VARIANT_CAST(2))
+
  // no messages will be output
 #define TraceLevelOff      (EBM_TRACE_CAST(0))
 // invalid inputs to the C library or assert failure before exit
@@ -159,6 +219,25 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION SetLogMessag
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION SetTraceLevel(TraceEbmType traceLevel);
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE const char * EBM_NATIVE_CALLING_CONVENTION GetTraceLevelString(TraceEbmType traceLevel);
 
+// every parallel operation in this library shares one pool of countThreads threads, including the threads that call us, 
+// so calls from several threads or on several boosters at once don't oversubscribe the machine.  0 means one thread per
+// hardware thread, which is also the default.  SetThreadCount can be called from any thread at any time, including 
+// while other threads are boosting.  Calls that are already running finish on the threads they have, with the same 
+// results.  SetThreadCount returns an error when the log callback calls it on one of the pool's worker threads, since
+// the pool can't stop the thread that asks it to stop.  The work is split by the size of the data and never by the 
+// thread count, and the pieces are summed in a fixed order, so boosting with the same seeds gives bitwise identical 
+// models and metrics for any countThreads
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION SetThreadCount(IntEbmType countThreads);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION GetThreadCount(void);
+
+// the hot boosting kernels, Discretize, and Softmax are built once per CpuVariant_* value, and when the library loads we
+// pick the highest variant that both the CPU and the operating system support.  GetCpuVariant returns the variant in use.  
+// SetCpuVariant can lower it to any variant at or below the one picked at load, which is mostly useful for testing and
+// benchmarking.  Every variant gives bitwise identical results.  Don't call SetCpuVariant while other calls into this 
+// library are running
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE CpuVariantType EBM_NATIVE_CALLING_CONVENTION GetCpuVariant(void);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION SetCpuVariant(CpuVariantType cpuVariant);
+
 // BINARY VS MULTICLASS AND LOGIT REDUCTION
 // - I initially considered storing our model files as negated logits [storing them as (0 - mathematical_logit)], but that's a bad choice because:
 //   - if you use the wrong formula, you need a negation for binary classification, but the best formula requires a logit without negation 
@@ -361,6 +440,29 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION Genera
    FloatEbmType * maxNonInfinityValueOut,
    IntEbmType * countPositiveInfinityOut
 );
+// GenerateFeaturesBinCuts bins all the columns of a dataset in one call, with the columns spread over up to
+// countThreads threads, where 0 means all the threads set by SetThreadCount.  featureValues is feature major
+// ([countFeatures][countSamples]).  Each feature has its own BinningMethod_* value, countSamplesPerBinMin (only used
+// by the quantile methods, and nullptr means 1 for every feature) and countBinCutsMax.  The cuts of each feature
+// start in binCutsLowerBoundInclusiveOut after the countBinCutsMax of all the features before it, and 
+// countBinCutsOut receives how many were used.  The other outputs have one entry per feature.  The results are 
+// identical to binning each column separately
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateFeaturesBinCuts(
+   IntEbmType countThreads,
+   IntEbmType countFeatures,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   const BinningMethodType * binningMethods,
+   const IntEbmType * countSamplesPerBinMin,
+   const IntEbmType * countBinCutsMax,
+   IntEbmType * countBinCutsOut,
+   FloatEbmType * binCutsLowerBoundInclusiveOut,
+   IntEbmType * countMissingValuesOut,
+   FloatEbmType * minNonInfinityValueOut,
+   IntEbmType * countNegativeInfinityOut,
+   FloatEbmType * maxNonInfinityValueOut,
+   IntEbmType * countPositiveInfinityOut
+);
 
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION SuggestGraphBounds(
    IntEbmType countBinCuts,
@@ -387,6 +489,108 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION Softma
    FloatEbmType * probabilitiesOut
 );
 
+// PredictScores computes the logits of a complete model in one pass.  featureValues is feature major
+// ([countFeatures][countSamples]) and binCutsLowerBoundInclusive holds the cuts of all features back to back.  Each
+// feature has featuresBinCutCount[iFeature] + 2 bins since bin 0 is reserved for missing values (see Discretize).
+// The feature group tensors are stored back to back in the same layout that GetBestModelFeatureGroup returns.
+// countTargetClasses is -1 for regression.  logitsOut receives [countSamples][scores per sample] and intercept,
+// which can be nullptr, has one entry per score.  The samples are split into blocks that are scored on up to
+// countThreads threads, where 0 means all the threads set by SetThreadCount.  Small batches always use a single thread
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION PredictScores(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const IntEbmType * featuresBinCutCount,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const IntEbmType * featureGroupsFeatureCount,
+   const IntEbmType * featureGroupsFeatureIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   IntEbmType countThreads,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   FloatEbmType * logitsOut
+);
+
+// CreatePredictor takes the same model description as PredictScores and compiles it once into a single 
+// contiguous block of memory.  PredictScoresWithPredictor then scores any number of samples without allocating
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PredictorHandle EBM_NATIVE_CALLING_CONVENTION CreatePredictor(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const IntEbmType * featuresBinCutCount,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const IntEbmType * featureGroupsFeatureCount,
+   const IntEbmType * featureGroupsFeatureIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept
+);
+// CreatePredictorWithStorage is CreatePredictor with the model tensors stored in a smaller type to reduce the
+// cache footprint of large models.  tensorStorage is one of the TensorStorage_* values.  GetPredictorMaxLogitError
+// returns a bound on how far any logit can move due to the storage, which is 0 for TensorStorage_Float64
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PredictorHandle EBM_NATIVE_CALLING_CONVENTION CreatePredictorWithStorage(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const IntEbmType * featuresBinCutCount,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const IntEbmType * featureGroupsFeatureCount,
+   const IntEbmType * featureGroupsFeatureIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   TensorStorageType tensorStorage
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION GetPredictorMaxLogitError(
+   PredictorHandle predictorHandle,
+   FloatEbmType * maxLogitErrorOut
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION PredictScoresWithPredictor(
+   PredictorHandle predictorHandle,
+   IntEbmType countThreads,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   FloatEbmType * logitsOut
+);
+// PredictProbabilitiesWithPredictor applies the logistic (binary) or softmax (multiclass) link to each block of
+// logits while it is still in cache, so there is no separate pass over the output.  probabilitiesOut receives
+// [countSamples][countTargetClasses], including both classes for binary classification.  precision is one of the
+// PredictionPrecision_* values.  Regression models have no probabilities and return an error
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION PredictProbabilitiesWithPredictor(
+   PredictorHandle predictorHandle,
+   IntEbmType countThreads,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   PredictionPrecisionType precision,
+   FloatEbmType * probabilitiesOut
+);
+// ExplainScores writes the score each feature group contributes to each sample, which is what local explanations
+// and reason codes are built from.  contributionsOut receives [countSamples][countFeatureGroups][scores per sample]
+// and interceptOut, which can be nullptr, receives the intercept once.  Summing a sample's contributions and the
+// intercept gives the same logits as PredictScoresWithPredictor, up to floating point rounding
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION ExplainScores(
+   PredictorHandle predictorHandle,
+   IntEbmType countThreads,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   FloatEbmType * interceptOut,
+   FloatEbmType * contributionsOut
+);
+// SavePredictorToFile writes the Predictor as a flat model file: a single pointer-free byte array that holds the 
+// cuts, tensors and metadata in the same layout and storage type we score from.  CreatePredictorFromFile memory 
+// maps the file read only and scores directly from the mapping, so loading is nearly instantaneous and every 
+// process that loads the same file shares its memory.  The file can't be modified or deleted while in use on some 
+// operating systems, and it must come from a host with the same byte order.  FreePredictor unmaps it
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION SavePredictorToFile(
+   PredictorHandle predictorHandle,
+   const char * filePath
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PredictorHandle EBM_NATIVE_CALLING_CONVENTION CreatePredictorFromFile(
+   const char * filePath
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION FreePredictor(
+   PredictorHandle predictorHandle
+);
+
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION SampleWithoutReplacement(
    SeedEbmType randomSeed,
    IntEbmType countTrainingSamples,
@@ -437,6 +641,107 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE BoosterHandle EBM_NATIVE_CALLING_CONVENTION Cre
    IntEbmType countInnerBags,
    const FloatEbmType * optionalTempParams
 );
+// CreateClassificationBoosterWithStorage and CreateRegressionBoosterWithStorage are CreateClassificationBooster and
+// CreateRegressionBooster with the per-sample residuals and predictor scores stored as residualStorage, which is one of 
+// the ResidualStorage_* values.  Boosting still computes and sums the histograms in FloatEbmType, so the models come 
+// out close to, but not bitwise identical with, ResidualStorage_Float64 boosting
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE BoosterHandle EBM_NATIVE_CALLING_CONVENTION CreateClassificationBoosterWithStorage(
+   SeedEbmType randomSeed,
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const BoolEbmType * featuresCategorical,
+   const IntEbmType * featuresBinCount,
+   IntEbmType countFeatureGroups,
+   const IntEbmType * featureGroupsFeatureCount,
+   const IntEbmType * featureGroupsFeatureIndexes,
+   IntEbmType countTrainingSamples,
+   const IntEbmType * trainingBinnedData,
+   const IntEbmType * trainingTargets,
+   const FloatEbmType * trainingWeights,
+   const FloatEbmType * trainingPredictorScores,
+   IntEbmType countValidationSamples,
+   const IntEbmType * validationBinnedData,
+   const IntEbmType * validationTargets,
+   const FloatEbmType * validationWeights,
+   const FloatEbmType * validationPredictorScores,
+   IntEbmType countInnerBags,
+   const FloatEbmType * optionalTempParams,
+   ResidualStorageType residualStorage
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE BoosterHandle EBM_NATIVE_CALLING_CONVENTION CreateRegressionBoosterWithStorage(
+   SeedEbmType randomSeed,
+   IntEbmType countFeatures,
+   const BoolEbmType * featuresCategorical,
+   const IntEbmType * featuresBinCount,
+   IntEbmType countFeatureGroups,
+   const IntEbmType * featureGroupsFeatureCount,
+   const IntEbmType * featureGroupsFeatureIndexes,
+   IntEbmType countTrainingSamples,
+   const IntEbmType * trainingBinnedData,
+   const FloatEbmType * trainingTargets,
+   const FloatEbmType * trainingWeights,
+   const FloatEbmType * trainingPredictorScores,
+   IntEbmType countValidationSamples,
+   const IntEbmType * validationBinnedData,
+   const FloatEbmType * validationTargets,
+   const FloatEbmType * validationWeights,
+   const FloatEbmType * validationPredictorScores,
+   IntEbmType countInnerBags,
+   const FloatEbmType * optionalTempParams,
+   ResidualStorageType residualStorage
+);
+// CreateClassificationBoosters and CreateRegressionBoosters make countBags boosters that share a single copy of the
+// bit packed countSamples samples.  bagsSampleCounts holds countBags * countSamples counts, and entry
+// [iBag * countSamples + iSample] puts the sample into the training set of bag iBag that many times when positive,
+// into its validation set that many times when negative, or leaves it out of the bag when zero.  Each bag needs at
+// least one training sample.  Booster iBag is seeded with randomSeeds[iBag] and boosts bitwise identically to a 
+// booster made by CreateClassificationBooster or CreateRegressionBooster from copies of its training and validation 
+// samples in their original order, with a repeated sample copied once per count.  Besides the shared data each 
+// booster only keeps its own residuals, scores and the list of its samples, and unpacks its samples for the feature 
+// group that it is boosting on.  Weights are not supported yet, and residualStorage has to be ResidualStorage_Float64
+// for now, so ResidualStorage_Float32 returns an error.  The handles are written to boosterHandlesOut and each one is
+// freed with FreeBooster.  The shared data is released when the last of them is freed
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION CreateClassificationBoosters(
+   IntEbmType countBags,
+   const SeedEbmType * randomSeeds,
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const BoolEbmType * featuresCategorical,
+   const IntEbmType * featuresBinCount,
+   IntEbmType countFeatureGroups,
+   const IntEbmType * featureGroupsFeatureCount,
+   const IntEbmType * featureGroupsFeatureIndexes,
+   IntEbmType countSamples,
+   const IntEbmType * binnedData,
+   const IntEbmType * targets,
+   const FloatEbmType * weights,
+   const FloatEbmType * predictorScores,
+   const IntEbmType * bagsSampleCounts,
+   IntEbmType countInnerBags,
+   const FloatEbmType * optionalTempParams,
+   ResidualStorageType residualStorage,
+   BoosterHandle * boosterHandlesOut
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION CreateRegressionBoosters(
+   IntEbmType countBags,
+   const SeedEbmType * randomSeeds,
+   IntEbmType countFeatures,
+   const BoolEbmType * featuresCategorical,
+   const IntEbmType * featuresBinCount,
+   IntEbmType countFeatureGroups,
+   const IntEbmType * featureGroupsFeatureCount,
+   const IntEbmType * featureGroupsFeatureIndexes,
+   IntEbmType countSamples,
+   const IntEbmType * binnedData,
+   const FloatEbmType * targets,
+   const FloatEbmType * weights,
+   const FloatEbmType * predictorScores,
+   const IntEbmType * bagsSampleCounts,
+   IntEbmType countInnerBags,
+   const FloatEbmType * optionalTempParams,
+   ResidualStorageType residualStorage,
+   BoosterHandle * boosterHandlesOut
+);
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE FloatEbmType * EBM_NATIVE_CALLING_CONVENTION GenerateModelFeatureGroupUpdate(
    BoosterHandle boosterHandle, 
    IntEbmType indexFeatureGroup, 
@@ -463,6 +768,58 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION Boosti
    const IntEbmType * leavesMax,
    FloatEbmType * validationMetricOut
 );
+// runs BoostingStep on each of the countBoosters boosters on up to countThreads threads, where 0 means all the threads
+// set by SetThreadCount.  The boosters must be distinct, and each one ends up in the same state as if BoostingStep had been
+// called on it alone.  validationMetricsOut, which can be nullptr, receives one validation metric per booster
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION BoostingStepParallel(
+   IntEbmType countThreads,
+   IntEbmType countBoosters,
+   const BoosterHandle * boosterHandles,
+   IntEbmType indexFeatureGroup,
+   GenerateUpdateOptionsType options,
+   FloatEbmType learningRate,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   const IntEbmType * leavesMax,
+   FloatEbmType * validationMetricsOut
+);
+// calls BoostingStep on each feature group in order, for up to countRoundsMax rounds, and stops early once the lowest
+// validation metric seen has failed to improve by more than earlyStoppingTolerance for countEarlyStoppingRounds rounds.
+// A negative countEarlyStoppingRounds disables early stopping.  leavesMax is used for every feature group, so it needs an
+// item for each dimension of the largest feature group.  countRoundsOut receives the number of rounds run and 
+// bestMetricOut the lowest validation metric.  GetBestModelFeatureGroup returns the model at that metric afterwards
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION BoostCyclic(
+   BoosterHandle boosterHandle,
+   GenerateUpdateOptionsType options,
+   FloatEbmType learningRate,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   const IntEbmType * leavesMax,
+   IntEbmType countRoundsMax,
+   IntEbmType countEarlyStoppingRounds,
+   FloatEbmType earlyStoppingTolerance,
+   IntEbmType * countRoundsOut,
+   FloatEbmType * bestMetricOut
+);
+// BoostJacobi is BoostCyclic where the updates for each block of countFeatureGroupsPerBlock feature groups (0 means all of 
+// them) are generated in parallel from the same residuals on up to countThreads threads (0 means all the threads set by 
+// SetThreadCount) and then applied together in feature group order.  The feature groups can't see each other's updates 
+// within a block, so the updates tend to overshoot and damping multiplies the learning rate to compensate, for example 
+// 1 / countFeatureGroupsPerBlock for strongly correlated features.  The model doesn't depend on countThreads, but it 
+// differs from the BoostCyclic model even with blocks of 1 feature group, since each feature group gets its own seed
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION BoostJacobi(
+   BoosterHandle boosterHandle,
+   IntEbmType countThreads,
+   IntEbmType countFeatureGroupsPerBlock,
+   FloatEbmType damping,
+   GenerateUpdateOptionsType options,
+   FloatEbmType learningRate,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   const IntEbmType * leavesMax,
+   IntEbmType countRoundsMax,
+   IntEbmType countEarlyStoppingRounds,
+   FloatEbmType earlyStoppingTolerance,
+   IntEbmType * countRoundsOut,
+   FloatEbmType * bestMetricOut
+);
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE FloatEbmType * EBM_NATIVE_CALLING_CONVENTION GetBestModelFeatureGroup(
    BoosterHandle boosterHandle, 
    IntEbmType indexFeatureGroup
@@ -506,6 +863,23 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION Calcul
    IntEbmType countSamplesRequiredForChildSplitMin,
    FloatEbmType * interactionScoreOut
 );
+// scores countFeatureGroups feature groups, given in the same format as for CreateClassificationBooster, on up to 
+// countThreads threads, where 0 means all the threads set by SetThreadCount.  Each thread reuses its buffers for all the
+// feature groups that it scores.  If countTopScores is 0, interactionScoresOut receives the score of every feature group
+// in order.  Otherwise only the min(countTopScores, countFeatureGroups) highest scores are returned, from highest to 
+// lowest, with the index of their feature group in topFeatureGroupIndexesOut.  Ties go to the lower index.  If scoring
+// any feature group fails we return an error, and with countTopScores nonzero the outputs are left unchanged
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION CalculateInteractionScores(
+   InteractionDetectorHandle interactionDetectorHandle,
+   IntEbmType countThreads,
+   IntEbmType countFeatureGroups,
+   const IntEbmType * featureGroupsFeatureCount,
+   const IntEbmType * featureGroupsFeatureIndexes,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   IntEbmType countTopScores,
+   IntEbmType * topFeatureGroupIndexesOut,
+   FloatEbmType * interactionScoresOut
+);
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION FreeInteractionDetector(
    InteractionDetectorHandle interactionDetectorHandle
 );